@@ -0,0 +1,64 @@
+"""Test the functionality of protocols.backend classes."""
+
+from typing import Optional
+
+import betterproto
+
+from ventserver.protocols import backend
+from ventserver.protocols.protobuf import mcu_pb as pb
+
+
+def receive(
+        receiver: backend.ReceiveFilter, time: float,
+        mcu_receive: Optional[betterproto.Message] = None
+) -> None:
+    """Input a clock update and an optional message from the MCU."""
+    receiver.input(backend.ReceiveEvent(time=time, mcu_receive=mcu_receive))
+    receiver.output()
+
+
+def test_mcu_baud_rate_negotiated() -> None:
+    """Test that the link follows the baud rate announced by the MCU."""
+    receiver = backend.ReceiveFilter()
+    receive(receiver, 0)
+    assert receiver.mcu_baud_rate == backend.MCU_DEFAULT_BAUD_RATE
+
+    receive(receiver, 0.1, pb.Capabilities(baud_rate=1000000))
+    assert receiver.mcu_baud_rate == 1000000
+
+    receive(receiver, 0.2, pb.Capabilities())
+    assert receiver.mcu_baud_rate == backend.MCU_DEFAULT_BAUD_RATE
+
+
+def test_mcu_baud_rate_fallback() -> None:
+    """Test the fallback to the default baud rate when the MCU goes quiet."""
+    timeout = backend.MCU_BAUD_RATE_FALLBACK_TIMEOUT
+    receiver = backend.ReceiveFilter()
+    receive(receiver, 0, pb.Capabilities(baud_rate=1000000))
+    assert receiver.mcu_baud_rate == 1000000
+
+    # Any message from the MCU keeps the negotiated baud rate
+    receive(receiver, timeout * 0.5)
+    receive(receiver, timeout * 0.5, pb.SensorMeasurements(time=1))
+    receive(receiver, timeout * 1.25)
+    assert receiver.mcu_baud_rate == 1000000
+
+    receive(receiver, timeout * 1.5)
+    assert receiver.mcu_baud_rate == backend.MCU_DEFAULT_BAUD_RATE
+    capabilities = receiver.all_states[pb.Capabilities]
+    assert isinstance(capabilities, pb.Capabilities)
+    assert capabilities.baud_rate == backend.MCU_DEFAULT_BAUD_RATE
+
+    # The link stays at the default baud rate until the MCU announces another
+    receive(receiver, timeout * 10)
+    assert receiver.mcu_baud_rate == backend.MCU_DEFAULT_BAUD_RATE
+    receive(receiver, timeout * 10, pb.Capabilities(baud_rate=1000000))
+    assert receiver.mcu_baud_rate == 1000000
+
+
+def test_mcu_baud_rate_default_without_capabilities() -> None:
+    """Test that the link never falls back from the default baud rate."""
+    receiver = backend.ReceiveFilter()
+    receive(receiver, backend.MCU_BAUD_RATE_FALLBACK_TIMEOUT * 10)
+    assert receiver.mcu_baud_rate == backend.MCU_DEFAULT_BAUD_RATE
+    assert receiver.all_states[pb.Capabilities] is None
@@ -0,0 +1,194 @@
+"""Test the functionality of protocols.mcu classes."""
+
+import struct
+from typing import Any, Dict, List, Optional
+
+import betterproto
+
+import pytest as pt  # type: ignore
+
+from ventserver.protocols import crcelements
+from ventserver.protocols import datagrams
+from ventserver.protocols import exceptions
+from ventserver.protocols import frames
+from ventserver.protocols import mcu
+from ventserver.protocols import messages
+from ventserver.protocols.protobuf import mcu_pb as pb
+
+
+example_sensor_measurements: List[Dict[str, Any]] = [
+    {},
+    {
+        'time': 1000, 'cycle': 4, 'paw': 20.5, 'flow': -12.25, 'volume': 300,
+        'fio2': 21, 'spo2': 97.5
+    },
+    {'time': 0xffffffff, 'cycle': 0xffffffff},
+]
+
+
+def varint(value: int) -> bytes:
+    """Encode a protobuf-style varint."""
+    encoded = bytearray()
+    while value > 0x7f:
+        encoded.append(value & 0x7f | 0x80)
+        value >>= 7
+    encoded.append(value)
+    return bytes(encoded)
+
+
+def float_bits(value: float) -> int:
+    """Return the bits of a value as a 32-bit float."""
+    (bits,) = struct.unpack('<I', struct.pack('<f', value))
+    return bits  # type: ignore
+
+
+def mcu_frame(seq: int, type_code: int, payload: bytes) -> bytes:
+    """Encode a message as the MCU would send it in a frame."""
+    datagram = datagrams.Datagram(
+        seq=seq, payload=bytes([type_code]) + payload
+    )
+    datagram.update_from_payload()
+    crc_sender = crcelements.CRCSender()
+    crc_sender.input(datagram.compute_body())
+    cobs_encoder = frames.COBSEncoder()
+    cobs_encoder.input(crc_sender.output())
+    merger = frames.ChunkMerger()
+    merger.input(cobs_encoder.output())
+    frame = merger.output()
+    assert frame is not None
+    return frame
+
+
+def receive_frames(
+        receiver: mcu.ReceiveFilter, frame_list: List[bytes]
+) -> List[Optional[betterproto.Message]]:
+    """Input frames into the receiver, returning the message from each."""
+    received = []
+    for frame in frame_list:
+        receiver.input(frame)
+        received.append(receiver.output())
+    return received
+
+
+# Binary SensorMeasurements
+
+
+@pt.mark.parametrize('fields', example_sensor_measurements)
+def test_binary_sensor_measurements_roundtrip(fields: Dict[str, Any]) -> None:
+    """Test the fixed layout of message type 14 in both directions."""
+    measurements = pb.SensorMeasurements(**fields)
+    body = bytes(mcu.BinarySensorMeasurements(**fields))
+    assert len(body) == mcu.BinarySensorMeasurements.LAYOUT.size == 28
+    assert body[:4] == struct.pack('<I', measurements.time)
+
+    message = messages.Message()
+    message.parse(bytes([14]) + body, mcu.MESSAGE_CLASSES)
+    assert not isinstance(message.payload, mcu.BinarySensorMeasurements)
+    assert message.payload == measurements
+
+
+def test_binary_sensor_measurements_bad_length() -> None:
+    """Test rejection of type 14 payloads with the wrong size."""
+    message = messages.Message()
+    body = bytes(mcu.BinarySensorMeasurements(time=1))
+    for bad_body in [body[:-1], body + b'\x00', b'']:
+        with pt.raises(exceptions.ProtocolDataError):
+            message.parse(bytes([14]) + bad_body, mcu.MESSAGE_CLASSES)
+
+
+# Measurements deltas
+
+
+def test_delta_apply() -> None:
+    """Test reconstruction of measurements from deltas."""
+    reference = pb.SensorMeasurements(
+        time=1000, cycle=4, paw=20.5, flow=-12.25, volume=300,
+        fio2=21, spo2=97.5
+    )
+    # time, paw, and fio2 changed
+    delta = mcu.SensorMeasurementsDelta().parse(
+        bytes([0b0100101]) + varint(10)
+        + varint(float_bits(20.5) ^ float_bits(22.0))
+        + varint(float_bits(21) ^ float_bits(40))
+    )
+    assert delta.apply(reference) == pb.SensorMeasurements(
+        time=1010, cycle=4, paw=22.0, flow=-12.25, volume=300,
+        fio2=40, spo2=97.5
+    )
+
+    unchanged = mcu.SensorMeasurementsDelta().parse(bytes([0]))
+    assert unchanged.apply(reference) == reference
+
+
+def test_delta_apply_counter_wraparound() -> None:
+    """Test that counter differences are applied modulo 2^32."""
+    reference = pb.CycleMeasurements(time=0xfffffffe, vt=300)
+    delta = mcu.CycleMeasurementsDelta().parse(b'\x01' + varint(4))
+    assert delta.apply(reference) == pb.CycleMeasurements(time=2, vt=300)
+
+    delta = mcu.CycleMeasurementsDelta().parse(
+        b'\x01' + varint((1 << 32) - 0xfffffffe)
+    )
+    assert delta.apply(reference).time == 0
+
+
+@pt.mark.parametrize('payload', [
+    b'\x80',  # nonexistent field
+    b'\x01',  # missing difference
+    b'\x01\x0a\x00',  # trailing byte
+    b'\x01\x80',  # truncated varint
+])
+def test_delta_parse_invalid(payload: bytes) -> None:
+    """Test rejection of malformed deltas."""
+    with pt.raises((ValueError, IndexError)):
+        mcu.SensorMeasurementsDelta().parse(payload)
+
+
+def test_delta_references_sequence_gap() -> None:
+    """Test that deltas are discarded after a gap until the next keyframe."""
+    keyframe = pb.SensorMeasurements(time=1000, cycle=4, paw=20.5)
+    keyframe_body = bytes(mcu.BinarySensorMeasurements(
+        time=keyframe.time, cycle=keyframe.cycle, paw=keyframe.paw
+    ))
+    time_delta = b'\x01' + varint(10)
+    receiver = mcu.ReceiveFilter()
+
+    received = receive_frames(receiver, [
+        mcu_frame(0, 14, keyframe_body),
+        mcu_frame(1, 15, time_delta),
+        mcu_frame(2, 15, time_delta),
+    ])
+    assert received == [
+        keyframe,
+        pb.SensorMeasurements(time=1010, cycle=4, paw=20.5),
+        pb.SensorMeasurements(time=1020, cycle=4, paw=20.5),
+    ]
+
+    # The datagram with seq 3 is lost
+    received = receive_frames(receiver, [
+        mcu_frame(4, 15, time_delta),
+        mcu_frame(5, 15, time_delta),
+        mcu_frame(6, 14, keyframe_body),
+        mcu_frame(7, 15, time_delta),
+    ])
+    assert received == [
+        None,
+        None,
+        keyframe,
+        pb.SensorMeasurements(time=1010, cycle=4, paw=20.5),
+    ]
+
+
+def test_delta_references_per_type() -> None:
+    """Test that each delta-coded type keeps its own reference."""
+    receiver = mcu.ReceiveFilter()
+    received = receive_frames(receiver, [
+        mcu_frame(0, 14, bytes(mcu.BinarySensorMeasurements(time=1000))),
+        mcu_frame(1, 16, b'\x01' + varint(10)),
+        mcu_frame(2, 15, b'\x01' + varint(10)),
+    ])
+    assert received == [
+        pb.SensorMeasurements(time=1000),
+        None,
+        pb.SensorMeasurements(time=1010),
+    ]
@@ -114,6 +114,11 @@ async def main() -> None:
                         serial_endpoint, websocket_endpoint,
                         filehandler
                     )
+                    # Follow the MCU when it announces or falls back from a
+                    # faster baud rate
+                    serial_endpoint.set_baud_rate(
+                        protocol.receive.backend.mcu_baud_rate
+                    )
 
                     if receive_output.frontend_delayed:
                         nursery.start_soon(
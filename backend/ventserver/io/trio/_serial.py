@@ -52,6 +52,18 @@ class Driver(endpoints.IOEndpoint[bytes, bytes]):
                 'Cannot open a serial connection to {}!'.format(self.props.port)
             ) from err
 
+    def set_baud_rate(self, baud_rate: int) -> None:
+        """Switch the open serial connection to another baud rate.
+
+        Connections are always opened at the baud rate in the driver
+        properties.
+        """
+        if self._connection is None or self._connection.baudrate == baud_rate:
+            return
+
+        self._connection.baudrate = baud_rate
+        self._logger.info('Switched to %d baud', baud_rate)
+
     @property
     def is_open(self) -> bool:
         """Return whether or not the serial device connection is open."""
@@ -23,6 +23,26 @@ MCU_SYNCHRONIZER_SCHEDULE = collections.deque([
     states.ScheduleEntry(time=0.05, type=mcu_pb.ParametersRequest),
 ])
 
+# Intervals between CapabilitiesRequests to the MCU, which are sent outside the
+# MCU synchronizer schedule: every CapabilitiesRequest makes the MCU restart
+# its delta-encoded measurements with full messages, so requests are only
+# repeated quickly until the MCU confirms them with a Capabilities reply
+MCU_CAPABILITIES_REQUEST_INTERVAL = 0.25  # s
+MCU_CAPABILITIES_REQUEST_KEEPALIVE_INTERVAL = 10.0  # s
+
+# Optional MCU protocol features which the backend supports
+MCU_CAPABILITIES = (
+    mcu_pb.Capability.binary_sensor_measurements
+    | mcu_pb.Capability.delta_measurements
+)
+
+# Baud rates of the MCU serial link: the link starts at the default baud rate,
+# switches to the baud rate announced in the MCU's Capabilities, and falls back
+# to the default baud rate if no MCU message arrives for the fallback timeout
+MCU_DEFAULT_BAUD_RATE = 115200
+MCU_MAX_BAUD_RATE = 3000000
+MCU_BAUD_RATE_FALLBACK_TIMEOUT = 1.0  # s
+
 FRONTEND_SYNCHRONIZER_SCHEDULE = collections.deque([
     states.ScheduleEntry(time=0.01, type=mcu_pb.SensorMeasurements),
     states.ScheduleEntry(time=0.01, type=mcu_pb.Parameters),
@@ -105,6 +125,9 @@ class ReceiveFilter(protocols.Filter[ReceiveEvent, OutputEvent]):
         mcu_pb.CycleMeasurements,
         mcu_pb.Parameters,
         mcu_pb.AlarmLimits,
+        mcu_pb.Capabilities,
+        mcu_pb.Diagnostics,
+        mcu_pb.Profile,
     }
     FRONTEND_INPUT_TYPES = {
         mcu_pb.ParametersRequest,
@@ -119,6 +142,11 @@ class ReceiveFilter(protocols.Filter[ReceiveEvent, OutputEvent]):
         factory=channels.DequeChannel
     )
     current_time: float = attr.ib(default=0)
+    _last_mcu_receive_time: float = attr.ib(default=0)
+    _capabilities_request_time: Optional[float] = attr.ib(default=None)
+    _capabilities_confirmed: Optional[mcu_pb.Capabilities] = attr.ib(
+        default=None
+    )
     all_states: Dict[
         Type[betterproto.Message], Optional[betterproto.Message]
     ] = attr.ib()
@@ -137,10 +165,16 @@ class ReceiveFilter(protocols.Filter[ReceiveEvent, OutputEvent]):
         Each pair consists of the type class to specify the states, and an
         actual object to store the state values.
         """
-        return {
+        all_states: Dict[
+            Type[betterproto.Message], Optional[betterproto.Message]
+        ] = {
             type: None for type in frontend.MESSAGE_CLASSES.values()
             # FRONTEND_MESSAGE_CLASSES is a superset of MCU_MESSAGE_CLASSES
         }
+        all_states[mcu_pb.CapabilitiesRequest] = mcu_pb.CapabilitiesRequest(
+            features=MCU_CAPABILITIES, max_baud_rate=MCU_MAX_BAUD_RATE
+        )
+        return all_states
 
     @_mcu_state_synchronizer.default
     def init_mcu_synchronizer(self) -> states.Synchronizer:  # pylint: disable=no-self-use
@@ -176,6 +210,16 @@ class ReceiveFilter(protocols.Filter[ReceiveEvent, OutputEvent]):
         """Initialize the frontend log events list sender."""
         return lists.SendSynchronizer(segment_type=mcu_pb.NextLogEvents)
 
+    @property
+    def mcu_baud_rate(self) -> int:
+        """Return the baud rate at which the MCU serial link should run."""
+        capabilities = typing.cast(
+            Optional[mcu_pb.Capabilities], self.all_states[mcu_pb.Capabilities]
+        )
+        if capabilities is None or not capabilities.baud_rate:
+            return MCU_DEFAULT_BAUD_RATE
+        return int(capabilities.baud_rate)
+
     def input(self, event: Optional[ReceiveEvent]) -> None:
         """Handle input events."""
         if event is None or not event.has_data():
@@ -204,6 +248,8 @@ class ReceiveFilter(protocols.Filter[ReceiveEvent, OutputEvent]):
             mcu_send = self._mcu_state_synchronizer.output()
         except exceptions.ProtocolDataError:
             self._logger.exception('MCU State Synchronizer:')
+        if mcu_send is None:
+            mcu_send = self._output_capabilities_request()
         frontend_send = None
         try:
             frontend_send = self._frontend_state_synchronizer.output()
@@ -233,6 +279,70 @@ class ReceiveFilter(protocols.Filter[ReceiveEvent, OutputEvent]):
         self._file_state_synchronizer.input(states.UpdateEvent(
             time=self.current_time
         ))
+        self._update_mcu_baud_rate()
+
+    def _update_mcu_baud_rate(self) -> None:
+        """Fall back to the default baud rate if the MCU stops responding."""
+        if self.mcu_baud_rate == MCU_DEFAULT_BAUD_RATE:
+            return
+
+        if (
+                self.current_time - self._last_mcu_receive_time
+                < MCU_BAUD_RATE_FALLBACK_TIMEOUT
+        ):
+            return
+
+        # The MCU falls back on its own after the same timeout
+        self._logger.warning(
+            'No messages from the MCU at %d baud, falling back to %d baud',
+            self.mcu_baud_rate, MCU_DEFAULT_BAUD_RATE
+        )
+        capabilities = typing.cast(
+            mcu_pb.Capabilities, self.all_states[mcu_pb.Capabilities]
+        )
+        capabilities.baud_rate = MCU_DEFAULT_BAUD_RATE
+        # Negotiate again as soon as the MCU responds
+        self._capabilities_confirmed = None
+        self._capabilities_request_time = None
+
+    def _output_capabilities_request(
+            self
+    ) -> Optional[mcu_pb.CapabilitiesRequest]:
+        """Emit a CapabilitiesRequest for the MCU, if one is due."""
+        if self._capabilities_confirmed is None:
+            interval = MCU_CAPABILITIES_REQUEST_INTERVAL
+        else:
+            interval = MCU_CAPABILITIES_REQUEST_KEEPALIVE_INTERVAL
+        if (
+                self._capabilities_request_time is not None
+                and self.current_time - self._capabilities_request_time
+                < interval
+        ):
+            return None
+
+        self._capabilities_request_time = self.current_time
+        return typing.cast(
+            mcu_pb.CapabilitiesRequest,
+            self.all_states[mcu_pb.CapabilitiesRequest]
+        )
+
+    def _confirm_capabilities(self, capabilities: mcu_pb.Capabilities) -> None:
+        """Handle a Capabilities reply from the MCU."""
+        if self._capabilities_request_time is None:
+            return
+
+        if self._capabilities_confirmed is None:
+            self._capabilities_confirmed = capabilities
+            return
+
+        if capabilities.features != self._capabilities_confirmed.features:
+            # The MCU has forgotten the last request, e.g. because it reset
+            self._logger.warning(
+                'MCU capabilities changed from %s to %s, negotiating again',
+                self._capabilities_confirmed.features, capabilities.features
+            )
+            self._capabilities_confirmed = None
+            self._capabilities_request_time = None
 
     def _handle_mcu_inbound_state(self, event: ReceiveEvent) -> None:
         """Handle any inbound state update from the MCU."""
@@ -242,6 +352,9 @@ class ReceiveFilter(protocols.Filter[ReceiveEvent, OutputEvent]):
         ):
             return
 
+        self._last_mcu_receive_time = self.current_time
+        if isinstance(event.mcu_receive, mcu_pb.Capabilities):
+            self._confirm_capabilities(event.mcu_receive)
         try:
             self._mcu_state_synchronizer.input(
                 states.UpdateEvent(pb_message=event.mcu_receive)
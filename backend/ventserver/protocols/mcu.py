@@ -1,7 +1,8 @@
 """Sans-I/O MCU device communication protocol."""
 
 import logging
-from typing import Mapping, Optional, Type
+import struct
+from typing import Dict, Mapping, Optional, Tuple, Type
 
 import attr
 
@@ -26,6 +27,129 @@ UpperEvent = betterproto.Message
 # Types
 
 
+class BinarySensorMeasurements(mcu_pb.SensorMeasurements):
+    """SensorMeasurements with the fixed layout of message type 14.
+
+    The MCU only sends this encoding after it receives a CapabilitiesRequest
+    with the binary_sensor_measurements flag. Parsing produces a plain
+    SensorMeasurements, so that nothing else needs to handle both encodings.
+    """
+
+    # time, cycle, paw, flow, volume, fio2, spo2
+    LAYOUT = struct.Struct('<IIfffff')
+
+    def parse(  # type: ignore
+            self, data: bytes
+    ) -> mcu_pb.SensorMeasurements:
+        """Parse the fixed layout in a single unpack."""
+        (time, cycle, paw, flow, volume, fio2, spo2) = self.LAYOUT.unpack(data)
+        return mcu_pb.SensorMeasurements(
+            time=time, cycle=cycle, paw=paw, flow=flow, volume=volume,
+            fio2=fio2, spo2=spo2
+        )
+
+    def __bytes__(self) -> bytes:
+        """Serialize into the fixed layout."""
+        return self.LAYOUT.pack(
+            self.time, self.cycle, self.paw, self.flow, self.volume,
+            self.fio2, self.spo2
+        )
+
+
+def _read_varint(data: bytes, offset: int) -> Tuple[int, int]:
+    """Read a protobuf-style varint, returning it and the offset after it."""
+    value = 0
+    shift = 0
+    while True:
+        byte = data[offset]  # may raise IndexError
+        offset += 1
+        value |= (byte & 0x7f) << shift
+        if not byte & 0x80:
+            return (value, offset)
+        shift += 7
+
+
+def _float_bits(value: float) -> int:
+    """Return the bits of a value as a 32-bit float."""
+    (bits,) = struct.unpack('<I', struct.pack('<f', value))
+    return bits  # type: ignore
+
+
+def _bits_float(bits: int) -> float:
+    """Return the 32-bit float with the given bits."""
+    (value,) = struct.unpack('<f', struct.pack('<I', bits))
+    return value  # type: ignore
+
+
+@attr.s
+class MeasurementsDelta:
+    """Changes in a measurements message from the previous one of its type.
+
+    The MCU only sends these after it receives a CapabilitiesRequest with the
+    delta_measurements flag. The payload is a byte with one bit per field, set
+    for each changed field, followed by a varint for each changed field: uint32
+    fields as their difference modulo 2^32, and float fields as the XOR of
+    their bits with the previous bits. Deltas can only be applied to the
+    previous message of their type, so ReceiveFilter discards them after any
+    gap in datagram sequence numbers until the next message sent whole.
+    """
+
+    MESSAGE_CLASS: Type[betterproto.Message] = betterproto.Message
+    # Field names in order, and whether each is a uint32 counter
+    FIELDS: Tuple[Tuple[str, bool], ...] = ()
+
+    differences: Dict[str, int] = attr.ib(factory=dict)
+
+    def parse(self, data: bytes) -> 'MeasurementsDelta':
+        """Parse the changed fields and their coded differences."""
+        changed = data[0]
+        if changed >> len(self.FIELDS):
+            raise ValueError(
+                'Delta marks nonexistent fields: {}'.format(changed)
+            )
+
+        offset = 1
+        for (index, (name, _)) in enumerate(self.FIELDS):
+            if changed & (1 << index):
+                (self.differences[name], offset) = _read_varint(data, offset)
+        if offset != len(data):
+            raise ValueError('Delta has trailing bytes: {!r}'.format(data))
+
+        return self
+
+    def apply(self, reference: betterproto.Message) -> betterproto.Message:
+        """Reconstruct the message from the previous one."""
+        values = {}
+        for (name, counter) in self.FIELDS:
+            value = getattr(reference, name)
+            difference = self.differences.get(name, 0)
+            if counter:
+                values[name] = (value + difference) % (1 << 32)
+            else:
+                values[name] = _bits_float(_float_bits(value) ^ difference)
+        return self.MESSAGE_CLASS(**values)
+
+
+class SensorMeasurementsDelta(MeasurementsDelta):
+    """SensorMeasurements delta, sent as message type 15."""
+
+    MESSAGE_CLASS = mcu_pb.SensorMeasurements
+    FIELDS = (
+        ('time', True), ('cycle', True), ('paw', False), ('flow', False),
+        ('volume', False), ('fio2', False), ('spo2', False)
+    )
+
+
+class CycleMeasurementsDelta(MeasurementsDelta):
+    """CycleMeasurements delta, sent as message type 16."""
+
+    MESSAGE_CLASS = mcu_pb.CycleMeasurements
+    FIELDS = (
+        ('time', True), ('vt', False), ('rr', False), ('peep', False),
+        ('pip', False), ('ip', False), ('ve', False)
+    )
+
+
 MESSAGE_CLASSES: Mapping[int, Type[betterproto.Message]] = {
     2: mcu_pb.SensorMeasurements,
     3: mcu_pb.CycleMeasurements,
@@ -36,6 +160,14 @@ MESSAGE_CLASSES: Mapping[int, Type[betterproto.Message]] = {
     8: mcu_pb.ExpectedLogEvent,
     9: mcu_pb.NextLogEvents,
     10: mcu_pb.ActiveLogEvents,
+    11: mcu_pb.SensorWaveforms,
+    12: mcu_pb.Capabilities,
+    13: mcu_pb.CapabilitiesRequest,
+    14: BinarySensorMeasurements,
+    15: SensorMeasurementsDelta,  # type: ignore
+    16: CycleMeasurementsDelta,  # type: ignore
+    17: mcu_pb.Diagnostics,
+    18: mcu_pb.Profile,
     254: mcu_pb.Ping,
     255: mcu_pb.Announcement
 }
@@ -63,6 +195,10 @@ class ReceiveFilter(protocols.Filter[LowerEvent, UpperEvent]):
         factory=datagrams.DatagramReceiver
     )
     _message_receiver: messages.MessageReceiver = attr.ib()
+    # The previous message of each delta-coded type, for applying deltas
+    _delta_references: Dict[
+        Type[betterproto.Message], betterproto.Message
+    ] = attr.ib(factory=dict)
 
     @_message_receiver.default
     def init_message_receiver(self) -> messages.MessageReceiver:  # pylint: disable=no-self-use
@@ -100,11 +236,19 @@ class ReceiveFilter(protocols.Filter[LowerEvent, UpperEvent]):
             self._logger.exception('CRCReceiver: %s', err)
         if crc_payload:
             self._datagram_receiver.input(crc_payload)
+        expected_seq = self._datagram_receiver.expected_seq
         datagram_payload = None
         try:
             datagram_payload = self._datagram_receiver.output()
         except exceptions.ProtocolDataError:
             self._logger.exception('DatagramReceiver: %s', frame_payload)
+        if datagram_payload is not None and (
+                expected_seq is None
+                or self._datagram_receiver.expected_seq
+                != (expected_seq + 1) % datagrams.SEQ_NUM_SPACE
+        ):
+            # Messages may have been lost, so deltas can't be applied
+            self._delta_references.clear()
 
         self._message_receiver.input(datagram_payload)
         message: Optional[betterproto.Message] = None
@@ -113,6 +257,26 @@ class ReceiveFilter(protocols.Filter[LowerEvent, UpperEvent]):
         except exceptions.ProtocolDataError:
             self._logger.exception('MessageReceiver: %s', datagram_payload)
 
+        return self._apply_delta(message)
+
+    def _apply_delta(
+            self, message: Optional[betterproto.Message]
+    ) -> Optional[betterproto.Message]:
+        """Reconstruct delta-coded messages and track their references."""
+        if isinstance(message, MeasurementsDelta):
+            reference = self._delta_references.get(message.MESSAGE_CLASS)
+            if reference is None:
+                self._logger.info(
+                    'Discarding %s until the next keyframe',
+                    type(message).__name__
+                )
+                return None
+
+            message = message.apply(reference)
+        if isinstance(message, (
+                mcu_pb.SensorMeasurements, mcu_pb.CycleMeasurements
+        )):
+            self._delta_references[type(message)] = message
         return message
 
 
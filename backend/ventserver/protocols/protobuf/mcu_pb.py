@@ -30,6 +30,26 @@ class LogEventCode(betterproto.Enum):
     screen_locked = 7
 
 
+class Capability(betterproto.Enum):
+    """Optional protocol features, as bit flags"""
+
+    no_capabilities = 0
+    binary_sensor_measurements = 1
+    delta_measurements = 2
+
+
+class ProfileRegion(betterproto.Enum):
+    """Regions of the firmware whose execution times are profiled"""
+
+    control_loop = 0
+    backend_receive = 1
+    backend_send = 2
+    sensors = 3
+    backend_uart_isr = 4
+    nonin_oem_uart_isr = 5
+    fdo2_uart_isr = 6
+
+
 @dataclass
 class Range(betterproto.Message):
     lower: int = betterproto.uint32_field(1)
@@ -83,6 +103,23 @@ class SensorMeasurements(betterproto.Message):
     spo2: float = betterproto.float_field(7)
 
 
+@dataclass
+class SensorWaveforms(betterproto.Message):
+    """
+    Batches of waveform samples at the rate of the control loop, so that each
+    frame carries many samples. Sample i of each channel was measured at time +
+    offset[i], in ms; first_sample is the number of samples measured before
+    this batch, so that gaps between batches can be detected.
+    """
+
+    time: int = betterproto.uint32_field(1)
+    first_sample: int = betterproto.uint32_field(2)
+    offset: List[int] = betterproto.uint32_field(3)
+    paw: List[float] = betterproto.float_field(4)
+    flow: List[float] = betterproto.float_field(5)
+    volume: List[float] = betterproto.float_field(6)
+
+
 @dataclass
 class CycleMeasurements(betterproto.Message):
     time: int = betterproto.uint32_field(1)
@@ -182,3 +219,84 @@ class AlarmMute(betterproto.Message):
 class AlarmMuteRequest(betterproto.Message):
     active: bool = betterproto.bool_field(1)
     remaining: float = betterproto.float_field(2)
+
+
+@dataclass
+class Capabilities(betterproto.Message):
+    """Features which the MCU has enabled, out of those requested"""
+
+    features: int = betterproto.uint32_field(1)
+    # The MCU switches the link to this baud rate as soon as it has sent this
+    # message, and switches back to 115200 baud if it receives no valid message
+    # for 1 s afterwards
+    baud_rate: int = betterproto.uint32_field(2)
+
+
+@dataclass
+class CapabilitiesRequest(betterproto.Message):
+    """Features which the receiver of MCU messages supports"""
+
+    features: int = betterproto.uint32_field(1)
+    # The highest baud rate which the receiver supports, or 0 to stay at 115200
+    # baud
+    max_baud_rate: int = betterproto.uint32_field(2)
+
+
+@dataclass
+class Diagnostics(betterproto.Message):
+    """
+    Counts of the outcomes of each layer of the backend serial protocol since
+    the MCU started, and the throughput of the link over the last second.
+    Counters wrap around at 2^32.
+    """
+
+    time: int = betterproto.uint32_field(1)
+    # Receiving
+    rx_bytes: int = betterproto.uint32_field(2)
+    rx_messages: int = betterproto.uint32_field(3)
+    rx_dropped_bytes: int = betterproto.uint32_field(4)
+    rx_frame_length_errors: int = betterproto.uint32_field(5)
+    rx_frames_overwritten: int = betterproto.uint32_field(6)
+    rx_crcelement_parse_errors: int = betterproto.uint32_field(7)
+    rx_crc_errors: int = betterproto.uint32_field(8)
+    rx_datagram_parse_errors: int = betterproto.uint32_field(9)
+    rx_datagram_length_errors: int = betterproto.uint32_field(10)
+    rx_sequence_gaps: int = betterproto.uint32_field(11)
+    rx_message_length_errors: int = betterproto.uint32_field(12)
+    rx_message_type_errors: int = betterproto.uint32_field(13)
+    rx_message_encoding_errors: int = betterproto.uint32_field(14)
+    rx_rejected_messages: int = betterproto.uint32_field(15)
+    # Sending
+    tx_bytes: int = betterproto.uint32_field(16)
+    tx_messages: int = betterproto.uint32_field(17)
+    tx_message_errors: int = betterproto.uint32_field(18)
+    tx_frame_errors: int = betterproto.uint32_field(19)
+    tx_stalls: int = betterproto.uint32_field(20)
+    # waveform samples whose batches were replaced by newer batches before they
+    # could be sent
+    tx_dropped_waveform_samples: int = betterproto.uint32_field(25)
+    # Throughput over the last second, per second
+    rx_message_rate: float = betterproto.float_field(21)
+    rx_byte_rate: float = betterproto.float_field(22)
+    tx_message_rate: float = betterproto.float_field(23)
+    tx_byte_rate: float = betterproto.float_field(24)
+
+
+@dataclass
+class Profile(betterproto.Message):
+    """
+    Execution times of one profiled region since the MCU started, in CPU
+    cycles. The MCU only sends these when its firmware was built with the
+    profiler enabled, and cycles through the regions, one per message.
+    """
+
+    time: int = betterproto.uint32_field(1)
+    region: "ProfileRegion" = betterproto.enum_field(2)
+    count: int = betterproto.uint32_field(3)
+    min_cycles: int = betterproto.uint32_field(4)
+    max_cycles: int = betterproto.uint32_field(5)
+    mean_cycles: int = betterproto.uint32_field(6)
+    # Element i counts executions of [2^i, 2^(i+1)) cycles; the first element
+    # also counts executions of 0 cycles, and the last element also counts all
+    # longer executions
+    histogram: List[int] = betterproto.uint32_field(7)
@@ -0,0 +1,58 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * Harness.h
+ *
+ *  A minimal harness for timing code on the host and reporting its throughput.
+ *  Each benchmark runs a function which processes one frame of a known number of bytes,
+ *  and is reported in ns/frame, MB/s, and bytes per CPU cycle.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace Pufferfish::Benchmark {
+
+struct Options {
+  // Minimum duration of each timed sample, in seconds
+  double min_sample_duration = 0.05;
+  // Number of timed samples of each benchmark; the fastest sample is reported
+  size_t samples = 5;
+  // Clock rate of the CPU, in Hz, for bytes-per-cycle estimates; 0 if unknown
+  double cpu_hz = 0;
+  // Only benchmarks whose names contain this string are run
+  std::string filter;
+};
+
+class Harness {
+ public:
+  explicit Harness(const Options &options) : options_(options) {}
+
+  void section(const std::string &title) const;
+
+  template <typename Function>
+  void run(const std::string &name, size_t frame_bytes, Function function) const;
+
+ private:
+  const Options options_;
+
+  template <typename Function>
+  static double time_iterations(size_t iterations, Function &function);
+
+  void report(const std::string &name, size_t frame_bytes, double ns_per_frame) const;
+};
+
+// Estimates the clock rate of the CPU, in Hz, or returns 0 if it cannot be estimated
+double estimate_cpu_hz();
+
+// Prevents the compiler from optimizing away the computation of a value
+template <typename Value>
+inline void do_not_optimize(const Value &value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+}  // namespace Pufferfish::Benchmark
+
+#include "Harness.tpp"
@@ -0,0 +1,52 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * Harness.tpp
+ *
+ *  A minimal harness for timing code on the host and reporting its throughput.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <limits>
+
+#include "Harness.h"
+
+namespace Pufferfish::Benchmark {
+
+template <typename Function>
+void Harness::run(const std::string &name, size_t frame_bytes, Function function) const {
+  if (name.find(options_.filter) == std::string::npos) {
+    return;
+  }
+
+  // Warm up while finding a number of iterations which takes long enough to time reliably
+  size_t iterations = 1;
+  while (time_iterations(iterations, function) < options_.min_sample_duration) {
+    iterations *= 2;
+  }
+
+  double best_duration = std::numeric_limits<double>::max();
+  for (size_t i = 0; i < options_.samples; ++i) {
+    double duration = time_iterations(iterations, function);
+    if (duration < best_duration) {
+      best_duration = duration;
+    }
+  }
+
+  static const double ns_per_s = 1e9;
+  report(name, frame_bytes, best_duration * ns_per_s / static_cast<double>(iterations));
+}
+
+template <typename Function>
+double Harness::time_iterations(size_t iterations, Function &function) {
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; ++i) {
+    function();
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double>(end - start).count();
+}
+
+}  // namespace Pufferfish::Benchmark
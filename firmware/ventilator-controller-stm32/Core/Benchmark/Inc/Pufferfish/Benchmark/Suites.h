@@ -0,0 +1,24 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * Suites.h
+ *
+ *  Benchmark suites run by the benchmark executable.
+ */
+
+#pragma once
+
+#include "Harness.h"
+
+namespace Pufferfish::Benchmark {
+
+// The CRC engines and SoftCRC, on frames and on Sensirion data words
+void benchmark_crc(const Harness &harness);
+
+// Each protocol layer of the backend serial link, across payload sizes
+void benchmark_backend_layers(const Harness &harness);
+
+// The complete backend serial link, across message types
+void benchmark_backend_messages(const Harness &harness);
+
+}  // namespace Pufferfish::Benchmark
@@ -0,0 +1,68 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * Harness.cpp
+ *
+ *  A minimal harness for timing code on the host and reporting its throughput.
+ */
+
+#include "Pufferfish/Benchmark/Harness.h"
+
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace Pufferfish::Benchmark {
+
+void Harness::section(const std::string &title) const {
+  std::printf("\n%s\n", title.c_str());
+  std::printf(
+      "%-52s %8s %12s %10s %10s\n", "benchmark", "bytes", "ns/frame", "MB/s", "bytes/cycle");
+}
+
+void Harness::report(const std::string &name, size_t frame_bytes, double ns_per_frame) const {
+  static const double ns_per_s = 1e9;
+  static const double bytes_per_mb = 1e6;
+  double bytes = static_cast<double>(frame_bytes);
+  double mb_per_s = bytes / ns_per_frame * ns_per_s / bytes_per_mb;
+  if (options_.cpu_hz > 0) {
+    double cycles_per_frame = ns_per_frame * options_.cpu_hz / ns_per_s;
+    std::printf(
+        "%-52s %8zu %12.1f %10.2f %10.3f\n",
+        name.c_str(),
+        frame_bytes,
+        ns_per_frame,
+        mb_per_s,
+        bytes / cycles_per_frame);
+  } else {
+    std::printf(
+        "%-52s %8zu %12.1f %10.2f %10s\n",
+        name.c_str(),
+        frame_bytes,
+        ns_per_frame,
+        mb_per_s,
+        "n/a");
+  }
+}
+
+double estimate_cpu_hz() {
+#if defined(__x86_64__) || defined(__i386__)
+  // The time-stamp counter runs at the nominal clock rate of the CPU
+  static const auto calibration_duration = std::chrono::milliseconds(100);
+  auto start_time = std::chrono::steady_clock::now();
+  uint64_t start_cycles = __rdtsc();
+  std::this_thread::sleep_for(calibration_duration);
+  uint64_t end_cycles = __rdtsc();
+  auto end_time = std::chrono::steady_clock::now();
+  return static_cast<double>(end_cycles - start_cycles) /
+         std::chrono::duration<double>(end_time - start_time).count();
+#else
+  return 0;
+#endif
+}
+
+}  // namespace Pufferfish::Benchmark
@@ -0,0 +1,304 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * Backend.cpp
+ *
+ *  Benchmarks of the backend serial communication protocol
+ */
+
+#include "Pufferfish/Driver/Serial/Backend/Backend.h"
+
+#include <array>
+#include <random>
+#include <string>
+
+#include "Pufferfish/Benchmark/Suites.h"
+#include "Pufferfish/HAL/CRCEngine.h"
+
+namespace Pufferfish::Benchmark {
+
+namespace BE = Driver::Serial::Backend;
+
+namespace {
+
+using CRCSender = Protocols::CRCElementSender<BE::FrameProps::payload_max_size>;
+using CRCReceiver = Protocols::CRCElementReceiver<BE::FrameProps::payload_max_size>;
+using DatagramSender = Protocols::DatagramSender<CRCSender::Props::payload_max_size>;
+using DatagramReceiver = Protocols::DatagramReceiver<CRCSender::Props::payload_max_size>;
+
+const auto payload_sizes = Util::make_array<size_t>(8, 32, 64, 128, 240);
+
+// Payload bytes are random, with about one zero byte in 32 for COBS to stuff
+template <size_t buffer_size>
+Util::ByteVector<buffer_size> make_payload(size_t size) {
+  static const unsigned int zero_probability = 32;
+  std::mt19937 generator(size);
+  std::uniform_int_distribution<unsigned int> distribution(0, UINT8_MAX * zero_probability);
+  Util::ByteVector<buffer_size> payload;
+  for (size_t i = 0; i < size; ++i) {
+    unsigned int value = distribution(generator);
+    payload.push_back(value < zero_probability ? 0 : static_cast<uint8_t>(value));
+  }
+  return payload;
+}
+
+std::string label(const std::string &name, size_t payload_size) {
+  return name + " (" + std::to_string(payload_size) + "-byte payload)";
+}
+
+BE::BackendMessage make_message(Application::MessageTypes type) {
+  BE::BackendMessage message;
+  switch (type) {
+    case Application::MessageTypes::sensor_measurements:
+    case Application::MessageTypes::sensor_measurements_binary:
+    case Application::MessageTypes::sensor_measurements_delta: {
+      SensorMeasurements payload{};
+      payload.time = 123456;      // NOLINT(readability-magic-numbers)
+      payload.cycle = 789;        // NOLINT(readability-magic-numbers)
+      payload.paw = 21.5F;        // NOLINT(readability-magic-numbers)
+      payload.flow = -12.25F;     // NOLINT(readability-magic-numbers)
+      payload.volume = 312.75F;   // NOLINT(readability-magic-numbers)
+      payload.fio2 = 40.5F;       // NOLINT(readability-magic-numbers)
+      payload.spo2 = 97.5F;       // NOLINT(readability-magic-numbers)
+      if (type == Application::MessageTypes::sensor_measurements_binary) {
+        message.payload.set(Application::BinarySensorMeasurements{payload});
+      } else if (type == Application::MessageTypes::sensor_measurements_delta) {
+        // A delta from the previous sample, 10 ms earlier
+        SensorMeasurements reference = payload;
+        reference.time -= 10;        // NOLINT(readability-magic-numbers)
+        reference.paw -= 0.125F;     // NOLINT(readability-magic-numbers)
+        reference.flow += 0.25F;     // NOLINT(readability-magic-numbers)
+        reference.volume -= 1.125F;  // NOLINT(readability-magic-numbers)
+        message.payload.set(Util::make_delta(reference, payload));
+      } else {
+        message.payload.set(payload);
+      }
+      break;
+    }
+    case Application::MessageTypes::cycle_measurements: {
+      CycleMeasurements payload{};
+      payload.time = 123456;  // NOLINT(readability-magic-numbers)
+      payload.vt = 450.5F;    // NOLINT(readability-magic-numbers)
+      payload.rr = 15.5F;     // NOLINT(readability-magic-numbers)
+      payload.peep = 5.25F;   // NOLINT(readability-magic-numbers)
+      payload.pip = 25.75F;   // NOLINT(readability-magic-numbers)
+      payload.ip = 20.5F;     // NOLINT(readability-magic-numbers)
+      payload.ve = 7.25F;     // NOLINT(readability-magic-numbers)
+      message.payload.set(payload);
+      break;
+    }
+    case Application::MessageTypes::parameters: {
+      Parameters payload{};
+      payload.time = 123456;  // NOLINT(readability-magic-numbers)
+      payload.mode = VentilationMode_hfnc;
+      payload.pip = 25.5F;    // NOLINT(readability-magic-numbers)
+      payload.peep = 5.5F;    // NOLINT(readability-magic-numbers)
+      payload.vt = 450.5F;    // NOLINT(readability-magic-numbers)
+      payload.rr = 15.5F;     // NOLINT(readability-magic-numbers)
+      payload.ie = 0.5F;      // NOLINT(readability-magic-numbers)
+      payload.fio2 = 40.5F;   // NOLINT(readability-magic-numbers)
+      payload.flow = 30.5F;   // NOLINT(readability-magic-numbers)
+      payload.ventilating = true;
+      message.payload.set(payload);
+      break;
+    }
+    default: {
+      AlarmLimits payload{};
+      payload.time = 123456;  // NOLINT(readability-magic-numbers)
+      payload.has_fio2 = true;
+      payload.fio2 = Range{21, 100};  // NOLINT(readability-magic-numbers)
+      payload.has_spo2 = true;
+      payload.spo2 = Range{85, 100};  // NOLINT(readability-magic-numbers)
+      payload.has_rr = true;
+      payload.rr = Range{10, 30};  // NOLINT(readability-magic-numbers)
+      payload.has_pip = true;
+      payload.pip = Range{5, 40};  // NOLINT(readability-magic-numbers)
+      payload.has_peep = true;
+      payload.peep = Range{2, 20};  // NOLINT(readability-magic-numbers)
+      message.payload.set(payload);
+      break;
+    }
+  }
+  return message;
+}
+
+}  // namespace
+
+void benchmark_backend_layers(const Harness &harness) {
+  HAL::EngineCRC32C crc32c;
+
+  harness.section("Backend protocol layers");
+  for (size_t payload_size : payload_sizes) {
+    auto payload = make_payload<BE::FrameProps::payload_max_size>(payload_size);
+
+    // COBS
+    BE::COBSEncoder cobs_encoder;
+    BE::FrameProps::ChunkBuffer encoded;
+    cobs_encoder.transform(payload, encoded);
+    harness.run(label("COBSEncoder::transform", payload_size), payload_size, [&]() {
+      BE::FrameProps::ChunkBuffer output;
+      cobs_encoder.transform(payload, output);
+      do_not_optimize(output);
+    });
+
+    BE::COBSDecoder cobs_decoder;
+    harness.run(label("COBSDecoder::transform", payload_size), payload_size, [&]() {
+      BE::FrameProps::PayloadBuffer output;
+      cobs_decoder.transform(encoded, output);
+      do_not_optimize(output);
+    });
+
+    BE::FrameReceiver frame_receiver;
+    harness.run(label("FrameReceiver input and output", payload_size), payload_size, [&]() {
+      for (size_t i = 0; i < encoded.size(); ++i) {
+        frame_receiver.input(encoded[i]);
+      }
+      frame_receiver.input(0x00);
+      Util::ByteView output;
+      frame_receiver.output(output);
+      do_not_optimize(output);
+    });
+
+    // CRCElement
+    auto crcelement_payload = make_payload<CRCSender::Props::payload_max_size>(payload_size);
+    CRCSender crc_sender{crc32c};
+    BE::FrameProps::PayloadBuffer crcelement_body;
+    crc_sender.transform(crcelement_payload, crcelement_body);
+    harness.run(label("CRCElementSender::transform", payload_size), payload_size, [&]() {
+      BE::FrameProps::PayloadBuffer output;
+      crc_sender.transform(crcelement_payload, output);
+      do_not_optimize(output);
+    });
+
+    CRCReceiver crc_receiver{crc32c};
+    harness.run(label("CRCElementReceiver::transform", payload_size), payload_size, [&]() {
+      Util::ByteView output;
+      Protocols::BorrowedCRCElement crcelement(output);
+      do_not_optimize(crc_receiver.transform(crcelement_body, crcelement));
+      do_not_optimize(output);
+    });
+
+    // Datagram
+    auto datagram_payload = make_payload<DatagramSender::Props::payload_max_size>(payload_size);
+    DatagramSender datagram_sender;
+    CRCSender::Props::PayloadBuffer datagram_body;
+    datagram_sender.transform(datagram_payload, datagram_body);
+    harness.run(label("DatagramSender::transform", payload_size), payload_size, [&]() {
+      CRCSender::Props::PayloadBuffer output;
+      datagram_sender.transform(datagram_payload, output);
+      do_not_optimize(output);
+    });
+
+    DatagramReceiver datagram_receiver;
+    harness.run(label("DatagramReceiver::transform", payload_size), payload_size, [&]() {
+      Util::ByteView output;
+      Protocols::BorrowedDatagram datagram(output);
+      do_not_optimize(datagram_receiver.transform(datagram_body, datagram));
+      do_not_optimize(output);
+    });
+  }
+}
+
+template <typename Payload>
+void benchmark_protobuf_codecs(
+    const Harness &harness, const std::string &name, const Payload &value) {
+  using Buffer = std::array<uint8_t, BE::FrameProps::payload_max_size>;
+  const pb_msgdesc_t *fields = nanopb::MessageDescriptor<Payload>::fields();
+  Buffer encoded{};
+  size_t encoded_size = 0;
+  Util::encode_protobuf(value, encoded.data(), encoded.size(), encoded_size);
+
+  harness.run("encode_protobuf " + name, encoded_size, [&]() {
+    Buffer output;
+    size_t output_size = 0;
+    do_not_optimize(Util::encode_protobuf(value, output.data(), output.size(), output_size));
+    do_not_optimize(output);
+  });
+  harness.run("pb_encode " + name, encoded_size, [&]() {
+    Buffer output;
+    pb_ostream_t stream = pb_ostream_from_buffer(output.data(), output.size());
+    do_not_optimize(pb_encode(&stream, fields, &value));
+    do_not_optimize(output);
+  });
+  harness.run("decode_protobuf " + name, encoded_size, [&]() {
+    Payload output;
+    do_not_optimize(Util::decode_protobuf(encoded.data(), encoded_size, output));
+    do_not_optimize(output);
+  });
+  harness.run("pb_decode " + name, encoded_size, [&]() {
+    Payload output;
+    pb_istream_t stream = pb_istream_from_buffer(encoded.data(), encoded_size);
+    do_not_optimize(pb_decode(&stream, fields, &output));
+    do_not_optimize(output);
+  });
+}
+
+void benchmark_backend_messages(const Harness &harness) {
+  HAL::EngineCRC32C crc32c;
+
+  struct NamedType {
+    const char *name;
+    Application::MessageTypes type;
+  };
+  const auto types = Util::make_array<NamedType>(
+      NamedType{"SensorMeasurements", Application::MessageTypes::sensor_measurements},
+      NamedType{
+          "BinarySensorMeasurements", Application::MessageTypes::sensor_measurements_binary},
+      NamedType{
+          "SensorMeasurementsDelta", Application::MessageTypes::sensor_measurements_delta},
+      NamedType{"CycleMeasurements", Application::MessageTypes::cycle_measurements},
+      NamedType{"Parameters", Application::MessageTypes::parameters},
+      NamedType{"AlarmLimits", Application::MessageTypes::alarm_limits});
+
+  harness.section("Backend messages, complete frames");
+  for (const auto &named_type : types) {
+    BE::BackendMessage message = make_message(named_type.type);
+    std::string name(named_type.name);
+
+    BE::FrameProps::PayloadBuffer body;
+    message.write(body);
+    harness.run("Message::write " + name, body.size(), [&]() {
+      BE::FrameProps::PayloadBuffer output;
+      do_not_optimize(message.write(output));
+      do_not_optimize(output);
+    });
+    harness.run("Message::parse " + name, body.size(), [&]() {
+      BE::BackendMessage output;
+      do_not_optimize(output.parse(body));
+      do_not_optimize(output);
+    });
+
+    // Protobuf payload encoding and decoding, with the generated codecs and with nanopb
+    Application::MessageRegistry::visit(
+        message.payload.tag,
+        [&](auto entry) {
+          using Entry = decltype(entry);
+          if constexpr (Util::ProtobufCodec<typename Entry::Type>::generated) {
+            benchmark_protobuf_codecs(harness, name, message.payload.value.*Entry::union_member);
+          }
+          return true;
+        },
+        false);
+
+    BE::BackendSender sender{crc32c};
+    BE::FrameProps::ChunkBuffer frame;
+    sender.transform(message, frame);
+    harness.run("BackendSender::transform " + name, frame.size(), [&]() {
+      BE::FrameProps::ChunkBuffer output;
+      do_not_optimize(sender.transform(message, output));
+      do_not_optimize(output);
+    });
+
+    BE::BackendReceiver receiver{crc32c};
+    harness.run("BackendReceiver input and output " + name, frame.size(), [&]() {
+      for (size_t i = 0; i < frame.size(); ++i) {
+        receiver.input(frame[i]);
+      }
+      BE::BackendMessage output;
+      do_not_optimize(receiver.output(output));
+      do_not_optimize(output);
+    });
+  }
+}
+
+}  // namespace Pufferfish::Benchmark
@@ -0,0 +1,87 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * CRCEngine.cpp
+ *
+ *  Benchmarks of the compile-time CRC engines against SoftCRC
+ */
+
+#include "Pufferfish/HAL/CRCEngine.h"
+
+#include <array>
+#include <random>
+
+#include "Pufferfish/Benchmark/Suites.h"
+#include "Pufferfish/HAL/CRCChecker.h"
+
+namespace Pufferfish::Benchmark {
+
+namespace {
+
+constexpr HAL::CRC8Parameters sensirion_crc8_params = {0x31, 0xff, false, false, 0x00};
+
+using CRC32CBytewise = HAL::CRCEngine<uint32_t, HAL::crc32c_params, 1>;
+using CRC32CSliced4 = HAL::CRCEngine<uint32_t, HAL::crc32c_params, 4>;
+using CRC32CSliced8 = HAL::CRCEngine<uint32_t, HAL::crc32c_params, 8>;
+using SensirionCRC8 = HAL::CRCEngine<uint8_t, sensirion_crc8_params>;
+
+template <size_t size>
+std::array<uint8_t, size> make_random_bytes() {
+  std::array<uint8_t, size> result{};
+  std::mt19937 generator(size);
+  std::uniform_int_distribution<unsigned int> distribution(0, UINT8_MAX);
+  for (auto &byte : result) {
+    byte = static_cast<uint8_t>(distribution(generator));
+  }
+  return result;
+}
+
+}  // namespace
+
+void benchmark_crc(const Harness &harness) {
+  // The size of a complete frame on the backend serial link, and of a Sensirion data word
+  auto frame = make_random_bytes<254>();
+  auto word = make_random_bytes<2>();
+  HAL::SoftCRC32 soft_crc32c(HAL::crc32c_params);
+  HAL::SoftCRC8 soft_crc8(sensirion_crc8_params);
+  HAL::EngineCRC32C engine_crc32c;
+  HAL::CRC32 &virtual_crc32c = engine_crc32c;
+
+  // The inputs are passed through do_not_optimize, so that the compile-time engines can't
+  // compute their checksums at compile time
+  harness.section("CRC implementations");
+  harness.run("SoftCRC32 setup", 0, [&]() {
+    HAL::SoftCRC32 crc(HAL::crc32c_params);
+    do_not_optimize(crc);
+  });
+  harness.run("SoftCRC32 CRC32C", frame.size(), [&]() {
+    do_not_optimize(frame);
+    do_not_optimize(soft_crc32c.compute(frame.data(), frame.size()));
+  });
+  harness.run("CRCEngine CRC32C, 1 slice", frame.size(), [&]() {
+    do_not_optimize(frame);
+    do_not_optimize(CRC32CBytewise::compute(frame.data(), frame.size()));
+  });
+  harness.run("CRCEngine CRC32C, 4 slices", frame.size(), [&]() {
+    do_not_optimize(frame);
+    do_not_optimize(CRC32CSliced4::compute(frame.data(), frame.size()));
+  });
+  harness.run("CRCEngine CRC32C, 8 slices", frame.size(), [&]() {
+    do_not_optimize(frame);
+    do_not_optimize(CRC32CSliced8::compute(frame.data(), frame.size()));
+  });
+  harness.run("EngineCRC32C through the CRC32 interface", frame.size(), [&]() {
+    do_not_optimize(frame);
+    do_not_optimize(virtual_crc32c.compute(frame.data(), frame.size()));
+  });
+  harness.run("SoftCRC8 Sensirion", word.size(), [&]() {
+    do_not_optimize(word);
+    do_not_optimize(soft_crc8.compute(word.data(), word.size()));
+  });
+  harness.run("CRCEngine Sensirion CRC8", word.size(), [&]() {
+    do_not_optimize(word);
+    do_not_optimize(SensirionCRC8::compute(word.data(), word.size()));
+  });
+}
+
+}  // namespace Pufferfish::Benchmark
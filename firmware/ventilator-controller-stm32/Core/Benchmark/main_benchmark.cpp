@@ -0,0 +1,71 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * main_benchmark.cpp
+ *
+ * Execution of all benchmarks, on the native computer.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "Pufferfish/Benchmark/Harness.h"
+#include "Pufferfish/Benchmark/Suites.h"
+
+namespace {
+
+void print_usage(const char *program) {
+  std::printf(
+      "Usage: %s [--min-time SECONDS] [--samples COUNT] [--cpu-mhz MHZ] [FILTER]\n"
+      "  --min-time SECONDS  minimum duration of each timed sample (default 0.05)\n"
+      "  --samples COUNT     number of timed samples of each benchmark (default 5)\n"
+      "  --cpu-mhz MHZ       CPU clock rate for bytes/cycle estimates (default: measured)\n"
+      "  FILTER              only run benchmarks whose names contain this text\n",
+      program);
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  using Pufferfish::Benchmark::Options;
+  static const double hz_per_mhz = 1e6;
+
+  Options options;
+  bool cpu_hz_given = false;
+  for (int i = 1; i < argc; ++i) {
+    const char *argument = argv[i];
+    bool has_value = i + 1 < argc;
+    if (std::strcmp(argument, "--min-time") == 0 && has_value) {
+      options.min_sample_duration = std::strtod(argv[++i], nullptr);
+    } else if (std::strcmp(argument, "--samples") == 0 && has_value) {
+      options.samples = std::strtoul(argv[++i], nullptr, 0);
+    } else if (std::strcmp(argument, "--cpu-mhz") == 0 && has_value) {
+      options.cpu_hz = std::strtod(argv[++i], nullptr) * hz_per_mhz;
+      cpu_hz_given = true;
+    } else if (argument[0] == '-') {
+      print_usage(argv[0]);
+      return std::strcmp(argument, "--help") == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    } else {
+      options.filter = argument;
+    }
+  }
+  if (!cpu_hz_given) {
+    options.cpu_hz = Pufferfish::Benchmark::estimate_cpu_hz();
+  }
+  if (options.samples == 0) {
+    options.samples = 1;
+  }
+
+  if (options.cpu_hz > 0) {
+    std::printf("CPU clock rate: %.0f MHz\n", options.cpu_hz / hz_per_mhz);
+  } else {
+    std::printf("CPU clock rate: unknown\n");
+  }
+
+  Pufferfish::Benchmark::Harness harness(options);
+  Pufferfish::Benchmark::benchmark_crc(harness);
+  Pufferfish::Benchmark::benchmark_backend_layers(harness);
+  Pufferfish::Benchmark::benchmark_backend_messages(harness);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * POSIXBufferedUART.h
+ *
+ *  A BufferedUART on a POSIX computer, backed by a serial device or a pseudoterminal.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "Pufferfish/HAL/Interfaces/BufferedUART.h"
+#include "Pufferfish/HAL/Types.h"
+#include "Pufferfish/Statuses.h"
+
+namespace Pufferfish::HAL {
+
+/**
+ * UART RX and TX with the same non-blocking interface as HAL::LargeBufferedUART, so that
+ * the firmware's serial drivers can run on a computer.
+ *
+ * The kernel's tty buffers take the place of the ring buffers serviced by interrupt handlers
+ * on the STM32. Received bytes are read from the kernel in chunks, to avoid a system call for
+ * every byte. There are no interrupt handlers, so the volatile qualifiers of the BufferedUART
+ * interface only exist for compatibility.
+ */
+class POSIXBufferedUART : public BufferedUART {
+ public:
+  POSIXBufferedUART() = default;
+  ~POSIXBufferedUART();
+  POSIXBufferedUART(const POSIXBufferedUART &) = delete;
+  POSIXBufferedUART &operator=(const POSIXBufferedUART &) = delete;
+
+  /**
+   * Opens a serial device or the peer end of a pseudoterminal in raw mode
+   * @param  path      the path of the device
+   * @param  baud_rate the baud rate, which is ignored by pseudoterminals
+   * @return error if the device could not be opened or configured, ok otherwise
+   */
+  UARTStatus open(const std::string &path, uint32_t baud_rate);
+
+  /**
+   * Creates a pseudoterminal in raw mode and opens its controlling end
+   * @param  peer_path output of the path of the peer end, for another program to open
+   * @return error if the pseudoterminal could not be created, ok otherwise
+   */
+  UARTStatus open_pty(std::string &peer_path);
+
+  void close();
+
+  /**
+   * Waits until bytes can be read, or until the timeout
+   * @param  timeout the maximum time to wait, in ms
+   * @return true if bytes can be read
+   */
+  bool wait_readable(uint32_t timeout) volatile;
+
+  BufferStatus read(uint8_t &read_byte) volatile override;
+  BufferStatus write(uint8_t write_byte) volatile override;
+  BufferStatus write(
+      const uint8_t *write_bytes,
+      AtomicSize write_size,
+      AtomicSize &written_size) volatile override;
+  BufferStatus write_block(uint8_t write_byte, uint32_t timeout) volatile override;
+  BufferStatus write_block(
+      const uint8_t *write_bytes,
+      AtomicSize write_size,
+      uint32_t timeout,
+      AtomicSize &written_size) volatile override;
+
+  /**
+   * The kernel does not report bytes which it discarded, so this is always 0
+   * @return the total number of discarded bytes
+   */
+  [[nodiscard]] uint32_t rx_dropped() const volatile;
+
+  /**
+   * Sets the baud rate, once the kernel has transmitted every byte written
+   * @param  baud_rate the new baud rate, which must be a standard baud rate
+   * @return busy if bytes are still waiting to be transmitted, error if the baud rate could
+   *  not be set, ok otherwise
+   */
+  UARTStatus set_baud_rate(uint32_t baud_rate) volatile;
+
+  [[nodiscard]] uint32_t baud_rate() const volatile;
+
+ private:
+  static const size_t rx_chunk_size = 256;
+
+  int fd_ = -1;
+  uint8_t rx_chunk_[rx_chunk_size]{};
+  size_t rx_chunk_length_ = 0;
+  size_t rx_chunk_index_ = 0;
+  uint32_t baud_rate_ = 0;
+
+  POSIXBufferedUART &self() volatile { return const_cast<POSIXBufferedUART &>(*this); }
+  [[nodiscard]] const POSIXBufferedUART &self() const volatile {
+    return const_cast<const POSIXBufferedUART &>(*this);
+  }
+
+  UARTStatus configure_raw();
+  // Waits for at most timeout ms, or indefinitely if it is negative
+  bool wait_writable(int timeout);
+};
+
+}  // namespace Pufferfish::HAL
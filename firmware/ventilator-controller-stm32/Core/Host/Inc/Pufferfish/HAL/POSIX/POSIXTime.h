@@ -0,0 +1,36 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * POSIXTime.h
+ *
+ *  Time on a POSIX computer, from its monotonic clock.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "Pufferfish/HAL/Interfaces/Time.h"
+
+namespace Pufferfish::HAL {
+
+/**
+ * Time since construction, from the monotonic clock of the computer, so that it rolls over
+ * like the time on the STM32 does
+ */
+class POSIXTime : public Time {
+ public:
+  POSIXTime();
+
+  uint32_t millis() override;
+  void delay(uint32_t ms) override;
+  uint32_t micros() override;
+  void delay_micros(uint32_t microseconds) override;
+
+ private:
+  uint64_t start_micros_;
+
+  static uint64_t monotonic_micros();
+};
+
+}  // namespace Pufferfish::HAL
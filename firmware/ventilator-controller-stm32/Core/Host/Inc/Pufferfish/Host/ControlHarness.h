@@ -0,0 +1,104 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * ControlHarness.h
+ *
+ *  A closed-loop harness for the HFNC control loop which runs faster than real time, for
+ *  scoring the control loop's responses to setpoint steps.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "Pufferfish/Application/States.h"
+#include "Pufferfish/Driver/BreathingCircuit/ControlLoop.h"
+#include "Pufferfish/Driver/BreathingCircuit/ParametersService.h"
+#include "Pufferfish/Driver/I2C/SFM3019/Sensor.h"
+#include "Pufferfish/HAL/Mock/MockI2CDevice.h"
+#include "Pufferfish/HAL/Mock/MockPWM.h"
+#include "Pufferfish/HAL/Mock/MockTime.h"
+#include "HFNCPlant.h"
+#include "SimulatedSFM3019.h"
+#include "StepResponse.h"
+
+namespace Pufferfish::Host {
+
+enum class ControlledVariable { flow, fio2 };
+
+struct Setpoints {
+  float flow;  // L/min
+  float fio2;  // %
+};
+
+struct ScoringOptions {
+  // Fraction of the size of a step within which a response is settled
+  float settling_fraction = 0.05;
+  // Minimum settling bands, for small steps
+  float min_flow_band = 1;  // L/min
+  float min_fio2_band = 1;  // % FiO2
+  // Duration at the end of each step over which the steady-state error is measured, in ms,
+  // up to the second half of the step
+  uint32_t steady_state_duration = 5000;
+};
+
+/**
+ * Runs the firmware's HFNC control loop and SFM3019 drivers against a model of the breathing
+ * circuit, on a mock clock which advances by 1 ms at a time, so that the control loop runs
+ * at its update interval in simulated time. The responses are measured from the model's flows,
+ * rather than from the sensor measurements which the firmware's simulators also write to.
+ */
+class ControlHarness {
+ public:
+  explicit ControlHarness(const ScoringOptions &options);
+
+  // Sets up the flow sensors, as main.cpp does before its main loop
+  InitializableState setup();
+
+  /**
+   * Requests new setpoints and runs the control loop for some time
+   * @param setpoints the setpoints to request
+   * @param variable  the controlled variable whose response is measured
+   * @param duration  the time to run the control loop, in ms
+   * @return the metrics of the response of the variable
+   */
+  StepMetrics step(const Setpoints &setpoints, ControlledVariable variable, uint32_t duration);
+
+  // Simulated time since the harness started, in ms
+  [[nodiscard]] uint32_t current_time() const;
+
+  // The duration over which the steady-state error of a step is measured, in ms
+  static uint32_t steady_state_duration(const ScoringOptions &options, uint32_t step_duration);
+
+ private:
+  static const uint32_t micros_per_milli = 1000;
+  static const uint32_t parameters_interval = 10;  // ms, as in main.cpp's scheduler
+  static const uint32_t valve_max_duty_cycle = 6400;
+
+  const ScoringOptions options_;
+  uint32_t current_time_ = 0;  // ms
+  HAL::MockTime time_;
+
+  // Breathing circuit
+  HAL::MockPWM valve_air_;
+  HAL::MockPWM valve_o2_;
+  SimulatedSFM3019 i2c_sfm3019_air_;
+  SimulatedSFM3019 i2c_sfm3019_o2_;
+  HAL::MockI2CDevice i2c_global_;
+  HFNCPlant plant_;
+
+  // Firmware
+  Driver::I2C::SFM3019::Device sfm3019_dev_air_;
+  Driver::I2C::SFM3019::Device sfm3019_dev_o2_;
+  Driver::I2C::SFM3019::Sensor sfm3019_air_;
+  Driver::I2C::SFM3019::Sensor sfm3019_o2_;
+  Application::States states_;
+  ParametersRequest parameters_request_{};
+  Driver::BreathingCircuit::ParametersServices parameters_service_;
+  Driver::BreathingCircuit::HFNCControlLoop hfnc_;
+
+  void advance();
+  [[nodiscard]] float response(ControlledVariable variable) const;
+};
+
+}  // namespace Pufferfish::Host
@@ -0,0 +1,68 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * HFNCPlant.h
+ *
+ *  A model of the air and oxygen flows of the HFNC breathing circuit, for closing the control
+ *  loop without the breathing circuit.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "Pufferfish/HAL/Mock/MockPWM.h"
+#include "SimulatedSFM3019.h"
+
+namespace Pufferfish::Host {
+
+/**
+ * Each proportional valve is modeled as a flow rate which approaches the flow rate for its
+ * opening with first-order dynamics. The flow rate for an opening is 0 below the opening at
+ * which the valve cracks, and rises linearly to the maximum flow rate of the valve at full
+ * opening. Valve openings are read from the duty cycles set on the PWMs of the valves, and
+ * flow rates are given to the emulated flow sensors of the valves. Air and oxygen mix
+ * instantaneously.
+ */
+class HFNCPlant {
+ public:
+  static constexpr float max_flow = 100;          // L/min
+  static constexpr float cracking_opening = 0.1;  // fraction of full opening
+  static constexpr float time_constant = 15;      // ms
+
+  HFNCPlant(
+      HAL::MockPWM &valve_air,
+      HAL::MockPWM &valve_o2,
+      SimulatedSFM3019 &sfm3019_air,
+      SimulatedSFM3019 &sfm3019_o2)
+      : valve_air_(valve_air),
+        valve_o2_(valve_o2),
+        sfm3019_air_(sfm3019_air),
+        sfm3019_o2_(sfm3019_o2) {}
+
+  // Advances the flow rates to the current time, in ms
+  void update(uint32_t current_time);
+
+  [[nodiscard]] float flow_air() const;
+  [[nodiscard]] float flow_o2() const;
+  // The FiO2 of the mixed flows, in %, assuming air with an FiO2 of 21% and pure oxygen
+  [[nodiscard]] float fio2() const;
+
+  // The flow rate to which a valve settles at some opening
+  static float steady_flow(float opening);
+
+ private:
+  HAL::MockPWM &valve_air_;
+  HAL::MockPWM &valve_o2_;
+  SimulatedSFM3019 &sfm3019_air_;
+  SimulatedSFM3019 &sfm3019_o2_;
+
+  bool started_ = false;
+  uint32_t previous_time_ = 0;  // ms
+  float flow_air_ = 0;          // L/min
+  float flow_o2_ = 0;           // L/min
+
+  static float opening(HAL::MockPWM &valve);
+};
+
+}  // namespace Pufferfish::Host
@@ -0,0 +1,117 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * LoadTester.h
+ *
+ *  A load generator for the backend serial link, which takes the place of the backend server
+ *  and measures the round-trip latency and throughput of the MCU's protocol stack.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <vector>
+
+#include "Pufferfish/Driver/Serial/Backend/Backend.h"
+#include "Pufferfish/HAL/Interfaces/CRCChecker.h"
+#include "Pufferfish/HAL/Interfaces/Time.h"
+#include "Pufferfish/HAL/POSIX/POSIXBufferedUART.h"
+
+namespace Pufferfish::Host {
+
+struct LoadOptions {
+  // Duration of the test, in s
+  double duration = 10;
+  // Rate at which ParametersRequest messages are sent, in Hz
+  double request_rate = 20;
+  // Capability flags requested from the MCU
+  uint32_t capabilities = 0;
+  // Maximum baud rate requested from the MCU; the link stays at the default baud rate if this
+  // is no faster than it
+  uint32_t max_baud_rate = 0;
+};
+
+struct LoadReport {
+  // Duration of the test, in s
+  double duration = 0;
+  size_t tx_messages = 0;
+  size_t tx_bytes = 0;
+  size_t rx_messages = 0;
+  size_t rx_bytes = 0;
+  // Frames which could not be decoded
+  size_t rx_errors = 0;
+  // Gaps in the datagram sequence, each of which lost one or more frames
+  size_t rx_gaps = 0;
+  // Falls back to the default baud rate after messages stopped arriving
+  size_t baud_rate_fallbacks = 0;
+  uint32_t baud_rate = 0;
+  // Received messages, by message type
+  std::map<Application::MessageTypes, size_t> rx_types;
+  // Round-trip latencies in us, from sending a ParametersRequest until the MCU first echoes it
+  // back in its parameters_request state segment
+  std::vector<uint32_t> round_trips;
+  // ParametersRequests which the MCU never echoed, because a later request replaced them before
+  // the MCU sent its parameters_request state segment, or because the test ended first
+  size_t unanswered_requests = 0;
+  // Interval at which the MCU sends its parameters_request state segment after a change, in ms;
+  // each round trip includes up to this much waiting for the MCU's state synchronization
+  uint32_t echo_interval = 0;
+};
+
+/**
+ * Drives the MCU's side of the backend serial link at configurable message rates, in the same
+ * way as the backend server, using the same protocol stack as the firmware.
+ *
+ * Each ParametersRequest carries the time at which it was sent; since the MCU echoes its
+ * parameters_request state segment back, each request's round trip includes the MCU's state
+ * synchronization delay, which is reported with the round trips. Requests sent faster than the
+ * MCU's state synchronization are replaced before they are echoed, so they are counted as
+ * unanswered instead. The requests never start ventilation.
+ */
+class LoadTester {
+ public:
+  LoadTester(volatile HAL::POSIXBufferedUART &uart, HAL::CRC32 &crc32c, HAL::Time &time)
+      : uart_(uart), receiver_(crc32c), sender_(crc32c), time_(time) {}
+
+  LoadReport run(const LoadOptions &options);
+
+ private:
+  // Capabilities requests are resent this often until the MCU confirms them, in ms
+  static const uint32_t capabilities_request_interval = 1000;
+  // Capabilities requests which only fail to switch the baud rate are given up after this
+  // many attempts, since the MCU may not support a faster baud rate
+  static const size_t max_capabilities_requests = 5;
+  // Maximum time to wait for a write to the UART, in ms
+  static const uint32_t write_timeout = 100;
+  // Maximum time to wait for bytes to receive in each iteration of the test, in ms
+  static const uint32_t receive_timeout = 1;
+
+  volatile HAL::POSIXBufferedUART &uart_;
+  Driver::Serial::Backend::BackendReceiver receiver_;
+  Driver::Serial::Backend::BackendSender sender_;
+  HAL::Time &time_;
+  Driver::Serial::Backend::BaudRateNegotiator baud_rates_;
+  Driver::Serial::Backend::FrameProps::ChunkBuffer send_output_;
+  Driver::Serial::Backend::BackendMessage receive_output_;
+
+  void receive(const LoadOptions &options, LoadReport &report);
+  void handle(const LoadOptions &options, LoadReport &report);
+  void send(const Application::StateSegment &payload, LoadReport &report);
+  void update_baud_rate(LoadReport &report);
+
+  bool capabilities_confirmed_ = false;
+  size_t capabilities_requests_ = 0;
+  // Send times of the ParametersRequests which the MCU has not yet echoed, in order
+  std::deque<uint32_t> pending_requests_;
+};
+
+// Returns the nearest-rank percentile of a sorted list of samples, or 0 if there are none
+uint32_t percentile(const std::vector<uint32_t> &sorted_samples, double fraction);
+
+// Sorts the round-trip latencies and prints the report
+void print_report(LoadReport &report);
+
+}  // namespace Pufferfish::Host
@@ -0,0 +1,60 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * LoopbackMCU.h
+ *
+ *  An emulation of the MCU's side of the backend serial link, for load tests without an MCU.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+#include "Pufferfish/Application/States.h"
+#include "Pufferfish/Driver/Serial/Backend/UART.h"
+#include "Pufferfish/HAL/Interfaces/CRCChecker.h"
+#include "Pufferfish/HAL/POSIX/POSIXBufferedUART.h"
+#include "Pufferfish/HAL/POSIX/POSIXTime.h"
+#include "Pufferfish/Statuses.h"
+
+namespace Pufferfish::Host {
+
+/**
+ * Runs the firmware's backend serial driver on its own thread, over the peer end of a
+ * pseudoterminal, with sensor measurements from a synthetic breath cycle at 100 Hz.
+ * Like the firmware's main loop, each iteration receives, updates the clock, and sends.
+ */
+class LoopbackMCU {
+ public:
+  explicit LoopbackMCU(HAL::CRC32 &crc32c) : backend_(uart_, crc32c, states_, time_) {}
+  ~LoopbackMCU();
+  LoopbackMCU(const LoopbackMCU &) = delete;
+  LoopbackMCU &operator=(const LoopbackMCU &) = delete;
+
+  // Opens the device and starts the thread
+  UARTStatus start(const std::string &path);
+  // Stops the thread and closes the device
+  void stop();
+
+ private:
+  // Interval between sensor measurements, in ms
+  static const uint32_t measurements_interval = 10;
+  // Maximum time to wait for bytes to receive in each iteration, in ms
+  static const uint32_t receive_timeout = 1;
+  // Number of outputs started in each iteration
+  static const size_t sends_per_iteration = 4;
+
+  HAL::POSIXBufferedUART uart_;
+  HAL::POSIXTime time_;
+  Application::States states_;
+  Driver::Serial::Backend::UARTBackend<HAL::POSIXBufferedUART> backend_;
+  std::thread thread_;
+  std::atomic<bool> running_{false};
+
+  void run();
+  void update_measurements(uint32_t current_time);
+};
+
+}  // namespace Pufferfish::Host
@@ -0,0 +1,62 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * SimulatedSFM3019.h
+ *
+ *  An emulation of the I2C interface of an SFM3019 flow sensor, for running the firmware's
+ *  SFM3019 driver without the sensor.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "Pufferfish/Driver/I2C/SFM3019/Types.h"
+#include "Pufferfish/HAL/CRCEngine.h"
+#include "Pufferfish/HAL/Interfaces/I2CDevice.h"
+#include "Pufferfish/Statuses.h"
+
+namespace Pufferfish::Host {
+
+/**
+ * Responds to the commands which the firmware's SFM3019 driver sends, with the product number
+ * and conversion factors from the SFM3019 datasheet, and with the flow rate given to it by a
+ * model of the breathing circuit. Like the sensor, each read returns the response to the last
+ * command written, as 16-bit words in network order which are each followed by a CRC-8.
+ */
+class SimulatedSFM3019 : public HAL::I2CDevice {
+ public:
+  explicit SimulatedSFM3019(Driver::I2C::SFM3019::GasType gas) : gas_(gas) {}
+
+  I2CDeviceStatus read(uint8_t *buf, size_t count) override;
+  I2CDeviceStatus write(uint8_t *buf, size_t count) override;
+
+  // Sets the flow rate to be measured, in L/min
+  void set_flow(float flow);
+  // Whether continuous measurement was started with the gas type of the sensor
+  [[nodiscard]] bool measuring() const;
+
+ private:
+  enum class Response { none, product_id, conversion_factors, flow };
+
+  static const uint32_t product_number = 0x04020611;
+  static const int16_t scale_factor = 170;
+  static const int16_t offset = -24576;
+  static const uint16_t flow_unit = Driver::I2C::SFM3019::make_flow_unit(
+      Driver::I2C::SFM3019::UnitPrefix::none,
+      Driver::I2C::SFM3019::TimeBase::per_min,
+      Driver::I2C::SFM3019::Unit::standard_liter_20deg);
+
+  static constexpr HAL::CRC8Parameters crc_params = {0x31, 0xff, false, false, 0x00};
+
+  HAL::EngineCRC<HAL::CRCEngine<uint8_t, crc_params>> crc8_;
+  const Driver::I2C::SFM3019::GasType gas_;
+  Response response_ = Response::none;
+  bool measuring_ = false;
+  int16_t raw_flow_ = offset;
+
+  I2CDeviceStatus write_words(const uint16_t *words, size_t num_words, uint8_t *buf, size_t count);
+};
+
+}  // namespace Pufferfish::Host
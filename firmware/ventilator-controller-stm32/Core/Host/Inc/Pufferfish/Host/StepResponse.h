@@ -0,0 +1,71 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * StepResponse.h
+ *
+ *  Performance metrics of the response of a controlled variable to a step of its setpoint.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace Pufferfish::Host {
+
+struct StepMetrics {
+  // Whether the response was within the settling band at the end of the step
+  bool settled;
+  // Time from the step until the response entered the settling band for the last time, in ms
+  uint32_t settling_time;
+  // Largest excursion of the response past the setpoint, in % of the size of the step
+  float overshoot;
+  // Mean of the setpoint minus the response, over the end of the step
+  float steady_state_error;
+};
+
+/**
+ * Computes the metrics of a step response from samples of the response, which are given in
+ * order of time without being stored. Overshoot is only measured for steps with a nonzero size.
+ */
+class StepResponse {
+ public:
+  /**
+   * @param initial             the setpoint before the step
+   * @param setpoint            the setpoint after the step
+   * @param settling_band       the maximum absolute error of a settled response
+   * @param start_time          the time of the step, in ms
+   * @param steady_state_start  the time from which samples count towards the steady-state
+   *  error, in ms
+   */
+  StepResponse(
+      float initial,
+      float setpoint,
+      float settling_band,
+      uint32_t start_time,
+      uint32_t steady_state_start)
+      : initial_(initial),
+        setpoint_(setpoint),
+        settling_band_(settling_band),
+        start_time_(start_time),
+        steady_state_start_(steady_state_start) {}
+
+  void input(uint32_t current_time, float value);
+  [[nodiscard]] StepMetrics metrics() const;
+
+ private:
+  static constexpr float percent = 100;
+
+  const float initial_;
+  const float setpoint_;
+  const float settling_band_;
+  const uint32_t start_time_;
+  const uint32_t steady_state_start_;
+
+  bool in_band_ = false;
+  uint32_t band_entry_time_ = 0;  // ms
+  float max_excursion_ = 0;
+  float steady_state_error_sum_ = 0;
+  uint32_t steady_state_samples_ = 0;
+};
+
+}  // namespace Pufferfish::Host
@@ -0,0 +1,269 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * POSIXBufferedUART.cpp
+ *
+ *  A BufferedUART on a POSIX computer, backed by a serial device or a pseudoterminal.
+ */
+
+#include "Pufferfish/HAL/POSIX/POSIXBufferedUART.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstdlib>
+
+namespace Pufferfish::HAL {
+
+namespace {
+
+const useconds_t micros_per_milli = 1000;
+
+// Returns false if the baud rate is not a standard baud rate of termios
+bool to_speed(uint32_t baud_rate, speed_t &speed) {
+  switch (baud_rate) {
+    case 9600:
+      speed = B9600;
+      return true;
+    case 19200:
+      speed = B19200;
+      return true;
+    case 38400:
+      speed = B38400;
+      return true;
+    case 57600:
+      speed = B57600;
+      return true;
+    case 115200:
+      speed = B115200;
+      return true;
+    case 230400:
+      speed = B230400;
+      return true;
+#ifdef B460800
+    case 460800:
+      speed = B460800;
+      return true;
+    case 921600:
+      speed = B921600;
+      return true;
+    case 1000000:
+      speed = B1000000;
+      return true;
+    case 2000000:
+      speed = B2000000;
+      return true;
+    case 3000000:
+      speed = B3000000;
+      return true;
+#endif
+    default:
+      return false;
+  }
+}
+
+// Makes poll wait indefinitely
+const int no_timeout = -1;
+
+int remaining_timeout(std::chrono::steady_clock::time_point deadline) {
+  auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+      deadline - std::chrono::steady_clock::now());
+  return remaining.count() > 0 ? static_cast<int>(remaining.count()) : 0;
+}
+
+}  // namespace
+
+POSIXBufferedUART::~POSIXBufferedUART() {
+  close();
+}
+
+UARTStatus POSIXBufferedUART::open(const std::string &path, uint32_t baud_rate) {
+  close();
+  fd_ = ::open(path.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK);
+  if (fd_ < 0) {
+    return UARTStatus::error;
+  }
+
+  if (configure_raw() != UARTStatus::ok || set_baud_rate(baud_rate) != UARTStatus::ok) {
+    close();
+    return UARTStatus::error;
+  }
+
+  return UARTStatus::ok;
+}
+
+UARTStatus POSIXBufferedUART::open_pty(std::string &peer_path) {
+  close();
+  fd_ = posix_openpt(O_RDWR | O_NOCTTY);
+  if (fd_ < 0) {
+    return UARTStatus::error;
+  }
+
+  char name[PATH_MAX]{};
+  if (grantpt(fd_) != 0 || unlockpt(fd_) != 0 || ptsname_r(fd_, name, sizeof(name)) != 0 ||
+      fcntl(fd_, F_SETFL, fcntl(fd_, F_GETFL) | O_NONBLOCK) != 0 ||
+      configure_raw() != UARTStatus::ok) {
+    close();
+    return UARTStatus::error;
+  }
+
+  peer_path = name;
+  return UARTStatus::ok;
+}
+
+void POSIXBufferedUART::close() {
+  if (fd_ >= 0) {
+    ::close(fd_);
+  }
+  fd_ = -1;
+  rx_chunk_length_ = 0;
+  rx_chunk_index_ = 0;
+}
+
+UARTStatus POSIXBufferedUART::configure_raw() {
+  termios options{};
+  if (tcgetattr(fd_, &options) != 0) {
+    return UARTStatus::error;
+  }
+
+  cfmakeraw(&options);
+  options.c_cflag |= CLOCAL | CREAD;
+  options.c_cc[VMIN] = 0;
+  options.c_cc[VTIME] = 0;
+  if (tcsetattr(fd_, TCSANOW, &options) != 0) {
+    return UARTStatus::error;
+  }
+
+  return UARTStatus::ok;
+}
+
+bool POSIXBufferedUART::wait_readable(uint32_t timeout) volatile {
+  POSIXBufferedUART &uart = self();
+  if (uart.rx_chunk_index_ < uart.rx_chunk_length_) {
+    return true;
+  }
+
+  pollfd poll_fd{uart.fd_, POLLIN, 0};
+  if (poll(&poll_fd, 1, static_cast<int>(timeout)) <= 0) {
+    return false;
+  }
+  if ((poll_fd.revents & POLLIN) == 0) {
+    // A pseudoterminal hangs up while its peer end is closed, so poll would return
+    // immediately until the peer end is opened again
+    usleep(timeout * micros_per_milli);
+    return false;
+  }
+
+  return true;
+}
+
+bool POSIXBufferedUART::wait_writable(int timeout) {
+  pollfd poll_fd{fd_, POLLOUT, 0};
+  return poll(&poll_fd, 1, timeout) > 0 && (poll_fd.revents & POLLOUT) != 0;
+}
+
+BufferStatus POSIXBufferedUART::read(uint8_t &read_byte) volatile {
+  POSIXBufferedUART &uart = self();
+  if (uart.rx_chunk_index_ >= uart.rx_chunk_length_) {
+    ssize_t length = ::read(uart.fd_, uart.rx_chunk_, rx_chunk_size);
+    // A pseudoterminal returns EIO while its peer end is closed
+    if (length <= 0) {
+      return BufferStatus::empty;
+    }
+
+    uart.rx_chunk_length_ = static_cast<size_t>(length);
+    uart.rx_chunk_index_ = 0;
+  }
+
+  read_byte = uart.rx_chunk_[uart.rx_chunk_index_];
+  ++uart.rx_chunk_index_;
+  return BufferStatus::ok;
+}
+
+BufferStatus POSIXBufferedUART::write(uint8_t write_byte) volatile {
+  AtomicSize written_size = 0;
+  return write(&write_byte, 1, written_size);
+}
+
+BufferStatus POSIXBufferedUART::write(
+    const uint8_t *write_bytes, AtomicSize write_size, AtomicSize &written_size) volatile {
+  written_size = 0;
+  if (write_size == 0) {
+    return BufferStatus::ok;
+  }
+
+  ssize_t length = ::write(self().fd_, write_bytes, write_size);
+  if (length <= 0) {
+    return BufferStatus::full;
+  }
+
+  written_size = static_cast<AtomicSize>(length);
+  return written_size == write_size ? BufferStatus::ok : BufferStatus::partial;
+}
+
+BufferStatus POSIXBufferedUART::write_block(uint8_t write_byte, uint32_t timeout) volatile {
+  AtomicSize written_size = 0;
+  return write_block(&write_byte, 1, timeout, written_size);
+}
+
+BufferStatus POSIXBufferedUART::write_block(
+    const uint8_t *write_bytes,
+    AtomicSize write_size,
+    uint32_t timeout,
+    AtomicSize &written_size) volatile {
+  POSIXBufferedUART &uart = self();
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+  written_size = 0;
+  while (written_size < write_size) {
+    AtomicSize just_written = 0;
+    write(write_bytes + written_size, write_size - written_size, just_written);
+    written_size += just_written;
+    // As in HALBufferedUART, a timeout of 0 never expires
+    if (written_size < write_size &&
+        !uart.wait_writable(timeout == 0 ? no_timeout : remaining_timeout(deadline))) {
+      break;
+    }
+  }
+  if (write_size == written_size) {
+    return BufferStatus::ok;
+  }
+  return BufferStatus::partial;
+}
+
+uint32_t POSIXBufferedUART::rx_dropped() const volatile {
+  return 0;
+}
+
+UARTStatus POSIXBufferedUART::set_baud_rate(uint32_t baud_rate) volatile {
+  POSIXBufferedUART &uart = self();
+  speed_t speed = B0;
+  if (!to_speed(baud_rate, speed)) {
+    return UARTStatus::error;
+  }
+
+  int queued = 0;
+  if (ioctl(uart.fd_, TIOCOUTQ, &queued) == 0 && queued > 0) {
+    return UARTStatus::busy;
+  }
+
+  termios options{};
+  if (tcgetattr(uart.fd_, &options) != 0 || cfsetispeed(&options, speed) != 0 ||
+      cfsetospeed(&options, speed) != 0 || tcsetattr(uart.fd_, TCSANOW, &options) != 0) {
+    return UARTStatus::error;
+  }
+
+  uart.baud_rate_ = baud_rate;
+  return UARTStatus::ok;
+}
+
+uint32_t POSIXBufferedUART::baud_rate() const volatile {
+  return self().baud_rate_;
+}
+
+}  // namespace Pufferfish::HAL
@@ -0,0 +1,50 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * POSIXTime.cpp
+ *
+ *  Time on a POSIX computer, from its monotonic clock.
+ */
+
+#include "Pufferfish/HAL/POSIX/POSIXTime.h"
+
+#include <cerrno>
+#include <ctime>
+
+namespace Pufferfish::HAL {
+
+static const uint64_t micros_per_milli = 1000;
+static const uint64_t micros_per_second = 1000000;
+static const long nanos_per_micro = 1000;
+
+POSIXTime::POSIXTime() : start_micros_(monotonic_micros()) {}
+
+uint32_t POSIXTime::millis() {
+  return static_cast<uint32_t>((monotonic_micros() - start_micros_) / micros_per_milli);
+}
+
+void POSIXTime::delay(uint32_t ms) {
+  delay_micros(ms * micros_per_milli);
+}
+
+uint32_t POSIXTime::micros() {
+  return static_cast<uint32_t>(monotonic_micros() - start_micros_);
+}
+
+void POSIXTime::delay_micros(uint32_t microseconds) {
+  timespec duration{};
+  duration.tv_sec = static_cast<time_t>(microseconds / micros_per_second);
+  duration.tv_nsec = static_cast<long>(microseconds % micros_per_second) * nanos_per_micro;
+  // Resume the delay whenever a signal interrupts it
+  while (nanosleep(&duration, &duration) != 0 && errno == EINTR) {
+  }
+}
+
+uint64_t POSIXTime::monotonic_micros() {
+  timespec now{};
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<uint64_t>(now.tv_sec) * micros_per_second +
+         static_cast<uint64_t>(now.tv_nsec / nanos_per_micro);
+}
+
+}  // namespace Pufferfish::HAL
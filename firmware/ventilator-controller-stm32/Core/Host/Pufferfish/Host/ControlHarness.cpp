@@ -0,0 +1,124 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * ControlHarness.cpp
+ *
+ *  A closed-loop harness for the HFNC control loop which runs faster than real time, for
+ *  scoring the control loop's responses to setpoint steps.
+ */
+
+#include "Pufferfish/Host/ControlHarness.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Pufferfish::Host {
+
+namespace SFM3019 = Driver::I2C::SFM3019;
+
+ControlHarness::ControlHarness(const ScoringOptions &options)
+    : options_(options),
+      i2c_sfm3019_air_(SFM3019::GasType::air),
+      i2c_sfm3019_o2_(SFM3019::GasType::o2),
+      plant_(valve_air_, valve_o2_, i2c_sfm3019_air_, i2c_sfm3019_o2_),
+      sfm3019_dev_air_(i2c_sfm3019_air_, i2c_global_, SFM3019::GasType::air),
+      sfm3019_dev_o2_(i2c_sfm3019_o2_, i2c_global_, SFM3019::GasType::o2),
+      sfm3019_air_(sfm3019_dev_air_, true, time_),
+      sfm3019_o2_(sfm3019_dev_o2_, true, time_),
+      hfnc_(
+          states_.parameters(),
+          states_.sensor_measurements(),
+          states_.sensor_waveforms(),
+          sfm3019_air_,
+          sfm3019_o2_,
+          valve_air_,
+          valve_o2_) {
+  for (auto *valve : {&valve_air_, &valve_o2_}) {
+    valve->set_max_duty_cycle(valve_max_duty_cycle);
+    valve->start();
+  }
+}
+
+InitializableState ControlHarness::setup() {
+  static const uint32_t setup_timeout = 1000;  // ms
+
+  for (uint32_t i = 0; i < setup_timeout; ++i) {
+    InitializableState air = sfm3019_air_.setup();
+    InitializableState o2 = sfm3019_o2_.setup();
+    if (air == InitializableState::failed || o2 == InitializableState::failed) {
+      return InitializableState::failed;
+    }
+    if (air == InitializableState::ok && o2 == InitializableState::ok) {
+      return InitializableState::ok;
+    }
+    advance();
+  }
+  return InitializableState::failed;
+}
+
+StepMetrics ControlHarness::step(
+    const Setpoints &setpoints, ControlledVariable variable, uint32_t duration) {
+  float initial = 0;
+  float setpoint = 0;
+  float min_band = 0;
+  switch (variable) {
+    case ControlledVariable::flow:
+      initial = parameters_request_.flow;
+      setpoint = setpoints.flow;
+      min_band = options_.min_flow_band;
+      break;
+    case ControlledVariable::fio2:
+      initial = parameters_request_.fio2;
+      setpoint = setpoints.fio2;
+      min_band = options_.min_fio2_band;
+      break;
+  }
+  float settling_band =
+      std::max(options_.settling_fraction * std::abs(setpoint - initial), min_band);
+  uint32_t steady_state_start =
+      current_time_ + duration - steady_state_duration(options_, duration);
+  StepResponse response(initial, setpoint, settling_band, current_time_, steady_state_start);
+
+  parameters_request_.mode = VentilationMode_hfnc;
+  parameters_request_.ventilating = true;
+  parameters_request_.flow = setpoints.flow;
+  parameters_request_.fio2 = setpoints.fio2;
+  for (uint32_t i = 0; i < duration; ++i) {
+    advance();
+    response.input(current_time_, this->response(variable));
+  }
+  return response.metrics();
+}
+
+uint32_t ControlHarness::steady_state_duration(
+    const ScoringOptions &options, uint32_t step_duration) {
+  return std::min(step_duration / 2, options.steady_state_duration);
+}
+
+uint32_t ControlHarness::current_time() const {
+  return current_time_;
+}
+
+void ControlHarness::advance() {
+  ++current_time_;
+  time_.set_millis(current_time_);
+  time_.set_micros(current_time_ * micros_per_milli);
+
+  plant_.update(current_time_);
+  if (current_time_ % parameters_interval == 0) {
+    parameters_service_.transform(parameters_request_, states_.parameters());
+  }
+  hfnc_.update(current_time_);
+}
+
+float ControlHarness::response(ControlledVariable variable) const {
+  switch (variable) {
+    case ControlledVariable::flow:
+      return plant_.flow_air() + plant_.flow_o2();
+    case ControlledVariable::fio2:
+      return plant_.fio2();
+  }
+  return 0;
+}
+
+}  // namespace Pufferfish::Host
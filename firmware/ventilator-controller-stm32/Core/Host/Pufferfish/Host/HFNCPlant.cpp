@@ -0,0 +1,68 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * HFNCPlant.cpp
+ *
+ *  A model of the air and oxygen flows of the HFNC breathing circuit, for closing the control
+ *  loop without the breathing circuit.
+ */
+
+#include "Pufferfish/Host/HFNCPlant.h"
+
+#include <cmath>
+
+#include "Pufferfish/Driver/BreathingCircuit/Controller.h"
+
+namespace Pufferfish::Host {
+
+void HFNCPlant::update(uint32_t current_time) {
+  if (!started_) {
+    started_ = true;
+    previous_time_ = current_time;
+  }
+
+  float time_step = static_cast<float>(current_time - previous_time_);
+  previous_time_ = current_time;
+  float response = 1 - std::exp(-time_step / time_constant);
+  flow_air_ += (steady_flow(opening(valve_air_)) - flow_air_) * response;
+  flow_o2_ += (steady_flow(opening(valve_o2_)) - flow_o2_) * response;
+
+  sfm3019_air_.set_flow(sfm3019_air_.measuring() ? flow_air_ : 0);
+  sfm3019_o2_.set_flow(sfm3019_o2_.measuring() ? flow_o2_ : 0);
+}
+
+float HFNCPlant::flow_air() const {
+  return flow_air_;
+}
+
+float HFNCPlant::flow_o2() const {
+  return flow_o2_;
+}
+
+float HFNCPlant::fio2() const {
+  using Driver::BreathingCircuit::fio2_max;
+  using Driver::BreathingCircuit::fio2_min;
+
+  float flow = flow_air_ + flow_o2_;
+  if (flow <= 0) {
+    return fio2_min;
+  }
+  return (fio2_min * flow_air_ + fio2_max * flow_o2_) / flow;
+}
+
+float HFNCPlant::steady_flow(float opening) {
+  if (opening <= cracking_opening) {
+    return 0;
+  }
+  return max_flow * (opening - cracking_opening) / (1 - cracking_opening);
+}
+
+float HFNCPlant::opening(HAL::MockPWM &valve) {
+  uint32_t max_duty = valve.get_max_duty_cycle();
+  if (max_duty == 0 || !valve.get_pwm_state()) {
+    return 0;
+  }
+  return valve.get_duty_cycle_raw() / static_cast<float>(max_duty);
+}
+
+}  // namespace Pufferfish::Host
@@ -0,0 +1,303 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * LoadTester.cpp
+ *
+ *  A load generator for the backend serial link, which takes the place of the backend server
+ *  and measures the round-trip latency and throughput of the MCU's protocol stack.
+ */
+
+#include "Pufferfish/Host/LoadTester.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+#include "Pufferfish/Util/Timeouts.h"
+
+namespace Pufferfish::Host {
+
+namespace BE = Driver::Serial::Backend;
+
+namespace {
+
+const double micros_per_second = 1e6;
+
+const char *message_type_name(Application::MessageTypes type) {
+  switch (type) {
+    case Application::MessageTypes::sensor_measurements:
+      return "SensorMeasurements";
+    case Application::MessageTypes::cycle_measurements:
+      return "CycleMeasurements";
+    case Application::MessageTypes::parameters:
+      return "Parameters";
+    case Application::MessageTypes::parameters_request:
+      return "ParametersRequest";
+    case Application::MessageTypes::alarm_limits:
+      return "AlarmLimits";
+    case Application::MessageTypes::alarm_limits_request:
+      return "AlarmLimitsRequest";
+    case Application::MessageTypes::sensor_waveforms:
+      return "SensorWaveforms";
+    case Application::MessageTypes::capabilities:
+      return "Capabilities";
+    case Application::MessageTypes::capabilities_request:
+      return "CapabilitiesRequest";
+    case Application::MessageTypes::sensor_measurements_binary:
+      return "SensorMeasurements (binary)";
+    case Application::MessageTypes::sensor_measurements_delta:
+      return "SensorMeasurements (delta)";
+    case Application::MessageTypes::cycle_measurements_delta:
+      return "CycleMeasurements (delta)";
+    case Application::MessageTypes::diagnostics:
+      return "Diagnostics";
+    case Application::MessageTypes::profile:
+      return "Profile";
+    case Application::MessageTypes::unknown:
+    default:
+      return "unknown";
+  }
+}
+
+// Returns the interval at which the MCU sends a changed state segment at the baud rate
+uint32_t output_interval(Application::MessageTypes type, uint32_t baud_rate) {
+  const auto &rates = baud_rate == BE::default_baud_rate ? BE::default_baud_state_sync_rates
+                                                         : BE::state_sync_rates;
+  for (const auto &rate : rates) {
+    if (rate.type == type) {
+      return rate.interval;
+    }
+  }
+  return 0;
+}
+
+}  // namespace
+
+// LoadTester
+
+LoadReport LoadTester::run(const LoadOptions &options) {
+  LoadReport report;
+  capabilities_confirmed_ =
+      options.capabilities == 0 && options.max_baud_rate <= BE::default_baud_rate;
+  capabilities_requests_ = 0;
+  pending_requests_.clear();
+
+  auto duration = static_cast<uint32_t>(options.duration * micros_per_second);
+  uint32_t request_interval = 0;
+  if (options.request_rate > 0) {
+    request_interval = static_cast<uint32_t>(micros_per_second / options.request_rate);
+  }
+  uint32_t start_time = time_.micros();
+  uint32_t last_request_time = start_time - request_interval;
+  uint32_t last_capabilities_time = 0;
+  uint32_t current_time = start_time;
+  while (Util::within_timeout(start_time, duration, current_time)) {
+    uart_.wait_readable(receive_timeout);
+    receive(options, report);
+    update_baud_rate(report);
+
+    uint32_t current_millis = time_.millis();
+    if (!capabilities_confirmed_ &&
+        (capabilities_requests_ == 0 ||
+         !Util::within_timeout(
+             last_capabilities_time, capabilities_request_interval, current_millis))) {
+      CapabilitiesRequest request{};
+      request.features = options.capabilities;
+      request.max_baud_rate = options.max_baud_rate;
+      Application::StateSegment payload;
+      payload.set(request);
+      send(payload, report);
+      ++capabilities_requests_;
+      last_capabilities_time = current_millis;
+    }
+
+    current_time = time_.micros();
+    if (request_interval > 0 && current_time - last_request_time >= request_interval) {
+      // Requests which are overdue by more than an interval are skipped rather than sent in
+      // a burst
+      last_request_time += request_interval;
+      if (current_time - last_request_time >= request_interval) {
+        last_request_time = current_time;
+      }
+      ParametersRequest request{};
+      request.time = current_time;
+      request.mode = VentilationMode_hfnc;
+      request.ventilating = false;
+      Application::StateSegment payload;
+      payload.set(request);
+      send(payload, report);
+      pending_requests_.push_back(current_time);
+    }
+  }
+
+  report.duration = static_cast<double>(time_.micros() - start_time) / micros_per_second;
+  report.baud_rate = uart_.baud_rate();
+  report.unanswered_requests += pending_requests_.size();
+  report.echo_interval =
+      output_interval(Application::MessageTypes::parameters_request, report.baud_rate);
+  return report;
+}
+
+void LoadTester::receive(const LoadOptions &options, LoadReport &report) {
+  uint8_t receive = 0;
+  while (uart_.read(receive) == BufferStatus::ok) {
+    ++report.rx_bytes;
+    if (receiver_.input(receive) != BE::BackendReceiver::InputStatus::output_ready) {
+      continue;
+    }
+
+    switch (receiver_.output(receive_output_)) {
+      case BE::BackendReceiver::OutputStatus::waiting:
+        break;
+      case BE::BackendReceiver::OutputStatus::invalid_datagram_sequence:
+        ++report.rx_gaps;
+        handle(options, report);
+        break;
+      case BE::BackendReceiver::OutputStatus::available:
+        handle(options, report);
+        break;
+      default:
+        ++report.rx_errors;
+        break;
+    }
+  }
+}
+
+void LoadTester::handle(const LoadOptions &options, LoadReport &report) {
+  const Application::StateSegment &payload = receive_output_.payload;
+  ++report.rx_messages;
+  ++report.rx_types[payload.tag];
+  baud_rates_.input_valid(time_.millis());
+
+  switch (payload.tag) {
+    case Application::MessageTypes::parameters_request: {
+      // The MCU keeps echoing its latest request until it receives a new one, so only the first
+      // echo of each request is pending
+      uint32_t sent_time = payload.value.parameters_request.time;
+      auto echoed = std::find(pending_requests_.begin(), pending_requests_.end(), sent_time);
+      if (echoed == pending_requests_.end()) {
+        break;
+      }
+
+      // Earlier requests were replaced before the MCU echoed them
+      report.unanswered_requests += static_cast<size_t>(echoed - pending_requests_.begin());
+      pending_requests_.erase(pending_requests_.begin(), echoed + 1);
+      report.round_trips.push_back(time_.micros() - sent_time);
+      break;
+    }
+    case Application::MessageTypes::capabilities: {
+      const Capabilities &capabilities = payload.value.capabilities;
+      baud_rates_.announce(capabilities.baud_rate, time_.millis());
+      if (capabilities_confirmed_ || capabilities_requests_ == 0) {
+        break;
+      }
+      bool features_confirmed =
+          capabilities.features == (options.capabilities & BE::supported_capabilities);
+      bool baud_rate_confirmed = options.max_baud_rate <= BE::default_baud_rate ||
+                                 capabilities.baud_rate != BE::default_baud_rate ||
+                                 capabilities_requests_ >= max_capabilities_requests;
+      capabilities_confirmed_ = features_confirmed && baud_rate_confirmed;
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+void LoadTester::send(const Application::StateSegment &payload, LoadReport &report) {
+  BE::BackendMessage message;
+  message.payload = payload;
+  if (sender_.transform(message, send_output_) != BE::BackendSender::Status::ok) {
+    return;
+  }
+
+  HAL::AtomicSize written = 0;
+  uart_.write_block(send_output_.buffer(), send_output_.size(), write_timeout, written);
+  ++report.tx_messages;
+  report.tx_bytes += written;
+}
+
+void LoadTester::update_baud_rate(LoadReport &report) {
+  if (baud_rates_.update_clock(time_.millis())) {
+    // Renegotiate, which the MCU will only do for a slower baud rate
+    ++report.baud_rate_fallbacks;
+    capabilities_confirmed_ = false;
+    capabilities_requests_ = 0;
+  }
+  if (uart_.baud_rate() != baud_rates_.baud_rate()) {
+    // This is retried until every byte sent at the previous baud rate has been transmitted
+    uart_.set_baud_rate(baud_rates_.baud_rate());
+  }
+}
+
+// Reports
+
+uint32_t percentile(const std::vector<uint32_t> &sorted_samples, double fraction) {
+  if (sorted_samples.empty()) {
+    return 0;
+  }
+
+  auto rank = static_cast<size_t>(std::ceil(fraction * sorted_samples.size()));
+  return sorted_samples[std::clamp<size_t>(rank, 1, sorted_samples.size()) - 1];
+}
+
+void print_report(LoadReport &report) {
+  // Each byte takes a start bit, 8 data bits, and a stop bit
+  static const double bits_per_byte = 10;
+  static const double percent = 100;
+
+  double duration = report.duration > 0 ? report.duration : 1;
+  std::printf(
+      "Duration: %.2f s, ending at %u baud after %zu fallbacks\n",
+      report.duration,
+      report.baud_rate,
+      report.baud_rate_fallbacks);
+  std::printf(
+      "TX: %zu messages (%.1f/s), %zu bytes (%.0f B/s)\n",
+      report.tx_messages,
+      static_cast<double>(report.tx_messages) / duration,
+      report.tx_bytes,
+      static_cast<double>(report.tx_bytes) / duration);
+  double rx_bytes_rate = static_cast<double>(report.rx_bytes) / duration;
+  std::printf(
+      "RX: %zu messages (%.1f/s), %zu bytes (%.0f B/s, %.1f%% of the link), "
+      "%zu errors, %zu gaps\n",
+      report.rx_messages,
+      static_cast<double>(report.rx_messages) / duration,
+      report.rx_bytes,
+      rx_bytes_rate,
+      report.baud_rate > 0 ? rx_bytes_rate * bits_per_byte / report.baud_rate * percent : 0,
+      report.rx_errors,
+      report.rx_gaps);
+
+  std::printf("\n%-32s %10s %10s\n", "received message type", "messages", "per s");
+  for (const auto &type_count : report.rx_types) {
+    std::printf(
+        "%-32s %10zu %10.1f\n",
+        message_type_name(type_count.first),
+        type_count.second,
+        static_cast<double>(type_count.second) / duration);
+  }
+
+  std::vector<uint32_t> &round_trips = report.round_trips;
+  std::sort(round_trips.begin(), round_trips.end());
+  std::printf(
+      "\nRound-trip latency of ParametersRequest (%zu samples, %zu unanswered):\n",
+      round_trips.size(),
+      report.unanswered_requests);
+  std::printf(
+      "  each includes up to %u ms for the MCU's state synchronization to echo the request\n",
+      report.echo_interval);
+  if (round_trips.empty()) {
+    return;
+  }
+  std::printf(
+      "  min %u us, p50 %u us, p90 %u us, p99 %u us, max %u us\n",
+      round_trips.front(),
+      percentile(round_trips, 0.5),   // NOLINT(readability-magic-numbers)
+      percentile(round_trips, 0.9),   // NOLINT(readability-magic-numbers)
+      percentile(round_trips, 0.99),  // NOLINT(readability-magic-numbers)
+      round_trips.back());
+}
+
+}  // namespace Pufferfish::Host
@@ -0,0 +1,75 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * LoopbackMCU.cpp
+ *
+ *  An emulation of the MCU's side of the backend serial link, for load tests without an MCU.
+ */
+
+#include "Pufferfish/Host/LoopbackMCU.h"
+
+#include <cmath>
+
+namespace Pufferfish::Host {
+
+namespace BE = Driver::Serial::Backend;
+
+LoopbackMCU::~LoopbackMCU() {
+  stop();
+}
+
+UARTStatus LoopbackMCU::start(const std::string &path) {
+  stop();
+  if (uart_.open(path, BE::default_baud_rate) != UARTStatus::ok) {
+    return UARTStatus::error;
+  }
+
+  running_ = true;
+  thread_ = std::thread(&LoopbackMCU::run, this);
+  return UARTStatus::ok;
+}
+
+void LoopbackMCU::stop() {
+  running_ = false;
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  uart_.close();
+}
+
+void LoopbackMCU::run() {
+  BE::UARTBackend<HAL::POSIXBufferedUART>::ReceiveBudget budget{};
+  BE::UARTBackend<HAL::POSIXBufferedUART>::ReceiveCounts counts{};
+  uint32_t last_measurements_time = time_.millis();
+  while (running_) {
+    uart_.wait_readable(receive_timeout);
+    backend_.receive(budget, counts);
+
+    uint32_t current_time = time_.millis();
+    if (current_time - last_measurements_time >= measurements_interval) {
+      last_measurements_time = current_time;
+      update_measurements(current_time);
+    }
+    backend_.update_clock(current_time);
+    for (size_t i = 0; i < sends_per_iteration; ++i) {
+      backend_.send();
+    }
+  }
+}
+
+void LoopbackMCU::update_measurements(uint32_t current_time) {
+  static const float pi = 3.14159265F;
+  static const uint32_t period = 3000;  // ms
+
+  float phase = 2 * pi * static_cast<float>(current_time % period) / period;
+  SensorMeasurements &measurements = states_.sensor_measurements();
+  measurements.time = current_time;
+  measurements.cycle = current_time / period;
+  measurements.paw = 12 + 8 * std::sin(phase);        // NOLINT(readability-magic-numbers)
+  measurements.flow = 30 * std::cos(phase);           // NOLINT(readability-magic-numbers)
+  measurements.volume = 250 - 200 * std::cos(phase);  // NOLINT(readability-magic-numbers)
+  measurements.fio2 = 40;                             // NOLINT(readability-magic-numbers)
+  measurements.spo2 = 97;                             // NOLINT(readability-magic-numbers)
+}
+
+}  // namespace Pufferfish::Host
@@ -0,0 +1,107 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * SimulatedSFM3019.cpp
+ *
+ *  An emulation of the I2C interface of an SFM3019 flow sensor, for running the firmware's
+ *  SFM3019 driver without the sensor.
+ */
+
+#include "Pufferfish/Host/SimulatedSFM3019.h"
+
+#include <array>
+#include <cmath>
+#include <limits>
+
+#include "Pufferfish/Util/Bytes.h"
+
+namespace Pufferfish::Host {
+
+using Driver::I2C::SFM3019::Command;
+
+I2CDeviceStatus SimulatedSFM3019::read(uint8_t *buf, size_t count) {
+  switch (response_) {
+    case Response::product_id: {
+      const std::array<uint16_t, 2> words{
+          {static_cast<uint16_t>(product_number >> 16U),
+           static_cast<uint16_t>(product_number & UINT16_MAX)}};
+      return write_words(words.data(), words.size(), buf, count);
+    }
+    case Response::conversion_factors: {
+      const std::array<uint16_t, 3> words{
+          {static_cast<uint16_t>(scale_factor), static_cast<uint16_t>(offset), flow_unit}};
+      return write_words(words.data(), words.size(), buf, count);
+    }
+    case Response::flow: {
+      const auto word = static_cast<uint16_t>(raw_flow_);
+      return write_words(&word, 1, buf, count);
+    }
+    case Response::none:
+      break;
+  }
+  return I2CDeviceStatus::read_error;
+}
+
+I2CDeviceStatus SimulatedSFM3019::write(uint8_t *buf, size_t count) {
+  if (count < sizeof(uint16_t)) {
+    return I2CDeviceStatus::write_error;
+  }
+
+  auto command = static_cast<Command>(Util::set_byte<1, uint16_t>(buf[0]) + buf[1]);
+  switch (command) {
+    case Command::read_product_id:
+      response_ = Response::product_id;
+      return I2CDeviceStatus::ok;
+    case Command::read_conversion:
+      response_ = Response::conversion_factors;
+      return I2CDeviceStatus::ok;
+    case Command::set_averaging:
+      return I2CDeviceStatus::ok;
+    case Command::start_measure_air:
+    case Command::start_measure_o2:
+    case Command::start_measure_mixture:
+      measuring_ = static_cast<uint16_t>(command) == static_cast<uint16_t>(gas_);
+      response_ = Response::flow;
+      return I2CDeviceStatus::ok;
+    case Command::stop_measure:
+      measuring_ = false;
+      response_ = Response::none;
+      return I2CDeviceStatus::ok;
+    default:
+      break;
+  }
+  return I2CDeviceStatus::write_error;
+}
+
+void SimulatedSFM3019::set_flow(float flow) {
+  float raw_flow = std::round(flow * scale_factor + offset);
+  if (raw_flow < std::numeric_limits<int16_t>::min()) {
+    raw_flow = std::numeric_limits<int16_t>::min();
+  }
+  if (raw_flow > std::numeric_limits<int16_t>::max()) {
+    raw_flow = std::numeric_limits<int16_t>::max();
+  }
+  raw_flow_ = static_cast<int16_t>(raw_flow);
+}
+
+bool SimulatedSFM3019::measuring() const {
+  return measuring_;
+}
+
+I2CDeviceStatus SimulatedSFM3019::write_words(
+    const uint16_t *words, size_t num_words, uint8_t *buf, size_t count) {
+  static const size_t bytes_per_word = sizeof(uint16_t) + sizeof(uint8_t);
+  if (count > num_words * bytes_per_word) {
+    return I2CDeviceStatus::read_error;
+  }
+
+  for (size_t i = 0; i < count / bytes_per_word; ++i) {
+    uint8_t *word_start = buf + i * bytes_per_word;
+    word_start[0] = Util::get_byte<1>(words[i]);
+    word_start[1] = Util::get_byte<0>(words[i]);
+    word_start[2] = crc8_.compute(word_start, sizeof(uint16_t));
+  }
+  return I2CDeviceStatus::ok;
+}
+
+}  // namespace Pufferfish::Host
@@ -0,0 +1,46 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * StepResponse.cpp
+ *
+ *  Performance metrics of the response of a controlled variable to a step of its setpoint.
+ */
+
+#include "Pufferfish/Host/StepResponse.h"
+
+#include <cmath>
+
+namespace Pufferfish::Host {
+
+void StepResponse::input(uint32_t current_time, float value) {
+  float error = setpoint_ - value;
+  bool in_band = std::abs(error) <= settling_band_;
+  if (in_band && !in_band_) {
+    band_entry_time_ = current_time;
+  }
+  in_band_ = in_band;
+
+  // Excursions past the setpoint are in the direction of the step
+  float excursion = setpoint_ >= initial_ ? value - setpoint_ : setpoint_ - value;
+  if (excursion > max_excursion_) {
+    max_excursion_ = excursion;
+  }
+
+  if (current_time - start_time_ >= steady_state_start_ - start_time_) {
+    steady_state_error_sum_ += error;
+    ++steady_state_samples_;
+  }
+}
+
+StepMetrics StepResponse::metrics() const {
+  StepMetrics metrics{};
+  metrics.settled = in_band_;
+  metrics.settling_time = in_band_ ? band_entry_time_ - start_time_ : 0;
+  float step_size = std::abs(setpoint_ - initial_);
+  metrics.overshoot = step_size > 0 ? max_excursion_ / step_size * percent : 0;
+  metrics.steady_state_error =
+      steady_state_samples_ > 0 ? steady_state_error_sum_ / steady_state_samples_ : 0;
+  return metrics;
+}
+
+}  // namespace Pufferfish::Host
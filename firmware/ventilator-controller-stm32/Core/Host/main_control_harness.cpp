@@ -0,0 +1,167 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * main_control_harness.cpp
+ *
+ * Scoring of the HFNC control loop's responses to setpoint steps, in closed loop with a model
+ * of the breathing circuit, faster than real time.
+ */
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "Pufferfish/Host/ControlHarness.h"
+
+namespace PF = Pufferfish;
+
+namespace {
+
+struct ScenarioStep {
+  const char *name;
+  PF::Host::Setpoints setpoints;
+  PF::Host::ControlledVariable variable;
+};
+
+// Each cycle of the scenario alternates between steps of flow and of FiO2, and ends at the
+// setpoints from which it starts
+const ScenarioStep start_step{"flow 0 -> 30", {30, 40}, PF::Host::ControlledVariable::flow};
+const std::array<ScenarioStep, 6> cycle_steps{
+    {{"FiO2 40 -> 60", {30, 60}, PF::Host::ControlledVariable::fio2},
+     {"flow 30 -> 50", {50, 60}, PF::Host::ControlledVariable::flow},
+     {"FiO2 60 -> 90", {50, 90}, PF::Host::ControlledVariable::fio2},
+     {"flow 50 -> 20", {20, 90}, PF::Host::ControlledVariable::flow},
+     {"FiO2 90 -> 40", {20, 40}, PF::Host::ControlledVariable::fio2},
+     {"flow 20 -> 30", {30, 40}, PF::Host::ControlledVariable::flow}}};
+
+const double millis_per_second = 1000;
+const double seconds_per_hour = 3600;
+const float percent = 100;
+
+// Metrics of every run of a step of the scenario
+struct StepSummary {
+  size_t runs = 0;
+  size_t settled = 0;
+  double settling_time_sum = 0;  // ms
+  uint32_t max_settling_time = 0;
+  float max_overshoot = 0;
+  float max_steady_state_error = 0;
+
+  void input(const PF::Host::StepMetrics &metrics) {
+    ++runs;
+    if (metrics.settled) {
+      ++settled;
+      settling_time_sum += metrics.settling_time;
+      max_settling_time = std::max(max_settling_time, metrics.settling_time);
+    }
+    max_overshoot = std::max(max_overshoot, metrics.overshoot);
+    max_steady_state_error =
+        std::max(max_steady_state_error, std::abs(metrics.steady_state_error));
+  }
+};
+
+void print_usage(const char *program) {
+  std::printf(
+      "Usage: %s [OPTIONS]\n"
+      "  --hours HOURS        simulated duration of the scenario (default 1)\n"
+      "  --hold SECONDS       simulated duration of each setpoint step (default 20)\n"
+      "  --settling FRACTION  fraction of each step within which a response is settled\n"
+      "                       (default 0.05)\n",
+      program);
+}
+
+void print_summary(const char *name, const StepSummary &summary) {
+  double mean_settling_time =
+      summary.settled > 0 ? summary.settling_time_sum / summary.settled : 0;
+  std::printf(
+      "%-14s %6zu %8zu %11.0f %11u %10.1f %10.3f\n",
+      name,
+      summary.runs,
+      summary.settled,
+      mean_settling_time,
+      summary.max_settling_time,
+      summary.max_overshoot,
+      summary.max_steady_state_error);
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  double hours = 1;
+  double hold = 20;  // s
+  PF::Host::ScoringOptions options;
+  for (int i = 1; i < argc; ++i) {
+    const char *argument = argv[i];
+    bool has_value = i + 1 < argc;
+    if (std::strcmp(argument, "--hours") == 0 && has_value) {
+      hours = std::strtod(argv[++i], nullptr);
+    } else if (std::strcmp(argument, "--hold") == 0 && has_value) {
+      hold = std::strtod(argv[++i], nullptr);
+    } else if (std::strcmp(argument, "--settling") == 0 && has_value) {
+      options.settling_fraction = static_cast<float>(std::strtod(argv[++i], nullptr));
+    } else {
+      print_usage(argv[0]);
+      return std::strcmp(argument, "--help") == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+  }
+  const auto step_duration = static_cast<uint32_t>(hold * millis_per_second);
+  const double cycle_duration = step_duration * cycle_steps.size() / millis_per_second;
+  const auto cycles = static_cast<size_t>(std::ceil(hours * seconds_per_hour / cycle_duration));
+  if (step_duration == 0 || cycles == 0) {
+    print_usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  auto wall_start = std::chrono::steady_clock::now();
+  PF::Host::ControlHarness harness(options);
+  if (harness.setup() != PF::InitializableState::ok) {
+    std::fprintf(stderr, "Couldn't set up the flow sensors\n");
+    return EXIT_FAILURE;
+  }
+
+  StepSummary start_summary;
+  std::array<StepSummary, cycle_steps.size()> cycle_summaries{};
+  start_summary.input(harness.step(start_step.setpoints, start_step.variable, step_duration));
+  for (size_t cycle = 0; cycle < cycles; ++cycle) {
+    for (size_t i = 0; i < cycle_steps.size(); ++i) {
+      const ScenarioStep &step = cycle_steps[i];
+      cycle_summaries[i].input(harness.step(step.setpoints, step.variable, step_duration));
+    }
+  }
+  std::chrono::duration<double> wall_duration = std::chrono::steady_clock::now() - wall_start;
+
+  double simulated_duration = harness.current_time() / millis_per_second;
+  std::printf(
+      "Simulated %.0f s of HFNC in %.2f s (%.0fx real time)\n\n",
+      simulated_duration,
+      wall_duration.count(),
+      simulated_duration / wall_duration.count());
+  std::printf(
+      "%-14s %6s %8s %11s %11s %10s %10s\n",
+      "Step",
+      "Runs",
+      "Settled",
+      "Mean (ms)",
+      "Max (ms)",
+      "Over (%)",
+      "Max SSE");
+  print_summary(start_step.name, start_summary);
+  bool all_settled = start_summary.settled == start_summary.runs;
+  for (size_t i = 0; i < cycle_steps.size(); ++i) {
+    print_summary(cycle_steps[i].name, cycle_summaries[i]);
+    all_settled = all_settled && cycle_summaries[i].settled == cycle_summaries[i].runs;
+  }
+  std::printf(
+      "\nSettling times are until the response stays within %.0f%% of each step (or within\n"
+      "%.0f L/min or %.0f%% FiO2 of small steps); overshoot is in %% of each step; steady-state\n"
+      "errors (SSE) are in L/min or %% FiO2, over the last %u ms of each step.\n",
+      options.settling_fraction * percent,
+      options.min_flow_band,
+      options.min_fio2_band,
+      PF::Host::ControlHarness::steady_state_duration(options, step_duration));
+  return all_settled ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * main_load_tester.cpp
+ *
+ * Load tests of the backend serial link, from the native computer.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "Pufferfish/HAL/CRCEngine.h"
+#include "Pufferfish/HAL/POSIX/POSIXBufferedUART.h"
+#include "Pufferfish/HAL/POSIX/POSIXTime.h"
+#include "Pufferfish/Host/LoadTester.h"
+#include "Pufferfish/Host/LoopbackMCU.h"
+
+namespace {
+
+void print_usage(const char *program) {
+  std::printf(
+      "Usage: %s [OPTIONS] (DEVICE | --loopback)\n"
+      "  DEVICE               serial device or pseudoterminal connected to the MCU\n"
+      "  --loopback           test against an emulated MCU over a pseudoterminal\n"
+      "  --duration SECONDS   duration of the test (default 10)\n"
+      "  --rate HZ            rate of ParametersRequest messages (default 20)\n"
+      "  --capabilities FLAGS capability flags to request from the MCU (default 0)\n"
+      "  --max-baud RATE      maximum baud rate to negotiate (default: stay at 115200)\n",
+      program);
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  namespace PF = Pufferfish;
+
+  PF::Host::LoadOptions options;
+  std::string device;
+  bool loopback = false;
+  for (int i = 1; i < argc; ++i) {
+    const char *argument = argv[i];
+    bool has_value = i + 1 < argc;
+    if (std::strcmp(argument, "--loopback") == 0) {
+      loopback = true;
+    } else if (std::strcmp(argument, "--duration") == 0 && has_value) {
+      options.duration = std::strtod(argv[++i], nullptr);
+    } else if (std::strcmp(argument, "--rate") == 0 && has_value) {
+      options.request_rate = std::strtod(argv[++i], nullptr);
+    } else if (std::strcmp(argument, "--capabilities") == 0 && has_value) {
+      options.capabilities = std::strtoul(argv[++i], nullptr, 0);
+    } else if (std::strcmp(argument, "--max-baud") == 0 && has_value) {
+      options.max_baud_rate = std::strtoul(argv[++i], nullptr, 0);
+    } else if (argument[0] == '-') {
+      print_usage(argv[0]);
+      return std::strcmp(argument, "--help") == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    } else {
+      device = argument;
+    }
+  }
+  if (loopback == !device.empty()) {
+    print_usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  PF::HAL::EngineCRC32C crc32c;
+  PF::HAL::POSIXBufferedUART uart;
+  // The emulated MCU runs on its own thread, with its own CRC calculator
+  PF::HAL::EngineCRC32C mcu_crc32c;
+  PF::Host::LoopbackMCU mcu(mcu_crc32c);
+  if (loopback) {
+    std::string peer_path;
+    if (uart.open_pty(peer_path) != PF::UARTStatus::ok ||
+        mcu.start(peer_path) != PF::UARTStatus::ok) {
+      std::fprintf(stderr, "Couldn't create a pseudoterminal for the emulated MCU\n");
+      return EXIT_FAILURE;
+    }
+    std::printf("Emulated MCU on %s\n", peer_path.c_str());
+  } else if (
+      uart.open(device, PF::Driver::Serial::Backend::default_baud_rate) != PF::UARTStatus::ok) {
+    std::fprintf(stderr, "Couldn't open %s\n", device.c_str());
+    return EXIT_FAILURE;
+  }
+
+  PF::HAL::POSIXTime time;
+  PF::Host::LoadTester tester(uart, crc32c, time);
+  PF::Host::LoadReport report = tester.run(options);
+  mcu.stop();
+  PF::Host::print_report(report);
+  return EXIT_SUCCESS;
+}
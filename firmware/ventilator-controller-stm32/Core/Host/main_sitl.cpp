@@ -0,0 +1,241 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * main_sitl.cpp
+ *
+ * Software-in-the-loop execution of the firmware application on the native computer, in real
+ * time, with the backend serial link on a pseudoterminal.
+ */
+
+#include <unistd.h>
+
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+
+#include "Pufferfish/Application/Firmware.h"
+#include "Pufferfish/Driver/BreathingCircuit/ControlLoop.h"
+#include "Pufferfish/Driver/I2C/SFM3019/Sensor.h"
+#include "Pufferfish/HAL/CRCEngine.h"
+#include "Pufferfish/HAL/Mock/MockI2CDevice.h"
+#include "Pufferfish/HAL/Mock/MockPWM.h"
+#include "Pufferfish/HAL/POSIX/POSIXBufferedUART.h"
+#include "Pufferfish/HAL/POSIX/POSIXTime.h"
+#include "Pufferfish/Host/HFNCPlant.h"
+#include "Pufferfish/Host/SimulatedSFM3019.h"
+#include "Pufferfish/Util/Array.h"
+#include "Pufferfish/Util/Scheduler.h"
+
+namespace PF = Pufferfish;
+
+namespace {
+
+// The same application as in main.cpp, with emulated hardware in place of the STM32's
+// peripherals
+
+// Utilities
+PF::HAL::EngineCRC32C crc32c;
+PF::HAL::POSIXTime time;
+
+// Backend serial link, on a pseudoterminal
+PF::HAL::POSIXBufferedUART backend_uart;
+
+// Solenoid Valves
+const uint32_t valve_max_duty_cycle = 6400;  // the period of the valves' PWM timers
+PF::HAL::MockPWM drive1_ch1;
+PF::HAL::MockPWM drive1_ch2;
+
+// SFM3019
+PF::Host::SimulatedSFM3019 i2c_sfm3019_air(PF::Driver::I2C::SFM3019::GasType::air);
+PF::Host::SimulatedSFM3019 i2c_sfm3019_o2(PF::Driver::I2C::SFM3019::GasType::o2);
+PF::HAL::MockI2CDevice i2c2_global;
+PF::HAL::MockI2CDevice i2c4_global;
+PF::Driver::I2C::SFM3019::Device sfm3019_dev_air(
+    i2c_sfm3019_air, i2c2_global, PF::Driver::I2C::SFM3019::GasType::air);
+PF::Driver::I2C::SFM3019::Sensor sfm3019_air(sfm3019_dev_air, true, time);
+PF::Driver::I2C::SFM3019::Device sfm3019_dev_o2(
+    i2c_sfm3019_o2, i2c4_global, PF::Driver::I2C::SFM3019::GasType::o2);
+PF::Driver::I2C::SFM3019::Sensor sfm3019_o2(sfm3019_dev_o2, true, time);
+
+// Breathing Circuit, in place of the valves and gas supplies
+PF::Host::HFNCPlant plant(drive1_ch1, drive1_ch2, i2c_sfm3019_air, i2c_sfm3019_o2);
+
+// Application
+using Firmware = PF::Application::Firmware<PF::HAL::POSIXBufferedUART>;
+Firmware firmware(backend_uart, crc32c, time, sfm3019_air, sfm3019_o2, drive1_ch1, drive1_ch2);
+
+// Scheduler
+// The control loop is polled, as when main.cpp's control_loop_timer_driven is false
+const uint32_t plant_period = 1;
+const uint32_t plant_budget = 50;
+const uint8_t plant_priority = 5;
+const uint32_t control_loop_period = PF::Driver::BreathingCircuit::ControlLoop::update_interval;
+auto tasks = PF::Util::make_array<PF::Util::Task>(
+    // Breathing Circuit
+    PF::Util::Task{
+        [](uint32_t current_time) { plant.update(current_time); },
+        plant_period,
+        plant_priority,
+        plant_budget},
+    // Breathing Circuit Control Loop
+    PF::Util::Task{
+        [](uint32_t current_time) { firmware.hfnc().update(current_time); },
+        control_loop_period,
+        Firmware::control_loop_priority,
+        Firmware::control_loop_budget},
+    // Breathing Circuit Sensor Simulator
+    PF::Util::Task{
+        [](uint32_t current_time) { firmware.update_simulator(current_time); },
+        Firmware::simulator_period,
+        Firmware::simulator_priority,
+        Firmware::simulator_budget},
+    // Backend Communication Protocol
+    PF::Util::Task{
+        [](uint32_t current_time) {
+          firmware.receive_backend();
+          firmware.backend().update_clock(current_time);
+          firmware.backend().send();
+        },
+        Firmware::backend_period,
+        Firmware::backend_priority,
+        Firmware::backend_budget},
+    // Parameters update
+    PF::Util::Task{
+        [](uint32_t /*current_time*/) { firmware.update_parameters(); },
+        Firmware::parameters_period,
+        Firmware::parameters_priority,
+        Firmware::parameters_budget});
+const auto task_names = PF::Util::make_array<const char *>(
+    "plant", "control loop", "simulator", "backend", "parameters");
+PF::Util::Scheduler<tasks.size()> scheduler(time);
+
+// Maximum time to sleep in each main loop iteration while waiting for bytes from the backend
+const uint32_t idle_timeout = 1;  // ms
+const double millis_per_second = 1000;
+
+volatile std::sig_atomic_t running = 1;
+
+void stop(int /*signal*/) {
+  running = 0;
+}
+
+void print_usage(const char *program) {
+  std::printf(
+      "Usage: %s [OPTIONS]\n"
+      "  --link PATH          also make the pseudoterminal of the backend available at PATH\n"
+      "  --duration SECONDS   stop after some time (default: run until interrupted)\n",
+      program);
+}
+
+bool setup_sensors() {
+  auto initializables =
+      PF::Util::make_array<std::reference_wrapper<PF::Driver::Initializable>>(
+          sfm3019_air, sfm3019_o2);
+  while (true) {
+    bool in_setup = false;
+    for (auto &initializable : initializables) {
+      switch (initializable.get().setup()) {
+        case PF::InitializableState::failed:
+          return false;
+        case PF::InitializableState::setup:
+          in_setup = true;
+          break;
+        case PF::InitializableState::ok:
+          break;
+      }
+    }
+    if (!in_setup) {
+      return true;
+    }
+    time.delay(1);
+  }
+}
+
+void print_task_stats() {
+  std::printf("%-14s %10s %10s %10s %14s\n", "Task", "Runs", "Overruns", "Missed", "Max (us)");
+  for (size_t i = 0; i < scheduler.size(); ++i) {
+    PF::Util::TaskStats stats{};
+    if (scheduler.stats(i, stats) != PF::IndexStatus::ok) {
+      continue;
+    }
+    std::printf(
+        "%-14s %10u %10u %10u %14u\n",
+        task_names[i],
+        stats.runs,
+        stats.overruns,
+        stats.missed_periods,
+        stats.max_duration);
+  }
+  std::printf("Longest main loop iteration: %u us\n", scheduler.max_iteration_duration());
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  std::string link_path;
+  double duration = 0;
+  for (int i = 1; i < argc; ++i) {
+    const char *argument = argv[i];
+    bool has_value = i + 1 < argc;
+    if (std::strcmp(argument, "--link") == 0 && has_value) {
+      link_path = argv[++i];
+    } else if (std::strcmp(argument, "--duration") == 0 && has_value) {
+      duration = std::strtod(argv[++i], nullptr);
+    } else {
+      print_usage(argv[0]);
+      return std::strcmp(argument, "--help") == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+  }
+
+  std::string peer_path;
+  if (backend_uart.open_pty(peer_path) != PF::UARTStatus::ok) {
+    std::fprintf(stderr, "Couldn't create a pseudoterminal for the backend\n");
+    return EXIT_FAILURE;
+  }
+  if (!link_path.empty()) {
+    unlink(link_path.c_str());
+    if (symlink(peer_path.c_str(), link_path.c_str()) != 0) {
+      std::fprintf(stderr, "Couldn't link %s to %s\n", link_path.c_str(), peer_path.c_str());
+      return EXIT_FAILURE;
+    }
+  }
+  std::printf(
+      "Backend serial link on %s\n", link_path.empty() ? peer_path.c_str() : link_path.c_str());
+  std::signal(SIGINT, stop);
+  std::signal(SIGTERM, stop);
+
+  // Hardware PWMs
+  for (auto *valve : {&drive1_ch1, &drive1_ch2}) {
+    valve->set_max_duty_cycle(valve_max_duty_cycle);
+    valve->start();
+    valve->set_duty_cycle_raw(0);
+  }
+
+  // Setup
+  if (!setup_sensors()) {
+    std::fprintf(stderr, "Couldn't set up the flow sensors\n");
+    return EXIT_FAILURE;
+  }
+
+  // Normal loop
+  for (const auto &task : tasks) {
+    if (scheduler.add(task) != PF::IndexStatus::ok) {
+      return EXIT_FAILURE;
+    }
+  }
+  const uint32_t start_time = time.millis();
+  const auto duration_millis = static_cast<uint32_t>(duration * millis_per_second);
+  while (running != 0 && (duration_millis == 0 || time.millis() - start_time < duration_millis)) {
+    scheduler.run(time.millis());
+    backend_uart.wait_readable(idle_timeout);
+  }
+
+  if (!link_path.empty()) {
+    unlink(link_path.c_str());
+  }
+  print_task_stats();
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * Firmware.h
+ *
+ *  The parts of the firmware application which don't depend on the MCU's peripherals, shared by
+ *  main.cpp and the software-in-the-loop build so that both run the same application.
+ */
+
+#pragma once
+
+#include "Pufferfish/Application/States.h"
+#include "Pufferfish/Driver/BreathingCircuit/ControlLoop.h"
+#include "Pufferfish/Driver/BreathingCircuit/ParametersService.h"
+#include "Pufferfish/Driver/BreathingCircuit/Simulator.h"
+#include "Pufferfish/Driver/I2C/SFM3019/Sensor.h"
+#include "Pufferfish/Driver/Serial/Backend/UART.h"
+#include "Pufferfish/HAL/Interfaces/CRCChecker.h"
+#include "Pufferfish/HAL/Interfaces/PWM.h"
+#include "Pufferfish/HAL/Interfaces/Time.h"
+
+namespace Pufferfish::Application {
+
+/**
+ * Connects the application states, the breathing circuit's parameters service, sensor
+ * simulators, and HFNC control loop, and the backend serial link, given the sensors, valves,
+ * and UART which they run on. Each of the update functions is meant to be run as a task of the
+ * main loop's scheduler, at the period, priority, and budget given here for it, so that the
+ * task tables of every build of the firmware schedule the application in the same way.
+ */
+template <typename BackendBufferedUART>
+class Firmware {
+ public:
+  using BackendUART = Driver::Serial::Backend::UARTBackend<BackendBufferedUART>;
+
+  // Periods are in ms and budgets are in us. Each task only does work when it is due, and the
+  // budgets are estimates of each task's worst case, to be checked against the recorded overruns.
+  // The control loop's period depends on whether it is driven by a timer.
+  static const uint32_t control_loop_budget = 1000;
+  static const uint8_t control_loop_priority = 4;
+  static const uint32_t simulator_period = 2;  // the simulator's own update interval
+  static const uint32_t simulator_budget = 100;
+  static const uint8_t simulator_priority = 3;
+  static const uint32_t backend_period = 0;  // the backend UART is polled on every iteration
+  static const uint32_t backend_receive_max_micros = 500;
+  static const uint32_t backend_budget = backend_receive_max_micros + 100;
+  static const uint8_t backend_priority = 1;
+  static const uint32_t parameters_period = 10;
+  static const uint32_t parameters_budget = 20;
+  static const uint8_t parameters_priority = 1;
+
+  Firmware(
+      volatile BackendBufferedUART &backend_uart,
+      HAL::CRC32 &crc32c,
+      HAL::Time &time,
+      Driver::I2C::SFM3019::Sensor &sfm3019_air,
+      Driver::I2C::SFM3019::Sensor &sfm3019_o2,
+      HAL::PWM &valve_air,
+      HAL::PWM &valve_o2);
+
+  States &states();
+  Driver::BreathingCircuit::HFNCControlLoop &hfnc();
+  BackendUART &backend();
+
+  void update_simulator(uint32_t current_time);
+  // Receives every complete request from the backend, but without delaying the control loop
+  void receive_backend();
+  void update_parameters();
+
+ private:
+  static const size_t backend_receive_max_bytes = 1024;
+
+  States states_;
+  Driver::BreathingCircuit::ParametersServices parameters_service_;
+  Driver::BreathingCircuit::Simulators simulator_;
+  BackendUART backend_;
+  typename BackendUART::ReceiveCounts backend_receive_counts_{};
+  Driver::BreathingCircuit::HFNCControlLoop hfnc_;
+};
+
+}  // namespace Pufferfish::Application
+
+#include "Firmware.tpp"
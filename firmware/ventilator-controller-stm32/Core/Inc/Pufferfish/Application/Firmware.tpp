@@ -0,0 +1,72 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * Firmware.tpp
+ *
+ *  The parts of the firmware application which don't depend on the MCU's peripherals, shared by
+ *  main.cpp and the software-in-the-loop build so that both run the same application.
+ */
+
+#pragma once
+
+#include "Firmware.h"
+
+namespace Pufferfish::Application {
+
+template <typename BackendBufferedUART>
+Firmware<BackendBufferedUART>::Firmware(
+    volatile BackendBufferedUART &backend_uart,
+    HAL::CRC32 &crc32c,
+    HAL::Time &time,
+    Driver::I2C::SFM3019::Sensor &sfm3019_air,
+    Driver::I2C::SFM3019::Sensor &sfm3019_o2,
+    HAL::PWM &valve_air,
+    HAL::PWM &valve_o2)
+    : backend_(backend_uart, crc32c, states_, time),
+      hfnc_(
+          states_.parameters(),
+          states_.sensor_measurements(),
+          states_.sensor_waveforms(),
+          sfm3019_air,
+          sfm3019_o2,
+          valve_air,
+          valve_o2) {}
+
+template <typename BackendBufferedUART>
+States &Firmware<BackendBufferedUART>::states() {
+  return states_;
+}
+
+template <typename BackendBufferedUART>
+Driver::BreathingCircuit::HFNCControlLoop &Firmware<BackendBufferedUART>::hfnc() {
+  return hfnc_;
+}
+
+template <typename BackendBufferedUART>
+typename Firmware<BackendBufferedUART>::BackendUART &Firmware<BackendBufferedUART>::backend() {
+  return backend_;
+}
+
+template <typename BackendBufferedUART>
+void Firmware<BackendBufferedUART>::update_simulator(uint32_t current_time) {
+  simulator_.transform(
+      current_time,
+      states_.parameters(),
+      hfnc_.sensor_vars(),
+      states_.sensor_measurements(),
+      states_.cycle_measurements());
+}
+
+template <typename BackendBufferedUART>
+void Firmware<BackendBufferedUART>::receive_backend() {
+  const typename BackendUART::ReceiveBudget budget{
+      backend_receive_max_bytes, backend_receive_max_micros};
+  backend_.receive(budget, backend_receive_counts_);
+}
+
+template <typename BackendBufferedUART>
+void Firmware<BackendBufferedUART>::update_parameters() {
+  parameters_service_.transform(states_.parameters_request(), states_.parameters());
+}
+
+}  // namespace Pufferfish::Application
@@ -0,0 +1,44 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * Profiler.h
+ *
+ *  Execution time statistics of the profiled regions of the firmware, for output to the
+ *  backend in the profile state segment.
+ */
+
+#pragma once
+
+#include <array>
+
+#include "Pufferfish/Util/Profiler.h"
+#include "mcu_pb.h"
+
+namespace Pufferfish::Application {
+
+static_assert(
+    Util::ProfileStats::histogram_size == pb_arraysize(Profile, histogram),
+    "The histogram of each region must fit exactly into a Profile message");
+
+/**
+ * Holds the statistics of each profiled region. Statistics of regions in interrupt handlers
+ * are recorded while the main loop may be reading them for output, so an output may mix
+ * statistics from before and after one execution of such a region.
+ */
+class Profiler {
+ public:
+  static constexpr size_t num_regions = _ProfileRegion_ARRAYSIZE;
+
+  Profiler() = default;
+
+  Util::ProfileStats &region(ProfileRegion region);
+  // Outputs the statistics of the next region in turn, so that every region is output once
+  // every num_regions calls
+  void output(uint32_t current_time, Profile &output);
+
+ private:
+  std::array<Util::ProfileStats, num_regions> regions_{};
+  size_t next_region_ = 0;
+};
+
+}  // namespace Pufferfish::Application
@@ -7,9 +7,12 @@
 
 #pragma once
 
-#include "Pufferfish/Util/Enums.h"
+#include "Pufferfish/Util/Deltas.h"
+#include "Pufferfish/Util/FixedLayout.h"
 #include "Pufferfish/Util/TaggedUnion.h"
+#include "Pufferfish/Util/TypeRegistry.h"
 #include "mcu_pb.h"
+#include "mcu_pb_codecs.h"
 
 namespace Pufferfish::Application {
 
@@ -22,28 +25,75 @@ enum class MessageTypes : uint8_t {
   parameters = 4,
   parameters_request = 5,
   alarm_limits = 6,
-  alarm_limits_request = 7
+  alarm_limits_request = 7,
+  sensor_waveforms = 11,
+  capabilities = 12,
+  capabilities_request = 13,
+  sensor_measurements_binary = 14,
+  sensor_measurements_delta = 15,
+  cycle_measurements_delta = 16,
+  diagnostics = 17,
+  profile = 18
 };
 
-// MessageTypeValues should include all defined values of MessageTypes
-using MessageTypeValues = Util::EnumValues<
-    MessageTypes,
-    MessageTypes::unknown,
-    MessageTypes::sensor_measurements,
-    MessageTypes::cycle_measurements,
-    MessageTypes::parameters,
-    MessageTypes::parameters_request,
-    MessageTypes::alarm_limits,
-    MessageTypes::alarm_limits_request>;
-
-// Since nanopb is running dynamically, we cannot have extensive compile-time type-checking.
-// It's not clear how we might use variants to replace this union, since the nanopb functions
-// would need access to the underlying memory in the variant, which is not publicly accessible.
-// For now the State Segment class is a simple tagged union, though we don't have any compiler
-// type-checking with the tags - it's enforced with the templated functions.
-union StateSegmentUnion;
-
-using StateSegment = Util::TaggedUnion<StateSegmentUnion, MessageTypes>;
+// SensorMeasurements, sent with a fixed little-endian layout instead of protobuf encoding once
+// the receiver has requested the binary_sensor_measurements capability
+struct BinarySensorMeasurements : SensorMeasurements {};
+
+}  // namespace Pufferfish::Application
+
+namespace Pufferfish::Util {
+
+template <>
+struct FixedLayout<Application::BinarySensorMeasurements> {
+  static constexpr bool enabled = true;
+  // time, cycle, paw, flow, volume, fio2, spo2
+  static constexpr size_t size = 7 * sizeof(uint32_t);
+};
+
+template <>
+struct DeltaFields<SensorMeasurements> : DeltaFieldList<
+                                             DeltaCounter<&SensorMeasurements::time>,
+                                             DeltaCounter<&SensorMeasurements::cycle>,
+                                             DeltaReal<&SensorMeasurements::paw>,
+                                             DeltaReal<&SensorMeasurements::flow>,
+                                             DeltaReal<&SensorMeasurements::volume>,
+                                             DeltaReal<&SensorMeasurements::fio2>,
+                                             DeltaReal<&SensorMeasurements::spo2>> {};
+
+template <>
+struct DeltaFields<CycleMeasurements> : DeltaFieldList<
+                                            DeltaCounter<&CycleMeasurements::time>,
+                                            DeltaReal<&CycleMeasurements::vt>,
+                                            DeltaReal<&CycleMeasurements::rr>,
+                                            DeltaReal<&CycleMeasurements::peep>,
+                                            DeltaReal<&CycleMeasurements::pip>,
+                                            DeltaReal<&CycleMeasurements::ip>,
+                                            DeltaReal<&CycleMeasurements::ve>> {};
+
+}  // namespace Pufferfish::Util
+
+namespace Pufferfish::Application {
+
+// The State Segment class is a simple tagged union, since the nanopb functions need access to
+// the underlying memory of each message type. Tags are kept consistent with the union members
+// by the message registry below.
+union StateSegmentUnion {
+  SensorMeasurements sensor_measurements;
+  CycleMeasurements cycle_measurements;
+  Parameters parameters;
+  ParametersRequest parameters_request;
+  AlarmLimits alarm_limits;
+  AlarmLimitsRequest alarm_limits_request;
+  SensorWaveforms sensor_waveforms;
+  Capabilities capabilities;
+  CapabilitiesRequest capabilities_request;
+  BinarySensorMeasurements sensor_measurements_binary;
+  Util::Delta<SensorMeasurements> sensor_measurements_delta;
+  Util::Delta<CycleMeasurements> cycle_measurements_delta;
+  Diagnostics diagnostics;
+  Profile profile;
+};
 
 struct StateSegments {
   // Backend States
@@ -53,8 +103,61 @@ struct StateSegments {
   ParametersRequest parameters_request;
   AlarmLimits alarm_limits;
   AlarmLimitsRequest alarm_limits_request;
+  SensorWaveforms sensor_waveforms;
+  Capabilities capabilities;
+  CapabilitiesRequest capabilities_request;
+  Diagnostics diagnostics;
+  Profile profile;
 };
 
+// Each message type is registered here once, with its protobuf type and the members which hold
+// it in StateSegmentUnion and StateSegments. Message type checking and dispatch, StateSegment
+// setters, and output rate validation are all generated from this registry at compile time.
+template <
+    MessageTypes type,
+    typename Message,
+    Message StateSegmentUnion::*union_member,
+    Message StateSegments::*struct_member>
+using MessageEntry = Util::TypeEntry<type, Message, union_member, struct_member>;
+
+// clang-format off
+using MessageRegistry = Util::TypeRegistry<
+    MessageTypes,
+    MessageEntry<MessageTypes::sensor_measurements, SensorMeasurements,
+        &StateSegmentUnion::sensor_measurements, &StateSegments::sensor_measurements>,
+    MessageEntry<MessageTypes::cycle_measurements, CycleMeasurements,
+        &StateSegmentUnion::cycle_measurements, &StateSegments::cycle_measurements>,
+    MessageEntry<MessageTypes::parameters, Parameters,
+        &StateSegmentUnion::parameters, &StateSegments::parameters>,
+    MessageEntry<MessageTypes::parameters_request, ParametersRequest,
+        &StateSegmentUnion::parameters_request, &StateSegments::parameters_request>,
+    MessageEntry<MessageTypes::alarm_limits, AlarmLimits,
+        &StateSegmentUnion::alarm_limits, &StateSegments::alarm_limits>,
+    MessageEntry<MessageTypes::alarm_limits_request, AlarmLimitsRequest,
+        &StateSegmentUnion::alarm_limits_request, &StateSegments::alarm_limits_request>,
+    MessageEntry<MessageTypes::sensor_waveforms, SensorWaveforms,
+        &StateSegmentUnion::sensor_waveforms, &StateSegments::sensor_waveforms>,
+    MessageEntry<MessageTypes::capabilities, Capabilities,
+        &StateSegmentUnion::capabilities, &StateSegments::capabilities>,
+    MessageEntry<MessageTypes::capabilities_request, CapabilitiesRequest,
+        &StateSegmentUnion::capabilities_request, &StateSegments::capabilities_request>,
+    MessageEntry<MessageTypes::diagnostics, Diagnostics,
+        &StateSegmentUnion::diagnostics, &StateSegments::diagnostics>,
+    MessageEntry<MessageTypes::profile, Profile,
+        &StateSegmentUnion::profile, &StateSegments::profile>,
+    // An alternate encoding of the sensor_measurements state segment
+    Util::TypeEntry<MessageTypes::sensor_measurements_binary, BinarySensorMeasurements,
+        &StateSegmentUnion::sensor_measurements_binary, &StateSegments::sensor_measurements>,
+    // Deltas between successive messages of a state segment, which only the backend protocol
+    // can reconstruct into state segments
+    Util::TypeEntry<MessageTypes::sensor_measurements_delta, Util::Delta<SensorMeasurements>,
+        &StateSegmentUnion::sensor_measurements_delta, nullptr>,
+    Util::TypeEntry<MessageTypes::cycle_measurements_delta, Util::Delta<CycleMeasurements>,
+        &StateSegmentUnion::cycle_measurements_delta, nullptr>>;
+// clang-format on
+
+using StateSegment = Util::TaggedUnion<StateSegmentUnion, MessageTypes, MessageRegistry>;
+
 class States {
  public:
   States() = default;
@@ -65,14 +168,20 @@ class States {
   Parameters &parameters();
   SensorMeasurements &sensor_measurements();
   CycleMeasurements &cycle_measurements();
+  SensorWaveforms &sensor_waveforms();
+  Capabilities &capabilities();
+  [[nodiscard]] const CapabilitiesRequest &capabilities_request() const;
+  Diagnostics &diagnostics();
+  Profile &profile();
 
   InputStatus input(const StateSegment &input);
   OutputStatus output(MessageTypes type, StateSegment &output) const;
+  // Outputs a hash of the current contents of a state segment, which changes whenever the
+  // segment changes, including when it is modified through a reference returned above
+  OutputStatus digest(MessageTypes type, uint32_t &output_digest) const;
 
  private:
-  StateSegments state_segments_;
+  StateSegments state_segments_{};
 };
 
 }  // namespace Pufferfish::Application
-
-#include "States.tpp"
@@ -31,6 +31,22 @@ typedef enum _LogEventCode {
     LogEventCode_screen_locked = 7
 } LogEventCode;
 
+typedef enum _Capability {
+    Capability_no_capabilities = 0,
+    Capability_binary_sensor_measurements = 1,
+    Capability_delta_measurements = 2
+} Capability;
+
+typedef enum _ProfileRegion {
+    ProfileRegion_control_loop = 0,
+    ProfileRegion_backend_receive = 1,
+    ProfileRegion_backend_send = 2,
+    ProfileRegion_sensors = 3,
+    ProfileRegion_backend_uart_isr = 4,
+    ProfileRegion_nonin_oem_uart_isr = 5,
+    ProfileRegion_fdo2_uart_isr = 6
+} ProfileRegion;
+
 /* Struct definitions */
 typedef struct _ActiveLogEvents {
     pb_callback_t id;
@@ -56,6 +72,16 @@ typedef struct _BatteryPower {
     uint32_t power_left;
 } BatteryPower;
 
+typedef struct _Capabilities {
+    uint32_t features;
+    uint32_t baud_rate;
+} Capabilities;
+
+typedef struct _CapabilitiesRequest {
+    uint32_t features;
+    uint32_t max_baud_rate;
+} CapabilitiesRequest;
+
 typedef struct _CycleMeasurements {
     uint32_t time;
     float vt;
@@ -66,6 +92,34 @@ typedef struct _CycleMeasurements {
     float ve;
 } CycleMeasurements;
 
+typedef struct _Diagnostics {
+    uint32_t time;
+    uint32_t rx_bytes;
+    uint32_t rx_messages;
+    uint32_t rx_dropped_bytes;
+    uint32_t rx_frame_length_errors;
+    uint32_t rx_frames_overwritten;
+    uint32_t rx_crcelement_parse_errors;
+    uint32_t rx_crc_errors;
+    uint32_t rx_datagram_parse_errors;
+    uint32_t rx_datagram_length_errors;
+    uint32_t rx_sequence_gaps;
+    uint32_t rx_message_length_errors;
+    uint32_t rx_message_type_errors;
+    uint32_t rx_message_encoding_errors;
+    uint32_t rx_rejected_messages;
+    uint32_t tx_bytes;
+    uint32_t tx_messages;
+    uint32_t tx_message_errors;
+    uint32_t tx_frame_errors;
+    uint32_t tx_stalls;
+    uint32_t tx_dropped_waveform_samples;
+    float rx_message_rate;
+    float rx_byte_rate;
+    float tx_message_rate;
+    float tx_byte_rate;
+} Diagnostics;
+
 typedef struct _ExpectedLogEvent {
     uint32_t id;
 } ExpectedLogEvent;
@@ -108,6 +162,17 @@ typedef struct _Ping {
     uint32_t id;
 } Ping;
 
+typedef struct _Profile {
+    uint32_t time;
+    ProfileRegion region;
+    uint32_t count;
+    uint32_t min_cycles;
+    uint32_t max_cycles;
+    uint32_t mean_cycles;
+    pb_size_t histogram_count;
+    uint32_t histogram[24];
+} Profile;
+
 typedef struct _Range {
     uint32_t lower;
     uint32_t upper;
@@ -127,6 +192,19 @@ typedef struct _SensorMeasurements {
     float spo2;
 } SensorMeasurements;
 
+typedef struct _SensorWaveforms {
+    uint32_t time;
+    uint32_t first_sample;
+    pb_size_t offset_count;
+    uint32_t offset[12];
+    pb_size_t paw_count;
+    float paw[12];
+    pb_size_t flow_count;
+    float flow[12];
+    pb_size_t volume_count;
+    float volume[12];
+} SensorWaveforms;
+
 typedef struct _AlarmLimits {
     uint32_t time;
     bool has_fio2;
@@ -207,6 +285,14 @@ typedef struct _LogEvent {
 #define _LogEventCode_MAX LogEventCode_screen_locked
 #define _LogEventCode_ARRAYSIZE ((LogEventCode)(LogEventCode_screen_locked+1))
 
+#define _Capability_MIN Capability_no_capabilities
+#define _Capability_MAX Capability_delta_measurements
+#define _Capability_ARRAYSIZE ((Capability)(Capability_delta_measurements+1))
+
+#define _ProfileRegion_MIN ProfileRegion_control_loop
+#define _ProfileRegion_MAX ProfileRegion_fdo2_uart_isr
+#define _ProfileRegion_ARRAYSIZE ((ProfileRegion)(ProfileRegion_fdo2_uart_isr+1))
+
 
 #ifdef __cplusplus
 extern "C" {
@@ -217,6 +303,7 @@ extern "C" {
 #define AlarmLimits_init_default                 {0, false, Range_init_default, false, Range_init_default, false, Range_init_default, false, Range_init_default, false, Range_init_default, false, Range_init_default, false, Range_init_default, false, Range_init_default, false, Range_init_default, false, Range_init_default, false, Range_init_default, false, Range_init_default, false, Range_init_default}
 #define AlarmLimitsRequest_init_default          {0, false, Range_init_default, false, Range_init_default, false, Range_init_default, false, Range_init_default, false, Range_init_default, false, Range_init_default, false, Range_init_default, false, Range_init_default, false, Range_init_default, false, Range_init_default, false, Range_init_default, false, Range_init_default, false, Range_init_default}
 #define SensorMeasurements_init_default          {0, 0, 0, 0, 0, 0, 0}
+#define SensorWaveforms_init_default             {0, 0, 0, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, 0, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, 0, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, 0, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}}
 #define CycleMeasurements_init_default           {0, 0, 0, 0, 0, 0, 0}
 #define Parameters_init_default                  {0, _VentilationMode_MIN, 0, 0, 0, 0, 0, 0, 0, 0}
 #define ParametersRequest_init_default           {0, _VentilationMode_MIN, 0, 0, 0, 0, 0, 0, 0, 0}
@@ -230,10 +317,15 @@ extern "C" {
 #define ScreenStatus_init_default                {0}
 #define AlarmMute_init_default                   {0, 0}
 #define AlarmMuteRequest_init_default            {0, 0}
+#define Capabilities_init_default                {0, 0}
+#define CapabilitiesRequest_init_default         {0, 0}
+#define Diagnostics_init_default         {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}
+#define Profile_init_default                     {0, _ProfileRegion_MIN, 0, 0, 0, 0, 0, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}}
 #define Range_init_zero                          {0, 0}
 #define AlarmLimits_init_zero                    {0, false, Range_init_zero, false, Range_init_zero, false, Range_init_zero, false, Range_init_zero, false, Range_init_zero, false, Range_init_zero, false, Range_init_zero, false, Range_init_zero, false, Range_init_zero, false, Range_init_zero, false, Range_init_zero, false, Range_init_zero, false, Range_init_zero}
 #define AlarmLimitsRequest_init_zero             {0, false, Range_init_zero, false, Range_init_zero, false, Range_init_zero, false, Range_init_zero, false, Range_init_zero, false, Range_init_zero, false, Range_init_zero, false, Range_init_zero, false, Range_init_zero, false, Range_init_zero, false, Range_init_zero, false, Range_init_zero, false, Range_init_zero}
 #define SensorMeasurements_init_zero             {0, 0, 0, 0, 0, 0, 0}
+#define SensorWaveforms_init_zero                {0, 0, 0, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, 0, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, 0, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, 0, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}}
 #define CycleMeasurements_init_zero              {0, 0, 0, 0, 0, 0, 0}
 #define Parameters_init_zero                     {0, _VentilationMode_MIN, 0, 0, 0, 0, 0, 0, 0, 0}
 #define ParametersRequest_init_zero              {0, _VentilationMode_MIN, 0, 0, 0, 0, 0, 0, 0, 0}
@@ -247,6 +339,10 @@ extern "C" {
 #define ScreenStatus_init_zero                   {0}
 #define AlarmMute_init_zero                      {0, 0}
 #define AlarmMuteRequest_init_zero               {0, 0}
+#define Capabilities_init_zero                   {0, 0}
+#define CapabilitiesRequest_init_zero            {0, 0}
+#define Diagnostics_init_zero            {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}
+#define Profile_init_zero                        {0, _ProfileRegion_MIN, 0, 0, 0, 0, 0, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}}
 
 /* Field tags (for use in manual encoding/decoding) */
 #define ActiveLogEvents_id_tag                   1
@@ -257,6 +353,10 @@ extern "C" {
 #define Announcement_time_tag                    1
 #define Announcement_announcement_tag            2
 #define BatteryPower_power_left_tag              1
+#define Capabilities_features_tag                1
+#define Capabilities_baud_rate_tag               2
+#define CapabilitiesRequest_features_tag         1
+#define CapabilitiesRequest_max_baud_rate_tag    2
 #define CycleMeasurements_time_tag               1
 #define CycleMeasurements_vt_tag                 2
 #define CycleMeasurements_rr_tag                 3
@@ -264,6 +364,38 @@ extern "C" {
 #define CycleMeasurements_pip_tag                5
 #define CycleMeasurements_ip_tag                 6
 #define CycleMeasurements_ve_tag                 7
+#define Diagnostics_time_tag                     1
+#define Diagnostics_rx_bytes_tag                 2
+#define Diagnostics_rx_messages_tag              3
+#define Diagnostics_rx_dropped_bytes_tag         4
+#define Diagnostics_rx_frame_length_errors_tag   5
+#define Diagnostics_rx_frames_overwritten_tag    6
+#define Diagnostics_rx_crcelement_parse_errors_tag 7
+#define Diagnostics_rx_crc_errors_tag            8
+#define Diagnostics_rx_datagram_parse_errors_tag 9
+#define Diagnostics_rx_datagram_length_errors_tag 10
+#define Diagnostics_rx_sequence_gaps_tag         11
+#define Diagnostics_rx_message_length_errors_tag 12
+#define Diagnostics_rx_message_type_errors_tag   13
+#define Diagnostics_rx_message_encoding_errors_tag 14
+#define Diagnostics_rx_rejected_messages_tag     15
+#define Diagnostics_tx_bytes_tag                 16
+#define Diagnostics_tx_messages_tag              17
+#define Diagnostics_tx_message_errors_tag        18
+#define Diagnostics_tx_frame_errors_tag          19
+#define Diagnostics_tx_stalls_tag                20
+#define Diagnostics_tx_dropped_waveform_samples_tag 25
+#define Diagnostics_rx_message_rate_tag          21
+#define Diagnostics_rx_byte_rate_tag             22
+#define Diagnostics_tx_message_rate_tag          23
+#define Diagnostics_tx_byte_rate_tag             24
+#define Profile_time_tag                         1
+#define Profile_region_tag                       2
+#define Profile_count_tag                        3
+#define Profile_min_cycles_tag                   4
+#define Profile_max_cycles_tag                   5
+#define Profile_mean_cycles_tag                  6
+#define Profile_histogram_tag                    7
 #define ExpectedLogEvent_id_tag                  1
 #define NextLogEvents_next_expected_tag          1
 #define NextLogEvents_total_tag                  2
@@ -301,6 +433,12 @@ extern "C" {
 #define SensorMeasurements_volume_tag            5
 #define SensorMeasurements_fio2_tag              6
 #define SensorMeasurements_spo2_tag              7
+#define SensorWaveforms_time_tag                 1
+#define SensorWaveforms_first_sample_tag         2
+#define SensorWaveforms_offset_tag               3
+#define SensorWaveforms_paw_tag                  4
+#define SensorWaveforms_flow_tag                 5
+#define SensorWaveforms_volume_tag               6
 #define AlarmLimits_time_tag                     1
 #define AlarmLimits_fio2_tag                     2
 #define AlarmLimits_spo2_tag                     3
@@ -416,6 +554,16 @@ X(a, STATIC,   SINGULAR, FLOAT,    spo2,              7)
 #define SensorMeasurements_CALLBACK NULL
 #define SensorMeasurements_DEFAULT NULL
 
+#define SensorWaveforms_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   time,              1) \
+X(a, STATIC,   SINGULAR, UINT32,   first_sample,      2) \
+X(a, STATIC,   REPEATED, UINT32,   offset,            3) \
+X(a, STATIC,   REPEATED, FLOAT,    paw,               4) \
+X(a, STATIC,   REPEATED, FLOAT,    flow,              5) \
+X(a, STATIC,   REPEATED, FLOAT,    volume,            6)
+#define SensorWaveforms_CALLBACK NULL
+#define SensorWaveforms_DEFAULT NULL
+
 #define CycleMeasurements_FIELDLIST(X, a) \
 X(a, STATIC,   SINGULAR, UINT32,   time,              1) \
 X(a, STATIC,   SINGULAR, FLOAT,    vt,                2) \
@@ -519,10 +667,63 @@ X(a, STATIC,   SINGULAR, FLOAT,    remaining,         2)
 #define AlarmMuteRequest_CALLBACK NULL
 #define AlarmMuteRequest_DEFAULT NULL
 
+#define Capabilities_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   features,          1) \
+X(a, STATIC,   SINGULAR, UINT32,   baud_rate,         2)
+#define Capabilities_CALLBACK NULL
+#define Capabilities_DEFAULT NULL
+
+#define CapabilitiesRequest_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   features,          1) \
+X(a, STATIC,   SINGULAR, UINT32,   max_baud_rate,     2)
+#define CapabilitiesRequest_CALLBACK NULL
+#define CapabilitiesRequest_DEFAULT NULL
+
+#define Diagnostics_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   time,              1) \
+X(a, STATIC,   SINGULAR, UINT32,   rx_bytes,          2) \
+X(a, STATIC,   SINGULAR, UINT32,   rx_messages,       3) \
+X(a, STATIC,   SINGULAR, UINT32,   rx_dropped_bytes,   4) \
+X(a, STATIC,   SINGULAR, UINT32,   rx_frame_length_errors,   5) \
+X(a, STATIC,   SINGULAR, UINT32,   rx_frames_overwritten,   6) \
+X(a, STATIC,   SINGULAR, UINT32,   rx_crcelement_parse_errors,   7) \
+X(a, STATIC,   SINGULAR, UINT32,   rx_crc_errors,     8) \
+X(a, STATIC,   SINGULAR, UINT32,   rx_datagram_parse_errors,   9) \
+X(a, STATIC,   SINGULAR, UINT32,   rx_datagram_length_errors,  10) \
+X(a, STATIC,   SINGULAR, UINT32,   rx_sequence_gaps,  11) \
+X(a, STATIC,   SINGULAR, UINT32,   rx_message_length_errors,  12) \
+X(a, STATIC,   SINGULAR, UINT32,   rx_message_type_errors,  13) \
+X(a, STATIC,   SINGULAR, UINT32,   rx_message_encoding_errors,  14) \
+X(a, STATIC,   SINGULAR, UINT32,   rx_rejected_messages,  15) \
+X(a, STATIC,   SINGULAR, UINT32,   tx_bytes,         16) \
+X(a, STATIC,   SINGULAR, UINT32,   tx_messages,      17) \
+X(a, STATIC,   SINGULAR, UINT32,   tx_message_errors,  18) \
+X(a, STATIC,   SINGULAR, UINT32,   tx_frame_errors,  19) \
+X(a, STATIC,   SINGULAR, UINT32,   tx_stalls,        20) \
+X(a, STATIC,   SINGULAR, UINT32,   tx_dropped_waveform_samples,  25) \
+X(a, STATIC,   SINGULAR, FLOAT,    rx_message_rate,  21) \
+X(a, STATIC,   SINGULAR, FLOAT,    rx_byte_rate,     22) \
+X(a, STATIC,   SINGULAR, FLOAT,    tx_message_rate,  23) \
+X(a, STATIC,   SINGULAR, FLOAT,    tx_byte_rate,     24)
+#define Diagnostics_CALLBACK NULL
+#define Diagnostics_DEFAULT NULL
+
+#define Profile_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   time,              1) \
+X(a, STATIC,   SINGULAR, UENUM,    region,            2) \
+X(a, STATIC,   SINGULAR, UINT32,   count,             3) \
+X(a, STATIC,   SINGULAR, UINT32,   min_cycles,        4) \
+X(a, STATIC,   SINGULAR, UINT32,   max_cycles,        5) \
+X(a, STATIC,   SINGULAR, UINT32,   mean_cycles,       6) \
+X(a, STATIC,   REPEATED, UINT32,   histogram,         7)
+#define Profile_CALLBACK NULL
+#define Profile_DEFAULT NULL
+
 extern const pb_msgdesc_t Range_msg;
 extern const pb_msgdesc_t AlarmLimits_msg;
 extern const pb_msgdesc_t AlarmLimitsRequest_msg;
 extern const pb_msgdesc_t SensorMeasurements_msg;
+extern const pb_msgdesc_t SensorWaveforms_msg;
 extern const pb_msgdesc_t CycleMeasurements_msg;
 extern const pb_msgdesc_t Parameters_msg;
 extern const pb_msgdesc_t ParametersRequest_msg;
@@ -536,12 +737,17 @@ extern const pb_msgdesc_t BatteryPower_msg;
 extern const pb_msgdesc_t ScreenStatus_msg;
 extern const pb_msgdesc_t AlarmMute_msg;
 extern const pb_msgdesc_t AlarmMuteRequest_msg;
+extern const pb_msgdesc_t Capabilities_msg;
+extern const pb_msgdesc_t CapabilitiesRequest_msg;
+extern const pb_msgdesc_t Diagnostics_msg;
+extern const pb_msgdesc_t Profile_msg;
 
 /* Defines for backwards compatibility with code written before nanopb-0.4.0 */
 #define Range_fields &Range_msg
 #define AlarmLimits_fields &AlarmLimits_msg
 #define AlarmLimitsRequest_fields &AlarmLimitsRequest_msg
 #define SensorMeasurements_fields &SensorMeasurements_msg
+#define SensorWaveforms_fields &SensorWaveforms_msg
 #define CycleMeasurements_fields &CycleMeasurements_msg
 #define Parameters_fields &Parameters_msg
 #define ParametersRequest_fields &ParametersRequest_msg
@@ -555,12 +761,17 @@ extern const pb_msgdesc_t AlarmMuteRequest_msg;
 #define ScreenStatus_fields &ScreenStatus_msg
 #define AlarmMute_fields &AlarmMute_msg
 #define AlarmMuteRequest_fields &AlarmMuteRequest_msg
+#define Capabilities_fields &Capabilities_msg
+#define CapabilitiesRequest_fields &CapabilitiesRequest_msg
+#define Diagnostics_fields &Diagnostics_msg
+#define Profile_fields &Profile_msg
 
 /* Maximum encoded size of messages (where known) */
 #define Range_size                               12
 #define AlarmLimits_size                         188
 #define AlarmLimitsRequest_size                  188
 #define SensorMeasurements_size                  37
+#define SensorWaveforms_size                     224
 #define CycleMeasurements_size                   36
 #define Parameters_size                          45
 #define ParametersRequest_size                   45
@@ -574,6 +785,10 @@ extern const pb_msgdesc_t AlarmMuteRequest_msg;
 #define ScreenStatus_size                        2
 #define AlarmMute_size                           7
 #define AlarmMuteRequest_size                    7
+#define Capabilities_size                        12
+#define CapabilitiesRequest_size                 12
+#define Diagnostics_size                         156
+#define Profile_size                             154
 
 #ifdef __cplusplus
 } /* extern "C" */
@@ -611,6 +826,13 @@ struct MessageDescriptor<SensorMeasurements> {
     }
 };
 template <>
+struct MessageDescriptor<SensorWaveforms> {
+    static PB_INLINE_CONSTEXPR const pb_size_t fields_array_length = 6;
+    static PB_INLINE_CONSTEXPR const pb_msgdesc_t* fields() {
+        return &SensorWaveforms_msg;
+    }
+};
+template <>
 struct MessageDescriptor<CycleMeasurements> {
     static PB_INLINE_CONSTEXPR const pb_size_t fields_array_length = 7;
     static PB_INLINE_CONSTEXPR const pb_msgdesc_t* fields() {
@@ -701,6 +923,34 @@ struct MessageDescriptor<AlarmMuteRequest> {
         return &AlarmMuteRequest_msg;
     }
 };
+template <>
+struct MessageDescriptor<Capabilities> {
+    static PB_INLINE_CONSTEXPR const pb_size_t fields_array_length = 1;
+    static PB_INLINE_CONSTEXPR const pb_msgdesc_t* fields() {
+        return &Capabilities_msg;
+    }
+};
+template <>
+struct MessageDescriptor<CapabilitiesRequest> {
+    static PB_INLINE_CONSTEXPR const pb_size_t fields_array_length = 1;
+    static PB_INLINE_CONSTEXPR const pb_msgdesc_t* fields() {
+        return &CapabilitiesRequest_msg;
+    }
+};
+template <>
+struct MessageDescriptor<Diagnostics> {
+    static PB_INLINE_CONSTEXPR const pb_size_t fields_array_length = 25;
+    static PB_INLINE_CONSTEXPR const pb_msgdesc_t* fields() {
+        return &Diagnostics_msg;
+    }
+};
+template <>
+struct MessageDescriptor<Profile> {
+    static PB_INLINE_CONSTEXPR const pb_size_t fields_array_length = 7;
+    static PB_INLINE_CONSTEXPR const pb_msgdesc_t* fields() {
+        return &Profile_msg;
+    }
+};
 }  // namespace nanopb
 
 #endif  /* __cplusplus */
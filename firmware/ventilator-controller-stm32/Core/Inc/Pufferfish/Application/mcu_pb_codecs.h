@@ -0,0 +1,1230 @@
+/* Automatically generated by generate_mcu_codecs.py from mcu_pb.h */
+/* Straight-line protobuf encoders and decoders, wire-compatible with nanopb */
+
+#pragma once
+
+#include "Pufferfish/Application/mcu_pb.h"
+#include "Pufferfish/Util/ProtobufWire.h"
+
+namespace Pufferfish::Util {
+
+template <>
+struct ProtobufCodec<Range> {
+  static constexpr bool generated = true;
+  static constexpr size_t max_size = 12;
+
+  static size_t encoded_size(const Range &message) {
+    return protobuf_uint32_size(1, message.lower) +
+           protobuf_uint32_size(2, message.upper);
+  }
+
+  static bool encode(const Range &message, ProtobufWriter &writer) {
+    return writer.write_uint32(1, message.lower) &&
+           writer.write_uint32(2, message.upper);
+  }
+
+  static bool decode(ProtobufReader &reader, Range &message) {
+    uint32_t field = 0;
+    ProtobufWireType wire_type = ProtobufWireType::varint;
+    while (!reader.empty()) {
+      if (!reader.read_tag(field, wire_type)) {
+        return false;
+      }
+      bool ok = false;
+      switch (field) {
+        case 1:
+          ok = reader.read_uint32(wire_type, message.lower);
+          break;
+        case 2:
+          ok = reader.read_uint32(wire_type, message.upper);
+          break;
+        default:
+          ok = reader.skip(wire_type);
+      }
+      if (!ok) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+template <>
+struct ProtobufCodec<AlarmLimits> {
+  static constexpr bool generated = true;
+  static constexpr size_t max_size = 188;
+
+  static size_t encoded_size(const AlarmLimits &message) {
+    return protobuf_uint32_size(1, message.time) +
+           protobuf_message_size(2, message.has_fio2, message.fio2) +
+           protobuf_message_size(3, message.has_spo2, message.spo2) +
+           protobuf_message_size(4, message.has_rr, message.rr) +
+           protobuf_message_size(5, message.has_pip, message.pip) +
+           protobuf_message_size(6, message.has_peep, message.peep) +
+           protobuf_message_size(7, message.has_ip_above_peep, message.ip_above_peep) +
+           protobuf_message_size(8, message.has_insp_time, message.insp_time) +
+           protobuf_message_size(9, message.has_paw, message.paw) +
+           protobuf_message_size(10, message.has_mve, message.mve) +
+           protobuf_message_size(11, message.has_tv, message.tv) +
+           protobuf_message_size(12, message.has_etco2, message.etco2) +
+           protobuf_message_size(13, message.has_flow, message.flow) +
+           protobuf_message_size(14, message.has_apnea, message.apnea);
+  }
+
+  static bool encode(const AlarmLimits &message, ProtobufWriter &writer) {
+    return writer.write_uint32(1, message.time) &&
+           writer.write_message(2, message.has_fio2, message.fio2) &&
+           writer.write_message(3, message.has_spo2, message.spo2) &&
+           writer.write_message(4, message.has_rr, message.rr) &&
+           writer.write_message(5, message.has_pip, message.pip) &&
+           writer.write_message(6, message.has_peep, message.peep) &&
+           writer.write_message(7, message.has_ip_above_peep, message.ip_above_peep) &&
+           writer.write_message(8, message.has_insp_time, message.insp_time) &&
+           writer.write_message(9, message.has_paw, message.paw) &&
+           writer.write_message(10, message.has_mve, message.mve) &&
+           writer.write_message(11, message.has_tv, message.tv) &&
+           writer.write_message(12, message.has_etco2, message.etco2) &&
+           writer.write_message(13, message.has_flow, message.flow) &&
+           writer.write_message(14, message.has_apnea, message.apnea);
+  }
+
+  static bool decode(ProtobufReader &reader, AlarmLimits &message) {
+    uint32_t field = 0;
+    ProtobufWireType wire_type = ProtobufWireType::varint;
+    while (!reader.empty()) {
+      if (!reader.read_tag(field, wire_type)) {
+        return false;
+      }
+      bool ok = false;
+      switch (field) {
+        case 1:
+          ok = reader.read_uint32(wire_type, message.time);
+          break;
+        case 2:
+          ok = reader.read_message(wire_type, message.has_fio2, message.fio2);
+          break;
+        case 3:
+          ok = reader.read_message(wire_type, message.has_spo2, message.spo2);
+          break;
+        case 4:
+          ok = reader.read_message(wire_type, message.has_rr, message.rr);
+          break;
+        case 5:
+          ok = reader.read_message(wire_type, message.has_pip, message.pip);
+          break;
+        case 6:
+          ok = reader.read_message(wire_type, message.has_peep, message.peep);
+          break;
+        case 7:
+          ok = reader.read_message(wire_type, message.has_ip_above_peep, message.ip_above_peep);
+          break;
+        case 8:
+          ok = reader.read_message(wire_type, message.has_insp_time, message.insp_time);
+          break;
+        case 9:
+          ok = reader.read_message(wire_type, message.has_paw, message.paw);
+          break;
+        case 10:
+          ok = reader.read_message(wire_type, message.has_mve, message.mve);
+          break;
+        case 11:
+          ok = reader.read_message(wire_type, message.has_tv, message.tv);
+          break;
+        case 12:
+          ok = reader.read_message(wire_type, message.has_etco2, message.etco2);
+          break;
+        case 13:
+          ok = reader.read_message(wire_type, message.has_flow, message.flow);
+          break;
+        case 14:
+          ok = reader.read_message(wire_type, message.has_apnea, message.apnea);
+          break;
+        default:
+          ok = reader.skip(wire_type);
+      }
+      if (!ok) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+template <>
+struct ProtobufCodec<AlarmLimitsRequest> {
+  static constexpr bool generated = true;
+  static constexpr size_t max_size = 188;
+
+  static size_t encoded_size(const AlarmLimitsRequest &message) {
+    return protobuf_uint32_size(1, message.time) +
+           protobuf_message_size(2, message.has_fio2, message.fio2) +
+           protobuf_message_size(3, message.has_spo2, message.spo2) +
+           protobuf_message_size(4, message.has_rr, message.rr) +
+           protobuf_message_size(5, message.has_pip, message.pip) +
+           protobuf_message_size(6, message.has_peep, message.peep) +
+           protobuf_message_size(7, message.has_ip_above_peep, message.ip_above_peep) +
+           protobuf_message_size(8, message.has_insp_time, message.insp_time) +
+           protobuf_message_size(9, message.has_paw, message.paw) +
+           protobuf_message_size(10, message.has_mve, message.mve) +
+           protobuf_message_size(11, message.has_tv, message.tv) +
+           protobuf_message_size(12, message.has_etco2, message.etco2) +
+           protobuf_message_size(13, message.has_flow, message.flow) +
+           protobuf_message_size(14, message.has_apnea, message.apnea);
+  }
+
+  static bool encode(const AlarmLimitsRequest &message, ProtobufWriter &writer) {
+    return writer.write_uint32(1, message.time) &&
+           writer.write_message(2, message.has_fio2, message.fio2) &&
+           writer.write_message(3, message.has_spo2, message.spo2) &&
+           writer.write_message(4, message.has_rr, message.rr) &&
+           writer.write_message(5, message.has_pip, message.pip) &&
+           writer.write_message(6, message.has_peep, message.peep) &&
+           writer.write_message(7, message.has_ip_above_peep, message.ip_above_peep) &&
+           writer.write_message(8, message.has_insp_time, message.insp_time) &&
+           writer.write_message(9, message.has_paw, message.paw) &&
+           writer.write_message(10, message.has_mve, message.mve) &&
+           writer.write_message(11, message.has_tv, message.tv) &&
+           writer.write_message(12, message.has_etco2, message.etco2) &&
+           writer.write_message(13, message.has_flow, message.flow) &&
+           writer.write_message(14, message.has_apnea, message.apnea);
+  }
+
+  static bool decode(ProtobufReader &reader, AlarmLimitsRequest &message) {
+    uint32_t field = 0;
+    ProtobufWireType wire_type = ProtobufWireType::varint;
+    while (!reader.empty()) {
+      if (!reader.read_tag(field, wire_type)) {
+        return false;
+      }
+      bool ok = false;
+      switch (field) {
+        case 1:
+          ok = reader.read_uint32(wire_type, message.time);
+          break;
+        case 2:
+          ok = reader.read_message(wire_type, message.has_fio2, message.fio2);
+          break;
+        case 3:
+          ok = reader.read_message(wire_type, message.has_spo2, message.spo2);
+          break;
+        case 4:
+          ok = reader.read_message(wire_type, message.has_rr, message.rr);
+          break;
+        case 5:
+          ok = reader.read_message(wire_type, message.has_pip, message.pip);
+          break;
+        case 6:
+          ok = reader.read_message(wire_type, message.has_peep, message.peep);
+          break;
+        case 7:
+          ok = reader.read_message(wire_type, message.has_ip_above_peep, message.ip_above_peep);
+          break;
+        case 8:
+          ok = reader.read_message(wire_type, message.has_insp_time, message.insp_time);
+          break;
+        case 9:
+          ok = reader.read_message(wire_type, message.has_paw, message.paw);
+          break;
+        case 10:
+          ok = reader.read_message(wire_type, message.has_mve, message.mve);
+          break;
+        case 11:
+          ok = reader.read_message(wire_type, message.has_tv, message.tv);
+          break;
+        case 12:
+          ok = reader.read_message(wire_type, message.has_etco2, message.etco2);
+          break;
+        case 13:
+          ok = reader.read_message(wire_type, message.has_flow, message.flow);
+          break;
+        case 14:
+          ok = reader.read_message(wire_type, message.has_apnea, message.apnea);
+          break;
+        default:
+          ok = reader.skip(wire_type);
+      }
+      if (!ok) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+template <>
+struct ProtobufCodec<SensorMeasurements> {
+  static constexpr bool generated = true;
+  static constexpr size_t max_size = 37;
+
+  static size_t encoded_size(const SensorMeasurements &message) {
+    return protobuf_uint32_size(1, message.time) +
+           protobuf_uint32_size(2, message.cycle) +
+           protobuf_float_size(3, message.paw) +
+           protobuf_float_size(4, message.flow) +
+           protobuf_float_size(5, message.volume) +
+           protobuf_float_size(6, message.fio2) +
+           protobuf_float_size(7, message.spo2);
+  }
+
+  static bool encode(const SensorMeasurements &message, ProtobufWriter &writer) {
+    return writer.write_uint32(1, message.time) &&
+           writer.write_uint32(2, message.cycle) &&
+           writer.write_float(3, message.paw) &&
+           writer.write_float(4, message.flow) &&
+           writer.write_float(5, message.volume) &&
+           writer.write_float(6, message.fio2) &&
+           writer.write_float(7, message.spo2);
+  }
+
+  static bool decode(ProtobufReader &reader, SensorMeasurements &message) {
+    uint32_t field = 0;
+    ProtobufWireType wire_type = ProtobufWireType::varint;
+    while (!reader.empty()) {
+      if (!reader.read_tag(field, wire_type)) {
+        return false;
+      }
+      bool ok = false;
+      switch (field) {
+        case 1:
+          ok = reader.read_uint32(wire_type, message.time);
+          break;
+        case 2:
+          ok = reader.read_uint32(wire_type, message.cycle);
+          break;
+        case 3:
+          ok = reader.read_float(wire_type, message.paw);
+          break;
+        case 4:
+          ok = reader.read_float(wire_type, message.flow);
+          break;
+        case 5:
+          ok = reader.read_float(wire_type, message.volume);
+          break;
+        case 6:
+          ok = reader.read_float(wire_type, message.fio2);
+          break;
+        case 7:
+          ok = reader.read_float(wire_type, message.spo2);
+          break;
+        default:
+          ok = reader.skip(wire_type);
+      }
+      if (!ok) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+template <>
+struct ProtobufCodec<SensorWaveforms> {
+  static constexpr bool generated = true;
+  static constexpr size_t max_size = 224;
+
+  static size_t encoded_size(const SensorWaveforms &message) {
+    return protobuf_uint32_size(1, message.time) +
+           protobuf_uint32_size(2, message.first_sample) +
+           protobuf_packed_uint32_size(3, message.offset, message.offset_count) +
+           protobuf_packed_float_size(4, message.paw_count) +
+           protobuf_packed_float_size(5, message.flow_count) +
+           protobuf_packed_float_size(6, message.volume_count);
+  }
+
+  static bool encode(const SensorWaveforms &message, ProtobufWriter &writer) {
+    return writer.write_uint32(1, message.time) &&
+           writer.write_uint32(2, message.first_sample) &&
+           writer.write_packed_uint32(
+               3, message.offset, message.offset_count, pb_arraysize(SensorWaveforms, offset)) &&
+           writer.write_packed_float(
+               4, message.paw, message.paw_count, pb_arraysize(SensorWaveforms, paw)) &&
+           writer.write_packed_float(
+               5, message.flow, message.flow_count, pb_arraysize(SensorWaveforms, flow)) &&
+           writer.write_packed_float(
+               6, message.volume, message.volume_count, pb_arraysize(SensorWaveforms, volume));
+  }
+
+  static bool decode(ProtobufReader &reader, SensorWaveforms &message) {
+    uint32_t field = 0;
+    ProtobufWireType wire_type = ProtobufWireType::varint;
+    while (!reader.empty()) {
+      if (!reader.read_tag(field, wire_type)) {
+        return false;
+      }
+      bool ok = false;
+      switch (field) {
+        case 1:
+          ok = reader.read_uint32(wire_type, message.time);
+          break;
+        case 2:
+          ok = reader.read_uint32(wire_type, message.first_sample);
+          break;
+        case 3:
+          ok = reader.read_repeated_uint32(
+              wire_type,
+              message.offset,
+              message.offset_count,
+              pb_arraysize(SensorWaveforms, offset));
+          break;
+        case 4:
+          ok = reader.read_repeated_float(
+              wire_type,
+              message.paw,
+              message.paw_count,
+              pb_arraysize(SensorWaveforms, paw));
+          break;
+        case 5:
+          ok = reader.read_repeated_float(
+              wire_type,
+              message.flow,
+              message.flow_count,
+              pb_arraysize(SensorWaveforms, flow));
+          break;
+        case 6:
+          ok = reader.read_repeated_float(
+              wire_type,
+              message.volume,
+              message.volume_count,
+              pb_arraysize(SensorWaveforms, volume));
+          break;
+        default:
+          ok = reader.skip(wire_type);
+      }
+      if (!ok) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+template <>
+struct ProtobufCodec<CycleMeasurements> {
+  static constexpr bool generated = true;
+  static constexpr size_t max_size = 36;
+
+  static size_t encoded_size(const CycleMeasurements &message) {
+    return protobuf_uint32_size(1, message.time) +
+           protobuf_float_size(2, message.vt) +
+           protobuf_float_size(3, message.rr) +
+           protobuf_float_size(4, message.peep) +
+           protobuf_float_size(5, message.pip) +
+           protobuf_float_size(6, message.ip) +
+           protobuf_float_size(7, message.ve);
+  }
+
+  static bool encode(const CycleMeasurements &message, ProtobufWriter &writer) {
+    return writer.write_uint32(1, message.time) &&
+           writer.write_float(2, message.vt) &&
+           writer.write_float(3, message.rr) &&
+           writer.write_float(4, message.peep) &&
+           writer.write_float(5, message.pip) &&
+           writer.write_float(6, message.ip) &&
+           writer.write_float(7, message.ve);
+  }
+
+  static bool decode(ProtobufReader &reader, CycleMeasurements &message) {
+    uint32_t field = 0;
+    ProtobufWireType wire_type = ProtobufWireType::varint;
+    while (!reader.empty()) {
+      if (!reader.read_tag(field, wire_type)) {
+        return false;
+      }
+      bool ok = false;
+      switch (field) {
+        case 1:
+          ok = reader.read_uint32(wire_type, message.time);
+          break;
+        case 2:
+          ok = reader.read_float(wire_type, message.vt);
+          break;
+        case 3:
+          ok = reader.read_float(wire_type, message.rr);
+          break;
+        case 4:
+          ok = reader.read_float(wire_type, message.peep);
+          break;
+        case 5:
+          ok = reader.read_float(wire_type, message.pip);
+          break;
+        case 6:
+          ok = reader.read_float(wire_type, message.ip);
+          break;
+        case 7:
+          ok = reader.read_float(wire_type, message.ve);
+          break;
+        default:
+          ok = reader.skip(wire_type);
+      }
+      if (!ok) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+template <>
+struct ProtobufCodec<Parameters> {
+  static constexpr bool generated = true;
+  static constexpr size_t max_size = 45;
+
+  static size_t encoded_size(const Parameters &message) {
+    return protobuf_uint32_size(1, message.time) +
+           protobuf_uint32_size(2, static_cast<uint32_t>(message.mode)) +
+           protobuf_float_size(3, message.pip) +
+           protobuf_float_size(4, message.peep) +
+           protobuf_float_size(5, message.vt) +
+           protobuf_float_size(6, message.rr) +
+           protobuf_float_size(7, message.ie) +
+           protobuf_float_size(8, message.fio2) +
+           protobuf_float_size(9, message.flow) +
+           protobuf_bool_size(10, message.ventilating);
+  }
+
+  static bool encode(const Parameters &message, ProtobufWriter &writer) {
+    return writer.write_uint32(1, message.time) &&
+           writer.write_uint32(2, static_cast<uint32_t>(message.mode)) &&
+           writer.write_float(3, message.pip) &&
+           writer.write_float(4, message.peep) &&
+           writer.write_float(5, message.vt) &&
+           writer.write_float(6, message.rr) &&
+           writer.write_float(7, message.ie) &&
+           writer.write_float(8, message.fio2) &&
+           writer.write_float(9, message.flow) &&
+           writer.write_bool(10, message.ventilating);
+  }
+
+  static bool decode(ProtobufReader &reader, Parameters &message) {
+    uint32_t field = 0;
+    ProtobufWireType wire_type = ProtobufWireType::varint;
+    while (!reader.empty()) {
+      if (!reader.read_tag(field, wire_type)) {
+        return false;
+      }
+      bool ok = false;
+      switch (field) {
+        case 1:
+          ok = reader.read_uint32(wire_type, message.time);
+          break;
+        case 2:
+          ok = reader.read_enum(wire_type, message.mode);
+          break;
+        case 3:
+          ok = reader.read_float(wire_type, message.pip);
+          break;
+        case 4:
+          ok = reader.read_float(wire_type, message.peep);
+          break;
+        case 5:
+          ok = reader.read_float(wire_type, message.vt);
+          break;
+        case 6:
+          ok = reader.read_float(wire_type, message.rr);
+          break;
+        case 7:
+          ok = reader.read_float(wire_type, message.ie);
+          break;
+        case 8:
+          ok = reader.read_float(wire_type, message.fio2);
+          break;
+        case 9:
+          ok = reader.read_float(wire_type, message.flow);
+          break;
+        case 10:
+          ok = reader.read_bool(wire_type, message.ventilating);
+          break;
+        default:
+          ok = reader.skip(wire_type);
+      }
+      if (!ok) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+template <>
+struct ProtobufCodec<ParametersRequest> {
+  static constexpr bool generated = true;
+  static constexpr size_t max_size = 45;
+
+  static size_t encoded_size(const ParametersRequest &message) {
+    return protobuf_uint32_size(1, message.time) +
+           protobuf_uint32_size(2, static_cast<uint32_t>(message.mode)) +
+           protobuf_float_size(3, message.pip) +
+           protobuf_float_size(4, message.peep) +
+           protobuf_float_size(5, message.vt) +
+           protobuf_float_size(6, message.rr) +
+           protobuf_float_size(7, message.ie) +
+           protobuf_float_size(8, message.fio2) +
+           protobuf_float_size(9, message.flow) +
+           protobuf_bool_size(10, message.ventilating);
+  }
+
+  static bool encode(const ParametersRequest &message, ProtobufWriter &writer) {
+    return writer.write_uint32(1, message.time) &&
+           writer.write_uint32(2, static_cast<uint32_t>(message.mode)) &&
+           writer.write_float(3, message.pip) &&
+           writer.write_float(4, message.peep) &&
+           writer.write_float(5, message.vt) &&
+           writer.write_float(6, message.rr) &&
+           writer.write_float(7, message.ie) &&
+           writer.write_float(8, message.fio2) &&
+           writer.write_float(9, message.flow) &&
+           writer.write_bool(10, message.ventilating);
+  }
+
+  static bool decode(ProtobufReader &reader, ParametersRequest &message) {
+    uint32_t field = 0;
+    ProtobufWireType wire_type = ProtobufWireType::varint;
+    while (!reader.empty()) {
+      if (!reader.read_tag(field, wire_type)) {
+        return false;
+      }
+      bool ok = false;
+      switch (field) {
+        case 1:
+          ok = reader.read_uint32(wire_type, message.time);
+          break;
+        case 2:
+          ok = reader.read_enum(wire_type, message.mode);
+          break;
+        case 3:
+          ok = reader.read_float(wire_type, message.pip);
+          break;
+        case 4:
+          ok = reader.read_float(wire_type, message.peep);
+          break;
+        case 5:
+          ok = reader.read_float(wire_type, message.vt);
+          break;
+        case 6:
+          ok = reader.read_float(wire_type, message.rr);
+          break;
+        case 7:
+          ok = reader.read_float(wire_type, message.ie);
+          break;
+        case 8:
+          ok = reader.read_float(wire_type, message.fio2);
+          break;
+        case 9:
+          ok = reader.read_float(wire_type, message.flow);
+          break;
+        case 10:
+          ok = reader.read_bool(wire_type, message.ventilating);
+          break;
+        default:
+          ok = reader.skip(wire_type);
+      }
+      if (!ok) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+template <>
+struct ProtobufCodec<Ping> {
+  static constexpr bool generated = true;
+  static constexpr size_t max_size = 12;
+
+  static size_t encoded_size(const Ping &message) {
+    return protobuf_uint32_size(1, message.time) +
+           protobuf_uint32_size(2, message.id);
+  }
+
+  static bool encode(const Ping &message, ProtobufWriter &writer) {
+    return writer.write_uint32(1, message.time) &&
+           writer.write_uint32(2, message.id);
+  }
+
+  static bool decode(ProtobufReader &reader, Ping &message) {
+    uint32_t field = 0;
+    ProtobufWireType wire_type = ProtobufWireType::varint;
+    while (!reader.empty()) {
+      if (!reader.read_tag(field, wire_type)) {
+        return false;
+      }
+      bool ok = false;
+      switch (field) {
+        case 1:
+          ok = reader.read_uint32(wire_type, message.time);
+          break;
+        case 2:
+          ok = reader.read_uint32(wire_type, message.id);
+          break;
+        default:
+          ok = reader.skip(wire_type);
+      }
+      if (!ok) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+template <>
+struct ProtobufCodec<LogEvent> {
+  static constexpr bool generated = true;
+  static constexpr size_t max_size = 38;
+
+  static size_t encoded_size(const LogEvent &message) {
+    return protobuf_uint32_size(1, message.id) +
+           protobuf_uint32_size(2, message.time) +
+           protobuf_uint32_size(3, static_cast<uint32_t>(message.code)) +
+           protobuf_message_size(4, message.has_alarm_limits, message.alarm_limits) +
+           protobuf_float_size(5, message.old_value) +
+           protobuf_float_size(6, message.new_value);
+  }
+
+  static bool encode(const LogEvent &message, ProtobufWriter &writer) {
+    return writer.write_uint32(1, message.id) &&
+           writer.write_uint32(2, message.time) &&
+           writer.write_uint32(3, static_cast<uint32_t>(message.code)) &&
+           writer.write_message(4, message.has_alarm_limits, message.alarm_limits) &&
+           writer.write_float(5, message.old_value) &&
+           writer.write_float(6, message.new_value);
+  }
+
+  static bool decode(ProtobufReader &reader, LogEvent &message) {
+    uint32_t field = 0;
+    ProtobufWireType wire_type = ProtobufWireType::varint;
+    while (!reader.empty()) {
+      if (!reader.read_tag(field, wire_type)) {
+        return false;
+      }
+      bool ok = false;
+      switch (field) {
+        case 1:
+          ok = reader.read_uint32(wire_type, message.id);
+          break;
+        case 2:
+          ok = reader.read_uint32(wire_type, message.time);
+          break;
+        case 3:
+          ok = reader.read_enum(wire_type, message.code);
+          break;
+        case 4:
+          ok = reader.read_message(wire_type, message.has_alarm_limits, message.alarm_limits);
+          break;
+        case 5:
+          ok = reader.read_float(wire_type, message.old_value);
+          break;
+        case 6:
+          ok = reader.read_float(wire_type, message.new_value);
+          break;
+        default:
+          ok = reader.skip(wire_type);
+      }
+      if (!ok) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+template <>
+struct ProtobufCodec<ExpectedLogEvent> {
+  static constexpr bool generated = true;
+  static constexpr size_t max_size = 6;
+
+  static size_t encoded_size(const ExpectedLogEvent &message) {
+    return protobuf_uint32_size(1, message.id);
+  }
+
+  static bool encode(const ExpectedLogEvent &message, ProtobufWriter &writer) {
+    return writer.write_uint32(1, message.id);
+  }
+
+  static bool decode(ProtobufReader &reader, ExpectedLogEvent &message) {
+    uint32_t field = 0;
+    ProtobufWireType wire_type = ProtobufWireType::varint;
+    while (!reader.empty()) {
+      if (!reader.read_tag(field, wire_type)) {
+        return false;
+      }
+      bool ok = false;
+      switch (field) {
+        case 1:
+          ok = reader.read_uint32(wire_type, message.id);
+          break;
+        default:
+          ok = reader.skip(wire_type);
+      }
+      if (!ok) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+template <>
+struct ProtobufCodec<BatteryPower> {
+  static constexpr bool generated = true;
+  static constexpr size_t max_size = 6;
+
+  static size_t encoded_size(const BatteryPower &message) {
+    return protobuf_uint32_size(1, message.power_left);
+  }
+
+  static bool encode(const BatteryPower &message, ProtobufWriter &writer) {
+    return writer.write_uint32(1, message.power_left);
+  }
+
+  static bool decode(ProtobufReader &reader, BatteryPower &message) {
+    uint32_t field = 0;
+    ProtobufWireType wire_type = ProtobufWireType::varint;
+    while (!reader.empty()) {
+      if (!reader.read_tag(field, wire_type)) {
+        return false;
+      }
+      bool ok = false;
+      switch (field) {
+        case 1:
+          ok = reader.read_uint32(wire_type, message.power_left);
+          break;
+        default:
+          ok = reader.skip(wire_type);
+      }
+      if (!ok) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+template <>
+struct ProtobufCodec<ScreenStatus> {
+  static constexpr bool generated = true;
+  static constexpr size_t max_size = 2;
+
+  static size_t encoded_size(const ScreenStatus &message) {
+    return protobuf_bool_size(1, message.lock);
+  }
+
+  static bool encode(const ScreenStatus &message, ProtobufWriter &writer) {
+    return writer.write_bool(1, message.lock);
+  }
+
+  static bool decode(ProtobufReader &reader, ScreenStatus &message) {
+    uint32_t field = 0;
+    ProtobufWireType wire_type = ProtobufWireType::varint;
+    while (!reader.empty()) {
+      if (!reader.read_tag(field, wire_type)) {
+        return false;
+      }
+      bool ok = false;
+      switch (field) {
+        case 1:
+          ok = reader.read_bool(wire_type, message.lock);
+          break;
+        default:
+          ok = reader.skip(wire_type);
+      }
+      if (!ok) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+template <>
+struct ProtobufCodec<AlarmMute> {
+  static constexpr bool generated = true;
+  static constexpr size_t max_size = 7;
+
+  static size_t encoded_size(const AlarmMute &message) {
+    return protobuf_bool_size(1, message.active) +
+           protobuf_float_size(2, message.remaining);
+  }
+
+  static bool encode(const AlarmMute &message, ProtobufWriter &writer) {
+    return writer.write_bool(1, message.active) &&
+           writer.write_float(2, message.remaining);
+  }
+
+  static bool decode(ProtobufReader &reader, AlarmMute &message) {
+    uint32_t field = 0;
+    ProtobufWireType wire_type = ProtobufWireType::varint;
+    while (!reader.empty()) {
+      if (!reader.read_tag(field, wire_type)) {
+        return false;
+      }
+      bool ok = false;
+      switch (field) {
+        case 1:
+          ok = reader.read_bool(wire_type, message.active);
+          break;
+        case 2:
+          ok = reader.read_float(wire_type, message.remaining);
+          break;
+        default:
+          ok = reader.skip(wire_type);
+      }
+      if (!ok) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+template <>
+struct ProtobufCodec<AlarmMuteRequest> {
+  static constexpr bool generated = true;
+  static constexpr size_t max_size = 7;
+
+  static size_t encoded_size(const AlarmMuteRequest &message) {
+    return protobuf_bool_size(1, message.active) +
+           protobuf_float_size(2, message.remaining);
+  }
+
+  static bool encode(const AlarmMuteRequest &message, ProtobufWriter &writer) {
+    return writer.write_bool(1, message.active) &&
+           writer.write_float(2, message.remaining);
+  }
+
+  static bool decode(ProtobufReader &reader, AlarmMuteRequest &message) {
+    uint32_t field = 0;
+    ProtobufWireType wire_type = ProtobufWireType::varint;
+    while (!reader.empty()) {
+      if (!reader.read_tag(field, wire_type)) {
+        return false;
+      }
+      bool ok = false;
+      switch (field) {
+        case 1:
+          ok = reader.read_bool(wire_type, message.active);
+          break;
+        case 2:
+          ok = reader.read_float(wire_type, message.remaining);
+          break;
+        default:
+          ok = reader.skip(wire_type);
+      }
+      if (!ok) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+template <>
+struct ProtobufCodec<Capabilities> {
+  static constexpr bool generated = true;
+  static constexpr size_t max_size = 12;
+
+  static size_t encoded_size(const Capabilities &message) {
+    return protobuf_uint32_size(1, message.features) +
+           protobuf_uint32_size(2, message.baud_rate);
+  }
+
+  static bool encode(const Capabilities &message, ProtobufWriter &writer) {
+    return writer.write_uint32(1, message.features) &&
+           writer.write_uint32(2, message.baud_rate);
+  }
+
+  static bool decode(ProtobufReader &reader, Capabilities &message) {
+    uint32_t field = 0;
+    ProtobufWireType wire_type = ProtobufWireType::varint;
+    while (!reader.empty()) {
+      if (!reader.read_tag(field, wire_type)) {
+        return false;
+      }
+      bool ok = false;
+      switch (field) {
+        case 1:
+          ok = reader.read_uint32(wire_type, message.features);
+          break;
+        case 2:
+          ok = reader.read_uint32(wire_type, message.baud_rate);
+          break;
+        default:
+          ok = reader.skip(wire_type);
+      }
+      if (!ok) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+template <>
+struct ProtobufCodec<CapabilitiesRequest> {
+  static constexpr bool generated = true;
+  static constexpr size_t max_size = 12;
+
+  static size_t encoded_size(const CapabilitiesRequest &message) {
+    return protobuf_uint32_size(1, message.features) +
+           protobuf_uint32_size(2, message.max_baud_rate);
+  }
+
+  static bool encode(const CapabilitiesRequest &message, ProtobufWriter &writer) {
+    return writer.write_uint32(1, message.features) &&
+           writer.write_uint32(2, message.max_baud_rate);
+  }
+
+  static bool decode(ProtobufReader &reader, CapabilitiesRequest &message) {
+    uint32_t field = 0;
+    ProtobufWireType wire_type = ProtobufWireType::varint;
+    while (!reader.empty()) {
+      if (!reader.read_tag(field, wire_type)) {
+        return false;
+      }
+      bool ok = false;
+      switch (field) {
+        case 1:
+          ok = reader.read_uint32(wire_type, message.features);
+          break;
+        case 2:
+          ok = reader.read_uint32(wire_type, message.max_baud_rate);
+          break;
+        default:
+          ok = reader.skip(wire_type);
+      }
+      if (!ok) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+template <>
+struct ProtobufCodec<Diagnostics> {
+  static constexpr bool generated = true;
+  static constexpr size_t max_size = 156;
+
+  static size_t encoded_size(const Diagnostics &message) {
+    return protobuf_uint32_size(1, message.time) +
+           protobuf_uint32_size(2, message.rx_bytes) +
+           protobuf_uint32_size(3, message.rx_messages) +
+           protobuf_uint32_size(4, message.rx_dropped_bytes) +
+           protobuf_uint32_size(5, message.rx_frame_length_errors) +
+           protobuf_uint32_size(6, message.rx_frames_overwritten) +
+           protobuf_uint32_size(7, message.rx_crcelement_parse_errors) +
+           protobuf_uint32_size(8, message.rx_crc_errors) +
+           protobuf_uint32_size(9, message.rx_datagram_parse_errors) +
+           protobuf_uint32_size(10, message.rx_datagram_length_errors) +
+           protobuf_uint32_size(11, message.rx_sequence_gaps) +
+           protobuf_uint32_size(12, message.rx_message_length_errors) +
+           protobuf_uint32_size(13, message.rx_message_type_errors) +
+           protobuf_uint32_size(14, message.rx_message_encoding_errors) +
+           protobuf_uint32_size(15, message.rx_rejected_messages) +
+           protobuf_uint32_size(16, message.tx_bytes) +
+           protobuf_uint32_size(17, message.tx_messages) +
+           protobuf_uint32_size(18, message.tx_message_errors) +
+           protobuf_uint32_size(19, message.tx_frame_errors) +
+           protobuf_uint32_size(20, message.tx_stalls) +
+           protobuf_uint32_size(25, message.tx_dropped_waveform_samples) +
+           protobuf_float_size(21, message.rx_message_rate) +
+           protobuf_float_size(22, message.rx_byte_rate) +
+           protobuf_float_size(23, message.tx_message_rate) +
+           protobuf_float_size(24, message.tx_byte_rate);
+  }
+
+  static bool encode(const Diagnostics &message, ProtobufWriter &writer) {
+    return writer.write_uint32(1, message.time) &&
+           writer.write_uint32(2, message.rx_bytes) &&
+           writer.write_uint32(3, message.rx_messages) &&
+           writer.write_uint32(4, message.rx_dropped_bytes) &&
+           writer.write_uint32(5, message.rx_frame_length_errors) &&
+           writer.write_uint32(6, message.rx_frames_overwritten) &&
+           writer.write_uint32(7, message.rx_crcelement_parse_errors) &&
+           writer.write_uint32(8, message.rx_crc_errors) &&
+           writer.write_uint32(9, message.rx_datagram_parse_errors) &&
+           writer.write_uint32(10, message.rx_datagram_length_errors) &&
+           writer.write_uint32(11, message.rx_sequence_gaps) &&
+           writer.write_uint32(12, message.rx_message_length_errors) &&
+           writer.write_uint32(13, message.rx_message_type_errors) &&
+           writer.write_uint32(14, message.rx_message_encoding_errors) &&
+           writer.write_uint32(15, message.rx_rejected_messages) &&
+           writer.write_uint32(16, message.tx_bytes) &&
+           writer.write_uint32(17, message.tx_messages) &&
+           writer.write_uint32(18, message.tx_message_errors) &&
+           writer.write_uint32(19, message.tx_frame_errors) &&
+           writer.write_uint32(20, message.tx_stalls) &&
+           writer.write_uint32(25, message.tx_dropped_waveform_samples) &&
+           writer.write_float(21, message.rx_message_rate) &&
+           writer.write_float(22, message.rx_byte_rate) &&
+           writer.write_float(23, message.tx_message_rate) &&
+           writer.write_float(24, message.tx_byte_rate);
+  }
+
+  static bool decode(ProtobufReader &reader, Diagnostics &message) {
+    uint32_t field = 0;
+    ProtobufWireType wire_type = ProtobufWireType::varint;
+    while (!reader.empty()) {
+      if (!reader.read_tag(field, wire_type)) {
+        return false;
+      }
+      bool ok = false;
+      switch (field) {
+        case 1:
+          ok = reader.read_uint32(wire_type, message.time);
+          break;
+        case 2:
+          ok = reader.read_uint32(wire_type, message.rx_bytes);
+          break;
+        case 3:
+          ok = reader.read_uint32(wire_type, message.rx_messages);
+          break;
+        case 4:
+          ok = reader.read_uint32(wire_type, message.rx_dropped_bytes);
+          break;
+        case 5:
+          ok = reader.read_uint32(wire_type, message.rx_frame_length_errors);
+          break;
+        case 6:
+          ok = reader.read_uint32(wire_type, message.rx_frames_overwritten);
+          break;
+        case 7:
+          ok = reader.read_uint32(wire_type, message.rx_crcelement_parse_errors);
+          break;
+        case 8:
+          ok = reader.read_uint32(wire_type, message.rx_crc_errors);
+          break;
+        case 9:
+          ok = reader.read_uint32(wire_type, message.rx_datagram_parse_errors);
+          break;
+        case 10:
+          ok = reader.read_uint32(wire_type, message.rx_datagram_length_errors);
+          break;
+        case 11:
+          ok = reader.read_uint32(wire_type, message.rx_sequence_gaps);
+          break;
+        case 12:
+          ok = reader.read_uint32(wire_type, message.rx_message_length_errors);
+          break;
+        case 13:
+          ok = reader.read_uint32(wire_type, message.rx_message_type_errors);
+          break;
+        case 14:
+          ok = reader.read_uint32(wire_type, message.rx_message_encoding_errors);
+          break;
+        case 15:
+          ok = reader.read_uint32(wire_type, message.rx_rejected_messages);
+          break;
+        case 16:
+          ok = reader.read_uint32(wire_type, message.tx_bytes);
+          break;
+        case 17:
+          ok = reader.read_uint32(wire_type, message.tx_messages);
+          break;
+        case 18:
+          ok = reader.read_uint32(wire_type, message.tx_message_errors);
+          break;
+        case 19:
+          ok = reader.read_uint32(wire_type, message.tx_frame_errors);
+          break;
+        case 20:
+          ok = reader.read_uint32(wire_type, message.tx_stalls);
+          break;
+        case 25:
+          ok = reader.read_uint32(wire_type, message.tx_dropped_waveform_samples);
+          break;
+        case 21:
+          ok = reader.read_float(wire_type, message.rx_message_rate);
+          break;
+        case 22:
+          ok = reader.read_float(wire_type, message.rx_byte_rate);
+          break;
+        case 23:
+          ok = reader.read_float(wire_type, message.tx_message_rate);
+          break;
+        case 24:
+          ok = reader.read_float(wire_type, message.tx_byte_rate);
+          break;
+        default:
+          ok = reader.skip(wire_type);
+      }
+      if (!ok) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+template <>
+struct ProtobufCodec<Profile> {
+  static constexpr bool generated = true;
+  static constexpr size_t max_size = 154;
+
+  static size_t encoded_size(const Profile &message) {
+    return protobuf_uint32_size(1, message.time) +
+           protobuf_uint32_size(2, static_cast<uint32_t>(message.region)) +
+           protobuf_uint32_size(3, message.count) +
+           protobuf_uint32_size(4, message.min_cycles) +
+           protobuf_uint32_size(5, message.max_cycles) +
+           protobuf_uint32_size(6, message.mean_cycles) +
+           protobuf_packed_uint32_size(7, message.histogram, message.histogram_count);
+  }
+
+  static bool encode(const Profile &message, ProtobufWriter &writer) {
+    return writer.write_uint32(1, message.time) &&
+           writer.write_uint32(2, static_cast<uint32_t>(message.region)) &&
+           writer.write_uint32(3, message.count) &&
+           writer.write_uint32(4, message.min_cycles) &&
+           writer.write_uint32(5, message.max_cycles) &&
+           writer.write_uint32(6, message.mean_cycles) &&
+           writer.write_packed_uint32(
+               7, message.histogram, message.histogram_count, pb_arraysize(Profile, histogram));
+  }
+
+  static bool decode(ProtobufReader &reader, Profile &message) {
+    uint32_t field = 0;
+    ProtobufWireType wire_type = ProtobufWireType::varint;
+    while (!reader.empty()) {
+      if (!reader.read_tag(field, wire_type)) {
+        return false;
+      }
+      bool ok = false;
+      switch (field) {
+        case 1:
+          ok = reader.read_uint32(wire_type, message.time);
+          break;
+        case 2:
+          ok = reader.read_enum(wire_type, message.region);
+          break;
+        case 3:
+          ok = reader.read_uint32(wire_type, message.count);
+          break;
+        case 4:
+          ok = reader.read_uint32(wire_type, message.min_cycles);
+          break;
+        case 5:
+          ok = reader.read_uint32(wire_type, message.max_cycles);
+          break;
+        case 6:
+          ok = reader.read_uint32(wire_type, message.mean_cycles);
+          break;
+        case 7:
+          ok = reader.read_repeated_uint32(
+              wire_type,
+              message.histogram,
+              message.histogram_count,
+              pb_arraysize(Profile, histogram));
+          break;
+        default:
+          ok = reader.skip(wire_type);
+      }
+      if (!ok) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+}  // namespace Pufferfish::Util
@@ -13,6 +13,7 @@
 
 #include "Controller.h"
 #include "ParametersService.h"
+#include "Waveforms.h"
 #include "Pufferfish/Driver/I2C/SFM3019/Sensor.h"
 #include "Pufferfish/HAL/Interfaces/PWM.h"
 
@@ -20,11 +21,15 @@ namespace Pufferfish::Driver::BreathingCircuit {
 
 class ControlLoop {
  public:
-  virtual void update(uint32_t current_time) = 0;
-
- protected:
   static const uint32_t update_interval = 2;  // ms
 
+  // Runs a step whenever the update interval has elapsed, for polling from the main loop
+  void update(uint32_t current_time);
+  // Runs one step unconditionally, for callers which keep the update interval themselves,
+  // such as a ControlTimer
+  virtual void step(uint32_t current_time) = 0;
+
+ protected:
   void advance_step_time(uint32_t current_time);
   [[nodiscard]] uint32_t step_duration(uint32_t current_time) const;
   [[nodiscard]] bool update_needed(uint32_t current_time) const;
@@ -38,18 +43,20 @@ class HFNCControlLoop : public ControlLoop {
   HFNCControlLoop(
       const Parameters &parameters,
       SensorMeasurements &sensor_measurements,
+      SensorWaveforms &sensor_waveforms,
       Driver::I2C::SFM3019::Sensor &sfm3019_air,
       Driver::I2C::SFM3019::Sensor &sfm3019_o2,
       HAL::PWM &valve_air,
       HAL::PWM &valve_o2)
       : parameters_(parameters),
         sensor_measurements_(sensor_measurements),
+        waveforms_(sensor_waveforms),
         sfm3019_air_(sfm3019_air),
         sfm3019_o2_(sfm3019_o2),
         valve_air_(valve_air),
         valve_o2_(valve_o2) {}
 
-  void update(uint32_t current_time) override;
+  void step(uint32_t current_time) override;
 
   [[nodiscard]] SensorVars &sensor_vars();
   [[nodiscard]] const SensorVars &sensor_vars() const;
@@ -59,6 +66,7 @@ class HFNCControlLoop : public ControlLoop {
  private:
   const Parameters &parameters_;
   SensorMeasurements &sensor_measurements_;
+  SensorWaveformsCollector waveforms_;
 
   HFNCController controller_;
 
@@ -0,0 +1,83 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * ControlTimer.h
+ *
+ *  Runs the steps of a control loop at the ticks of a hardware timer, so that the control
+ *  period does not depend on how long the other work in the main loop takes.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "ControlLoop.h"
+#include "Pufferfish/HAL/Interfaces/Time.h"
+
+namespace Pufferfish::Driver::BreathingCircuit {
+
+struct ControlTimingStats {
+  uint32_t steps;
+  // Ticks whose steps were skipped because the main loop fell more than a tick behind
+  uint32_t missed_ticks;
+  // Delay from a tick of the timer until the start of its step, in us
+  uint32_t latency;
+  uint32_t max_latency;
+  // Deviation of the interval between the starts of successive steps from the interval
+  // between their ticks, in us
+  uint32_t jitter;
+  uint32_t max_jitter;
+};
+
+/**
+ * Work is split between the timer's interrupt handler and the main loop:
+ * - tick() only counts the ticks of the timer and timestamps the latest tick, so it is safe to
+ *   call from the interrupt handler.
+ * - service() runs the control loop's step in the main loop, once per tick. The step may block
+ *   on I2C sensors and shares the application's state segments with the other tasks of the
+ *   main loop, so it is not safe to run in the interrupt handler.
+ *
+ * Each step is given the nominal time of its tick rather than the time when it runs, so the
+ * control loop always sees a period of exactly ControlLoop::update_interval between its steps.
+ * If the main loop falls more than a tick behind, the missed ticks are counted and skipped
+ * instead of being run in a burst. Latency and jitter are measured with the microsecond clock;
+ * measurements across a rollover of the clock are skipped.
+ */
+class ControlTimer {
+ public:
+  static const uint32_t micros_per_milli = 1000;
+  // The timer must tick at this period, in us
+  static const uint32_t period = ControlLoop::update_interval * micros_per_milli;
+
+  ControlTimer(ControlLoop &control_loop, HAL::Time &time)
+      : control_loop_(control_loop), time_(time) {}
+
+  // Call this just before the timer is started, with the current time in ms; the nth tick
+  // after this has a nominal time of current_time + n * ControlLoop::update_interval
+  void start(uint32_t current_time);
+  // Call this from the timer's update interrupt
+  void tick();
+  // Call this from the main loop; returns true if it ran a step
+  bool service();
+
+  [[nodiscard]] const ControlTimingStats &stats() const { return stats_; }
+
+ private:
+  ControlLoop &control_loop_;
+  HAL::Time &time_;
+
+  // Only modified by tick()
+  std::atomic<uint32_t> ticks_{0};
+  std::atomic<uint32_t> tick_micros_{0};
+
+  // Only modified by start() and service()
+  uint32_t start_time_ = 0;
+  uint32_t serviced_ticks_ = 0;
+  uint32_t previous_step_micros_ = 0;
+  ControlTimingStats stats_{};
+
+  void measure(uint32_t tick_micros, uint32_t step_micros, uint32_t elapsed_ticks);
+};
+
+}  // namespace Pufferfish::Driver::BreathingCircuit
@@ -0,0 +1,35 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * Waveforms.h
+ *
+ *  Collection of sensor measurements from every step of the control loop into batches of
+ *  waveform samples, so that the complete waveforms can be sent in a few large messages.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "Pufferfish/Application/States.h"
+
+namespace Pufferfish::Driver::BreathingCircuit {
+
+class SensorWaveformsCollector {
+ public:
+  static constexpr size_t batch_size = pb_arraysize(SensorWaveforms, paw);
+
+  explicit SensorWaveformsCollector(SensorWaveforms &sensor_waveforms)
+      : sensor_waveforms_(sensor_waveforms) {}
+
+  // Adds a sample to the current batch, and outputs the batch once it is full
+  void input(uint32_t current_time, const SensorMeasurements &sensor_measurements);
+
+ private:
+  SensorWaveforms &sensor_waveforms_;
+  SensorWaveforms batch_{};
+  uint32_t samples_ = 0;
+};
+
+}  // namespace Pufferfish::Driver::BreathingCircuit
@@ -36,7 +36,7 @@
 #include <array>
 
 #include "Pufferfish/Driver/Testable.h"
-#include "Pufferfish/HAL/CRCChecker.h"
+#include "Pufferfish/HAL/CRCEngine.h"
 #include "Pufferfish/HAL/HAL.h"
 #include "SensirionDevice.h"
 
@@ -64,7 +64,7 @@ class SDPSensor : public Testable {
   // Cppcheck false positive, dev cannot be given to SensirionDevice ctor as
   // const ref cppcheck-suppress constParameter
   SDPSensor(HAL::I2CDevice &dev, HAL::Time &time)
-      : crc8_(crc_params), sensirion_(dev, crc8_), time_(time) {}
+      : sensirion_(dev, crc8_), time_(time) {}
 
   /**
    * start continuously making measurements in sensor
@@ -117,7 +117,7 @@ class SDPSensor : public Testable {
 
   static const size_t full_reading_size = 6;
 
-  HAL::SoftCRC8 crc8_;
+  HAL::EngineCRC<HAL::CRCEngine<uint8_t, crc_params>> crc8_;
   SensirionDevice sensirion_;
   HAL::Time &time_;
   bool measuring_ = false;
@@ -11,7 +11,7 @@
 #pragma once
 
 #include "Pufferfish/Driver/Testable.h"
-#include "Pufferfish/HAL/CRCChecker.h"
+#include "Pufferfish/HAL/CRCEngine.h"
 #include "Pufferfish/HAL/Interfaces/Time.h"
 #include "SensirionDevice.h"
 
@@ -39,7 +39,7 @@ class SFM3000 : public Testable {
   static constexpr float scale_factor_o2 = 142.8F;
 
   explicit SFM3000(HAL::I2CDevice &dev, HAL::Time &time, float scale_factor = scale_factor_air)
-      : crc8_(crc_params), sensirion_(dev, crc8_), time_(time), scale_factor_(scale_factor) {}
+      : sensirion_(dev, crc8_), time_(time), scale_factor_(scale_factor) {}
 
   /**
    * Starts a flow measurement
@@ -67,7 +67,7 @@ class SFM3000 : public Testable {
  private:
   static constexpr HAL::CRC8Parameters crc_params = {0x31, 0x00, false, false, 0x00};
 
-  HAL::SoftCRC8 crc8_;
+  HAL::EngineCRC<HAL::CRCEngine<uint8_t, crc_params>> crc8_;
   SensirionDevice sensirion_;
   bool measuring_ = false;
   HAL::Time &time_;
@@ -14,7 +14,7 @@
 
 #include "Pufferfish/Driver/I2C/SensirionDevice.h"
 #include "Pufferfish/Driver/Testable.h"
-#include "Pufferfish/HAL/CRCChecker.h"
+#include "Pufferfish/HAL/CRCEngine.h"
 #include "Pufferfish/HAL/Interfaces/I2CDevice.h"
 #include "Types.h"
 
@@ -28,7 +28,7 @@ static const uint16_t default_i2c_addr = 0x2e;
 class Device {
  public:
   explicit Device(HAL::I2CDevice &dev, HAL::I2CDevice &global_dev, GasType gas)
-      : crc8_(crc_params), sensirion_(dev, crc8_), global_(global_dev, crc8_), gas(gas) {}
+      : sensirion_(dev, crc8_), global_(global_dev, crc8_), gas(gas) {}
 
   /**
    * Starts a flow measurement
@@ -85,7 +85,7 @@ class Device {
  private:
   static constexpr HAL::CRC8Parameters crc_params = {0x31, 0xff, false, false, 0x00};
 
-  HAL::SoftCRC8 crc8_;
+  HAL::EngineCRC<HAL::CRCEngine<uint8_t, crc_params>> crc8_;
   SensirionDevice sensirion_;
   SensirionDevice global_;
   const GasType gas;
@@ -14,45 +14,93 @@
 #include "Pufferfish/HAL/Interfaces/CRCChecker.h"
 #include "Pufferfish/Protocols/CRCElements.h"
 #include "Pufferfish/Protocols/Datagrams.h"
+#include "Pufferfish/Protocols/Deltas.h"
 #include "Pufferfish/Protocols/Messages.h"
 #include "Pufferfish/Protocols/States.h"
 #include "Pufferfish/Util/Array.h"
 
 namespace Pufferfish::Driver::Serial::Backend {
 
-// States
+// State Synchronization
 
-static const auto message_descriptors = Util::make_array<Util::ProtobufDescriptor>(
-    // array index should match the type code value
-    Util::get_protobuf_descriptor<Util::UnrecognizedMessage>(),  // 0
-    Util::get_protobuf_descriptor<Util::UnrecognizedMessage>(),  // 1
-    Util::get_protobuf_descriptor<SensorMeasurements>(),         // 2
-    Util::get_protobuf_descriptor<CycleMeasurements>(),          // 3
-    Util::get_protobuf_descriptor<Parameters>(),                 // 4
-    Util::get_protobuf_descriptor<ParametersRequest>(),          // 5
-    Util::get_protobuf_descriptor<AlarmLimits>(),                // 6
-    Util::get_protobuf_descriptor<AlarmLimitsRequest>()          // 7
-);
+using StateOutputRate = Protocols::StateOutputRate<Application::MessageTypes>;
 
-// State Synchronization
+// Intervals and deadlines are in ms; only the rate of the sensor measurements depends on the
+// baud rate of the link
+constexpr auto make_state_sync_rates(
+    uint32_t sensor_measurements_interval, uint32_t sensor_measurements_deadline) {
+  return Util::make_array<const StateOutputRate>(
+      StateOutputRate{
+          Application::MessageTypes::sensor_measurements,
+          sensor_measurements_interval,
+          sensor_measurements_deadline},
+      // Only changes when a batch of samples is complete, every 24 ms
+      StateOutputRate{Application::MessageTypes::sensor_waveforms, 10, 24},
+      // Only changes once per breath
+      StateOutputRate{Application::MessageTypes::cycle_measurements, 100, 500},
+      // Only change when operators edit them, and are sent within 20 ms of each change, for
+      // feedback on changes made in the frontend; otherwise they are only sent at the keepalive
+      StateOutputRate{Application::MessageTypes::parameters, 20, 100},
+      StateOutputRate{Application::MessageTypes::alarm_limits, 20, 100},
+      StateOutputRate{Application::MessageTypes::parameters_request, 20, 100},
+      StateOutputRate{Application::MessageTypes::alarm_limits_request, 20, 100},
+      // Only changes when the capabilities are negotiated
+      StateOutputRate{Application::MessageTypes::capabilities, 20, 100},
+      // 1 Hz, for monitoring of the link
+      StateOutputRate{Application::MessageTypes::diagnostics, 1000, 2000},
+      // 10 Hz, one profiled region at a time; only changes if the profiler is enabled
+      StateOutputRate{Application::MessageTypes::profile, 100, 500});
+}
+
+// Sensor measurements at 100 Hz
+static constexpr auto state_sync_rates = make_state_sync_rates(10, 50);
+// At the default baud rate (about 11.5 kB/s), the link cannot carry both the sensor waveforms
+// which the control loop streams (up to about 8 kB/s) and sensor measurements at 100 Hz (about
+// 4 kB/s), and waveform batches would be replaced before they could be sent. Every sample is
+// already in the waveforms, so the sensor measurements are reduced to 20 Hz, which is enough
+// for the displayed values.
+static constexpr auto default_baud_state_sync_rates = make_state_sync_rates(50, 100);
+static_assert(
+    Protocols::valid_output_rates<Application::MessageRegistry>(state_sync_rates),
+    "Every output rate must be for a distinct registered message type");
+static_assert(
+    Protocols::same_output_types(state_sync_rates, default_baud_state_sync_rates),
+    "The output rates at every baud rate must be for the same types in the same order");
+
+// Unchanged state segments are only re-sent this often, in ms; this must be longer than the
+// intervals of the segments which only change occasionally, so that they are not re-sent at
+// their intervals while they are unchanged
+static const uint32_t state_sync_keepalive_interval = 500;
+
+// Capability flags which are enabled whenever the receiver requests them
+static const uint32_t supported_capabilities =
+    Capability_binary_sensor_measurements | Capability_delta_measurements;
+
+// With delta_measurements enabled, measurements are sent whole once every this many messages
+// of their type, so that the receiver resynchronizes within about 320 ms of a lost frame at
+// 100 Hz, and within a few breaths for cycle measurements
+static const size_t sensor_measurements_keyframe_interval = 32;
+static const size_t cycle_measurements_keyframe_interval = 4;
 
-using StateOutputScheduleEntry = Protocols::StateOutputScheduleEntry<Application::MessageTypes>;
+// The throughput rates in the diagnostics state segment are averaged over windows of this
+// duration, in ms
+static const uint32_t diagnostics_rate_window = 1000;
 
-static const auto state_sync_schedule = Util::make_array<const StateOutputScheduleEntry>(
-    StateOutputScheduleEntry{10, Application::MessageTypes::sensor_measurements},
-    StateOutputScheduleEntry{10, Application::MessageTypes::parameters},
-    StateOutputScheduleEntry{10, Application::MessageTypes::alarm_limits},
-    StateOutputScheduleEntry{10, Application::MessageTypes::sensor_measurements},
-    StateOutputScheduleEntry{10, Application::MessageTypes::cycle_measurements},
-    StateOutputScheduleEntry{10, Application::MessageTypes::alarm_limits_request},
-    StateOutputScheduleEntry{10, Application::MessageTypes::sensor_measurements},
-    StateOutputScheduleEntry{10, Application::MessageTypes::parameters_request},
-    StateOutputScheduleEntry{10, Application::MessageTypes::cycle_measurements});
+// Link Negotiation
+
+// The link starts at the default baud rate, which must match the UART's initial configuration,
+// and switches to the fastest of these baud rates which the receiver also supports
+static const uint32_t default_baud_rate = 115200;
+static constexpr auto supported_baud_rates = Util::make_array<const uint32_t>(
+    3000000, 2000000, 1000000, 921600, 460800, 230400, default_baud_rate);
+// Both sides fall back to the default baud rate if no valid message is received for this long
+// after switching to a faster baud rate, in ms
+static const uint32_t baud_rate_fallback_timeout = 1000;
 
 // Backend
 using BackendMessage = Protocols::Message<
     Application::StateSegment,
-    Application::MessageTypeValues,
+    Application::MessageRegistry,
     Protocols::DatagramProps<
         Driver::Serial::Backend::FrameProps::payload_max_size>::payload_max_size>;
 
@@ -73,23 +121,23 @@ class BackendReceiver {
     invalid_message_encoding
   };
 
-  explicit BackendReceiver(HAL::CRC32 &crc32c) : crc_(crc32c), message_(message_descriptors) {}
+  explicit BackendReceiver(HAL::CRC32 &crc32c)
+      : crc_accumulator_(crc32c), crc_(crc32c) {}
 
   // Call this until it returns outputReady, then call output
   InputStatus input(uint8_t new_byte);
+  // The message is also output with invalid_datagram_sequence, which indicates that messages
+  // were lost before it
   OutputStatus output(BackendMessage &output_message);
 
  private:
   using BackendCRCReceiver = Protocols::CRCElementReceiver<FrameProps::payload_max_size>;
-  using BackendParsedCRC = Protocols::ParsedCRCElement<FrameProps::payload_max_size>;
   using BackendDatagramReceiver =
       Protocols::DatagramReceiver<BackendCRCReceiver::Props::payload_max_size>;
-  using BackendParsedDatagram =
-      Protocols::ParsedDatagram<BackendCRCReceiver::Props::payload_max_size>;
-  using BackendMessageReceiver =
-      Protocols::MessageReceiver<BackendMessage, message_descriptors.size()>;
+  using BackendMessageReceiver = Protocols::MessageReceiver<BackendMessage>;
 
   FrameReceiver frame_;
+  Protocols::CRCElementAccumulator crc_accumulator_;
   BackendCRCReceiver crc_;
   BackendDatagramReceiver datagram_;
   BackendMessageReceiver message_;
@@ -108,7 +156,7 @@ class BackendSender {
     invalid_return_code
   };
 
-  explicit BackendSender(HAL::CRC32 &crc32c) : message_(message_descriptors), crc_(crc32c) {}
+  explicit BackendSender(HAL::CRC32 &crc32c) : crc_(crc32c) {}
 
   Status transform(const BackendMessage &input_message, FrameProps::ChunkBuffer &output_buffer);
 
@@ -116,7 +164,15 @@ class BackendSender {
   using BackendCRCSender = Protocols::CRCElementSender<FrameProps::payload_max_size>;
   using BackendDatagramSender =
       Protocols::DatagramSender<BackendCRCSender::Props::payload_max_size>;
-  using BackendMessageSender = Protocols::MessageSender<BackendMessage, message_descriptors.size()>;
+  using BackendMessageSender = Protocols::MessageSender<BackendMessage>;
+
+  // All layers write into a single frame payload buffer: each layer's body is placed after
+  // headroom reserved for the headers of the layers below it, so no payload is ever copied
+  static const size_t crcelement_body_offset = 0;
+  static const size_t datagram_body_offset =
+      crcelement_body_offset + Protocols::CRCElementHeaderProps::header_size;
+  static const size_t message_body_offset =
+      datagram_body_offset + Protocols::DatagramHeaderProps::header_size;
 
   BackendMessageSender message_;
   BackendDatagramSender datagram_;
@@ -124,6 +180,31 @@ class BackendSender {
   FrameSender frame_;
 };
 
+// Chooses the baud rate of the link and falls back to the default baud rate when messages stop
+// arriving. A baud rate which the link had to fall back from is not chosen again.
+class BaudRateNegotiator {
+ public:
+  BaudRateNegotiator() = default;
+
+  // Returns the fastest supported baud rate up to the receiver's maximum, which should be
+  // announced to the receiver
+  uint32_t negotiate(uint32_t max_baud_rate) const;
+  // Call this once a baud rate has been announced to the receiver
+  void announce(uint32_t announced_baud_rate, uint32_t current_time);
+  // Call this whenever a valid message is received
+  void input_valid(uint32_t current_time);
+  // Returns true if the link fell back to the default baud rate
+  bool update_clock(uint32_t current_time);
+
+  // The baud rate at which the link should run
+  [[nodiscard]] uint32_t baud_rate() const { return baud_rate_; }
+
+ private:
+  uint32_t baud_rate_ = default_baud_rate;
+  uint32_t max_baud_rate_ = supported_baud_rates[0];
+  uint32_t last_valid_time_ = 0;
+};
+
 class Backend {
  public:
   enum class Status { ok = 0, waiting, invalid };
@@ -132,24 +213,73 @@ class Backend {
       : receiver_(crc32c),
         sender_(crc32c),
         states_(states),
-        synchronizer_(states, state_sync_schedule) {}
+        synchronizer_(states, default_baud_state_sync_rates, state_sync_keepalive_interval) {
+    states_.capabilities().baud_rate = default_baud_rate;
+  }
 
   static constexpr bool accept_message(Application::MessageTypes type) noexcept;
   Status input(uint8_t new_byte);
   void update_clock(uint32_t current_time);
   Status output(FrameProps::ChunkBuffer &output_buffer);
 
+  // The transport below the backend reports its own errors into the diagnostics state
+  // segment through these methods
+  // Call this with the total number of received bytes which the transport has discarded
+  void update_rx_dropped(uint32_t total_dropped);
+  // Call this once for each output which could not be written to the transport all at once
+  void count_tx_stall();
+
+  // The baud rate at which the transport should run; this changes once an output which
+  // announces a new baud rate has been returned, or when the link falls back to the default
+  // baud rate. The transport should only switch once all previous outputs have been written.
+  [[nodiscard]] uint32_t baud_rate() const { return baud_rates_.baud_rate(); }
+
  private:
   using BackendStateSynchronizer = Protocols::StateSynchronizer<
       Application::States,
       Application::StateSegment,
       Application::MessageTypes,
-      state_sync_schedule.size()>;
+      state_sync_rates.size()>;
+
+  // Replaces the payload with its delta, if it has the delta sender's type and is not due to
+  // be sent as a keyframe
+  template <typename MessageType, size_t keyframe_interval>
+  static void code_delta(
+      Protocols::DeltaSender<MessageType, keyframe_interval> &deltas,
+      Application::StateSegment &payload);
+
+  // Count the outcomes of the receiver and sender in the diagnostics state segment
+  void count(BackendReceiver::InputStatus status);
+  void count(BackendReceiver::OutputStatus status);
+  void count(BackendSender::Status status, size_t output_size);
+  void update_rates(uint32_t current_time);
+  // Switch the state synchronizer's output rates to suit the baud rate of the link
+  void select_output_rates();
+  // Count the waveform samples which were replaced before the state synchronizer sent them
+  void count_dropped_samples(const SensorWaveforms &sensor_waveforms);
+
+  // The counters of the diagnostics state segment at the start of the current rate window
+  struct RateWindow {
+    uint32_t time;
+    uint32_t rx_messages;
+    uint32_t rx_bytes;
+    uint32_t tx_messages;
+    uint32_t tx_bytes;
+  };
 
   BackendReceiver receiver_;
   BackendSender sender_;
   Application::States &states_;
   BackendStateSynchronizer synchronizer_;
+  Protocols::DeltaSender<SensorMeasurements, sensor_measurements_keyframe_interval>
+      sensor_measurements_deltas_;
+  Protocols::DeltaSender<CycleMeasurements, cycle_measurements_keyframe_interval>
+      cycle_measurements_deltas_;
+  RateWindow rate_window_{};
+  BaudRateNegotiator baud_rates_;
+  uint32_t current_time_ = 0;
+  // The first waveform sample after the last batch which was sent
+  uint32_t next_waveform_sample_ = 0;
 };
 
 }  // namespace Pufferfish::Driver::Serial::Backend
@@ -8,13 +8,23 @@
 #pragma once
 
 #include "Backend.h"
+#include "Pufferfish/Util/Timeouts.h"
 
 namespace Pufferfish::Driver::Serial::Backend {
 
 // BackendReceiver
 
-BackendReceiver::InputStatus BackendReceiver::input(uint8_t new_byte) {
-  switch (frame_.input(new_byte)) {
+inline BackendReceiver::InputStatus BackendReceiver::input(uint8_t new_byte) {
+  FrameProps::InputStatus status = frame_.input(new_byte);
+  if (status == FrameProps::InputStatus::input_overwritten) {
+    // The frame receiver discarded the previous frame and started a new one
+    crc_accumulator_.reset();
+  }
+  // Each decoded byte is folded into the CRC as it arrives, so that checking the CRC
+  // takes constant time once the whole frame has arrived
+  crc_accumulator_.update(frame_.decoded());
+
+  switch (status) {
     case FrameProps::InputStatus::output_ready:
       return InputStatus::output_ready;
     case FrameProps::InputStatus::invalid_length:
@@ -27,24 +37,29 @@ BackendReceiver::InputStatus BackendReceiver::input(uint8_t new_byte) {
   return InputStatus::ok;
 }
 
-BackendReceiver::OutputStatus BackendReceiver::output(BackendMessage &output_message) {
-  FrameProps::PayloadBuffer temp_buffer1;
-  BackendCRCReceiver::Props::PayloadBuffer temp_buffer2;
-  BackendDatagramReceiver::Props::PayloadBuffer temp_buffer3;
+inline BackendReceiver::OutputStatus BackendReceiver::output(BackendMessage &output_message) {
+  // The frame payload is decoded into a single buffer owned by the frame receiver, and each
+  // layer above it only parses a view into that buffer, so no payload is ever copied
+  Util::ByteView frame_buffer;
+  Util::ByteView crc_payload;
+  Util::ByteView datagram_payload;
 
   // Frame
-  switch (frame_.output(temp_buffer1)) {
-    case FrameProps::OutputStatus::waiting:
-      return OutputStatus::waiting;
-    case FrameProps::OutputStatus::invalid_length:
-      return OutputStatus::invalid_frame_length;
-    case FrameProps::OutputStatus::ok:
-      break;
+  FrameProps::OutputStatus frame_status = frame_.output(frame_buffer);
+  if (frame_status == FrameProps::OutputStatus::waiting) {
+    return OutputStatus::waiting;
+  }
+
+  // The frame receiver has started a new frame, so the CRC must also start over
+  uint32_t payload_crc = crc_accumulator_.crc();
+  crc_accumulator_.reset();
+  if (frame_status == FrameProps::OutputStatus::invalid_length) {
+    return OutputStatus::invalid_frame_length;
   }
 
   // CRCElement
-  BackendParsedCRC receive_crc(temp_buffer2);
-  switch (crc_.transform(temp_buffer1, receive_crc)) {
+  Protocols::BorrowedCRCElement receive_crc(crc_payload);
+  switch (crc_.transform(frame_buffer, payload_crc, receive_crc)) {
     case BackendCRCReceiver::Status::invalid_parse:
       return OutputStatus::invalid_crcelement_parse;
     case BackendCRCReceiver::Status::invalid_crc:
@@ -54,20 +69,23 @@ BackendReceiver::OutputStatus BackendReceiver::output(BackendMessage &output_mes
   }
 
   // Datagram
-  BackendParsedDatagram receive_datagram(temp_buffer3);
-  switch (datagram_.transform(temp_buffer2, receive_datagram)) {
+  Protocols::BorrowedDatagram receive_datagram(datagram_payload);
+  bool sequence_gap = false;
+  switch (datagram_.transform(crc_payload, receive_datagram)) {
     case BackendDatagramReceiver::Status::invalid_parse:
       return OutputStatus::invalid_datagram_parse;
     case BackendDatagramReceiver::Status::invalid_length:
       return OutputStatus::invalid_datagram_length;
     case BackendDatagramReceiver::Status::invalid_sequence:
-      // TODO(lietk12): emit a warning about invalid sequence
+      // The message is still output, but earlier messages may have been lost
+      sequence_gap = true;
+      break;
     case BackendDatagramReceiver::Status::ok:
       break;
   }
 
   // Message
-  switch (message_.transform(temp_buffer3, output_message)) {
+  switch (message_.transform(datagram_payload, output_message)) {
     case Protocols::MessageStatus::invalid_length:
       return OutputStatus::invalid_message_length;
     case Protocols::MessageStatus::invalid_type:
@@ -77,19 +95,20 @@ BackendReceiver::OutputStatus BackendReceiver::output(BackendMessage &output_mes
     case Protocols::MessageStatus::ok:
       break;
   }
+  if (sequence_gap) {
+    return OutputStatus::invalid_datagram_sequence;
+  }
   return OutputStatus::available;
 }
 
 // BackendSender
 
-BackendSender::Status BackendSender::transform(
+inline BackendSender::Status BackendSender::transform(
     const BackendMessage &input_message, FrameProps::ChunkBuffer &output_buffer) {
-  BackendDatagramSender::Props::PayloadBuffer temp_buffer1;
-  BackendCRCSender::Props::PayloadBuffer temp_buffer2;
-  FrameProps::PayloadBuffer temp_buffer3;
+  FrameProps::PayloadBuffer body_buffer;
 
   // Message
-  switch (message_.transform(input_message, temp_buffer1)) {
+  switch (message_.transform(input_message, body_buffer, message_body_offset)) {
     case Protocols::MessageStatus::invalid_length:
       return Status::invalid_message_length;
     case Protocols::MessageStatus::invalid_type:
@@ -101,7 +120,7 @@ BackendSender::Status BackendSender::transform(
   }
 
   // Datagram
-  switch (datagram_.transform(temp_buffer1, temp_buffer2)) {
+  switch (datagram_.transform(body_buffer, datagram_body_offset)) {
     case BackendDatagramSender::Status::invalid_length:
       return Status::invalid_datagram_length;
     case BackendDatagramSender::Status::ok:
@@ -109,7 +128,7 @@ BackendSender::Status BackendSender::transform(
   }
 
   // CRCElement
-  switch (crc_.transform(temp_buffer2, temp_buffer3)) {
+  switch (crc_.transform(body_buffer, crcelement_body_offset)) {
     case BackendCRCSender::Status::invalid_length:
       return Status::invalid_crcelement_length;
     case BackendCRCSender::Status::ok:
@@ -117,7 +136,7 @@ BackendSender::Status BackendSender::transform(
   }
 
   // Frame
-  switch (frame_.transform(temp_buffer3, output_buffer)) {
+  switch (frame_.transform(body_buffer, output_buffer)) {
     case FrameProps::OutputStatus::invalid_length:
       return Status::invalid_frame_length;
     case FrameProps::OutputStatus::ok:
@@ -128,25 +147,65 @@ BackendSender::Status BackendSender::transform(
   return Status::ok;
 }
 
+// BaudRateNegotiator
+
+inline uint32_t BaudRateNegotiator::negotiate(uint32_t max_baud_rate) const {
+  for (uint32_t baud_rate : supported_baud_rates) {
+    if (baud_rate <= max_baud_rate && baud_rate <= max_baud_rate_) {
+      return baud_rate;
+    }
+  }
+  return default_baud_rate;
+}
+
+inline void BaudRateNegotiator::announce(uint32_t announced_baud_rate, uint32_t current_time) {
+  if (announced_baud_rate == baud_rate_) {
+    return;
+  }
+
+  baud_rate_ = announced_baud_rate;
+  // The receiver needs time to switch before its messages can arrive at the new baud rate
+  last_valid_time_ = current_time;
+}
+
+inline void BaudRateNegotiator::input_valid(uint32_t current_time) {
+  last_valid_time_ = current_time;
+}
+
+inline bool BaudRateNegotiator::update_clock(uint32_t current_time) {
+  if (baud_rate_ == default_baud_rate ||
+      Util::within_timeout(last_valid_time_, baud_rate_fallback_timeout, current_time)) {
+    return false;
+  }
+
+  // Only slower baud rates will be negotiated from now on
+  max_baud_rate_ = baud_rate_ - 1;
+  baud_rate_ = default_baud_rate;
+  return true;
+}
+
 // Backend
 
-Backend::Status Backend::input(uint8_t new_byte) {
+inline Backend::Status Backend::input(uint8_t new_byte) {
   // Input into receiver
-  switch (receiver_.input(new_byte)) {
+  BackendReceiver::InputStatus input_status = receiver_.input(new_byte);
+  count(input_status);
+  switch (input_status) {
     case BackendReceiver::InputStatus::output_ready:
       break;
     case BackendReceiver::InputStatus::invalid_frame_length:
     case BackendReceiver::InputStatus::input_overwritten:
-      // TODO(lietk12): handle error case first
     case BackendReceiver::InputStatus::ok:
       return Status::waiting;
   }
 
   // Output from receiver
   BackendMessage message;
-  switch (receiver_.output(message)) {
+  BackendReceiver::OutputStatus output_status = receiver_.output(message);
+  count(output_status);
+  switch (output_status) {
     case BackendReceiver::OutputStatus::invalid_datagram_sequence:
-      // TODO(lietk12): handle warning case first
+      // Earlier messages were lost, but this one is still valid
     case BackendReceiver::OutputStatus::available:
       break;
     case BackendReceiver::OutputStatus::invalid_frame_length:
@@ -157,13 +216,14 @@ Backend::Status Backend::input(uint8_t new_byte) {
     case BackendReceiver::OutputStatus::invalid_message_length:
     case BackendReceiver::OutputStatus::invalid_message_type:
     case BackendReceiver::OutputStatus::invalid_message_encoding:
-      // TODO(lietk12): handle error cases first
       return Status::invalid;
     case BackendReceiver::OutputStatus::waiting:
       return Status::waiting;
   }
+  baud_rates_.input_valid(current_time_);
 
   if (!accept_message(message.payload.tag)) {
+    ++states_.diagnostics().rx_rejected_messages;
     return Status::invalid;
   }
 
@@ -172,23 +232,41 @@ Backend::Status Backend::input(uint8_t new_byte) {
     case Application::States::InputStatus::ok:
       break;
     case Application::States::InputStatus::invalid_type:
-      // TODO(lietk12): handle error case
+      ++states_.diagnostics().rx_rejected_messages;
       return Status::invalid;
   }
 
+  if (message.payload.tag == Application::MessageTypes::capabilities_request) {
+    // Features are only enabled if both sides of the link support them
+    states_.capabilities().features =
+        states_.capabilities_request().features & supported_capabilities;
+    states_.capabilities().baud_rate =
+        baud_rates_.negotiate(states_.capabilities_request().max_baud_rate);
+    // The receiver may have lost its references for deltas, so they must start over
+    sensor_measurements_deltas_.reset();
+    cycle_measurements_deltas_.reset();
+  }
+
   return Status::ok;
 }
 
-void Backend::update_clock(uint32_t current_time) {
+inline void Backend::update_clock(uint32_t current_time) {
+  current_time_ = current_time;
   synchronizer_.input(current_time);
+  update_rates(current_time);
+  if (baud_rates_.update_clock(current_time)) {
+    states_.capabilities().baud_rate = baud_rates_.baud_rate();
+    select_output_rates();
+  }
 }
 
 constexpr bool Backend::accept_message(Application::MessageTypes type) noexcept {
   return type == Application::MessageTypes::parameters_request ||
-         type == Application::MessageTypes::alarm_limits_request;
+         type == Application::MessageTypes::alarm_limits_request ||
+         type == Application::MessageTypes::capabilities_request;
 }
 
-Backend::Status Backend::output(FrameProps::ChunkBuffer &output_buffer) {
+inline Backend::Status Backend::output(FrameProps::ChunkBuffer &output_buffer) {
   // Output from state synchronization
   BackendMessage message;
   switch (synchronizer_.output(message.payload)) {
@@ -200,7 +278,21 @@ Backend::Status Backend::output(FrameProps::ChunkBuffer &output_buffer) {
       return Status::waiting;
   }
 
-  switch (sender_.transform(message, output_buffer)) {
+  if ((states_.capabilities().features & Capability_delta_measurements) != 0) {
+    code_delta(sensor_measurements_deltas_, message.payload);
+    code_delta(cycle_measurements_deltas_, message.payload);
+  }
+  // Keyframes may still be sent in the fixed layout
+  if (message.payload.tag == Application::MessageTypes::sensor_measurements &&
+      (states_.capabilities().features & Capability_binary_sensor_measurements) != 0) {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-union-access)
+    const SensorMeasurements &measurements = message.payload.value.sensor_measurements;
+    message.payload.set(Application::BinarySensorMeasurements{measurements});
+  }
+
+  BackendSender::Status send_status = sender_.transform(message, output_buffer);
+  count(send_status, output_buffer.size());
+  switch (send_status) {
     case BackendSender::Status::ok:
       break;
     case BackendSender::Status::invalid_message_length:
@@ -210,11 +302,169 @@ Backend::Status Backend::output(FrameProps::ChunkBuffer &output_buffer) {
     case BackendSender::Status::invalid_crcelement_length:
     case BackendSender::Status::invalid_frame_length:
     case BackendSender::Status::invalid_return_code:
-      // TODO(lietk12): handle error cases first
       return Status::invalid;
   }
 
+  if (message.payload.tag == Application::MessageTypes::capabilities) {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-union-access)
+    baud_rates_.announce(message.payload.value.capabilities.baud_rate, current_time_);
+    select_output_rates();
+  }
+  if (message.payload.tag == Application::MessageTypes::sensor_waveforms) {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-union-access)
+    count_dropped_samples(message.payload.value.sensor_waveforms);
+  }
+
   return Status::ok;
 }
 
+inline void Backend::update_rx_dropped(uint32_t total_dropped) {
+  states_.diagnostics().rx_dropped_bytes = total_dropped;
+}
+
+inline void Backend::count_tx_stall() {
+  ++states_.diagnostics().tx_stalls;
+}
+
+inline void Backend::select_output_rates() {
+  if (baud_rates_.baud_rate() == default_baud_rate) {
+    synchronizer_.set_rates(default_baud_state_sync_rates);
+  } else {
+    synchronizer_.set_rates(state_sync_rates);
+  }
+}
+
+inline void Backend::count_dropped_samples(const SensorWaveforms &sensor_waveforms) {
+  // A batch which starts before the next sample is a re-send of the last batch at the
+  // keepalive interval
+  auto skipped = static_cast<int32_t>(sensor_waveforms.first_sample - next_waveform_sample_);
+  if (skipped < 0) {
+    return;
+  }
+
+  states_.diagnostics().tx_dropped_waveform_samples += static_cast<uint32_t>(skipped);
+  next_waveform_sample_ = sensor_waveforms.first_sample + sensor_waveforms.offset_count;
+}
+
+template <typename MessageType, size_t keyframe_interval>
+void Backend::code_delta(
+    Protocols::DeltaSender<MessageType, keyframe_interval> &deltas,
+    Application::StateSegment &payload) {
+  using Entry = Application::MessageRegistry::EntryOf<MessageType>;
+  if (payload.tag != Entry::tag) {
+    return;
+  }
+
+  Util::Delta<MessageType> delta{};
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-union-access)
+  if (deltas.transform(payload.value.*Entry::union_member, delta) ==
+      Protocols::DeltaSender<MessageType, keyframe_interval>::Status::ok) {
+    payload.set(delta);
+  }
+}
+
+inline void Backend::count(BackendReceiver::InputStatus status) {
+  Diagnostics &diagnostics = states_.diagnostics();
+  ++diagnostics.rx_bytes;
+  switch (status) {
+    case BackendReceiver::InputStatus::input_overwritten:
+      ++diagnostics.rx_frames_overwritten;
+      break;
+    case BackendReceiver::InputStatus::invalid_frame_length:
+      // Every byte past the maximum frame length is invalid, so the frame is only counted once
+      // it is output
+    case BackendReceiver::InputStatus::output_ready:
+    case BackendReceiver::InputStatus::ok:
+      break;
+  }
+}
+
+inline void Backend::count(BackendReceiver::OutputStatus status) {
+  Diagnostics &diagnostics = states_.diagnostics();
+  switch (status) {
+    case BackendReceiver::OutputStatus::available:
+      ++diagnostics.rx_messages;
+      break;
+    case BackendReceiver::OutputStatus::invalid_datagram_sequence:
+      ++diagnostics.rx_messages;
+      ++diagnostics.rx_sequence_gaps;
+      break;
+    case BackendReceiver::OutputStatus::invalid_frame_length:
+      ++diagnostics.rx_frame_length_errors;
+      break;
+    case BackendReceiver::OutputStatus::invalid_crcelement_parse:
+      ++diagnostics.rx_crcelement_parse_errors;
+      break;
+    case BackendReceiver::OutputStatus::invalid_crcelement_crc:
+      ++diagnostics.rx_crc_errors;
+      break;
+    case BackendReceiver::OutputStatus::invalid_datagram_parse:
+      ++diagnostics.rx_datagram_parse_errors;
+      break;
+    case BackendReceiver::OutputStatus::invalid_datagram_length:
+      ++diagnostics.rx_datagram_length_errors;
+      break;
+    case BackendReceiver::OutputStatus::invalid_message_length:
+      ++diagnostics.rx_message_length_errors;
+      break;
+    case BackendReceiver::OutputStatus::invalid_message_type:
+      ++diagnostics.rx_message_type_errors;
+      break;
+    case BackendReceiver::OutputStatus::invalid_message_encoding:
+      ++diagnostics.rx_message_encoding_errors;
+      break;
+    case BackendReceiver::OutputStatus::waiting:
+      break;
+  }
+}
+
+inline void Backend::count(BackendSender::Status status, size_t output_size) {
+  Diagnostics &diagnostics = states_.diagnostics();
+  switch (status) {
+    case BackendSender::Status::ok:
+      ++diagnostics.tx_messages;
+      diagnostics.tx_bytes += output_size;
+      break;
+    case BackendSender::Status::invalid_message_length:
+    case BackendSender::Status::invalid_message_type:
+    case BackendSender::Status::invalid_message_encoding:
+      ++diagnostics.tx_message_errors;
+      break;
+    case BackendSender::Status::invalid_datagram_length:
+    case BackendSender::Status::invalid_crcelement_length:
+    case BackendSender::Status::invalid_frame_length:
+    case BackendSender::Status::invalid_return_code:
+      ++diagnostics.tx_frame_errors;
+      break;
+  }
+}
+
+inline void Backend::update_rates(uint32_t current_time) {
+  static const float ms_per_s = 1000;
+
+  uint32_t elapsed = current_time - rate_window_.time;
+  if (elapsed < diagnostics_rate_window) {
+    return;
+  }
+
+  // Counters wrap around at 2^32, so their differences are still correct within a window
+  Diagnostics &diagnostics = states_.diagnostics();
+  float per_second = ms_per_s / static_cast<float>(elapsed);
+  diagnostics.time = current_time;
+  diagnostics.rx_message_rate =
+      static_cast<float>(diagnostics.rx_messages - rate_window_.rx_messages) * per_second;
+  diagnostics.rx_byte_rate =
+      static_cast<float>(diagnostics.rx_bytes - rate_window_.rx_bytes) * per_second;
+  diagnostics.tx_message_rate =
+      static_cast<float>(diagnostics.tx_messages - rate_window_.tx_messages) * per_second;
+  diagnostics.tx_byte_rate =
+      static_cast<float>(diagnostics.tx_bytes - rate_window_.tx_bytes) * per_second;
+  rate_window_ = RateWindow{
+      current_time,
+      diagnostics.rx_messages,
+      diagnostics.rx_bytes,
+      diagnostics.tx_messages,
+      diagnostics.tx_bytes};
+}
+
 }  // namespace Pufferfish::Driver::Serial::Backend
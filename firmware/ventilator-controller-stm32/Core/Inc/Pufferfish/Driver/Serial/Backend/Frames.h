@@ -11,6 +11,8 @@
 #include <cstdint>
 
 #include "Pufferfish/Protocols/Chunks.h"
+#include "Pufferfish/Util/COBS.h"
+#include "Pufferfish/Util/Span.h"
 #include "Pufferfish/Util/Vector.h"
 
 namespace Pufferfish::Driver::Serial::Backend {
@@ -27,8 +29,6 @@ struct FrameProps {
   using OutputStatus = Protocols::ChunkOutputStatus;
 };
 
-using FrameChunkSplitter = Protocols::ChunkSplitter<FrameProps::encoded_max_size>;
-
 // Decodes frames (length up to 255 bytes, excluding frame delimiter) with COBS
 class COBSDecoder {
  public:
@@ -51,17 +51,31 @@ class COBSEncoder {
       Util::ByteVector<output_size> &output_buffer) const;
 };
 
+// Splits frames from a stream and decodes them with COBS. Each byte is decoded as
+// soon as it is input, so the decoded frame is ready when its delimiter arrives.
 class FrameReceiver {
  public:
   FrameReceiver() = default;
 
-  // Call this until it returns available, then call output
+  // Call this until it returns output_ready, then call output
   FrameProps::InputStatus input(uint8_t new_byte);
   FrameProps::OutputStatus output(FrameProps::PayloadBuffer &output_buffer);
+  // The view refers to the decoded frame without copying it, so it is only valid
+  // until the next call of input
+  FrameProps::OutputStatus output(Util::ByteView &output_view);
+
+  // The bytes of the current frame which have been decoded so far
+  [[nodiscard]] Util::ByteView decoded() const { return buffer_; }
 
  private:
-  FrameChunkSplitter chunk_splitter_;
-  const COBSDecoder cobs_decoder = COBSDecoder();
+  static const uint8_t delimiter = 0x00;
+
+  FrameProps::PayloadBuffer buffer_;
+  Util::COBSStreamDecoder cobs_decoder_;
+  FrameProps::InputStatus input_status_ = FrameProps::InputStatus::ok;
+  bool length_exceeded_ = false;
+
+  void reset();
 };
 
 class FrameSender {
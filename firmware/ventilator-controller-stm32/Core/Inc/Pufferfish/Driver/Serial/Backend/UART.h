@@ -10,27 +10,60 @@
 #include "Pufferfish/Application/States.h"
 #include "Pufferfish/Driver/Serial/Backend/Backend.h"
 #include "Pufferfish/HAL/Interfaces/CRCChecker.h"
-#include "Pufferfish/HAL/STM32/HALBufferedUART.h"
+#include "Pufferfish/HAL/Interfaces/Time.h"
+#include "Pufferfish/Statuses.h"
 
 namespace Pufferfish::Driver::Serial::Backend {
 
+// BufferedUART is any class with the same interface as HAL::BufferedUART, plus rx_dropped and
+// set_baud_rate methods, such as HAL::LargeBufferedUART in the firmware and
+// HAL::MockLargeBufferedUART in tests. The UART must start at the default baud rate.
+template <typename BufferedUART>
 class UARTBackend {
  public:
-  using BufferedUART = HAL::LargeBufferedUART;
+  // Limits on the work done by one call of receive; a limit of 0 means no limit
+  struct ReceiveBudget {
+    size_t max_bytes = 0;
+    uint32_t max_micros = 0;
+  };
+  struct ReceiveCounts {
+    size_t messages = 0;
+    size_t bytes = 0;
+  };
+  enum class ReceiveStatus { empty = 0, budget_exhausted };
 
-  UARTBackend(volatile BufferedUART &uart, HAL::CRC32 &crc32c, Application::States &states)
-      : uart_(uart), backend_(crc32c, states) {}
+  UARTBackend(
+      volatile BufferedUART &uart,
+      HAL::CRC32 &crc32c,
+      Application::States &states,
+      HAL::Time &time)
+      : uart_(uart), backend_(crc32c, states), time_(time) {}
 
-  void setup_irq();
+  // Returns the status of the UART's setup, for UARTs whose setup can fail
+  auto setup_irq();
+  // Receives bytes until one message is received or the UART read buffer is empty
   void receive();
+  // Receives every message in the UART read buffer, unless the budget is exhausted first
+  ReceiveStatus receive(const ReceiveBudget &budget, ReceiveCounts &counts);
+  // Also updates the count of received bytes which the UART dropped
   void update_clock(uint32_t current_time);
+  // An output stalls if the UART write buffer is too full for all of it when it is first
+  // written; each stalled output is counted once.
+  // When the backend switches baud rates, no new output is started until the UART has finished
+  // transmitting the previous output and has switched.
   void send();
 
  private:
+  // Number of bytes to receive between checks of the time budget
+  static const size_t time_check_interval = 32;
+
   volatile BufferedUART &uart_;
   Backend backend_;
+  HAL::Time &time_;
   FrameProps::ChunkBuffer send_output_;
   HAL::AtomicSize sent_ = 0;
+  bool stalled_ = false;
+  uint32_t baud_rate_ = default_baud_rate;
 };
 
 }  // namespace Pufferfish::Driver::Serial::Backend
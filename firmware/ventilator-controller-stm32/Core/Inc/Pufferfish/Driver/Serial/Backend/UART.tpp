@@ -7,17 +7,20 @@
 
 #pragma once
 
+#include "Pufferfish/Util/Timeouts.h"
 #include "UART.h"
 
 namespace Pufferfish::Driver::Serial::Backend {
 
 // UARTBackend
 
-void UARTBackend::setup_irq() {
-  uart_.setup_irq();
+template <typename BufferedUART>
+auto UARTBackend<BufferedUART>::setup_irq() {
+  return uart_.setup_irq();
 }
 
-void UARTBackend::receive() {
+template <typename BufferedUART>
+void UARTBackend<BufferedUART>::receive() {
   while (true) {  // repeat until UART read buffer is empty or output is available
     uint8_t receive = 0;
 
@@ -33,7 +36,7 @@ void UARTBackend::receive() {
     // Backend
     switch (backend_.input(receive)) {
       case Backend::Status::invalid:
-        // TODO(lietk12): handle error case first
+        // Errors are counted by the backend
       case Backend::Status::waiting:
         break;
       case Backend::Status::ok:
@@ -42,26 +45,88 @@ void UARTBackend::receive() {
   }
 }
 
-void UARTBackend::update_clock(uint32_t current_time) {
+template <typename BufferedUART>
+typename UARTBackend<BufferedUART>::ReceiveStatus UARTBackend<BufferedUART>::receive(
+    const ReceiveBudget &budget, ReceiveCounts &counts) {
+  counts = ReceiveCounts{};
+  uint32_t start_time = time_.micros();
+  while (true) {
+    if (budget.max_bytes > 0 && counts.bytes >= budget.max_bytes) {
+      return ReceiveStatus::budget_exhausted;
+    }
+    if (budget.max_micros > 0 && counts.bytes > 0 && counts.bytes % time_check_interval == 0 &&
+        !Util::within_timeout(start_time, budget.max_micros, time_.micros())) {
+      return ReceiveStatus::budget_exhausted;
+    }
+
+    uint8_t receive = 0;
+
+    // UART
+    switch (uart_.read(receive)) {
+      case BufferStatus::ok:
+        break;
+      case BufferStatus::empty:
+      default:
+        return ReceiveStatus::empty;
+    }
+    ++counts.bytes;
+
+    // Backend
+    switch (backend_.input(receive)) {
+      case Backend::Status::invalid:
+        // Errors are counted by the backend
+      case Backend::Status::waiting:
+        break;
+      case Backend::Status::ok:
+        ++counts.messages;
+        break;
+    }
+  }
+}
+
+template <typename BufferedUART>
+void UARTBackend<BufferedUART>::update_clock(uint32_t current_time) {
+  backend_.update_rx_dropped(uart_.rx_dropped());
   backend_.update_clock(current_time);
 }
 
-void UARTBackend::send() {
+template <typename BufferedUART>
+void UARTBackend<BufferedUART>::send() {
   // Create a new output to write if needed
   if (sent_ >= send_output_.size()) {
+    if (backend_.baud_rate() != baud_rate_) {
+      switch (uart_.set_baud_rate(backend_.baud_rate())) {
+        case UARTStatus::ok:
+          baud_rate_ = backend_.baud_rate();
+          break;
+        case UARTStatus::busy:
+        case UARTStatus::error:
+          // Try again on the next send; if the UART can't switch, the link will fall back to
+          // the baud rate which the UART is still running at
+          return;
+      }
+    }
     switch (backend_.output(send_output_)) {
       case Backend::Status::ok:  // ready to write to UART
         sent_ = 0;
+        stalled_ = false;
         break;
       default:
-        // TODO(lietk12): handle error cases first
+        // Errors are counted by the backend
         return;
     }
   }
   // Attempt to finish writing the current output
+  HAL::AtomicSize remaining = send_output_.size() - sent_;
   HAL::AtomicSize written = 0;
-  uart_.write(send_output_.buffer() + sent_, send_output_.size() - sent_, written);
+  uart_.write(send_output_.buffer() + sent_, remaining, written);
   sent_ += written;
+  if (written < remaining && !stalled_) {
+    // The UART write buffer is full, so the rest of the output must wait; the output is only
+    // counted once, however many sends it takes to finish writing it
+    stalled_ = true;
+    backend_.count_tx_stall();
+  }
 }
 
 }  // namespace Pufferfish::Driver::Serial::Backend
@@ -46,11 +46,15 @@ class SoftCRC : public CRCChecker<Checksum> {
 
   Checksum compute(const uint8_t *data, size_t size) override;
 
+  Checksum init() override;
+  Checksum update(Checksum running, const uint8_t *data, size_t size) override;
+  Checksum finalize(Checksum running) override;
+
  private:
   static const size_t table_size = 256;
 
   const Checksum polynomial;
-  const Checksum init;
+  const Checksum init_value;
   const bool ref_in{};
   const bool ref_out{};
   const Checksum xor_out;
@@ -16,7 +16,11 @@ namespace HAL {
 template <typename Checksum>
 SoftCRC<Checksum>::SoftCRC(
     Checksum polynomial, Checksum init, bool ref_in, bool ref_out, Checksum xor_out)
-    : polynomial(polynomial), init(init), ref_in(ref_in), ref_out(ref_out), xor_out(xor_out) {
+    : polynomial(polynomial),
+      init_value(init),
+      ref_in(ref_in),
+      ref_out(ref_out),
+      xor_out(xor_out) {
   setup();
 };
 
@@ -31,9 +35,19 @@ SoftCRC<Checksum>::SoftCRC(const CRCParameters<Checksum> &parameters)
 
 template <typename Checksum>
 Checksum SoftCRC<Checksum>::compute(const uint8_t *data, size_t size) {
+  return finalize(update(init(), data, size));
+}
+
+template <typename Checksum>
+Checksum SoftCRC<Checksum>::init() {
+  return init_value;
+}
+
+template <typename Checksum>
+Checksum SoftCRC<Checksum>::update(Checksum running, const uint8_t *data, size_t size) {
   // Adapted from https://barrgroup.com/Embedded-Systems/How-To/CRC-Calculation-C-Code
   static const size_t width = CHAR_BIT * sizeof(Checksum);
-  Checksum remainder = init;
+  Checksum remainder = running;
 
   // Divide the message by the polynomial, a byte at a time.
   for (size_t i = 0; i < size; ++i) {
@@ -46,10 +60,15 @@ Checksum SoftCRC<Checksum>::compute(const uint8_t *data, size_t size) {
                 static_cast<Checksum>(remainder << static_cast<uint8_t>(CHAR_BIT));
   }
 
+  return remainder;
+}
+
+template <typename Checksum>
+Checksum SoftCRC<Checksum>::finalize(Checksum running) {
   if (ref_out) {
-    remainder = reflect(remainder);
+    running = reflect(running);
   }
-  return remainder ^ xor_out;
+  return running ^ xor_out;
 }
 
 template <typename Checksum>
@@ -0,0 +1,84 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ *  Software-backed CRC calculation with lookup tables generated at compile time.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "CRCChecker.h"
+#include "Pufferfish/HAL/Interfaces/CRCChecker.h"
+
+namespace Pufferfish::HAL {
+
+/**
+ * Computes cyclic redundancy check codes with lookup tables generated at compile time,
+ * so that the tables can be placed in flash and no setup is needed at runtime.
+ * Methods are static, so calls can be resolved and inlined at compile time.
+ *
+ * Reflected CRCs (with ref_in and ref_out) are computed entirely in the reflected domain,
+ * so neither the input bytes nor the output need to be reflected bit by bit.
+ * Reflected 32-bit CRCs can also process 4 or 8 bytes per step with slicing-by-4 or
+ * slicing-by-8, which need 4 or 8 lookup tables of 1 KB each.
+ *
+ * @tparam ChecksumType  the type of the CRC code
+ * @tparam parameters    parameters of the CRC; ref_in and ref_out must be equal
+ * @tparam slices        the number of bytes processed per step: 1, 4, or 8
+ */
+template <typename ChecksumType, const CRCParameters<ChecksumType> &parameters, size_t slices = 1>
+class CRCEngine {
+ public:
+  using Checksum = ChecksumType;
+
+  static_assert(
+      parameters.ref_in == parameters.ref_out,
+      "CRCEngine is unavailable for CRCs which only reflect their input or output");
+  static_assert(slices == 1 || slices == 4 || slices == 8, "Unsupported number of slices");
+  static_assert(
+      slices == 1 || (parameters.ref_in && sizeof(Checksum) == sizeof(uint32_t)),
+      "Slicing is only available for reflected 32-bit CRCs");
+
+  static constexpr Checksum compute(const uint8_t *data, size_t size);
+
+  // Incremental computation, with the same semantics as in the CRCChecker interface
+  static constexpr Checksum init();
+  static constexpr Checksum update(Checksum running, const uint8_t *data, size_t size);
+  static constexpr Checksum finalize(Checksum running);
+
+ private:
+  static const size_t table_size = 256;
+  using Table = std::array<Checksum, table_size>;
+  using Tables = std::array<Table, slices>;
+
+  static constexpr bool reflected = parameters.ref_in;
+
+  static constexpr Checksum reflect_bits(Checksum num);
+  static constexpr Tables make_tables();
+  static constexpr uint32_t read_le32(const uint8_t *data);
+
+  static const Tables tables;
+};
+
+// Exposes a CRCEngine through the CRCChecker interface, for code which needs dynamic dispatch
+template <typename Engine>
+class EngineCRC : public CRCChecker<typename Engine::Checksum> {
+ public:
+  using Checksum = typename Engine::Checksum;
+
+  Checksum compute(const uint8_t *data, size_t size) override;
+
+  Checksum init() override;
+  Checksum update(Checksum running, const uint8_t *data, size_t size) override;
+  Checksum finalize(Checksum running) override;
+};
+
+using CRC32CEngine = CRCEngine<uint32_t, crc32c_params, 8>;
+using EngineCRC32C = EngineCRC<CRC32CEngine>;
+
+}  // namespace Pufferfish::HAL
+
+#include "CRCEngine.tpp"
@@ -0,0 +1,170 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ *  Software-backed CRC calculation with lookup tables generated at compile time.
+ */
+
+#pragma once
+
+#include <climits>
+
+#include "CRCEngine.h"
+
+namespace Pufferfish::HAL {
+
+// CRCEngine
+
+template <typename ChecksumType, const CRCParameters<ChecksumType> &parameters, size_t slices>
+constexpr ChecksumType CRCEngine<ChecksumType, parameters, slices>::reflect_bits(Checksum num) {
+  const size_t num_bits = CHAR_BIT * sizeof(Checksum);
+  Checksum reflection = 0;
+  for (size_t i = 0; i < num_bits; ++i) {
+    if ((num & 1U) != 0) {
+      reflection |= static_cast<Checksum>(1U << (num_bits - 1U - i));
+    }
+    num = static_cast<Checksum>(num >> 1U);
+  }
+  return reflection;
+}
+
+template <typename ChecksumType, const CRCParameters<ChecksumType> &parameters, size_t slices>
+constexpr typename CRCEngine<ChecksumType, parameters, slices>::Tables
+CRCEngine<ChecksumType, parameters, slices>::make_tables() {
+  constexpr size_t width = CHAR_BIT * sizeof(Checksum);
+  Tables result{};
+
+  // Compute the remainder of each possible dividend
+  for (size_t dividend = 0; dividend < table_size; ++dividend) {
+    Checksum remainder = 0;
+    if constexpr (reflected) {
+      const Checksum polynomial = reflect_bits(parameters.polynomial);
+      remainder = static_cast<Checksum>(dividend);
+      for (uint8_t i = CHAR_BIT; i > 0; --i) {
+        if ((remainder & 1U) != 0) {
+          remainder = static_cast<Checksum>(remainder >> 1U) ^ polynomial;
+        } else {
+          remainder = static_cast<Checksum>(remainder >> 1U);
+        }
+      }
+    } else {
+      const Checksum top_bit = static_cast<Checksum>(1U << (width - 1U));
+      remainder = static_cast<Checksum>(dividend << (width - CHAR_BIT));
+      for (uint8_t i = CHAR_BIT; i > 0; --i) {
+        if ((remainder & top_bit) != 0) {
+          remainder = static_cast<Checksum>(remainder << 1U) ^ parameters.polynomial;
+        } else {
+          remainder = static_cast<Checksum>(remainder << 1U);
+        }
+      }
+    }
+    result[0][dividend] = remainder;
+  }
+
+  // Each further table advances the remainder of the previous table by one more zero byte
+  for (size_t slice = 1; slice < slices; ++slice) {
+    for (size_t dividend = 0; dividend < table_size; ++dividend) {
+      Checksum previous = result[slice - 1][dividend];
+      result[slice][dividend] =
+          static_cast<Checksum>(previous >> CHAR_BIT) ^ result[0][previous & UINT8_MAX];
+    }
+  }
+
+  return result;
+}
+
+template <typename ChecksumType, const CRCParameters<ChecksumType> &parameters, size_t slices>
+constexpr const typename CRCEngine<ChecksumType, parameters, slices>::Tables
+    CRCEngine<ChecksumType, parameters, slices>::tables =
+        CRCEngine<ChecksumType, parameters, slices>::make_tables();
+
+template <typename ChecksumType, const CRCParameters<ChecksumType> &parameters, size_t slices>
+constexpr uint32_t CRCEngine<ChecksumType, parameters, slices>::read_le32(const uint8_t *data) {
+  return static_cast<uint32_t>(data[0]) | (static_cast<uint32_t>(data[1]) << 8U) |
+         (static_cast<uint32_t>(data[2]) << 16U) | (static_cast<uint32_t>(data[3]) << 24U);
+}
+
+template <typename ChecksumType, const CRCParameters<ChecksumType> &parameters, size_t slices>
+constexpr ChecksumType CRCEngine<ChecksumType, parameters, slices>::compute(
+    const uint8_t *data, size_t size) {
+  return finalize(update(init(), data, size));
+}
+
+template <typename ChecksumType, const CRCParameters<ChecksumType> &parameters, size_t slices>
+constexpr ChecksumType CRCEngine<ChecksumType, parameters, slices>::init() {
+  if constexpr (reflected) {
+    return reflect_bits(parameters.init);
+  }
+  return parameters.init;
+}
+
+template <typename ChecksumType, const CRCParameters<ChecksumType> &parameters, size_t slices>
+constexpr ChecksumType CRCEngine<ChecksumType, parameters, slices>::update(
+    Checksum running, const uint8_t *data, size_t size) {
+  constexpr size_t width = CHAR_BIT * sizeof(Checksum);
+  Checksum remainder = running;
+  size_t i = 0;
+
+  if constexpr (slices == 8) {
+    for (; size - i >= 8; i += 8) {
+      uint32_t low = remainder ^ read_le32(data + i);
+      uint32_t high = read_le32(data + i + 4);
+      remainder = tables[7][low & UINT8_MAX] ^ tables[6][(low >> 8U) & UINT8_MAX] ^
+                  tables[5][(low >> 16U) & UINT8_MAX] ^ tables[4][low >> 24U] ^
+                  tables[3][high & UINT8_MAX] ^ tables[2][(high >> 8U) & UINT8_MAX] ^
+                  tables[1][(high >> 16U) & UINT8_MAX] ^ tables[0][high >> 24U];
+    }
+  }
+
+  if constexpr (slices >= 4) {
+    for (; size - i >= 4; i += 4) {
+      uint32_t word = remainder ^ read_le32(data + i);
+      remainder = tables[3][word & UINT8_MAX] ^ tables[2][(word >> 8U) & UINT8_MAX] ^
+                  tables[1][(word >> 16U) & UINT8_MAX] ^ tables[0][word >> 24U];
+    }
+  }
+
+  // Divide the rest of the message by the polynomial, a byte at a time.
+  for (; i < size; ++i) {
+    if constexpr (reflected) {
+      remainder = tables[0][(remainder ^ data[i]) & UINT8_MAX] ^
+                  static_cast<Checksum>(remainder >> static_cast<uint8_t>(CHAR_BIT));
+    } else {
+      uint8_t lookup_index = data[i] ^ static_cast<uint8_t>(remainder >> (width - CHAR_BIT));
+      remainder = tables[0][lookup_index] ^
+                  static_cast<Checksum>(remainder << static_cast<uint8_t>(CHAR_BIT));
+    }
+  }
+
+  return remainder;
+}
+
+template <typename ChecksumType, const CRCParameters<ChecksumType> &parameters, size_t slices>
+constexpr ChecksumType CRCEngine<ChecksumType, parameters, slices>::finalize(Checksum running) {
+  // In the reflected domain, the remainder is already reflected for output
+  return running ^ parameters.xor_out;
+}
+
+// EngineCRC
+
+template <typename Engine>
+typename Engine::Checksum EngineCRC<Engine>::compute(const uint8_t *data, size_t size) {
+  return Engine::compute(data, size);
+}
+
+template <typename Engine>
+typename Engine::Checksum EngineCRC<Engine>::init() {
+  return Engine::init();
+}
+
+template <typename Engine>
+typename Engine::Checksum EngineCRC<Engine>::update(
+    Checksum running, const uint8_t *data, size_t size) {
+  return Engine::update(running, data, size);
+}
+
+template <typename Engine>
+typename Engine::Checksum EngineCRC<Engine>::finalize(Checksum running) {
+  return Engine::finalize(running);
+}
+
+}  // namespace Pufferfish::HAL
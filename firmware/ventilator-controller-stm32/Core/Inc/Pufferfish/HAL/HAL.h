@@ -26,6 +26,7 @@
 #include "STM32/Endian.h"
 #include "STM32/HALAnalogInput.h"
 #include "STM32/HALBufferedUART.h"
+#include "STM32/HALDMABufferedUART.h"
 #include "STM32/HALDigitalInput.h"
 #include "STM32/HALDigitalOutput.h"
 #include "STM32/HALI2CDevice.h"
@@ -24,6 +24,33 @@ class CRCChecker {
    * @param size      size of the data
    */
   virtual Checksum compute(const uint8_t *data, size_t size) = 0;
+
+  /**
+   * Starts an incremental computation of a cyclic redundancy check code.
+   * The running value is held by the caller rather than by the checker,
+   * so one checker can be shared by several concurrent computations.
+   *
+   * @return the running value for a computation over no data
+   */
+  virtual Checksum init() = 0;
+
+  /**
+   * Folds more data into an incremental computation
+   *
+   * @param running   the running value from init or from the previous update
+   * @param data      a pointer to the data to be folded into the running value
+   * @param size      size of the data
+   * @return the running value including the data
+   */
+  virtual Checksum update(Checksum running, const uint8_t *data, size_t size) = 0;
+
+  /**
+   * Finishes an incremental computation
+   *
+   * @param running   the running value from init or from the last update
+   * @return the CRC code of all data given to update, equal to the result of compute
+   */
+  virtual Checksum finalize(Checksum running) = 0;
 };
 
 using CRC8 = CRCChecker<uint8_t>;
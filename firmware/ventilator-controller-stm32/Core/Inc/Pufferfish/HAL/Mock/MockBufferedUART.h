@@ -115,9 +115,31 @@ class MockBufferedUART : public BufferedUART {
       uint32_t timeout,
       HAL::AtomicSize &written_size) volatile override;
 
+  /**
+   * A counter of the number of bytes from set_read which were discarded
+   * because the read buffer was full
+   * @return the total number of discarded bytes
+   */
+  [[nodiscard]] uint32_t rx_dropped() const volatile;
+
+  /**
+   * Sets the baud rate, once every byte written has been taken by get_write
+   * @param  baud_rate the new baud rate
+   * @return busy if the write buffer is not empty, ok otherwise
+   */
+  UARTStatus set_baud_rate(uint32_t baud_rate) volatile;
+
+  /**
+   * Gets the baud rate last set by set_baud_rate
+   * @return the baud rate
+   */
+  [[nodiscard]] uint32_t baud_rate() const volatile;
+
  private:
   volatile Util::RingBuffer<rx_buffer_size> rx_buffer_;
   volatile Util::RingBuffer<tx_buffer_size> tx_buffer_;
+  volatile uint32_t rx_dropped_ = 0;
+  volatile uint32_t baud_rate_ = 0;
 };
 
 static const size_t mock_large_uart_buffer_size = 4096;
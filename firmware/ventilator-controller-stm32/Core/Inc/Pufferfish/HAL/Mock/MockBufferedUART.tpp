@@ -33,7 +33,9 @@ BufferStatus MockBufferedUART<rx_buffer_size, tx_buffer_size>::read(uint8_t &rea
 
 template <AtomicSize rx_buffer_size, AtomicSize tx_buffer_size>
 void MockBufferedUART<rx_buffer_size, tx_buffer_size>::set_read(const uint8_t &byte) volatile {
-  rx_buffer_.write(byte);
+  if (rx_buffer_.write(byte) != BufferStatus::ok) {
+    ++rx_dropped_;
+  }
 }
 
 template <AtomicSize rx_buffer_size, AtomicSize tx_buffer_size>
@@ -50,15 +52,8 @@ void MockBufferedUART<rx_buffer_size, tx_buffer_size>::get_write(uint8_t &byte)
 template <AtomicSize rx_buffer_size, AtomicSize tx_buffer_size>
 BufferStatus MockBufferedUART<rx_buffer_size, tx_buffer_size>::write(
     const uint8_t *write_bytes, AtomicSize write_size, HAL::AtomicSize &written_size) volatile {
-  for (written_size = 0; written_size < write_size; ++written_size) {
-    if (write(write_bytes[written_size]) != BufferStatus::ok) {
-      break;
-    }
-  }
-  if (write_size == written_size) {
-    return BufferStatus::ok;
-  }
-  return BufferStatus::partial;
+  BufferStatus status = tx_buffer_.write(Util::ByteView(write_bytes, write_size), written_size);
+  return status;
 }
 
 template <AtomicSize rx_buffer_size, AtomicSize tx_buffer_size>
@@ -107,5 +102,26 @@ BufferStatus MockBufferedUART<rx_buffer_size, tx_buffer_size>::write_block(
   return BufferStatus::partial;
 }
 
+template <AtomicSize rx_buffer_size, AtomicSize tx_buffer_size>
+uint32_t MockBufferedUART<rx_buffer_size, tx_buffer_size>::rx_dropped() const volatile {
+  return rx_dropped_;
+}
+
+template <AtomicSize rx_buffer_size, AtomicSize tx_buffer_size>
+UARTStatus MockBufferedUART<rx_buffer_size, tx_buffer_size>::set_baud_rate(
+    uint32_t baud_rate) volatile {
+  if (tx_buffer_.size() > 0) {
+    return UARTStatus::busy;
+  }
+
+  baud_rate_ = baud_rate;
+  return UARTStatus::ok;
+}
+
+template <AtomicSize rx_buffer_size, AtomicSize tx_buffer_size>
+uint32_t MockBufferedUART<rx_buffer_size, tx_buffer_size>::baud_rate() const volatile {
+  return baud_rate_;
+}
+
 }  // namespace HAL
 }  // namespace Pufferfish
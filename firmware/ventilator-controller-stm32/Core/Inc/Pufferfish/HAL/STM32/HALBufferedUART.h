@@ -134,6 +134,20 @@ class HALBufferedUART : public BufferedUART {
    */
   [[nodiscard]] uint32_t rx_dropped() const volatile;
 
+  /**
+   * Change the baud rate of the UART, if it has finished transmitting.
+   *
+   * Changing the baud rate in the middle of a transmitted byte would corrupt
+   * it, so this gives up without causing any side-effects if the TX queue is
+   * not empty or the last byte has not been completely transmitted; call it
+   * again later in that case. Bytes received while the baud rate is being
+   * changed may be lost.
+   * @param baud_rate the new baud rate
+   * @return ok on success, busy if the UART is still transmitting, error if
+   * the UART peripheral could not be reconfigured
+   */
+  UARTStatus set_baud_rate(uint32_t baud_rate) volatile;
+
  private:
   UART_HandleTypeDef &huart_;
   Time &time_;
@@ -28,15 +28,9 @@ BufferStatus HALBufferedUART<rx_buffer_size, tx_buffer_size>::write(uint8_t writ
 template <AtomicSize rx_buffer_size, AtomicSize tx_buffer_size>
 BufferStatus HALBufferedUART<rx_buffer_size, tx_buffer_size>::write(
     const uint8_t *write_bytes, AtomicSize write_size, HAL::AtomicSize &written_size) volatile {
-  for (written_size = 0; written_size < write_size; ++written_size) {
-    if (write(write_bytes[written_size]) != BufferStatus::ok) {
-      break;
-    }
-  }
-  if (write_size == written_size) {
-    return BufferStatus::ok;
-  }
-  return BufferStatus::partial;
+  BufferStatus status = tx_buffer_.write(Util::ByteView(write_bytes, write_size), written_size);
+  __HAL_UART_ENABLE_IT(&huart_, UART_IT_TXE);  // write a byte on the next TX empty interrupt
+  return status;
 }
 
 template <AtomicSize rx_buffer_size, AtomicSize tx_buffer_size>
@@ -92,6 +86,25 @@ uint32_t HALBufferedUART<rx_buffer_size, tx_buffer_size>::rx_dropped() const vol
   return rx_dropped_;
 }
 
+template <AtomicSize rx_buffer_size, AtomicSize tx_buffer_size>
+UARTStatus HALBufferedUART<rx_buffer_size, tx_buffer_size>::set_baud_rate(
+    uint32_t baud_rate) volatile {
+  if (tx_buffer_.size() > 0 || __HAL_UART_GET_FLAG(&huart_, UART_FLAG_TC) == RESET) {
+    return UARTStatus::busy;
+  }
+
+  // The baud rate register can only be written while the UART is disabled; the interrupt
+  // enable bits are preserved
+  __HAL_UART_DISABLE(&huart_);
+  huart_.Init.BaudRate = baud_rate;
+  HAL_StatusTypeDef status = UART_SetConfig(&huart_);
+  __HAL_UART_ENABLE(&huart_);
+  if (status != HAL_OK) {
+    return UARTStatus::error;
+  }
+  return UARTStatus::ok;
+}
+
 template <AtomicSize rx_buffer_size, AtomicSize tx_buffer_size>
 void HALBufferedUART<rx_buffer_size, tx_buffer_size>::handle_irq_rx() volatile {
   bool rxne_enabled = __HAL_UART_GET_IT_SOURCE(&huart_, UART_IT_RXNE) != RESET;
@@ -20,8 +20,16 @@ class HALCRC32 : public CRC32 {
 
   uint32_t compute(const uint8_t *data, size_t size) override;
 
+  // The running value is the internal state of the peripheral, before output inversion
+  uint32_t init() override;
+  uint32_t update(uint32_t running, const uint8_t *data, size_t size) override;
+  uint32_t finalize(uint32_t running) override;
+
  private:
   CRC_HandleTypeDef &hcrc_;
+
+  [[nodiscard]] uint32_t init_value() const;
+  [[nodiscard]] uint32_t invert_output(uint32_t value) const;
 };
 
 }  // namespace Pufferfish::HAL
@@ -0,0 +1,226 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * HALDMABufferedUART.h
+ *
+ *  A DMA-backed UART I/O endpoint, exposing the same buffered read/write
+ * interface as HALBufferedUART without taking an interrupt for every byte.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include "Pufferfish/HAL/Interfaces/BufferedUART.h"
+#include "Pufferfish/HAL/STM32/HALTime.h"
+#include "Pufferfish/Statuses.h"
+#include "Pufferfish/Types.h"
+#include "stm32h7xx_hal.h"
+
+namespace Pufferfish::HAL {
+
+/**
+ * UART RX and TX with non-blocking queue interface, backed by DMA.
+ *
+ * RX uses a circular DMA buffer which the DMA controller fills continuously;
+ * the position of the DMA controller in that buffer is sampled whenever the
+ * UART line goes idle and whenever the DMA controller reaches the half-way
+ * point or the end of the buffer, so a burst of received bytes costs a few
+ * interrupts rather than one interrupt per byte.
+ *
+ * TX uses a pair of ping-pong DMA buffers: written bytes are copied straight
+ * into the buffer which is not being transmitted, and when the transmission
+ * of the other buffer completes the buffers are swapped and the filled buffer
+ * is transmitted by DMA. Interrupts are only masked briefly around each
+ * write, not while its bytes are copied, so writes must only be made from
+ * one context at a time, such as the main loop.
+ *
+ * The UART handle must have its RX DMA stream configured in circular mode and
+ * its TX DMA stream configured in normal mode. If either stream is missing or
+ * the RX transfer can't be started, setup_irq() returns an error and the UART
+ * stays stopped, so the owner must check its status. The buffers are members of
+ * this object, so the object must be placed in a memory region which the DMA
+ * controller can access and which is not cached (or the D-cache must be
+ * disabled); with the default linker script, globals are placed in AXI SRAM,
+ * which satisfies both requirements while the D-cache is disabled.
+ *
+ * The owner must route the following events to this object:
+ * - handle_irq() from the UART's interrupt handler, before HAL_UART_IRQHandler
+ * - handle_rx_dma_event() from HAL_UART_RxHalfCpltCallback and HAL_UART_RxCpltCallback
+ * - handle_tx_dma_complete() from HAL_UART_TxCpltCallback
+ */
+template <AtomicSize rx_buffer_size, AtomicSize tx_buffer_size>
+class HALDMABufferedUART : public BufferedUART {
+ public:
+  static_assert(
+      rx_buffer_size > 0 && (rx_buffer_size & (rx_buffer_size - 1)) == 0,
+      "RX buffer size must be a power of two");
+  static_assert(
+      rx_buffer_size <= UINT16_MAX, "RX buffer size must fit in a single DMA transfer");
+  static_assert(
+      tx_buffer_size >= 2 && tx_buffer_size % 2 == 0,
+      "TX buffer size must be split evenly into two ping-pong buffers");
+  static_assert(
+      tx_buffer_size / 2 <= UINT16_MAX, "TX buffer size must fit in two DMA transfers");
+
+  static constexpr AtomicSize tx_half_size = tx_buffer_size / 2;
+
+  explicit HALDMABufferedUART(UART_HandleTypeDef &huart, Time &time);
+
+  /**
+   * Attempt to "pop" the next received byte from the RX queue.
+   *
+   * Gives up without causing any side-effects if the RX queue is empty;
+   * if it gives up, readByte will be left unmodified.
+   * @param readByte[[out] the byte popped from the RX queue
+   * @return ok on success, empty otherwise
+   */
+  BufferStatus read(uint8_t &read_byte) volatile override;
+
+  /**
+   * Attempt to "push" the provided byte onto the TX queue.
+   *
+   * Gives up without causing any side-effects if the TX queue is full.
+   * @param writeByte the byte to push onto the TX queue
+   * @return ok on success, full otherwise
+   */
+  BufferStatus write(uint8_t write_byte) volatile override;
+
+  /**
+   * "Push" bytes in the provided buffer onto the TX queue until either
+   * all provided bytes are pushed or the TX queue becomes full.
+   *
+   * The bytes are copied directly into the TX DMA buffer which is being
+   * filled, and a DMA transfer is started immediately if none is in progress.
+   * @param writeBytes a pointer to the start of the buffer of bytes to push
+   * @param writeSize the number of bytes in the buffer to push
+   * @param writtenSize[out] the number of bytes successfully pushed onto the TX
+   * queue
+   * @return ok if all provided bytes were added to the queue, partial otherwise
+   */
+  BufferStatus write(
+      const uint8_t *write_bytes,
+      AtomicSize write_size,
+      HAL::AtomicSize &written_size) volatile override;
+
+  /**
+   * Persistently attempt to "push" the provided byte onto the TX queue
+   * until the byte gets pushed or the timeout has elapsed.
+   * @param writeByte the byte to push onto the TX queue
+   * @param uint32_t timeout the length of time in ms to retry pushing the byte
+   * if the TX queue is full
+   * @return ok on success, full otherwise
+   */
+  BufferStatus write_block(uint8_t write_byte, uint32_t timeout) volatile override;
+
+  /**
+   * Persistently attempt to "push" bytes in the provided buffer onto the TX
+   * queue until either all provided bytes are pushed or the timeout has
+   * elapsed.
+   * @param writeBytes a pointer to the start of the buffer of bytes to push
+   * @param writeSize the number of bytes in the buffer to push
+   * @param timeout the length of time in ms to retry pushing bytes when the TX
+   * queue is full
+   * @param writtenSize[out] the number of bytes successfully pushed onto the TX
+   * queue
+   * @return ok if all provided bytes were added to the queue, partial otherwise
+   */
+  BufferStatus write_block(
+      const uint8_t *write_bytes,
+      AtomicSize write_size,
+      uint32_t timeout,
+      HAL::AtomicSize &written_size) volatile override;
+
+  /**
+   * Start the circular RX DMA transfer and enable the UART idle-line interrupt,
+   * and start transmitting any bytes which were written before.
+   * @return ok on success, error if the UART handle has no RX or TX DMA stream
+   * or the RX DMA transfer could not be started
+   */
+  [[nodiscard]] UARTStatus setup_irq() volatile;
+
+  /**
+   * Handle the UART interrupt, which samples the RX DMA position when the
+   * UART line goes idle.
+   */
+  void handle_irq() volatile;
+
+  /**
+   * Handle the RX DMA half-transfer and transfer-complete events, which sample
+   * the RX DMA position before the DMA controller wraps around the buffer.
+   */
+  void handle_rx_dma_event() volatile;
+
+  /**
+   * Handle the TX DMA transfer-complete event, which starts the transmission of
+   * the other TX buffer if it has been filled.
+   */
+  void handle_tx_dma_complete() volatile;
+
+  /**
+   * A counter of the number of received UART bytes which were discarded.
+   *
+   * Received UART bytes are discarded when the DMA controller overwrites them
+   * in the circular RX buffer before they are read. If you are seeing many
+   * dropped bytes, you are not consuming bytes from the RX queue quickly
+   * enough.
+   * @return the total number of received UART bytes which were discarded.
+   */
+  [[nodiscard]] uint32_t rx_dropped() const volatile;
+
+ private:
+  // Masks interrupts for its lifetime, restoring the previous interrupt mask afterwards
+  class InterruptLock {
+   public:
+    InterruptLock() : primask_(__get_PRIMASK()) { __disable_irq(); }
+    ~InterruptLock() { __set_PRIMASK(primask_); }
+
+    InterruptLock(const InterruptLock &) = delete;
+    InterruptLock &operator=(const InterruptLock &) = delete;
+    InterruptLock(InterruptLock &&) = delete;
+    InterruptLock &operator=(InterruptLock &&) = delete;
+
+   private:
+    uint32_t primask_;
+  };
+
+  static const AtomicSize rx_index_mask = rx_buffer_size - 1;
+
+  UART_HandleTypeDef &huart_;
+  Time &time_;
+
+  // We have to use C-style arrays because std::array doesn't work with volatile
+  // NOLINTNEXTLINE(modernize-avoid-c-arrays)
+  uint8_t rx_dma_buffer_[rx_buffer_size]{};
+  // Monotonic counts of bytes written into the RX buffer by DMA and read out of it
+  volatile uint32_t rx_written_ = 0;
+  volatile uint32_t rx_read_ = 0;
+  volatile AtomicSize rx_dma_position_ = 0;
+  volatile uint32_t rx_dropped_ = 0;
+
+  // NOLINTNEXTLINE(modernize-avoid-c-arrays)
+  uint8_t tx_dma_buffers_[2][tx_half_size]{};
+  volatile AtomicSize tx_fill_index_ = 0;
+  volatile AtomicSize tx_fill_size_ = 0;
+  volatile bool tx_busy_ = false;
+  // Whether a write is copying bytes into the buffer being filled, which mustn't be transmitted
+  // until the copy is done
+  volatile bool tx_filling_ = false;
+
+  // Whether setup_irq has started the DMA transfers; until then, the DMA handles may be missing
+  volatile bool dma_ready_ = false;
+
+  void update_rx() volatile;
+  void start_tx() volatile;
+};
+
+static const size_t large_dma_uart_buffer_size = 4096;
+using LargeDMABufferedUART =
+    HALDMABufferedUART<large_dma_uart_buffer_size, large_dma_uart_buffer_size>;
+
+static const size_t read_only_dma_uart_buffer_size = 512;
+using ReadOnlyDMABufferedUART = HALDMABufferedUART<read_only_dma_uart_buffer_size, 2>;
+
+}  // namespace Pufferfish::HAL
+
+#include "Pufferfish/HAL/STM32/HALDMABufferedUART.tpp"
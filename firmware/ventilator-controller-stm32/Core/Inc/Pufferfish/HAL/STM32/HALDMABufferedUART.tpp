@@ -0,0 +1,231 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * HALDMABufferedUART.tpp
+ *
+ *  A DMA-backed UART I/O endpoint, exposing a buffered read/write interface.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+
+#include "HALDMABufferedUART.h"
+
+namespace Pufferfish::HAL {
+
+template <AtomicSize rx_buffer_size, AtomicSize tx_buffer_size>
+HALDMABufferedUART<rx_buffer_size, tx_buffer_size>::HALDMABufferedUART(
+    UART_HandleTypeDef &huart, HAL::Time &time)
+    : huart_(huart), time_(time) {}
+
+template <AtomicSize rx_buffer_size, AtomicSize tx_buffer_size>
+BufferStatus HALDMABufferedUART<rx_buffer_size, tx_buffer_size>::read(
+    uint8_t &read_byte) volatile {
+  uint32_t read = rx_read_;
+  if (read == rx_written_) {
+    return BufferStatus::empty;
+  }
+
+  // rx_written_ is only sampled on events which occur every half buffer, so the DMA controller
+  // may have written up to half a buffer more since then. Once that much is unread, the oldest
+  // unread byte may be overwritten at any time, so the DMA position is sampled before and after
+  // the byte is copied out to check that the copy is intact.
+  bool lapping = rx_written_ - read >= rx_buffer_size / 2;
+  if (lapping) {
+    update_rx();
+  }
+  while (true) {
+    uint32_t written = rx_written_;
+    if (written - read > rx_buffer_size) {
+      // The DMA controller has wrapped around past unread bytes, so skip to the oldest intact
+      // byte
+      rx_dropped_ += written - read - rx_buffer_size;
+      read = written - rx_buffer_size;
+    }
+    read_byte = rx_dma_buffer_[read & rx_index_mask];
+    if (!lapping) {
+      break;
+    }
+
+    update_rx();
+    if (rx_written_ - read <= rx_buffer_size) {
+      break;
+    }
+    // The byte was overwritten while it was copied, so retry with the oldest intact byte
+  }
+  rx_read_ = read + 1;
+  return BufferStatus::ok;
+}
+
+template <AtomicSize rx_buffer_size, AtomicSize tx_buffer_size>
+BufferStatus HALDMABufferedUART<rx_buffer_size, tx_buffer_size>::write(
+    uint8_t write_byte) volatile {
+  AtomicSize written_size = 0;
+  if (write(&write_byte, 1, written_size) != BufferStatus::ok) {
+    return BufferStatus::full;
+  }
+  return BufferStatus::ok;
+}
+
+template <AtomicSize rx_buffer_size, AtomicSize tx_buffer_size>
+BufferStatus HALDMABufferedUART<rx_buffer_size, tx_buffer_size>::write(
+    const uint8_t *write_bytes, AtomicSize write_size, HAL::AtomicSize &written_size) volatile {
+  // Interrupts are only masked to reserve space in the buffer being filled and to commit it, not
+  // while the bytes are copied, so that a large write doesn't delay other interrupts
+  AtomicSize fill_size = 0;
+  uint8_t *fill_buffer = nullptr;
+  {
+    InterruptLock lock;
+    fill_size = tx_fill_size_;
+    written_size = std::min(write_size, tx_half_size - fill_size);
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+    fill_buffer = const_cast<uint8_t *>(tx_dma_buffers_[tx_fill_index_]);
+    tx_filling_ = true;
+  }
+  std::memcpy(fill_buffer + fill_size, write_bytes, written_size);
+  {
+    InterruptLock lock;
+    tx_fill_size_ = fill_size + written_size;
+    tx_filling_ = false;
+    start_tx();
+  }
+  if (write_size == written_size) {
+    return BufferStatus::ok;
+  }
+  return BufferStatus::partial;
+}
+
+template <AtomicSize rx_buffer_size, AtomicSize tx_buffer_size>
+BufferStatus HALDMABufferedUART<rx_buffer_size, tx_buffer_size>::write_block(
+    uint8_t write_byte, uint32_t timeout) volatile {
+  uint32_t start = time_.millis();
+  while (true) {
+    if (write(write_byte) == BufferStatus::ok) {
+      return BufferStatus::ok;
+    }
+    if ((timeout > 0) && ((time_.millis() - start) > timeout)) {
+      return BufferStatus::full;
+    }
+  }
+}
+
+template <AtomicSize rx_buffer_size, AtomicSize tx_buffer_size>
+BufferStatus HALDMABufferedUART<rx_buffer_size, tx_buffer_size>::write_block(
+    const uint8_t *write_bytes,
+    AtomicSize write_size,
+    uint32_t timeout,
+    HAL::AtomicSize &written_size) volatile {
+  uint32_t start = time_.millis();
+  while (written_size < write_size) {
+    AtomicSize just_written = 0;
+    write(write_bytes + written_size, write_size - written_size, just_written);
+    written_size += just_written;
+    if ((timeout > 0) && ((time_.millis() - start) > timeout)) {
+      break;
+    }
+  }
+  if (write_size == written_size) {
+    return BufferStatus::ok;
+  }
+  return BufferStatus::partial;
+}
+
+template <AtomicSize rx_buffer_size, AtomicSize tx_buffer_size>
+UARTStatus HALDMABufferedUART<rx_buffer_size, tx_buffer_size>::setup_irq() volatile {
+  // Without a DMA stream the HAL silently skips the transfer, and update_rx would then read the
+  // counter of a missing stream
+  if (huart_.hdmarx == nullptr || huart_.hdmatx == nullptr) {
+    return UARTStatus::error;
+  }
+
+  // An overrun error would make the HAL abort the RX DMA transfer, so overruns are ignored;
+  // the circular buffer is serviced by DMA and only overflows if it isn't read
+  __HAL_UART_DISABLE(&huart_);
+  SET_BIT(huart_.Instance->CR3, USART_CR3_OVRDIS);
+  __HAL_UART_ENABLE(&huart_);
+
+  rx_dma_position_ = 0;
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+  auto *rx_buffer = const_cast<uint8_t *>(rx_dma_buffer_);
+  if (HAL_UART_Receive_DMA(&huart_, rx_buffer, rx_buffer_size) != HAL_OK) {
+    return UARTStatus::error;
+  }
+  __HAL_UART_CLEAR_IDLEFLAG(&huart_);
+  __HAL_UART_ENABLE_IT(&huart_, UART_IT_IDLE);
+
+  InterruptLock lock;
+  dma_ready_ = true;
+  start_tx();
+  return UARTStatus::ok;
+}
+
+template <AtomicSize rx_buffer_size, AtomicSize tx_buffer_size>
+void HALDMABufferedUART<rx_buffer_size, tx_buffer_size>::handle_irq() volatile {
+  bool idle_enabled = __HAL_UART_GET_IT_SOURCE(&huart_, UART_IT_IDLE) != RESET;
+  bool idle_flagged = __HAL_UART_GET_FLAG(&huart_, UART_FLAG_IDLE) != RESET;
+  if (!idle_enabled || !idle_flagged) {  // check for idle line interrupt
+    return;
+  }
+
+  __HAL_UART_CLEAR_IDLEFLAG(&huart_);
+  update_rx();
+}
+
+template <AtomicSize rx_buffer_size, AtomicSize tx_buffer_size>
+void HALDMABufferedUART<rx_buffer_size, tx_buffer_size>::handle_rx_dma_event() volatile {
+  update_rx();
+}
+
+template <AtomicSize rx_buffer_size, AtomicSize tx_buffer_size>
+void HALDMABufferedUART<rx_buffer_size, tx_buffer_size>::handle_tx_dma_complete() volatile {
+  InterruptLock lock;
+  tx_busy_ = false;
+  start_tx();
+}
+
+template <AtomicSize rx_buffer_size, AtomicSize tx_buffer_size>
+uint32_t HALDMABufferedUART<rx_buffer_size, tx_buffer_size>::rx_dropped() const volatile {
+  return rx_dropped_;
+}
+
+template <AtomicSize rx_buffer_size, AtomicSize tx_buffer_size>
+void HALDMABufferedUART<rx_buffer_size, tx_buffer_size>::update_rx() volatile {
+  // The UART and DMA interrupts may have different priorities, so they may preempt each other
+  InterruptLock lock;
+  if (!dma_ready_) {
+    return;
+  }
+
+  // The DMA counter counts down the bytes remaining before the circular buffer wraps around
+  AtomicSize position = (rx_buffer_size - __HAL_DMA_GET_COUNTER(huart_.hdmarx)) & rx_index_mask;
+  // Events occur at least every half buffer, so the DMA controller can't have lapped us
+  rx_written_ = rx_written_ + ((position - rx_dma_position_) & rx_index_mask);
+  rx_dma_position_ = position;
+}
+
+template <AtomicSize rx_buffer_size, AtomicSize tx_buffer_size>
+void HALDMABufferedUART<rx_buffer_size, tx_buffer_size>::start_tx() volatile {
+  // Must be called with interrupts masked
+  if (!dma_ready_ || tx_busy_ || tx_filling_ || tx_fill_size_ == 0) {
+    return;
+  }
+
+  AtomicSize index = tx_fill_index_;
+  AtomicSize size = tx_fill_size_;
+  tx_fill_index_ = index ^ 1U;
+  tx_fill_size_ = 0;
+  tx_busy_ = true;
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+  auto *buffer = const_cast<uint8_t *>(tx_dma_buffers_[index]);
+  if (HAL_UART_Transmit_DMA(&huart_, buffer, static_cast<uint16_t>(size)) != HAL_OK) {
+    // The bytes stay in the buffer being filled, so the next write or completed transfer
+    // retries them
+    tx_fill_index_ = index;
+    tx_fill_size_ = size;
+    tx_busy_ = false;
+  }
+}
+
+}  // namespace Pufferfish::HAL
@@ -50,6 +50,13 @@ class HALTime : public Time {
    */
   uint32_t micros() override;
 
+  /**
+   * @brief  Returns the DWT cycle counter, which must be enabled by micros_delay_init
+   * @param  None
+   * @return CPU cycles since the counter was reset, modulo 2^32
+   */
+  static uint32_t cycles();
+
   /**
    * @brief mock delay in micros
    * @param microseconds delay in micro seconds
@@ -11,6 +11,7 @@
 #include <cstdint>
 
 #include "Pufferfish/HAL/Interfaces/CRCChecker.h"
+#include "Pufferfish/Util/Span.h"
 #include "Pufferfish/Util/Vector.h"
 
 namespace Pufferfish::Protocols {
@@ -46,9 +47,11 @@ class CRCElement {
   template <size_t input_size>
   IndexStatus parse(
       const Util::ByteVector<input_size> &input_buffer);  // updates all fields, including payload
+  IndexStatus parse(const Util::ByteView &input_buffer);  // updates all fields, including payload
 
   template <size_t buffer_size>
   static uint32_t compute_body_crc(const Util::ByteVector<buffer_size> &buffer, HAL::CRC32 &crc32c);
+  static uint32_t compute_body_crc(const Util::ByteView &buffer, HAL::CRC32 &crc32c);
 
  private:
   uint32_t crc_ = 0;
@@ -70,6 +73,29 @@ template <size_t body_max_size>
 using ConstructedCRCElement =
     CRCElement<const typename CRCElementProps<body_max_size>::PayloadBuffer>;
 
+// In this CRCElement, the parse method makes the payload refer to the bytes in the
+// input buffer rather than copying them, so the input buffer must outlive the payload.
+using BorrowedCRCElement = CRCElement<Util::ByteView>;
+
+// Computes the CRC of a CRCElement's payload incrementally, as the bytes of the
+// CRCElement body arrive, so that the CRC is already known once the whole body has arrived
+class CRCElementAccumulator {
+ public:
+  explicit CRCElementAccumulator(HAL::CRC32 &crc32c) : crc32c_(crc32c) {}
+
+  // Folds in any bytes which were appended to the body since the last update
+  void update(const Util::ByteView &body);
+  [[nodiscard]] uint32_t crc() const;
+  // Call this before the first byte of each body
+  void reset();
+
+ private:
+  HAL::CRC32 &crc32c_;
+  bool started_ = false;
+  uint32_t running_ = 0;
+  size_t folded_size_ = 0;
+};
+
 // Parses datagrams into payloads, with data integrity checking
 template <size_t body_max_size>
 class CRCElementReceiver {
@@ -84,8 +110,21 @@ class CRCElementReceiver {
       const Util::ByteVector<input_size> &input_buffer,
       ParsedCRCElement<body_max_size> &output_crcelement);
 
+  // Parses without copying the payload out of the input buffer
+  Status transform(const Util::ByteView &input_buffer, BorrowedCRCElement &output_crcelement);
+  // Checks the payload against a CRC which was already computed while the input arrived,
+  // instead of computing it over the whole payload again
+  Status transform(
+      const Util::ByteView &input_buffer,
+      uint32_t payload_crc,
+      BorrowedCRCElement &output_crcelement);
+
  private:
   HAL::CRC32 &crc32c_;
+
+  template <typename InputBuffer, typename PayloadBuffer>
+  Status transform_element(
+      const InputBuffer &input_buffer, CRCElement<PayloadBuffer> &output_crcelement);
 };
 
 // Generates datagrams from payloads
@@ -102,6 +141,12 @@ class CRCElementSender {
       const typename Props::PayloadBuffer &input_payload,
       Util::ByteVector<output_size> &output_buffer);
 
+  // Writes the header into headroom reserved in front of a payload which was already
+  // written into the buffer, so that the payload is not copied. The CRCElement body
+  // starts at body_offset, and the payload runs to the end of the buffer.
+  template <size_t buffer_size>
+  Status transform(Util::ByteVector<buffer_size> &input_output_buffer, size_t body_offset);
+
  private:
   HAL::CRC32 &crc32c_;
 };
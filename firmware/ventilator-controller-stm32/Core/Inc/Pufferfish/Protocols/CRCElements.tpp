@@ -49,21 +49,28 @@ IndexStatus CRCElement<PayloadBuffer>::write_protected(
 template <typename PayloadBuffer>
 template <size_t input_size>
 IndexStatus CRCElement<PayloadBuffer>::parse(const Util::ByteVector<input_size> &input_buffer) {
+  if constexpr (!Util::IsSpan<PayloadBuffer>::value) {
+    static_assert(
+        Util::ByteVector<input_size>::max_size() <=
+            (PayloadBuffer::max_size() + CRCElementHeaderProps::header_size),
+        "Parse method unavailable as the input buffer size is too large");
+  }
+
+  return parse(Util::ByteView(input_buffer));
+}
+
+template <typename PayloadBuffer>
+IndexStatus CRCElement<PayloadBuffer>::parse(const Util::ByteView &input_buffer) {
   static_assert(
       !std::is_const<PayloadBuffer>::value,
       "Parse method unavailable for CRCElements with const PayloadBuffer type");
-  static_assert(
-      Util::ByteVector<input_size>::max_size() <=
-          (PayloadBuffer::max_size() + CRCElementHeaderProps::header_size),
-      "Parse method unavailable as the input buffer size is too large");
 
   if (input_buffer.size() < CRCElementHeaderProps::header_size) {
     return IndexStatus::out_of_bounds;
   }
   Util::read_ntoh(input_buffer.buffer(), crc_);
-  if (payload_.copy_from(
-          input_buffer.buffer() + CRCElementHeaderProps::payload_offset,
-          input_buffer.size() - CRCElementHeaderProps::payload_offset) != IndexStatus::ok) {
+  if (Util::assign(payload_, input_buffer.subspan(CRCElementHeaderProps::payload_offset)) !=
+      IndexStatus::ok) {
     return IndexStatus::out_of_bounds;
   };
   return IndexStatus::ok;
@@ -73,12 +80,49 @@ template <typename PayloadBuffer>
 template <size_t buffer_size>
 uint32_t CRCElement<PayloadBuffer>::compute_body_crc(
     const Util::ByteVector<buffer_size> &buffer, HAL::CRC32 &crc32c) {
+  return compute_body_crc(Util::ByteView(buffer), crc32c);
+}
+
+template <typename PayloadBuffer>
+uint32_t CRCElement<PayloadBuffer>::compute_body_crc(
+    const Util::ByteView &buffer, HAL::CRC32 &crc32c) {
   return crc32c.compute(
       buffer.buffer() + CRCElementHeaderProps::payload_offset,  // exclude the CRC field
       buffer.size() - sizeof(uint32_t)                          // exclude the size of the CRC field
   );
 }
 
+// CRCElementAccumulator
+
+inline void CRCElementAccumulator::update(const Util::ByteView &body) {
+  if (!started_) {
+    running_ = crc32c_.init();
+    folded_size_ = CRCElementHeaderProps::payload_offset;  // exclude the CRC field
+    started_ = true;
+  }
+
+  if (body.size() <= folded_size_) {
+    return;
+  }
+
+  running_ = crc32c_.update(running_, body.buffer() + folded_size_, body.size() - folded_size_);
+  folded_size_ = body.size();
+}
+
+inline uint32_t CRCElementAccumulator::crc() const {
+  if (!started_) {
+    return crc32c_.finalize(crc32c_.init());
+  }
+
+  return crc32c_.finalize(running_);
+}
+
+inline void CRCElementAccumulator::reset() {
+  started_ = false;
+  running_ = 0;
+  folded_size_ = 0;
+}
+
 // CRCElementReceiver
 
 template <size_t body_max_size>
@@ -86,11 +130,41 @@ template <size_t input_size>
 typename CRCElementReceiver<body_max_size>::Status CRCElementReceiver<body_max_size>::transform(
     const Util::ByteVector<input_size> &input_buffer,
     ParsedCRCElement<body_max_size> &output_crcelement) {
+  return transform_element(input_buffer, output_crcelement);
+}
+
+template <size_t body_max_size>
+typename CRCElementReceiver<body_max_size>::Status CRCElementReceiver<body_max_size>::transform(
+    const Util::ByteView &input_buffer, BorrowedCRCElement &output_crcelement) {
+  return transform_element(input_buffer, output_crcelement);
+}
+
+template <size_t body_max_size>
+typename CRCElementReceiver<body_max_size>::Status CRCElementReceiver<body_max_size>::transform(
+    const Util::ByteView &input_buffer,
+    uint32_t payload_crc,
+    BorrowedCRCElement &output_crcelement) {
   if (output_crcelement.parse(input_buffer) != IndexStatus::ok) {
     return Status::invalid_parse;
   }
 
-  if (ParsedCRCElement<body_max_size>::compute_body_crc(input_buffer, crc32c_) !=
+  if (payload_crc != output_crcelement.crc()) {
+    return Status::invalid_crc;
+  }
+
+  return Status::ok;
+}
+
+template <size_t body_max_size>
+template <typename InputBuffer, typename PayloadBuffer>
+typename CRCElementReceiver<body_max_size>::Status
+CRCElementReceiver<body_max_size>::transform_element(
+    const InputBuffer &input_buffer, CRCElement<PayloadBuffer> &output_crcelement) {
+  if (output_crcelement.parse(input_buffer) != IndexStatus::ok) {
+    return Status::invalid_parse;
+  }
+
+  if (CRCElement<PayloadBuffer>::compute_body_crc(input_buffer, crc32c_) !=
       output_crcelement.crc()) {
     return Status::invalid_crc;
   }
@@ -113,4 +187,23 @@ typename CRCElementSender<body_max_size>::Status CRCElementSender<body_max_size>
   return Status::ok;
 }
 
+template <size_t body_max_size>
+template <size_t buffer_size>
+typename CRCElementSender<body_max_size>::Status CRCElementSender<body_max_size>::transform(
+    Util::ByteVector<buffer_size> &input_output_buffer, size_t body_offset) {
+  size_t payload_offset = body_offset + CRCElementHeaderProps::payload_offset;
+  if (input_output_buffer.size() < payload_offset) {
+    return Status::invalid_length;
+  }
+
+  size_t payload_size = input_output_buffer.size() - payload_offset;
+  if (payload_size > Props::payload_max_size) {
+    return Status::invalid_length;
+  }
+
+  uint32_t crc = crc32c_.compute(input_output_buffer.buffer() + payload_offset, payload_size);
+  Util::write_hton(crc, input_output_buffer.buffer() + body_offset);
+  return Status::ok;
+}
+
 }  // namespace Pufferfish::Protocols
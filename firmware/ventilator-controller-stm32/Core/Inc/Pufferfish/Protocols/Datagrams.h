@@ -10,6 +10,7 @@
 #include <cstddef>
 #include <cstdint>
 
+#include "Pufferfish/Util/Span.h"
 #include "Pufferfish/Util/Vector.h"
 
 namespace Pufferfish::Protocols {
@@ -49,6 +50,7 @@ class Datagram {
   template <size_t input_size>
   IndexStatus parse(
       const Util::ByteVector<input_size> &input_buffer);  // updates all fields, including payload
+  IndexStatus parse(const Util::ByteView &input_buffer);  // updates all fields, including payload
 
  private:
   uint8_t seq_ = 0;
@@ -67,6 +69,10 @@ using ParsedDatagram = Datagram<typename DatagramProps<body_max_size>::PayloadBu
 template <size_t body_max_size>
 using ConstructedDatagram = Datagram<const typename DatagramProps<body_max_size>::PayloadBuffer>;
 
+// In this Datagram, the parse method makes the payload refer to the bytes in the
+// input buffer rather than copying them, so the input buffer must outlive the payload.
+using BorrowedDatagram = Datagram<Util::ByteView>;
+
 // Parses datagrams into payloads, with data integrity checking
 template <size_t body_max_size>
 class DatagramReceiver {
@@ -81,8 +87,15 @@ class DatagramReceiver {
       const Util::ByteVector<input_size> &input_buffer,
       ParsedDatagram<body_max_size> &output_datagram);
 
+  // Parses without copying the payload out of the input buffer
+  Status transform(const Util::ByteView &input_buffer, BorrowedDatagram &output_datagram);
+
  private:
   uint8_t expected_seq_ = 0;
+
+  template <typename InputBuffer, typename PayloadBuffer>
+  Status transform_datagram(
+      const InputBuffer &input_buffer, Datagram<PayloadBuffer> &output_datagram);
 };
 
 // Generates datagrams from payloads
@@ -99,6 +112,12 @@ class DatagramSender {
       const typename Props::PayloadBuffer &input_payload,
       Util::ByteVector<output_size> &output_buffer);
 
+  // Writes the header into headroom reserved in front of a payload which was already
+  // written into the buffer, so that the payload is not copied. The datagram body
+  // starts at body_offset, and the payload runs to the end of the buffer.
+  template <size_t buffer_size>
+  Status transform(Util::ByteVector<buffer_size> &input_output_buffer, size_t body_offset);
+
  private:
   uint8_t next_seq_ = 0;
 };
@@ -37,6 +37,11 @@ IndexStatus Datagram<PayloadBuffer>::write(Util::ByteVector<output_size> &output
 template <typename PayloadBuffer>
 template <size_t input_size>
 IndexStatus Datagram<PayloadBuffer>::parse(const Util::ByteVector<input_size> &input_buffer) {
+  return parse(Util::ByteView(input_buffer));
+}
+
+template <typename PayloadBuffer>
+IndexStatus Datagram<PayloadBuffer>::parse(const Util::ByteView &input_buffer) {
   static_assert(
       !std::is_const<PayloadBuffer>::value,
       "Parse method unavailable for Datagrams with const PayloadBuffer type");
@@ -46,9 +51,8 @@ IndexStatus Datagram<PayloadBuffer>::parse(const Util::ByteVector<input_size> &i
   }
   seq_ = input_buffer[DatagramHeaderProps::seq_offset];
   length_ = input_buffer[DatagramHeaderProps::length_offset];
-  if (payload_.copy_from(
-          input_buffer.buffer() + DatagramHeaderProps::payload_offset,
-          input_buffer.size() - DatagramHeaderProps::payload_offset) != IndexStatus::ok) {
+  if (Util::assign(payload_, input_buffer.subspan(DatagramHeaderProps::payload_offset)) !=
+      IndexStatus::ok) {
     return IndexStatus::out_of_bounds;
   };
   return IndexStatus::ok;
@@ -61,6 +65,20 @@ template <size_t input_size>
 typename DatagramReceiver<body_max_size>::Status DatagramReceiver<body_max_size>::transform(
     const Util::ByteVector<input_size> &input_buffer,
     ParsedDatagram<body_max_size> &output_datagram) {
+  return transform_datagram(input_buffer, output_datagram);
+}
+
+template <size_t body_max_size>
+typename DatagramReceiver<body_max_size>::Status DatagramReceiver<body_max_size>::transform(
+    const Util::ByteView &input_buffer, BorrowedDatagram &output_datagram) {
+  return transform_datagram(input_buffer, output_datagram);
+}
+
+template <size_t body_max_size>
+template <typename InputBuffer, typename PayloadBuffer>
+typename DatagramReceiver<body_max_size>::Status
+DatagramReceiver<body_max_size>::transform_datagram(
+    const InputBuffer &input_buffer, Datagram<PayloadBuffer> &output_datagram) {
   if (output_datagram.parse(input_buffer) != IndexStatus::ok) {
     return Status::invalid_parse;
   }
@@ -94,4 +112,25 @@ typename DatagramSender<body_max_size>::Status DatagramSender<body_max_size>::tr
   return Status::ok;
 }
 
+template <size_t body_max_size>
+template <size_t buffer_size>
+typename DatagramSender<body_max_size>::Status DatagramSender<body_max_size>::transform(
+    Util::ByteVector<buffer_size> &input_output_buffer, size_t body_offset) {
+  size_t payload_offset = body_offset + DatagramHeaderProps::payload_offset;
+  if (input_output_buffer.size() < payload_offset) {
+    return Status::invalid_length;
+  }
+
+  size_t payload_size = input_output_buffer.size() - payload_offset;
+  if (payload_size > Props::payload_max_size) {
+    return Status::invalid_length;
+  }
+
+  input_output_buffer[body_offset + DatagramHeaderProps::seq_offset] = next_seq_;
+  input_output_buffer[body_offset + DatagramHeaderProps::length_offset] =
+      static_cast<uint8_t>(payload_size);
+  ++next_seq_;
+  return Status::ok;
+}
+
 }  // namespace Pufferfish::Protocols
@@ -0,0 +1,66 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * Deltas.h
+ *
+ *  Streams of messages of a single type, in which most messages are replaced by their
+ *  deltas from the previous message and the rest are sent whole as keyframes.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include "Pufferfish/Util/Deltas.h"
+
+namespace Pufferfish::Protocols {
+
+// Replaces messages with their deltas from the previous message; every keyframe_interval-th
+// message is instead sent whole, so that a receiver which missed a message can resynchronize
+template <typename MessageType, size_t keyframe_interval>
+class DeltaSender {
+ public:
+  static_assert(keyframe_interval > 0, "Keyframe interval must be positive");
+
+  // ok means the delta should be sent in place of the message; keyframe means the
+  // message should be sent whole, and the delta is not written
+  enum class Status { ok = 0, keyframe };
+
+  DeltaSender() = default;
+
+  Status transform(const MessageType &input_message, Util::Delta<MessageType> &output_delta);
+
+  // The next message will be a keyframe
+  void reset();
+
+ private:
+  MessageType reference_{};
+  size_t since_keyframe_ = keyframe_interval;
+};
+
+// Reconstructs messages from deltas against the previous message received
+template <typename MessageType>
+class DeltaReceiver {
+ public:
+  enum class Status { ok = 0, invalid_reference };
+
+  DeltaReceiver() = default;
+
+  // Call this with every message which was received whole
+  void input(const MessageType &keyframe);
+
+  // Deltas are rejected until a keyframe has been received
+  Status transform(const Util::Delta<MessageType> &input_delta, MessageType &output_message);
+
+  // Call this whenever messages may have been lost, such as after a gap in datagram sequence
+  // numbers; deltas will be rejected until the next keyframe
+  void reset();
+
+ private:
+  MessageType reference_{};
+  bool synchronized_ = false;
+};
+
+}  // namespace Pufferfish::Protocols
+
+#include "Deltas.tpp"
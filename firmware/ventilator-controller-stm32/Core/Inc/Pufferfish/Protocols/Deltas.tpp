@@ -0,0 +1,64 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * Deltas.tpp
+ *
+ *  Streams of messages of a single type, in which most messages are replaced by their
+ *  deltas from the previous message and the rest are sent whole as keyframes.
+ */
+
+#pragma once
+
+#include "Deltas.h"
+
+namespace Pufferfish::Protocols {
+
+// DeltaSender
+
+template <typename MessageType, size_t keyframe_interval>
+typename DeltaSender<MessageType, keyframe_interval>::Status
+DeltaSender<MessageType, keyframe_interval>::transform(
+    const MessageType &input_message, Util::Delta<MessageType> &output_delta) {
+  if (since_keyframe_ >= keyframe_interval) {
+    reference_ = input_message;
+    since_keyframe_ = 1;
+    return Status::keyframe;
+  }
+
+  output_delta = Util::make_delta(reference_, input_message);
+  reference_ = input_message;
+  ++since_keyframe_;
+  return Status::ok;
+}
+
+template <typename MessageType, size_t keyframe_interval>
+void DeltaSender<MessageType, keyframe_interval>::reset() {
+  since_keyframe_ = keyframe_interval;
+}
+
+// DeltaReceiver
+
+template <typename MessageType>
+void DeltaReceiver<MessageType>::input(const MessageType &keyframe) {
+  reference_ = keyframe;
+  synchronized_ = true;
+}
+
+template <typename MessageType>
+typename DeltaReceiver<MessageType>::Status DeltaReceiver<MessageType>::transform(
+    const Util::Delta<MessageType> &input_delta, MessageType &output_message) {
+  if (!synchronized_) {
+    return Status::invalid_reference;
+  }
+
+  Util::apply_delta(reference_, input_delta, output_message);
+  reference_ = output_message;
+  return Status::ok;
+}
+
+template <typename MessageType>
+void DeltaReceiver<MessageType>::reset() {
+  synchronized_ = false;
+}
+
+}  // namespace Pufferfish::Protocols
@@ -9,7 +9,10 @@
 
 #include <cstdint>
 
+#include "Pufferfish/Util/Deltas.h"
+#include "Pufferfish/Util/FixedLayout.h"
 #include "Pufferfish/Util/Protobuf.h"
+#include "Pufferfish/Util/Span.h"
 #include "Pufferfish/Util/Vector.h"
 #include "nanopb/pb_common.h"
 
@@ -19,7 +22,10 @@ enum class MessageStatus { ok = 0, invalid_length, invalid_type, invalid_encodin
 
 // Messages
 
-template <typename TaggedUnion, typename MessageTypes, size_t max_size>
+// Registry is a Util::TypeRegistry of the payload types, which are encoded and decoded with
+// their types known at compile time: with a single copy for types with a Util::FixedLayout,
+// as a delta for Util::Delta types, and as protobuf otherwise
+template <typename TaggedUnion, typename Registry, size_t max_size>
 class Message {
  public:
   static const size_t type_offset = 0;
@@ -38,44 +44,43 @@ class Message {
   uint8_t type = 0;
   TaggedUnion payload{};
 
-  template <size_t output_size, size_t num_descriptors>
-  MessageStatus write(
-      Util::ByteVector<output_size> &output_buffer,
-      const Util::ProtobufDescriptors<num_descriptors> &pb_protobuf_descriptors) const;
+  // The message body is written starting at body_offset, so that headroom can be reserved
+  // in front of it for the headers of lower protocol layers
+  template <size_t output_size>
+  MessageStatus write(Util::ByteVector<output_size> &output_buffer, size_t body_offset = 0) const;
 
-  template <size_t input_size, size_t num_descriptors>
+  template <size_t input_size>
   MessageStatus parse(
-      const Util::ByteVector<input_size> &input_buffer,
-      const Util::ProtobufDescriptors<num_descriptors>
-          &pb_protobuf_descriptors);  // updates type and payload fields
+      const Util::ByteVector<input_size> &input_buffer);  // updates type and payload fields
+  MessageStatus parse(const Util::ByteView &input_buffer);  // updates type and payload fields
+
+ private:
+  template <typename Payload, size_t output_size>
+  static MessageStatus write_payload(
+      const Payload &value, Util::ByteVector<output_size> &output_buffer, size_t payload_offset);
+  template <typename Payload>
+  static MessageStatus parse_payload(const Util::ByteView &input_buffer, Payload &value);
 };
 
 // Parses messages into payloads, with data integrity checking
-template <typename Message, size_t num_descriptors>
+template <typename Message>
 class MessageReceiver {
  public:
-  explicit MessageReceiver(const Util::ProtobufDescriptors<num_descriptors> &descriptors);
-
   template <size_t input_size>
   MessageStatus transform(
       const Util::ByteVector<input_size> &input_buffer, Message &output_message) const;
-
- private:
-  const Util::ProtobufDescriptors<num_descriptors> &descriptors_;
+  MessageStatus transform(const Util::ByteView &input_buffer, Message &output_message) const;
 };
 
 // Generates messages from payloads
-template <typename Message, size_t num_descriptors>
+template <typename Message>
 class MessageSender {
  public:
-  explicit MessageSender(const Util::ProtobufDescriptors<num_descriptors> &descriptors);
-
   template <size_t output_size>
   MessageStatus transform(
-      const Message &input_message, Util::ByteVector<output_size> &output_buffer) const;
-
- private:
-  const Util::ProtobufDescriptors<num_descriptors> &descriptors_;
+      const Message &input_message,
+      Util::ByteVector<output_size> &output_buffer,
+      size_t body_offset = 0) const;
 };
 
 }  // namespace Pufferfish::Protocols
@@ -15,99 +15,182 @@ namespace Pufferfish::Protocols {
 
 // Message
 
-template <typename TaggedUnion, typename MessageTypes, size_t max_size>
-template <size_t output_size, size_t num_descriptors>
-MessageStatus Message<TaggedUnion, MessageTypes, max_size>::write(
-    Util::ByteVector<output_size> &output_buffer,
-    const Util::ProtobufDescriptors<num_descriptors> &pb_protobuf_descriptors) const {
-  auto type = static_cast<uint8_t>(payload.tag);
-  if (type > pb_protobuf_descriptors.size()) {
-    return MessageStatus::invalid_type;
-  }
-
-  const pb_msgdesc_t *fields = pb_protobuf_descriptors[type];
-  if (fields == Util::get_protobuf_descriptor<Util::UnrecognizedMessage>()) {
-    return MessageStatus::invalid_type;
+template <typename TaggedUnion, typename Registry, size_t max_size>
+template <size_t output_size>
+MessageStatus Message<TaggedUnion, Registry, max_size>::write(
+    Util::ByteVector<output_size> &output_buffer, size_t body_offset) const {
+  size_t payload_offset = body_offset + header_size;
+  if (payload_offset > output_buffer.max_size()) {
+    return MessageStatus::invalid_length;
   }
 
-  size_t encoded_size = 0;
-  if (!pb_get_encoded_size(&encoded_size, fields, &(payload.value))) {
-    return MessageStatus::invalid_encoding;
+  MessageStatus status = Registry::visit(
+      payload.tag,
+      [&](auto entry) {
+        using Entry = decltype(entry);
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-union-access)
+        return write_payload(payload.value.*Entry::union_member, output_buffer, payload_offset);
+      },
+      MessageStatus::invalid_type);
+  if (status != MessageStatus::ok) {
+    return status;
   }
 
-  if (output_buffer.resize(header_size + encoded_size) != IndexStatus::ok) {
-    return MessageStatus::invalid_length;
-  }
+  output_buffer[body_offset + type_offset] = static_cast<uint8_t>(payload.tag);
+  return MessageStatus::ok;
+}
 
-  output_buffer[type_offset] = type;
-  pb_ostream_t stream = pb_ostream_from_buffer(
-      output_buffer.buffer() + header_size, output_buffer.size() - header_size);
-  if (!pb_encode(&stream, fields, &(payload.value))) {
-    return MessageStatus::invalid_encoding;
+template <typename TaggedUnion, typename Registry, size_t max_size>
+template <typename Payload, size_t output_size>
+MessageStatus Message<TaggedUnion, Registry, max_size>::write_payload(
+    const Payload &value, Util::ByteVector<output_size> &output_buffer, size_t payload_offset) {
+  if constexpr (Util::FixedLayout<Payload>::enabled) {
+    constexpr size_t layout_size = Util::FixedLayout<Payload>::size;
+    if (layout_size > payload_max_size ||
+        output_buffer.resize(payload_offset + layout_size) != IndexStatus::ok) {
+      return MessageStatus::invalid_length;
+    }
+
+    size_t encoded_size = 0;
+    Util::encode_fixed_layout(
+        value, output_buffer.buffer() + payload_offset, layout_size, encoded_size);
+    return MessageStatus::ok;
+  } else if constexpr (Util::DeltaPayload<Payload>::enabled) {
+    size_t capacity = output_buffer.max_size() - payload_offset;
+    if (capacity > payload_max_size) {
+      capacity = payload_max_size;
+    }
+    output_buffer.resize(payload_offset + capacity);
+    size_t encoded_size = 0;
+    if (!Util::encode_delta(
+            value, output_buffer.buffer() + payload_offset, capacity, encoded_size)) {
+      output_buffer.resize(payload_offset);
+      return MessageStatus::invalid_length;
+    }
+
+    output_buffer.resize(payload_offset + encoded_size);
+    return MessageStatus::ok;
+  } else if constexpr (Util::ProtobufCodec<Payload>::generated) {
+    // Generated encoders write straight into the buffer in one pass, up to its capacity
+    size_t capacity = output_buffer.max_size() - payload_offset;
+    if (capacity > payload_max_size) {
+      capacity = payload_max_size;
+    }
+    output_buffer.resize(payload_offset + capacity);
+    size_t encoded_size = 0;
+    if (!Util::encode_protobuf(
+            value, output_buffer.buffer() + payload_offset, capacity, encoded_size)) {
+      output_buffer.resize(payload_offset);
+      return MessageStatus::invalid_length;
+    }
+
+    output_buffer.resize(payload_offset + encoded_size);
+    return MessageStatus::ok;
+  } else {
+    const pb_msgdesc_t *fields = nanopb::MessageDescriptor<Payload>::fields();
+    size_t encoded_size = 0;
+    if (!pb_get_encoded_size(&encoded_size, fields, &value)) {
+      return MessageStatus::invalid_encoding;
+    }
+
+    if (encoded_size > payload_max_size ||
+        output_buffer.resize(payload_offset + encoded_size) != IndexStatus::ok) {
+      return MessageStatus::invalid_length;
+    }
+
+    pb_ostream_t stream = pb_ostream_from_buffer(
+        output_buffer.buffer() + payload_offset, output_buffer.size() - payload_offset);
+    if (!pb_encode(&stream, fields, &value)) {
+      return MessageStatus::invalid_encoding;
+    }
+
+    return MessageStatus::ok;
   }
+}
 
-  return MessageStatus::ok;
+template <typename TaggedUnion, typename Registry, size_t max_size>
+template <size_t input_size>
+MessageStatus Message<TaggedUnion, Registry, max_size>::parse(
+    const Util::ByteVector<input_size> &input_buffer) {
+  return parse(Util::ByteView(input_buffer));
 }
 
-template <typename TaggedUnion, typename MessageTypes, size_t max_size>
-template <size_t input_size, size_t num_descriptors>
-MessageStatus Message<TaggedUnion, MessageTypes, max_size>::parse(
-    const Util::ByteVector<input_size> &input_buffer,
-    const Util::ProtobufDescriptors<num_descriptors> &pb_protobuf_descriptors) {
+template <typename TaggedUnion, typename Registry, size_t max_size>
+MessageStatus Message<TaggedUnion, Registry, max_size>::parse(const Util::ByteView &input_buffer) {
   if (input_buffer.size() < Message::header_size) {
     return MessageStatus::invalid_length;
   }
 
   type = input_buffer[Message::type_offset];
-  if (!MessageTypes::includes(type)) {
-    return MessageStatus::invalid_type;
-  }
-
   payload.tag = static_cast<typename TaggedUnion::Tag>(type);
-  if (type >= pb_protobuf_descriptors.size()) {
-    return MessageStatus::invalid_type;
-  }
-
-  const pb_msgdesc_t *fields = pb_protobuf_descriptors[type];
-  if (fields == Util::get_protobuf_descriptor<Util::UnrecognizedMessage>()) {
-    return MessageStatus::invalid_type;
-  }
+  return Registry::visit(
+      payload.tag,
+      [&](auto entry) {
+        using Entry = decltype(entry);
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-union-access)
+        return parse_payload(input_buffer, payload.value.*Entry::union_member);
+      },
+      MessageStatus::invalid_type);
+}
 
-  pb_istream_t stream = pb_istream_from_buffer(
-      input_buffer.buffer() + header_size, input_buffer.size() - header_size);
-  if (!pb_decode(&stream, fields, &(payload.value))) {
-    return MessageStatus::invalid_encoding;
+template <typename TaggedUnion, typename Registry, size_t max_size>
+template <typename Payload>
+MessageStatus Message<TaggedUnion, Registry, max_size>::parse_payload(
+    const Util::ByteView &input_buffer, Payload &value) {
+  const uint8_t *payload_buffer = input_buffer.buffer() + header_size;
+  size_t payload_size = input_buffer.size() - header_size;
+  if constexpr (Util::FixedLayout<Payload>::enabled) {
+    if (!Util::decode_fixed_layout(payload_buffer, payload_size, value)) {
+      return MessageStatus::invalid_length;
+    }
+
+    return MessageStatus::ok;
+  } else if constexpr (Util::DeltaPayload<Payload>::enabled) {
+    if (!Util::decode_delta(payload_buffer, payload_size, value)) {
+      return MessageStatus::invalid_encoding;
+    }
+
+    return MessageStatus::ok;
+  } else if constexpr (Util::ProtobufCodec<Payload>::generated) {
+    if (!Util::decode_protobuf(payload_buffer, payload_size, value)) {
+      return MessageStatus::invalid_encoding;
+    }
+
+    return MessageStatus::ok;
+  } else {
+    pb_istream_t stream = pb_istream_from_buffer(payload_buffer, payload_size);
+    if (!pb_decode(&stream, nanopb::MessageDescriptor<Payload>::fields(), &value)) {
+      return MessageStatus::invalid_encoding;
+    }
+
+    return MessageStatus::ok;
   }
-
-  return MessageStatus::ok;
 }
 
 // MessageReceiver
 
-template <typename Message, size_t num_descriptors>
-MessageReceiver<Message, num_descriptors>::MessageReceiver(
-    const Util::ProtobufDescriptors<num_descriptors> &descriptors)
-    : descriptors_(descriptors) {}
-
-template <typename Message, size_t num_descriptors>
+template <typename Message>
 template <size_t input_size>
-MessageStatus MessageReceiver<Message, num_descriptors>::transform(
+MessageStatus MessageReceiver<Message>::transform(
     const Util::ByteVector<input_size> &input_buffer, Message &output_message) const {
-  return output_message.parse(input_buffer, descriptors_);
+  return output_message.parse(input_buffer);
 }
 
-// MessageSender
+template <typename Message>
+MessageStatus MessageReceiver<Message>::transform(
+    const Util::ByteView &input_buffer, Message &output_message) const {
+  return output_message.parse(input_buffer);
+}
 
-template <typename Message, size_t num_descriptors>
-MessageSender<Message, num_descriptors>::MessageSender(
-    const Util::ProtobufDescriptors<num_descriptors> &descriptors)
-    : descriptors_(descriptors) {}
+// MessageSender
 
-template <typename Message, size_t num_descriptors>
+template <typename Message>
 template <size_t output_size>
-MessageStatus MessageSender<Message, num_descriptors>::transform(
-    const Message &input_message, Util::ByteVector<output_size> &output_buffer) const {
-  return input_message.write(output_buffer, descriptors_);
+MessageStatus MessageSender<Message>::transform(
+    const Message &input_message,
+    Util::ByteVector<output_size> &output_buffer,
+    size_t body_offset) const {
+  return input_message.write(output_buffer, body_offset);
 }
 
 }  // namespace Pufferfish::Protocols
@@ -15,35 +15,87 @@ namespace Pufferfish::Protocols {
 
 // State Synchronization
 
+// The output rate of one type of state segment, with times in ms. A changing segment is output
+// at most once per interval; a segment which has not changed since it was last output is only
+// output again after the keepalive interval of the synchronizer. When several segments need to
+// be output, changed segments are output before unchanged ones; among changed segments, the one
+// which is furthest past its deadline is output first, and among unchanged segments, the one
+// which is furthest past the keepalive interval is output first.
 template <typename MessageTypes>
-struct StateOutputScheduleEntry {
-  uint32_t delay;
+struct StateOutputRate {
   MessageTypes type;
+  uint32_t interval;
+  uint32_t deadline;
 };
 
 template <typename MessageTypes, size_t size>
-using StateOutputSchedule = std::array<const StateOutputScheduleEntry<MessageTypes>, size>;
+using StateOutputRates = std::array<const StateOutputRate<MessageTypes>, size>;
 
-template <typename States, typename StateSegment, typename MessageTypes, size_t schedule_size>
+// Checks that every output rate is for a type in the registry and that no type has more than
+// one output rate, so that output rates can be validated at compile time with static_assert
+template <typename Registry, typename MessageTypes, size_t size>
+constexpr bool valid_output_rates(const StateOutputRates<MessageTypes, size> &rates) noexcept {
+  for (size_t i = 0; i < size; ++i) {
+    if (!Registry::includes(rates[i].type)) {
+      return false;
+    }
+
+    for (size_t j = i + 1; j < size; ++j) {
+      if (rates[i].type == rates[j].type) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Checks that two sets of output rates are for the same types in the same order, so that a
+// synchronizer can switch between them
+template <typename MessageTypes, size_t size>
+constexpr bool same_output_types(
+    const StateOutputRates<MessageTypes, size> &rates,
+    const StateOutputRates<MessageTypes, size> &other_rates) noexcept {
+  for (size_t i = 0; i < size; ++i) {
+    if (rates[i].type != other_rates[i].type) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename States, typename StateSegment, typename MessageTypes, size_t num_rates>
 class StateSynchronizer {
  public:
   enum class OutputStatus { ok = 0, waiting, invalid_type };
 
   StateSynchronizer(
-      States &all_states, const StateOutputSchedule<MessageTypes, schedule_size> &schedule)
-      : all_states_(all_states), output_schedule_(schedule) {}
+      States &all_states,
+      const StateOutputRates<MessageTypes, num_rates> &rates,
+      uint32_t keepalive_interval)
+      : all_states_(all_states), output_rates_(&rates), keepalive_interval_(keepalive_interval) {}
 
   void input(uint32_t time);
+  // Switches to other output rates, which must be for the same types in the same order as the
+  // current output rates; segments which were already sent are not sent again any sooner
+  void set_rates(const StateOutputRates<MessageTypes, num_rates> &rates);
+  // Call this whenever there is room to send another state segment
   OutputStatus output(StateSegment &output);
 
  private:
+  struct SentSegment {
+    bool sent = false;
+    uint32_t digest = 0;
+    uint32_t time = 0;
+  };
+
   States &all_states_;
-  const StateOutputSchedule<MessageTypes, schedule_size> &output_schedule_;
+  const StateOutputRates<MessageTypes, num_rates> *output_rates_;
+  const uint32_t keepalive_interval_;
   uint32_t current_time_ = 0;
-  size_t current_schedule_entry_ = 0;
-  uint32_t current_schedule_entry_start_time_ = 0;
+  std::array<SentSegment, num_rates> sent_segments_{};
 
-  [[nodiscard]] bool should_output() const;
+  [[nodiscard]] bool should_send(
+      const SentSegment &sent_segment, uint32_t elapsed, uint32_t digest) const;
 };
 
 }  // namespace Pufferfish::Protocols
@@ -7,40 +7,85 @@
 
 #pragma once
 
-#include "Pufferfish/Util/Timeouts.h"
 #include "States.h"
 
 namespace Pufferfish::Protocols {
 
 // StateSynchronizer
 
-template <typename States, typename StateSegment, typename MessageTypes, size_t schedule_size>
-void StateSynchronizer<States, StateSegment, MessageTypes, schedule_size>::input(uint32_t time) {
+template <typename States, typename StateSegment, typename MessageTypes, size_t num_rates>
+void StateSynchronizer<States, StateSegment, MessageTypes, num_rates>::input(uint32_t time) {
   current_time_ = time;
 }
 
-template <typename States, typename StateSegment, typename MessageTypes, size_t schedule_size>
-typename StateSynchronizer<States, StateSegment, MessageTypes, schedule_size>::OutputStatus
-StateSynchronizer<States, StateSegment, MessageTypes, schedule_size>::output(StateSegment &output) {
-  if (!should_output()) {
+template <typename States, typename StateSegment, typename MessageTypes, size_t num_rates>
+void StateSynchronizer<States, StateSegment, MessageTypes, num_rates>::set_rates(
+    const StateOutputRates<MessageTypes, num_rates> &rates) {
+  output_rates_ = &rates;
+}
+
+template <typename States, typename StateSegment, typename MessageTypes, size_t num_rates>
+typename StateSynchronizer<States, StateSegment, MessageTypes, num_rates>::OutputStatus
+StateSynchronizer<States, StateSegment, MessageTypes, num_rates>::output(StateSegment &output) {
+  const StateOutputRates<MessageTypes, num_rates> &output_rates = *output_rates_;
+
+  // Find the segment which needs to be sent and is the most overdue. Segments which changed are
+  // sent before segments which are only due for a keepalive, so that a re-send of unchanged data
+  // never delays fresh data
+  bool found = false;
+  size_t most_overdue = 0;
+  bool most_overdue_changed = false;
+  int64_t most_overdue_lateness = 0;
+  uint32_t most_overdue_digest = 0;
+  for (size_t i = 0; i < output_rates.size(); ++i) {
+    const SentSegment &sent_segment = sent_segments_[i];
+    uint32_t elapsed = current_time_ - sent_segment.time;
+    if (sent_segment.sent && elapsed < output_rates[i].interval) {
+      continue;
+    }
+
+    uint32_t digest = 0;
+    if (all_states_.digest(output_rates[i].type, digest) != States::OutputStatus::ok) {
+      return OutputStatus::invalid_type;
+    }
+    if (!should_send(sent_segment, elapsed, digest)) {
+      continue;
+    }
+
+    // Keepalives are late relative to the keepalive interval, not to the segment's deadline
+    bool changed = !sent_segment.sent || sent_segment.digest != digest;
+    uint32_t deadline = changed ? output_rates[i].deadline : keepalive_interval_;
+    int64_t lateness = static_cast<int64_t>(elapsed) - deadline;
+    bool more_urgent = lateness > most_overdue_lateness;
+    if (changed != most_overdue_changed) {
+      more_urgent = changed;
+    }
+    if (!found || more_urgent) {
+      found = true;
+      most_overdue = i;
+      most_overdue_changed = changed;
+      most_overdue_lateness = lateness;
+      most_overdue_digest = digest;
+    }
+  }
+  if (!found) {
     return OutputStatus::waiting;
   }
 
-  if (all_states_.output(output_schedule_[current_schedule_entry_].type, output) !=
-      States::OutputStatus::ok) {
+  if (all_states_.output(output_rates[most_overdue].type, output) != States::OutputStatus::ok) {
     return OutputStatus::invalid_type;
   }
-  current_schedule_entry_ = (current_schedule_entry_ + 1) % output_schedule_.size();
-  current_schedule_entry_start_time_ = current_time_;
+  SentSegment &sent_segment = sent_segments_[most_overdue];
+  sent_segment.sent = true;
+  sent_segment.digest = most_overdue_digest;
+  sent_segment.time = current_time_;
   return OutputStatus::ok;
 }
 
-template <typename States, typename StateSegment, typename MessageTypes, size_t schedule_size>
-bool StateSynchronizer<States, StateSegment, MessageTypes, schedule_size>::should_output() const {
-  return !Util::within_timeout(
-      current_schedule_entry_start_time_,
-      output_schedule_[current_schedule_entry_].delay,
-      current_time_);
+template <typename States, typename StateSegment, typename MessageTypes, size_t num_rates>
+bool StateSynchronizer<States, StateSegment, MessageTypes, num_rates>::should_send(
+    const SentSegment &sent_segment, uint32_t elapsed, uint32_t digest) const {
+  return !sent_segment.sent || sent_segment.digest != digest || elapsed >= keepalive_interval_;
 }
 
 }  // namespace Pufferfish::Protocols
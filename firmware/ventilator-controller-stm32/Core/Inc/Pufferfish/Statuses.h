@@ -20,6 +20,15 @@ enum class BufferStatus {
 
 enum class IndexStatus { ok = 0, out_of_bounds };
 
+/**
+ * An outcome of reconfiguring a UART
+ */
+enum class UARTStatus {
+  ok = 0,  /// success
+  busy,    /// bytes are still waiting to be transmitted, so try again later
+  error    /// error reconfiguring the UART peripheral
+};
+
 /**
  * Possible alarms that could be raised by the system, must by sorted by
  * priority in ascending order
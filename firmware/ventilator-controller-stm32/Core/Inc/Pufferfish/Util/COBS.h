@@ -30,6 +30,9 @@
 #include <cstddef>
 #include <cstdint>
 
+#include "Pufferfish/Statuses.h"
+#include "Vector.h"
+
 namespace Pufferfish::Util {
 
 /// \brief A Consistent Overhead Byte Stuffing (COBS) Encoder.
@@ -70,4 +73,38 @@ size_t decode_cobs(const uint8_t *encoded_buffer, size_t size, uint8_t *decoded_
 /// \returns the maximum size of the required encoded buffer.
 size_t get_encoded_cobs_buffer_size(size_t unencoded_buffer_size);
 
+/// \brief An incremental COBS decoder.
+///
+/// Decodes an encoded buffer one byte at a time, as the bytes arrive, producing
+/// the same output as decode_cobs would produce for the whole encoded buffer.
+/// Call reset() before the first byte of each encoded buffer.
+class COBSStreamDecoder {
+ public:
+  COBSStreamDecoder() = default;
+
+  /// \brief Decode the next byte of an encoded buffer.
+  /// \param encoded_byte The next byte of the encoded buffer; must not be 0,
+  ///        which is only used as a frame delimiter.
+  /// \param decoded_buffer The target buffer for the decoded bytes.
+  /// \returns ok, or out_of_bounds if the decoded_buffer is full.
+  template <size_t output_size>
+  IndexStatus input(uint8_t encoded_byte, ByteVector<output_size> &decoded_buffer);
+
+  /// \brief Check whether the bytes given so far form a complete encoded buffer.
+  /// \returns false if the last block is missing some of its bytes, in which
+  ///          case decode_cobs would have rejected the encoded buffer.
+  [[nodiscard]] bool complete() const { return block_remaining_ == 0; }
+
+  void reset();
+
+ private:
+  static const uint8_t max_block_code = 0xff;
+
+  bool block_started_ = false;
+  uint8_t block_code_ = 0;
+  uint8_t block_remaining_ = 0;
+};
+
 }  // namespace Pufferfish::Util
+
+#include "COBS.tpp"
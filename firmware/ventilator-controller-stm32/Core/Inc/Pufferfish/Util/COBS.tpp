@@ -0,0 +1,38 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * COBS.tpp
+ *
+ *  Incremental COBS decoding, one encoded byte at a time.
+ */
+
+#pragma once
+
+#include "COBS.h"
+
+namespace Pufferfish::Util {
+
+// COBSStreamDecoder
+
+template <size_t output_size>
+IndexStatus COBSStreamDecoder::input(
+    uint8_t encoded_byte, ByteVector<output_size> &decoded_buffer) {
+  if (block_remaining_ > 0) {
+    --block_remaining_;
+    return decoded_buffer.push_back(encoded_byte);
+  }
+
+  // encoded_byte is the code of a new block, so the previous block ends here; its
+  // trailing zero is only known to be part of the data once another block follows it
+  bool previous_ended_with_zero = block_started_ && block_code_ != max_block_code;
+  block_started_ = true;
+  block_code_ = encoded_byte;
+  block_remaining_ = encoded_byte - 1;
+  if (previous_ended_with_zero) {
+    return decoded_buffer.push_back(0);
+  }
+
+  return IndexStatus::ok;
+}
+
+}  // namespace Pufferfish::Util
@@ -0,0 +1,194 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * Deltas.h
+ *
+ *  Coding of messages as the changes in their fields from a reference message of the
+ *  same type, for message types whose values change little from one message to the next.
+ *  A delta is encoded as a byte with one bit per field, set for each field which changed,
+ *  followed by a varint for each changed field.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+#include "ProtobufWire.h"
+
+namespace Pufferfish::Util {
+
+// Fields
+
+// A uint32 field which usually increases in small steps, coded as its difference from the
+// reference value, modulo 2^32
+template <auto member>
+struct DeltaCounter {
+  template <typename MessageType>
+  static uint32_t difference(const MessageType &reference, const MessageType &value) {
+    return value.*member - reference.*member;
+  }
+
+  template <typename MessageType>
+  static void apply(const MessageType &reference, uint32_t difference, MessageType &value) {
+    value.*member = reference.*member + difference;
+  }
+};
+
+// A float field which changes slowly, coded as the XOR of its bits with the bits of the
+// reference value, so that the sign, exponent, and high mantissa bits which nearby values
+// share become leading zeros of the varint
+template <auto member>
+struct DeltaReal {
+  template <typename MessageType>
+  static uint32_t difference(const MessageType &reference, const MessageType &value) {
+    return protobuf_float_bits(value.*member) ^ protobuf_float_bits(reference.*member);
+  }
+
+  template <typename MessageType>
+  static void apply(const MessageType &reference, uint32_t difference, MessageType &value) {
+    uint32_t bits = protobuf_float_bits(reference.*member) ^ difference;
+    std::memcpy(&(value.*member), &bits, sizeof(bits));
+  }
+};
+
+static const size_t delta_max_fields = 8;
+
+template <typename... Fields>
+struct DeltaFieldList {
+  static constexpr bool enabled = true;
+  static constexpr size_t size = sizeof...(Fields);
+  static_assert(size <= delta_max_fields, "The changed fields of a delta must fit in a byte");
+
+  // Calls the visitor with each field and its index, in field order
+  template <typename Visitor>
+  static void for_each(Visitor &&visitor) {
+    for_each(visitor, std::index_sequence_for<Fields...>{});
+  }
+
+ private:
+  template <typename Visitor, size_t... indices>
+  static void for_each(Visitor &visitor, std::index_sequence<indices...> /*indices*/) {
+    (visitor(Fields{}, indices), ...);
+  }
+};
+
+// Specialize this for each message type which can be delta-coded, deriving from a
+// DeltaFieldList of all of its fields in order
+template <typename MessageType>
+struct DeltaFields {
+  static constexpr bool enabled = false;
+  static constexpr size_t size = 0;
+};
+
+template <typename MessageType>
+constexpr bool check_delta_fields() noexcept {
+  static_assert(DeltaFields<MessageType>::enabled, "Message type has no delta fields");
+  static_assert(
+      sizeof(MessageType) == DeltaFields<MessageType>::size * sizeof(uint32_t),
+      "Every field of the message type must be delta-coded");
+  return true;
+}
+
+// Deltas
+
+// Bit i of changed is set if field i differs from its reference value, in which case
+// differences[i] holds the coded difference; otherwise, differences[i] is zero
+template <typename MessageType>
+struct Delta {
+  using Message = MessageType;
+
+  uint8_t changed;
+  std::array<uint32_t, DeltaFields<MessageType>::size> differences;
+};
+
+template <typename Payload>
+struct DeltaPayload {
+  static constexpr bool enabled = false;
+};
+
+template <typename MessageType>
+struct DeltaPayload<Delta<MessageType>> {
+  static constexpr bool enabled = true;
+};
+
+template <typename MessageType>
+constexpr size_t delta_max_size =
+    sizeof(uint8_t) + DeltaFields<MessageType>::size * protobuf_varint_size(UINT32_MAX);
+
+template <typename MessageType>
+Delta<MessageType> make_delta(const MessageType &reference, const MessageType &value) {
+  static_assert(check_delta_fields<MessageType>());
+  Delta<MessageType> delta{};
+  DeltaFields<MessageType>::for_each([&](auto field, size_t index) {
+    uint32_t difference = decltype(field)::difference(reference, value);
+    if (difference != 0) {
+      delta.changed |= static_cast<uint8_t>(1U << index);
+      delta.differences[index] = difference;
+    }
+  });
+  return delta;
+}
+
+template <typename MessageType>
+void apply_delta(
+    const MessageType &reference, const Delta<MessageType> &delta, MessageType &value) {
+  static_assert(check_delta_fields<MessageType>());
+  value = reference;
+  DeltaFields<MessageType>::for_each([&](auto field, size_t index) {
+    decltype(field)::apply(reference, delta.differences[index], value);
+  });
+}
+
+template <typename MessageType>
+bool encode_delta(
+    const Delta<MessageType> &delta, uint8_t *buffer, size_t buffer_size, size_t &encoded_size) {
+  static_assert(check_delta_fields<MessageType>());
+  if (buffer_size < sizeof(delta.changed)) {
+    return false;
+  }
+
+  buffer[0] = delta.changed;
+  ProtobufWriter writer(buffer + sizeof(delta.changed), buffer_size - sizeof(delta.changed));
+  bool success = true;
+  DeltaFields<MessageType>::for_each([&](auto /*field*/, size_t index) {
+    if ((delta.changed & (1U << index)) != 0) {
+      success = success && writer.write_varint(delta.differences[index]);
+    }
+  });
+  if (!success) {
+    return false;
+  }
+
+  encoded_size = sizeof(delta.changed) + writer.written();
+  return true;
+}
+
+// Decoding fails if the delta marks a field which doesn't exist as changed, if a varint is
+// out of range, or if any bytes remain after the last varint
+template <typename MessageType>
+bool decode_delta(const uint8_t *buffer, size_t buffer_size, Delta<MessageType> &delta) {
+  static_assert(check_delta_fields<MessageType>());
+  static const uint32_t field_mask = (1U << DeltaFields<MessageType>::size) - 1;
+  if (buffer_size < sizeof(delta.changed) || (buffer[0] & ~field_mask) != 0) {
+    return false;
+  }
+
+  delta = Delta<MessageType>{};
+  delta.changed = buffer[0];
+  ProtobufReader reader(buffer + sizeof(delta.changed), buffer_size - sizeof(delta.changed));
+  bool success = true;
+  DeltaFields<MessageType>::for_each([&](auto /*field*/, size_t index) {
+    if (success && (delta.changed & (1U << index)) != 0) {
+      uint64_t difference = 0;
+      success = reader.read_varint(difference) && difference <= UINT32_MAX;
+      delta.differences[index] = static_cast<uint32_t>(difference);
+    }
+  });
+  return success && reader.empty();
+}
+
+}  // namespace Pufferfish::Util
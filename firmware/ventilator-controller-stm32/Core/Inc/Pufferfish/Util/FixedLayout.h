@@ -0,0 +1,66 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * FixedLayout.h
+ *
+ *  Encoding and decoding of message types whose wire format is their memory layout,
+ *  with a single copy.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace Pufferfish::Util {
+
+// Specialize this for each message type whose wire format is its memory layout, giving the size
+// of that format; all fields must be little-endian, in order, and without padding between them
+template <typename MessageType>
+struct FixedLayout {
+  static constexpr bool enabled = false;
+  static constexpr size_t size = 0;
+};
+
+template <typename MessageType>
+constexpr bool check_fixed_layout() noexcept {
+  static_assert(FixedLayout<MessageType>::enabled, "Message type has no fixed layout");
+  static_assert(
+      std::is_trivially_copyable_v<MessageType> && std::is_standard_layout_v<MessageType>,
+      "Message type must be copyable as bytes");
+  static_assert(
+      sizeof(MessageType) == FixedLayout<MessageType>::size,
+      "Message type must have no padding");
+  static_assert(
+      __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "Fixed layouts require a little-endian target");
+  return true;
+}
+
+template <typename MessageType>
+bool encode_fixed_layout(
+    const MessageType &message, uint8_t *buffer, size_t buffer_size, size_t &encoded_size) {
+  static_assert(check_fixed_layout<MessageType>());
+  if (buffer_size < sizeof(MessageType)) {
+    return false;
+  }
+
+  std::memcpy(buffer, &message, sizeof(MessageType));
+  encoded_size = sizeof(MessageType);
+  return true;
+}
+
+// Unlike protobuf decoding, the buffer must have exactly the size of the layout
+template <typename MessageType>
+bool decode_fixed_layout(const uint8_t *buffer, size_t buffer_size, MessageType &message) {
+  static_assert(check_fixed_layout<MessageType>());
+  if (buffer_size != sizeof(MessageType)) {
+    return false;
+  }
+
+  std::memcpy(&message, buffer, sizeof(MessageType));
+  return true;
+}
+
+}  // namespace Pufferfish::Util
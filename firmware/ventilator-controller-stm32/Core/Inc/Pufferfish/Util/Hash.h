@@ -0,0 +1,42 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * Hash.h
+ *
+ *  Cheap non-cryptographic hashes for detecting changes in data.
+ *  These are not suitable for detecting transmission errors; use a CRC for that.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace Pufferfish::Util {
+
+static const uint32_t fnv1a_offset_basis = 2166136261UL;
+static const uint32_t fnv1a_prime = 16777619UL;
+
+// 32-bit FNV-1a hash of a buffer
+inline uint32_t hash_fnv1a(const uint8_t *buffer, size_t size) {
+  uint32_t hash = fnv1a_offset_basis;
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= buffer[i];
+    hash *= fnv1a_prime;
+  }
+  return hash;
+}
+
+// 32-bit FNV-1a hash of the bytes of an object. Padding bytes are included, so the object
+// should be value-initialized before its fields are set.
+template <typename Object>
+inline uint32_t hash_object(const Object &object) {
+  static_assert(
+      std::is_trivially_copyable<Object>::value,
+      "Only objects which are trivially copyable can be hashed by their bytes");
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  return hash_fnv1a(reinterpret_cast<const uint8_t *>(&object), sizeof(Object));
+}
+
+}  // namespace Pufferfish::Util
@@ -0,0 +1,83 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * Profiler.h
+ *
+ *  A lightweight scoped profiler, which records the execution times of regions of code in CPU
+ *  cycles. Profiling is only compiled in when PF_PROFILER is defined.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace Pufferfish::Util {
+
+// Statistics of the execution times of a region of code, in cycles
+class ProfileStats {
+ public:
+  // Bucket i counts executions of [2^i, 2^(i+1)) cycles; bucket 0 also counts executions of
+  // 0 cycles, and the last bucket also counts all longer executions
+  static constexpr size_t histogram_size = 24;
+  using Histogram = std::array<uint32_t, histogram_size>;
+
+  static size_t histogram_bucket(uint32_t cycles);
+
+  void record(uint32_t cycles);
+
+  // The count wraps around at 2^32; min, max, and mean are 0 until an execution is recorded
+  [[nodiscard]] uint32_t count() const { return count_; }
+  [[nodiscard]] uint32_t min() const { return count_ == 0 ? 0 : min_; }
+  [[nodiscard]] uint32_t max() const { return max_; }
+  [[nodiscard]] uint32_t mean() const;
+  [[nodiscard]] const Histogram &histogram() const { return histogram_; }
+
+ private:
+  uint32_t count_ = 0;
+  uint32_t min_ = UINT32_MAX;
+  uint32_t max_ = 0;
+  // Sum of the executions since the count last wrapped around, for the mean
+  uint64_t total_ = 0;
+  Histogram histogram_{};
+};
+
+/**
+ * Records the number of cycles from its construction until its destruction into a
+ * ProfileStats. CycleCounter must provide a static cycles() function which returns a
+ * free-running cycle count that wraps around at 2^32, such as HAL::HALTime::cycles.
+ *
+ * Executions of interrupt handlers which preempt a profiled region are counted in the region's
+ * execution time.
+ */
+template <typename CycleCounter>
+class ScopedProfile {
+ public:
+  explicit ScopedProfile(ProfileStats &stats) : stats_(stats), start_(CycleCounter::cycles()) {}
+  ~ScopedProfile();
+
+  ScopedProfile(const ScopedProfile &) = delete;
+  ScopedProfile(ScopedProfile &&) = delete;
+  ScopedProfile &operator=(const ScopedProfile &) = delete;
+  ScopedProfile &operator=(ScopedProfile &&) = delete;
+
+ private:
+  ProfileStats &stats_;
+  const uint32_t start_;
+};
+
+}  // namespace Pufferfish::Util
+
+#include "Profiler.tpp"
+
+// Profiles the rest of the enclosing scope into stats, if PF_PROFILER is defined; otherwise,
+// this expands to nothing and stats is not evaluated
+#ifdef PF_PROFILER
+#define PF_PROFILE_JOIN_(prefix, line) prefix##line
+#define PF_PROFILE_JOIN(prefix, line) PF_PROFILE_JOIN_(prefix, line)
+#define PF_PROFILE(CycleCounter, stats) \
+  ::Pufferfish::Util::ScopedProfile<CycleCounter> PF_PROFILE_JOIN(pf_profile_, __LINE__)(stats)
+#else
+#define PF_PROFILE(CycleCounter, stats) static_cast<void>(0)
+#endif
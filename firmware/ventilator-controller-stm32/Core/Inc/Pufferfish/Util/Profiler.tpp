@@ -0,0 +1,24 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * Profiler.tpp
+ *
+ *  A lightweight scoped profiler, which records the execution times of regions of code in CPU
+ *  cycles. Profiling is only compiled in when PF_PROFILER is defined.
+ */
+
+#pragma once
+
+#include "Profiler.h"
+
+namespace Pufferfish::Util {
+
+// ScopedProfile
+
+template <typename CycleCounter>
+ScopedProfile<CycleCounter>::~ScopedProfile() {
+  // The difference is correct across a wraparound of the cycle counter
+  stats_.record(CycleCounter::cycles() - start_);
+}
+
+}  // namespace Pufferfish::Util
@@ -7,28 +7,36 @@
 
 #pragma once
 
-#include <array>
 #include <cstddef>
+#include <cstdint>
 
+#include "ProtobufWire.h"
 #include "nanopb/pb_common.h"
 
 namespace Pufferfish::Util {
 
-using ProtobufDescriptor = const pb_msgdesc_t *;
-
-template <size_t size>
-using ProtobufDescriptors = std::array<ProtobufDescriptor, size>;
-
-using UnrecognizedMessage = std::nullptr_t;
+// Straight-line encoding and decoding with the codecs generated for a message type; message
+// types without generated codecs must be encoded and decoded by nanopb instead
 
 template <typename MessageType>
-constexpr ProtobufDescriptor get_protobuf_descriptor() noexcept {
-  return nanopb::MessageDescriptor<MessageType>::fields();
+bool encode_protobuf(
+    const MessageType &message, uint8_t *buffer, size_t buffer_size, size_t &encoded_size) {
+  static_assert(ProtobufCodec<MessageType>::generated, "Message type has no generated codec");
+  ProtobufWriter writer(buffer, buffer_size);
+  if (!ProtobufCodec<MessageType>::encode(message, writer)) {
+    return false;
+  }
+  encoded_size = writer.written();
+  return true;
 }
 
-template <>
-constexpr ProtobufDescriptor get_protobuf_descriptor<UnrecognizedMessage>() noexcept {
-  return nullptr;
+// Like pb_decode, fields missing from the buffer are set to their default values
+template <typename MessageType>
+bool decode_protobuf(const uint8_t *buffer, size_t buffer_size, MessageType &message) {
+  static_assert(ProtobufCodec<MessageType>::generated, "Message type has no generated codec");
+  message = MessageType{};
+  ProtobufReader reader(buffer, buffer_size);
+  return ProtobufCodec<MessageType>::decode(reader, message);
 }
 
 }  // namespace Pufferfish::Util
@@ -0,0 +1,396 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * ProtobufWire.h
+ *
+ *  Primitives of the protobuf wire format, for the straight-line message encoders
+ *  and decoders which are generated alongside the nanopb code. Fields follow proto3
+ *  semantics as nanopb implements them: singular scalar fields are omitted when zero,
+ *  repeated scalar fields are packed, and submessages are only present when their
+ *  has_ flag is set. The output is byte-for-byte identical to nanopb's.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace Pufferfish::Util {
+
+enum class ProtobufWireType : uint8_t {
+  varint = 0,
+  fixed64 = 1,
+  length_delimited = 2,
+  fixed32 = 5
+};
+
+// Generated encoders and decoders specialize this for each fixed-shape message type.
+// Specializations provide generated = true and static members max_size, encoded_size,
+// encode, and decode.
+template <typename MessageType>
+struct ProtobufCodec {
+  static constexpr bool generated = false;
+};
+
+// Sizes
+
+static const uint8_t protobuf_varint_payload_bits = 7;
+static const uint8_t protobuf_varint_continuation = 0x80;
+static const uint8_t protobuf_wire_type_bits = 3;
+static const uint8_t protobuf_byte_bits = 8;
+
+constexpr size_t protobuf_varint_size(uint64_t value) {
+  size_t size = 1;
+  while (value >= protobuf_varint_continuation) {
+    value >>= protobuf_varint_payload_bits;
+    ++size;
+  }
+  return size;
+}
+
+constexpr uint32_t protobuf_tag(uint32_t field, ProtobufWireType wire_type) {
+  return (field << protobuf_wire_type_bits) | static_cast<uint32_t>(wire_type);
+}
+
+constexpr size_t protobuf_tag_size(uint32_t field) {
+  return protobuf_varint_size(protobuf_tag(field, ProtobufWireType::varint));
+}
+
+inline uint32_t protobuf_float_bits(float value) {
+  uint32_t bits = 0;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+inline size_t protobuf_uint32_size(uint32_t field, uint32_t value) {
+  return value == 0 ? 0 : protobuf_tag_size(field) + protobuf_varint_size(value);
+}
+
+inline size_t protobuf_bool_size(uint32_t field, bool value) {
+  return value ? protobuf_tag_size(field) + 1 : 0;
+}
+
+inline size_t protobuf_float_size(uint32_t field, float value) {
+  return protobuf_float_bits(value) == 0 ? 0 : protobuf_tag_size(field) + sizeof(uint32_t);
+}
+
+inline size_t protobuf_packed_uint32_body_size(const uint32_t *values, size_t count) {
+  size_t size = 0;
+  for (size_t i = 0; i < count; ++i) {
+    size += protobuf_varint_size(values[i]);
+  }
+  return size;
+}
+
+inline size_t protobuf_packed_uint32_size(uint32_t field, const uint32_t *values, size_t count) {
+  if (count == 0) {
+    return 0;
+  }
+  size_t body_size = protobuf_packed_uint32_body_size(values, count);
+  return protobuf_tag_size(field) + protobuf_varint_size(body_size) + body_size;
+}
+
+inline size_t protobuf_packed_float_size(uint32_t field, size_t count) {
+  if (count == 0) {
+    return 0;
+  }
+  size_t body_size = count * sizeof(uint32_t);
+  return protobuf_tag_size(field) + protobuf_varint_size(body_size) + body_size;
+}
+
+template <typename Submessage>
+inline size_t protobuf_message_size(uint32_t field, bool has_value, const Submessage &value) {
+  if (!has_value) {
+    return 0;
+  }
+  size_t body_size = ProtobufCodec<Submessage>::encoded_size(value);
+  return protobuf_tag_size(field) + protobuf_varint_size(body_size) + body_size;
+}
+
+// Encoding
+
+/**
+ * Writes protobuf fields into a buffer of fixed size.
+ *
+ * Each method returns false without writing anything past the end of the buffer
+ * if the field does not fit.
+ */
+class ProtobufWriter {
+ public:
+  ProtobufWriter(uint8_t *buffer, size_t size) : buffer_(buffer), size_(size) {}
+
+  [[nodiscard]] size_t written() const { return written_; }
+
+  bool write_varint(uint64_t value) {
+    if (protobuf_varint_size(value) > size_ - written_) {
+      return false;
+    }
+    while (value >= protobuf_varint_continuation) {
+      buffer_[written_++] = static_cast<uint8_t>(value) | protobuf_varint_continuation;
+      value >>= protobuf_varint_payload_bits;
+    }
+    buffer_[written_++] = static_cast<uint8_t>(value);
+    return true;
+  }
+
+  bool write_fixed32(uint32_t value) {
+    if (sizeof(uint32_t) > size_ - written_) {
+      return false;
+    }
+    for (size_t i = 0; i < sizeof(uint32_t); ++i) {
+      buffer_[written_++] = static_cast<uint8_t>(value >> (i * protobuf_byte_bits));
+    }
+    return true;
+  }
+
+  bool write_tag(uint32_t field, ProtobufWireType wire_type) {
+    return write_varint(protobuf_tag(field, wire_type));
+  }
+
+  bool write_uint32(uint32_t field, uint32_t value) {
+    return value == 0 || (write_tag(field, ProtobufWireType::varint) && write_varint(value));
+  }
+
+  bool write_bool(uint32_t field, bool value) {
+    return !value || (write_tag(field, ProtobufWireType::varint) && write_varint(1));
+  }
+
+  bool write_float(uint32_t field, float value) {
+    uint32_t bits = protobuf_float_bits(value);
+    return bits == 0 || (write_tag(field, ProtobufWireType::fixed32) && write_fixed32(bits));
+  }
+
+  bool write_packed_uint32(
+      uint32_t field, const uint32_t *values, size_t count, size_t max_count) {
+    if (count == 0) {
+      return true;
+    }
+    if (count > max_count) {
+      return false;
+    }
+    if (!write_tag(field, ProtobufWireType::length_delimited) ||
+        !write_varint(protobuf_packed_uint32_body_size(values, count))) {
+      return false;
+    }
+    for (size_t i = 0; i < count; ++i) {
+      if (!write_varint(values[i])) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool write_packed_float(uint32_t field, const float *values, size_t count, size_t max_count) {
+    if (count == 0) {
+      return true;
+    }
+    if (count > max_count) {
+      return false;
+    }
+    if (!write_tag(field, ProtobufWireType::length_delimited) ||
+        !write_varint(count * sizeof(uint32_t))) {
+      return false;
+    }
+    for (size_t i = 0; i < count; ++i) {
+      if (!write_fixed32(protobuf_float_bits(values[i]))) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  template <typename Submessage>
+  bool write_message(uint32_t field, bool has_value, const Submessage &value) {
+    return !has_value ||
+           (write_tag(field, ProtobufWireType::length_delimited) &&
+            write_varint(ProtobufCodec<Submessage>::encoded_size(value)) &&
+            ProtobufCodec<Submessage>::encode(value, *this));
+  }
+
+ private:
+  uint8_t *buffer_;
+  size_t size_;
+  size_t written_ = 0;
+};
+
+// Decoding
+
+/**
+ * Reads protobuf fields from a buffer of fixed size.
+ *
+ * Each method returns false if the buffer ends in the middle of a field, if a field
+ * has an unexpected wire type, or if a value is out of range for its field; fields
+ * are merged into the message in the same way as nanopb merges them.
+ */
+class ProtobufReader {
+ public:
+  ProtobufReader(const uint8_t *buffer, size_t size) : buffer_(buffer), size_(size) {}
+
+  [[nodiscard]] bool empty() const { return read_ == size_; }
+
+  bool read_varint(uint64_t &value) {
+    static const size_t max_varint_size = 10;
+    value = 0;
+    for (size_t i = 0; i < max_varint_size && read_ < size_; ++i) {
+      uint8_t byte = buffer_[read_++];
+      value |= static_cast<uint64_t>(byte & ~protobuf_varint_continuation)
+               << (i * protobuf_varint_payload_bits);
+      if ((byte & protobuf_varint_continuation) == 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool read_fixed32(uint32_t &value) {
+    if (sizeof(uint32_t) > size_ - read_) {
+      return false;
+    }
+    value = 0;
+    for (size_t i = 0; i < sizeof(uint32_t); ++i) {
+      value |= static_cast<uint32_t>(buffer_[read_++]) << (i * protobuf_byte_bits);
+    }
+    return true;
+  }
+
+  bool read_tag(uint32_t &field, ProtobufWireType &wire_type) {
+    static const uint64_t wire_type_mask = (1U << protobuf_wire_type_bits) - 1;
+    uint64_t tag = 0;
+    if (!read_varint(tag) || tag > UINT32_MAX) {
+      return false;
+    }
+    field = static_cast<uint32_t>(tag >> protobuf_wire_type_bits);
+    wire_type = static_cast<ProtobufWireType>(tag & wire_type_mask);
+    return field != 0;
+  }
+
+  // Skips the value of a field which the message doesn't have
+  bool skip(ProtobufWireType wire_type) {
+    uint64_t value = 0;
+    switch (wire_type) {
+      case ProtobufWireType::varint:
+        return read_varint(value);
+      case ProtobufWireType::fixed64:
+        return skip_bytes(sizeof(uint64_t));
+      case ProtobufWireType::length_delimited:
+        return read_varint(value) && skip_bytes(value);
+      case ProtobufWireType::fixed32:
+        return skip_bytes(sizeof(uint32_t));
+    }
+    return false;
+  }
+
+  bool read_uint32(ProtobufWireType wire_type, uint32_t &value) {
+    uint64_t raw = 0;
+    if (wire_type != ProtobufWireType::varint || !read_varint(raw) || raw > UINT32_MAX) {
+      return false;
+    }
+    value = static_cast<uint32_t>(raw);
+    return true;
+  }
+
+  template <typename Enum>
+  bool read_enum(ProtobufWireType wire_type, Enum &value) {
+    uint32_t raw = 0;
+    if (!read_uint32(wire_type, raw)) {
+      return false;
+    }
+    value = static_cast<Enum>(raw);
+    return true;
+  }
+
+  bool read_bool(ProtobufWireType wire_type, bool &value) {
+    uint64_t raw = 0;
+    if (wire_type != ProtobufWireType::varint || !read_varint(raw)) {
+      return false;
+    }
+    value = raw != 0;
+    return true;
+  }
+
+  bool read_float(ProtobufWireType wire_type, float &value) {
+    uint32_t bits = 0;
+    if (wire_type != ProtobufWireType::fixed32 || !read_fixed32(bits)) {
+      return false;
+    }
+    std::memcpy(&value, &bits, sizeof(value));
+    return true;
+  }
+
+  // Accepts both packed and unpacked encodings, appending to the values already read
+  template <typename Count>
+  bool read_repeated_uint32(
+      ProtobufWireType wire_type, uint32_t *values, Count &count, size_t max_count) {
+    if (wire_type != ProtobufWireType::length_delimited) {
+      return count < max_count && read_uint32(wire_type, values[count++]);
+    }
+    ProtobufReader packed(nullptr, 0);
+    if (!read_length_delimited(packed)) {
+      return false;
+    }
+    while (!packed.empty()) {
+      if (count >= max_count || !packed.read_uint32(ProtobufWireType::varint, values[count++])) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Accepts both packed and unpacked encodings, appending to the values already read
+  template <typename Count>
+  bool read_repeated_float(
+      ProtobufWireType wire_type, float *values, Count &count, size_t max_count) {
+    if (wire_type != ProtobufWireType::length_delimited) {
+      return count < max_count && read_float(wire_type, values[count++]);
+    }
+    ProtobufReader packed(nullptr, 0);
+    if (!read_length_delimited(packed)) {
+      return false;
+    }
+    while (!packed.empty()) {
+      if (count >= max_count || !packed.read_float(ProtobufWireType::fixed32, values[count++])) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  template <typename Submessage>
+  bool read_message(ProtobufWireType wire_type, bool &has_value, Submessage &value) {
+    ProtobufReader submessage(nullptr, 0);
+    if (wire_type != ProtobufWireType::length_delimited || !read_length_delimited(submessage)) {
+      return false;
+    }
+    if (!has_value) {
+      value = Submessage{};
+      has_value = true;
+    }
+    return ProtobufCodec<Submessage>::decode(submessage, value);
+  }
+
+ private:
+  bool skip_bytes(uint64_t size) {
+    if (size > size_ - read_) {
+      return false;
+    }
+    read_ += size;
+    return true;
+  }
+
+  bool read_length_delimited(ProtobufReader &body) {
+    uint64_t size = 0;
+    if (!read_varint(size) || size > size_ - read_) {
+      return false;
+    }
+    body = ProtobufReader(buffer_ + read_, size);
+    read_ += size;
+    return true;
+  }
+
+  const uint8_t *buffer_;
+  size_t size_;
+  size_t read_ = 0;
+};
+
+}  // namespace Pufferfish::Util
@@ -50,6 +50,7 @@
 
 #include "Pufferfish/HAL/Types.h"
 #include "Pufferfish/Statuses.h"
+#include "Span.h"
 
 namespace Pufferfish::Util {
 
@@ -60,14 +61,27 @@ namespace Pufferfish::Util {
  * https://hackaday.com/2015/10/29/embed-with-elliot-going-round-with-circular-buffers/
  * This class provides a bounded-length queue data structure which is
  * statically allocated. Behind the scenes, it is backed by an array.
- * BufferSize is recommended to be a power of two for compiler optimization.
- * Methods are declared volatile because they are usable with ISRs.
+ * BufferSize must be a power of two, so that indices can be wrapped by masking.
+ * Methods are declared volatile because they are usable with ISRs: the queue
+ * is safe to use with one producer and one consumer (e.g. an ISR and the main
+ * loop), and memory barriers order each access to the array against the update
+ * of the index which hands that part of the array over to the other side.
  */
 template <HAL::AtomicSize buffer_size>
 class RingBuffer {
  public:
+  static_assert(
+      buffer_size > 0 && (buffer_size & (buffer_size - 1)) == 0,
+      "Buffer size must be a power of two");
+
   RingBuffer();
 
+  /**
+   * Count the number of bytes in the queue.
+   * @return the number of bytes which can be read from the queue
+   */
+  [[nodiscard]] HAL::AtomicSize size() const volatile;
+
   /**
    * Attempt to "pop" a byte from the head of the queue.
    *
@@ -97,7 +111,53 @@ class RingBuffer {
    */
   BufferStatus write(uint8_t write_byte) volatile;
 
+  /**
+   * "Pop" bytes from the head of the queue into the provided buffer, until
+   * either the buffer is full or the queue is empty.
+   *
+   * The bytes are copied with at most two memcpys, one for each contiguous
+   * region of the queue.
+   * @param dest the buffer to copy popped bytes into
+   * @param[out] read_size the number of bytes popped from the queue
+   * @return ok if any bytes were popped, empty otherwise
+   */
+  BufferStatus read(Span<uint8_t> dest, HAL::AtomicSize &read_size) volatile;
+
+  /**
+   * "Push" bytes from the provided buffer onto the tail of the queue, until
+   * either all bytes are pushed or the queue becomes full.
+   *
+   * The bytes are copied with at most two memcpys, one for each contiguous
+   * region of the queue.
+   * @param source the bytes to push onto the tail of the queue
+   * @param[out] written_size the number of bytes pushed onto the queue
+   * @return ok if all bytes were pushed, partial otherwise
+   */
+  BufferStatus write(ByteView source, HAL::AtomicSize &written_size) volatile;
+
+  /**
+   * Get a view of the contiguous region of bytes at the head of the queue,
+   * without popping them, so that they can be parsed in place.
+   *
+   * If the queued bytes wrap around the end of the array, only the bytes up
+   * to the end of the array are in the region; the rest can be peeked after
+   * the region is committed. The region remains valid until it is committed.
+   * @param[out] region a view of the bytes at the head of the queue
+   * @return ok on success, empty if the queue is empty
+   */
+  BufferStatus peek(ByteView &region) const volatile;
+
+  /**
+   * "Pop" bytes from the head of the queue without copying them, e.g. after
+   * they were parsed from a peeked region.
+   * @param commit_size the number of bytes to pop
+   * @return ok on success, out_of_bounds if the queue has fewer bytes than that
+   */
+  IndexStatus commit(HAL::AtomicSize commit_size) volatile;
+
  private:
+  static const HAL::AtomicSize index_mask = buffer_size - 1;
+
   // We have to use a C-style array because std::array doesn't work with
   // volatile
   // NOLINTNEXTLINE(modernize-avoid-c-arrays)
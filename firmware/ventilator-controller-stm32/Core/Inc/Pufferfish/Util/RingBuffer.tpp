@@ -46,46 +46,140 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <cstring>
 
 #include "RingBuffer.h"
 
 namespace Pufferfish::Util {
 
+// Each side of the queue reads the other side's index, then fences with acquire semantics
+// before it touches the array; it then fences with release semantics before it publishes its
+// own index. On the Cortex-M7 these fences compile to DMB instructions.
+
 template <HAL::AtomicSize buffer_size>
 RingBuffer<buffer_size>::RingBuffer() = default;
 
+template <HAL::AtomicSize buffer_size>
+HAL::AtomicSize RingBuffer<buffer_size>::size() const volatile {
+  return (newest_index_ - oldest_index_) & index_mask;
+}
+
 template <HAL::AtomicSize buffer_size>
 BufferStatus RingBuffer<buffer_size>::read(uint8_t &read_byte) volatile {
-  if (newest_index_ == oldest_index_) {
+  HAL::AtomicSize oldest = oldest_index_;
+  if (newest_index_ == oldest) {
     return BufferStatus::empty;
   }
 
-  read_byte = buffer_[oldest_index_];
-  oldest_index_ = (oldest_index_ + 1) % buffer_size;
+  std::atomic_thread_fence(std::memory_order_acquire);
+  read_byte = buffer_[oldest];
+  std::atomic_thread_fence(std::memory_order_release);
+  oldest_index_ = (oldest + 1) & index_mask;
   return BufferStatus::ok;
 }
 
 template <HAL::AtomicSize buffer_size>
 BufferStatus RingBuffer<buffer_size>::peek(uint8_t &peek_byte) const volatile {
-  if (newest_index_ == oldest_index_) {
+  HAL::AtomicSize oldest = oldest_index_;
+  if (newest_index_ == oldest) {
     return BufferStatus::empty;
   }
 
-  peek_byte = buffer_[oldest_index_];
+  std::atomic_thread_fence(std::memory_order_acquire);
+  peek_byte = buffer_[oldest];
   return BufferStatus::ok;
 }
 
 template <HAL::AtomicSize buffer_size>
 BufferStatus RingBuffer<buffer_size>::write(uint8_t write_byte) volatile {
-  HAL::AtomicSize next_index = (newest_index_ + 1) % buffer_size;
+  HAL::AtomicSize newest = newest_index_;
+  HAL::AtomicSize next_index = (newest + 1) & index_mask;
   if (next_index == oldest_index_) {
     return BufferStatus::full;
   }
 
-  buffer_[newest_index_] = write_byte;
+  std::atomic_thread_fence(std::memory_order_acquire);
+  buffer_[newest] = write_byte;
+  std::atomic_thread_fence(std::memory_order_release);
   newest_index_ = next_index;
   return BufferStatus::ok;
 }
 
+template <HAL::AtomicSize buffer_size>
+BufferStatus RingBuffer<buffer_size>::read(
+    Span<uint8_t> dest, HAL::AtomicSize &read_size) volatile {
+  HAL::AtomicSize oldest = oldest_index_;
+  HAL::AtomicSize available = (newest_index_ - oldest) & index_mask;
+  read_size = std::min<HAL::AtomicSize>(dest.size(), available);
+  if (read_size == 0) {
+    return BufferStatus::empty;
+  }
+
+  std::atomic_thread_fence(std::memory_order_acquire);
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+  const auto *buffer = const_cast<const uint8_t *>(buffer_);
+  HAL::AtomicSize first_size = std::min(read_size, buffer_size - oldest);
+  std::memcpy(dest.buffer(), buffer + oldest, first_size);
+  if (first_size < read_size) {
+    std::memcpy(dest.buffer() + first_size, buffer, read_size - first_size);
+  }
+  std::atomic_thread_fence(std::memory_order_release);
+  oldest_index_ = (oldest + read_size) & index_mask;
+  return BufferStatus::ok;
+}
+
+template <HAL::AtomicSize buffer_size>
+BufferStatus RingBuffer<buffer_size>::write(
+    ByteView source, HAL::AtomicSize &written_size) volatile {
+  HAL::AtomicSize newest = newest_index_;
+  HAL::AtomicSize free = (oldest_index_ - newest - 1) & index_mask;
+  written_size = std::min<HAL::AtomicSize>(source.size(), free);
+  if (written_size > 0) {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+    auto *buffer = const_cast<uint8_t *>(buffer_);
+    HAL::AtomicSize first_size = std::min(written_size, buffer_size - newest);
+    std::memcpy(buffer + newest, source.buffer(), first_size);
+    if (first_size < written_size) {
+      std::memcpy(buffer, source.buffer() + first_size, written_size - first_size);
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+    newest_index_ = (newest + written_size) & index_mask;
+  }
+  if (written_size == source.size()) {
+    return BufferStatus::ok;
+  }
+  return BufferStatus::partial;
+}
+
+template <HAL::AtomicSize buffer_size>
+BufferStatus RingBuffer<buffer_size>::peek(ByteView &region) const volatile {
+  HAL::AtomicSize oldest = oldest_index_;
+  HAL::AtomicSize newest = newest_index_;
+  if (newest == oldest) {
+    return BufferStatus::empty;
+  }
+
+  std::atomic_thread_fence(std::memory_order_acquire);
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+  const auto *buffer = const_cast<const uint8_t *>(buffer_);
+  HAL::AtomicSize region_end = newest > oldest ? newest : buffer_size;
+  region = ByteView(buffer + oldest, region_end - oldest);
+  return BufferStatus::ok;
+}
+
+template <HAL::AtomicSize buffer_size>
+IndexStatus RingBuffer<buffer_size>::commit(HAL::AtomicSize commit_size) volatile {
+  HAL::AtomicSize oldest = oldest_index_;
+  if (commit_size > ((newest_index_ - oldest) & index_mask)) {
+    return IndexStatus::out_of_bounds;
+  }
+
+  std::atomic_thread_fence(std::memory_order_release);
+  oldest_index_ = (oldest + commit_size) & index_mask;
+  return IndexStatus::ok;
+}
+
 }  // namespace Pufferfish::Util
@@ -0,0 +1,115 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * SPSCQueue.h
+ *
+ *  A wait-free single-producer, single-consumer queue of typed elements,
+ *  for handing complete records (e.g. sensor samples or decoded frames)
+ *  from an ISR to the main loop without re-parsing bytes there.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+#include "Pufferfish/Statuses.h"
+#include "Span.h"
+
+namespace Pufferfish::Util {
+
+/**
+ * Bounded queue with non-blocking interface and static allocation.
+ *
+ * Exactly one context may push (e.g. an ISR or a DMA callback) and exactly
+ * one other context may pop (e.g. the main loop); neither ever waits for the
+ * other. Elements are constructed in place in the queue's storage when they
+ * are pushed and destroyed when they are popped. The capacity must be a power
+ * of two, and all of it is usable.
+ */
+template <typename Element, size_t queue_capacity>
+class SPSCQueue {
+ public:
+  static_assert(
+      queue_capacity > 0 && (queue_capacity & (queue_capacity - 1)) == 0,
+      "Queue capacity must be a power of two");
+  static_assert(
+      std::atomic<size_t>::is_always_lock_free, "Queue indices must be lock-free atomics");
+
+  SPSCQueue() = default;
+  ~SPSCQueue();
+
+  SPSCQueue(const SPSCQueue &) = delete;
+  SPSCQueue &operator=(const SPSCQueue &) = delete;
+  SPSCQueue(SPSCQueue &&) = delete;
+  SPSCQueue &operator=(SPSCQueue &&) = delete;
+
+  [[nodiscard]] static constexpr size_t capacity() { return queue_capacity; }
+
+  // May be called from either side, but the result may be stale by the time it is used
+  [[nodiscard]] size_t size() const;
+  [[nodiscard]] bool empty() const;
+
+  /**
+   * Construct an element in place at the tail of the queue. Producer side only.
+   *
+   * Gives up without causing any side-effects if the queue is full.
+   * @param args the arguments to pass to the element's constructor
+   * @return ok on success, full otherwise
+   */
+  template <typename... Args>
+  BufferStatus emplace(Args &&... args);
+
+  /**
+   * Push a copy of the provided element onto the tail of the queue. Producer side only.
+   * @param element the element to push
+   * @return ok on success, full otherwise
+   */
+  BufferStatus push(const Element &element);
+
+  /**
+   * Move the provided element onto the tail of the queue. Producer side only.
+   * @param element the element to push
+   * @return ok on success, full otherwise
+   */
+  BufferStatus push(Element &&element);
+
+  /**
+   * Pop the element at the head of the queue. Consumer side only.
+   *
+   * Gives up without causing any side-effects if the queue is empty.
+   * @param[out] element the element popped from the queue
+   * @return ok on success, empty otherwise
+   */
+  BufferStatus pop(Element &element);
+
+  /**
+   * Pop elements from the head of the queue into the provided buffer, until
+   * either the buffer is full or the queue is empty. Consumer side only.
+   *
+   * The consumer's index is only published once for the whole batch.
+   * @param dest the buffer to move popped elements into
+   * @param[out] popped_size the number of elements popped
+   * @return ok if any elements were popped, empty otherwise
+   */
+  BufferStatus pop(Span<Element> dest, size_t &popped_size);
+
+ private:
+  static const size_t index_mask = queue_capacity - 1;
+
+  using Storage = std::aligned_storage_t<sizeof(Element), alignof(Element)>;
+
+  Element *slot(size_t index);
+
+  // Monotonic counts of pushed and popped elements, each written by only one side
+  std::atomic<size_t> pushed_{0};
+  std::atomic<size_t> popped_{0};
+  // NOLINTNEXTLINE(modernize-avoid-c-arrays)
+  Storage slots_[queue_capacity];
+};
+
+}  // namespace Pufferfish::Util
+
+#include "SPSCQueue.tpp"
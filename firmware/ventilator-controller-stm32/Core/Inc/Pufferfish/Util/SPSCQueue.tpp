@@ -0,0 +1,99 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * SPSCQueue.tpp
+ *
+ *  A wait-free single-producer, single-consumer queue of typed elements.
+ */
+
+#pragma once
+
+#include <utility>
+
+#include "SPSCQueue.h"
+
+namespace Pufferfish::Util {
+
+// Each side loads the other side's count with acquire ordering before it touches a slot, and
+// publishes its own count with release ordering after it is done with the slot.
+
+template <typename Element, size_t queue_capacity>
+SPSCQueue<Element, queue_capacity>::~SPSCQueue() {
+  size_t pushed = pushed_.load(std::memory_order_acquire);
+  for (size_t popped = popped_.load(std::memory_order_relaxed); popped != pushed; ++popped) {
+    slot(popped)->~Element();
+  }
+}
+
+template <typename Element, size_t queue_capacity>
+size_t SPSCQueue<Element, queue_capacity>::size() const {
+  return pushed_.load(std::memory_order_acquire) - popped_.load(std::memory_order_acquire);
+}
+
+template <typename Element, size_t queue_capacity>
+bool SPSCQueue<Element, queue_capacity>::empty() const {
+  return size() == 0;
+}
+
+template <typename Element, size_t queue_capacity>
+template <typename... Args>
+BufferStatus SPSCQueue<Element, queue_capacity>::emplace(Args &&... args) {
+  size_t pushed = pushed_.load(std::memory_order_relaxed);
+  if (pushed - popped_.load(std::memory_order_acquire) == queue_capacity) {
+    return BufferStatus::full;
+  }
+
+  new (&slots_[pushed & index_mask]) Element(std::forward<Args>(args)...);
+  pushed_.store(pushed + 1, std::memory_order_release);
+  return BufferStatus::ok;
+}
+
+template <typename Element, size_t queue_capacity>
+BufferStatus SPSCQueue<Element, queue_capacity>::push(const Element &element) {
+  return emplace(element);
+}
+
+template <typename Element, size_t queue_capacity>
+BufferStatus SPSCQueue<Element, queue_capacity>::push(Element &&element) {
+  return emplace(std::move(element));
+}
+
+template <typename Element, size_t queue_capacity>
+BufferStatus SPSCQueue<Element, queue_capacity>::pop(Element &element) {
+  size_t popped = popped_.load(std::memory_order_relaxed);
+  if (pushed_.load(std::memory_order_acquire) == popped) {
+    return BufferStatus::empty;
+  }
+
+  Element *source = slot(popped);
+  element = std::move(*source);
+  source->~Element();
+  popped_.store(popped + 1, std::memory_order_release);
+  return BufferStatus::ok;
+}
+
+template <typename Element, size_t queue_capacity>
+BufferStatus SPSCQueue<Element, queue_capacity>::pop(Span<Element> dest, size_t &popped_size) {
+  size_t popped = popped_.load(std::memory_order_relaxed);
+  size_t available = pushed_.load(std::memory_order_acquire) - popped;
+  popped_size = available < dest.size() ? available : dest.size();
+  if (popped_size == 0) {
+    return BufferStatus::empty;
+  }
+
+  for (size_t i = 0; i < popped_size; ++i) {
+    Element *source = slot(popped + i);
+    dest[i] = std::move(*source);
+    source->~Element();
+  }
+  popped_.store(popped + popped_size, std::memory_order_release);
+  return BufferStatus::ok;
+}
+
+template <typename Element, size_t queue_capacity>
+Element *SPSCQueue<Element, queue_capacity>::slot(size_t index) {
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  return std::launder(reinterpret_cast<Element *>(&slots_[index & index_mask]));
+}
+
+}  // namespace Pufferfish::Util
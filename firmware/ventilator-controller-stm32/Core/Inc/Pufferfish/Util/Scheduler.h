@@ -0,0 +1,94 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * Scheduler.h
+ *
+ *  A cooperative scheduler of periodic tasks for the main loop, which only runs tasks when
+ *  they are due and records how long each task takes against its CPU budget.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "Pufferfish/HAL/Interfaces/Time.h"
+#include "Pufferfish/Statuses.h"
+
+namespace Pufferfish::Util {
+
+// Tasks are functions of the current time in ms, such as capture-less lambdas
+using TaskFunction = void (*)(uint32_t current_time);
+
+struct Task {
+  TaskFunction function;
+  // Interval between runs, in ms; a period of 0 runs the task on every iteration
+  uint32_t period;
+  // When several tasks are due, tasks with higher priorities run first
+  uint8_t priority;
+  // Expected maximum duration of each run, in us
+  uint32_t budget;
+};
+
+struct TaskStats {
+  uint32_t runs;
+  // Runs which took longer than the task's budget
+  uint32_t overruns;
+  // Periods which were skipped because the task started more than a period late
+  uint32_t missed_periods;
+  // Longest duration of a run, in us
+  uint32_t max_duration;
+};
+
+/**
+ * Runs a fixed set of periodic tasks from the main loop. Tasks are never preempted, so a task
+ * which runs long delays every task after it. Budgets are not enforced: they are only compared
+ * against the measured duration of each run, and runs which exceed them are counted as overruns
+ * in the task's stats. The duration of an iteration is only bounded by the sum of the budgets of
+ * the tasks due in it if no task overruns.
+ *
+ * Tasks are scheduled on a fixed grid of their periods, so they do not drift; a task which
+ * falls more than a period behind skips the missed periods instead of running in a burst.
+ * Durations are measured with the microsecond clock; runs during which it rolls over are not
+ * measured, since the STM32's microsecond clock rolls over before reaching UINT32_MAX.
+ */
+template <size_t max_tasks>
+class Scheduler {
+ public:
+  explicit Scheduler(HAL::Time &time) : time_(time) {}
+
+  // Tasks are identified by the order in which they were added, starting from 0; the first
+  // run of every task is due on the first iteration
+  IndexStatus add(const Task &task);
+
+  // Runs every task which is due, in order of priority, and returns the number of tasks run
+  size_t run(uint32_t current_time);
+
+  [[nodiscard]] size_t size() const { return size_; }
+  IndexStatus stats(size_t index, TaskStats &output) const;
+  // Longest duration of an iteration which ran at least one task, in us
+  [[nodiscard]] uint32_t max_iteration_duration() const { return max_iteration_duration_; }
+
+ private:
+  struct Entry {
+    Task task;
+    TaskStats stats;
+    uint32_t next_time;
+    bool started;
+  };
+
+  HAL::Time &time_;
+  std::array<Entry, max_tasks> entries_{};
+  // Indices of entries, in order of descending priority
+  std::array<size_t, max_tasks> order_{};
+  size_t size_ = 0;
+  uint32_t max_iteration_duration_ = 0;
+
+  static bool due(const Entry &entry, uint32_t current_time);
+  void run_task(Entry &entry, uint32_t current_time);
+};
+
+}  // namespace Pufferfish::Util
+
+#include "Scheduler.tpp"
@@ -0,0 +1,110 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * Scheduler.tpp
+ *
+ *  A cooperative scheduler of periodic tasks for the main loop, which only runs tasks when
+ *  they are due and records how long each task takes against its CPU budget.
+ */
+
+#pragma once
+
+#include "Scheduler.h"
+
+namespace Pufferfish::Util {
+
+template <size_t max_tasks>
+IndexStatus Scheduler<max_tasks>::add(const Task &task) {
+  if (size_ >= max_tasks) {
+    return IndexStatus::out_of_bounds;
+  }
+
+  entries_[size_] = Entry{task, TaskStats{}, 0, false};
+  // Insert after every task of the same or higher priority
+  size_t position = size_;
+  while (position > 0 && entries_[order_[position - 1]].task.priority < task.priority) {
+    order_[position] = order_[position - 1];
+    --position;
+  }
+  order_[position] = size_;
+  ++size_;
+  return IndexStatus::ok;
+}
+
+template <size_t max_tasks>
+size_t Scheduler<max_tasks>::run(uint32_t current_time) {
+  size_t runs = 0;
+  uint32_t start_time = time_.micros();
+  for (size_t i = 0; i < size_; ++i) {
+    Entry &entry = entries_[order_[i]];
+    if (!due(entry, current_time)) {
+      continue;
+    }
+
+    run_task(entry, current_time);
+    ++runs;
+  }
+
+  uint32_t end_time = time_.micros();
+  if (runs > 0 && end_time >= start_time && end_time - start_time > max_iteration_duration_) {
+    max_iteration_duration_ = end_time - start_time;
+  }
+  return runs;
+}
+
+template <size_t max_tasks>
+IndexStatus Scheduler<max_tasks>::stats(size_t index, TaskStats &output) const {
+  if (index >= size_) {
+    return IndexStatus::out_of_bounds;
+  }
+
+  output = entries_[index].stats;
+  return IndexStatus::ok;
+}
+
+template <size_t max_tasks>
+bool Scheduler<max_tasks>::due(const Entry &entry, uint32_t current_time) {
+  if (!entry.started || entry.task.period == 0) {
+    return true;
+  }
+
+  // The next run is never scheduled more than a period ahead, so the difference from the
+  // current time is negative exactly when the next run is still in the future, even across
+  // rollovers of the current time
+  return static_cast<int32_t>(current_time - entry.next_time) >= 0;
+}
+
+template <size_t max_tasks>
+void Scheduler<max_tasks>::run_task(Entry &entry, uint32_t current_time) {
+  const Task &task = entry.task;
+  if (!entry.started) {
+    entry.started = true;
+    entry.next_time = current_time;
+  }
+  if (task.period > 0) {
+    uint32_t lateness = current_time - entry.next_time;
+    if (lateness >= task.period) {
+      entry.stats.missed_periods += lateness / task.period;
+      entry.next_time += (lateness / task.period) * task.period;
+    }
+    entry.next_time += task.period;
+  }
+
+  uint32_t start_time = time_.micros();
+  task.function(current_time);
+  uint32_t end_time = time_.micros();
+
+  ++entry.stats.runs;
+  if (end_time < start_time) {
+    return;
+  }
+  uint32_t duration = end_time - start_time;
+  if (duration > entry.stats.max_duration) {
+    entry.stats.max_duration = duration;
+  }
+  if (duration > task.budget) {
+    ++entry.stats.overruns;
+  }
+}
+
+}  // namespace Pufferfish::Util
@@ -0,0 +1,87 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * Span.h
+ *
+ *  A basic non-owning view of a contiguous sequence of elements.
+ *  This lets protocol layers refer to a section of a buffer owned by someone else,
+ *  instead of copying that section into a buffer of their own. Methods mirror the
+ *  accessors of Vector, so templated code can work with either.
+ *  A span does not extend the lifetime of the buffer it refers to, so it must not
+ *  be used after that buffer has been modified or destroyed.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "Pufferfish/Statuses.h"
+#include "Vector.h"
+
+namespace Pufferfish::Util {
+
+template <typename Element>
+class Span {
+ public:
+  constexpr Span() noexcept = default;
+  constexpr Span(Element *buffer, size_t size) noexcept : buffer_(buffer), size_(size) {}
+
+  template <size_t array_size>
+  // NOLINTNEXTLINE(google-explicit-constructor)
+  constexpr Span(Vector<std::remove_const_t<Element>, array_size> &vector) noexcept
+      : Span(vector.buffer(), vector.size()) {}
+
+  template <size_t array_size>
+  // NOLINTNEXTLINE(google-explicit-constructor)
+  constexpr Span(const Vector<std::remove_const_t<Element>, array_size> &vector) noexcept
+      : Span(vector.buffer(), vector.size()) {}
+
+  [[nodiscard]] constexpr size_t size() const noexcept { return size_; }
+  [[nodiscard]] constexpr bool empty() const noexcept { return size_ == 0; }
+
+  constexpr Element &operator[](size_t position) const noexcept { return buffer_[position]; }
+
+  [[nodiscard]] constexpr Element *buffer() const noexcept { return buffer_; }
+
+  // Returns the view of all elements starting from offset, or an empty view if offset is
+  // out of bounds
+  [[nodiscard]] constexpr Span subspan(size_t offset) const noexcept {
+    if (offset > size_) {
+      return Span(buffer_ + size_, 0);
+    }
+    return Span(buffer_ + offset, size_ - offset);
+  }
+
+ private:
+  Element *buffer_ = nullptr;
+  size_t size_ = 0;
+};
+
+using ByteView = Span<const uint8_t>;
+
+template <typename Buffer>
+struct IsSpan : std::false_type {};
+
+template <typename Element>
+struct IsSpan<Span<Element>> : std::true_type {};
+
+/**
+ * Sets a payload buffer to the given bytes: a vector receives a copy of the bytes, while a
+ * view is made to refer to the bytes where they already are
+ * @param dest the payload buffer to set
+ * @param source the bytes to set the payload buffer to
+ * @return ok on success, out_of_bounds if a vector is too small to hold the bytes
+ */
+template <size_t array_size>
+IndexStatus assign(Vector<uint8_t, array_size> &dest, ByteView source) {
+  return dest.copy_from(source.buffer(), source.size());
+}
+
+inline IndexStatus assign(ByteView &dest, ByteView source) {
+  dest = source;
+  return IndexStatus::ok;
+}
+
+}  // namespace Pufferfish::Util
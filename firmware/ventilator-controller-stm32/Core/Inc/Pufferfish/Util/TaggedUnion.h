@@ -15,8 +15,27 @@
 
 namespace Pufferfish::Util {
 
-template <typename Union, typename TagValue>
+// If a TypeRegistry mapping the tags to union members is given, set is generated from it.
+// Otherwise, set must be explicitly specialized for each value type.
+template <typename Union, typename TagValue, typename Registry = void>
 class TaggedUnion {
+ public:
+  using Tag = TagValue;
+
+  template <typename Value>
+  void set(const Value &new_value) {
+    using Entry = typename Registry::template EntryOf<Value>;
+    static_assert(Registry::template contains<Value>(), "Type is not registered");
+    tag = Entry::tag;
+    value.*Entry::union_member = new_value;
+  }
+
+  TagValue tag;
+  Union value;
+};
+
+template <typename Union, typename TagValue>
+class TaggedUnion<Union, TagValue, void> {
  public:
   using Tag = TagValue;
 
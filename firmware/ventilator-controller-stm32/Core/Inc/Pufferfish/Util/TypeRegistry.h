@@ -0,0 +1,141 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * TypeRegistry.h
+ *
+ *  Compile-time mapping between the values of a tag enum and the types they tag,
+ *  for dispatching on run-time tag values through jump tables.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <type_traits>
+
+namespace Pufferfish::Util {
+
+// Maps a tag value to a type, and to the members which hold values of that type in a union
+// and in a struct; struct_field is nullptr for types which are never held in the struct
+template <auto tag_value, typename Value, auto union_field, auto struct_field>
+struct TypeEntry {
+  using Type = Value;
+  static constexpr auto tag = tag_value;
+  static constexpr auto union_member = union_field;
+  static constexpr auto struct_member = struct_field;
+  static constexpr bool has_struct_member = !std::is_null_pointer_v<decltype(struct_field)>;
+};
+
+template <typename Value, typename... Entries>
+struct TypeEntryOf;
+
+template <typename Value, typename First, typename... Rest>
+struct TypeEntryOf<Value, First, Rest...> {
+  using Entry = std::conditional_t<
+      std::is_same_v<Value, typename First::Type>,
+      First,
+      typename TypeEntryOf<Value, Rest...>::Entry>;
+};
+
+template <typename Value>
+struct TypeEntryOf<Value> {
+  using Entry = void;
+};
+
+template <typename Value, typename... Entries>
+constexpr size_t count_type_entries() noexcept {
+  return (static_cast<size_t>(std::is_same_v<Value, typename Entries::Type>) + ...);
+}
+
+template <typename... Entries>
+constexpr size_t count_tag_entries(size_t tag) noexcept {
+  return (static_cast<size_t>(tag == static_cast<size_t>(Entries::tag)) + ...);
+}
+
+template <typename Tag, typename... Entries>
+class TypeRegistry {
+ public:
+  static constexpr size_t size = sizeof...(Entries);
+
+  template <typename Value>
+  static constexpr bool includes(Value value) noexcept {
+    return ((static_cast<size_t>(value) == index(Entries::tag)) || ...);
+  }
+
+  template <typename Value>
+  static constexpr bool contains() noexcept {
+    return (std::is_same_v<Value, typename Entries::Type> || ...);
+  }
+
+  template <typename Value>
+  using EntryOf = typename TypeEntryOf<Value, Entries...>::Entry;
+
+  template <typename Value>
+  static constexpr Tag tag_of() noexcept {
+    static_assert(contains<Value>(), "Type is not registered");
+    return EntryOf<Value>::tag;
+  }
+
+  // Calls the visitor with the entry registered for the tag, in constant time through a table
+  // of handlers indexed by tag value; returns invalid if no entry is registered for the tag
+  template <typename Result, typename Visitor>
+  static Result visit(Tag tag, Visitor &&visitor, Result invalid) {
+    using VisitorType = std::remove_reference_t<Visitor>;
+    static constexpr HandlerTable<Result, VisitorType> handlers =
+        make_handlers<Result, VisitorType>();
+    size_t tag_index = index(tag);
+    if (tag_index >= handlers.size()) {
+      return invalid;
+    }
+
+    return handlers[tag_index](visitor, invalid);
+  }
+
+ private:
+  static_assert(size > 0, "Registry must have at least one entry");
+  static_assert(
+      (std::is_same_v<Tag, std::remove_const_t<decltype(Entries::tag)>> && ...),
+      "Registry entries must be tagged with the registry's tag type");
+  static_assert(
+      ((count_tag_entries<Entries...>(static_cast<size_t>(Entries::tag)) == 1) && ...),
+      "Registry tags must be unique");
+  static_assert(
+      ((count_type_entries<typename Entries::Type, Entries...>() == 1) && ...),
+      "Registry types must be unique");
+
+  static constexpr size_t index(Tag tag) noexcept { return static_cast<size_t>(tag); }
+
+  static constexpr size_t table_size =
+      std::max({static_cast<size_t>(Entries::tag)...}) + 1;
+
+  template <typename Result, typename Visitor>
+  using Handler = Result (*)(Visitor &visitor, Result invalid);
+
+  template <typename Result, typename Visitor>
+  using HandlerTable = std::array<Handler<Result, Visitor>, table_size>;
+
+  template <typename Entry, typename Result, typename Visitor>
+  static Result call(Visitor &visitor, Result /*invalid*/) {
+    return visitor(Entry{});
+  }
+
+  template <typename Result, typename Visitor>
+  static Result reject(Visitor & /*visitor*/, Result invalid) {
+    return invalid;
+  }
+
+  // Tag values without an entry get a handler which rejects them, so that dispatch never needs
+  // to check for missing handlers
+  template <typename Result, typename Visitor>
+  static constexpr HandlerTable<Result, Visitor> make_handlers() noexcept {
+    HandlerTable<Result, Visitor> handlers{};
+    for (auto &handler : handlers) {
+      handler = &reject<Result, Visitor>;
+    }
+    ((handlers[index(Entries::tag)] = &call<Entries, Result, Visitor>), ...);
+    return handlers;
+  }
+};
+
+}  // namespace Pufferfish::Util
@@ -58,6 +58,7 @@ void PendSV_Handler(void);
 void SysTick_Handler(void);
 void USART3_IRQHandler(void);
 void UART4_IRQHandler(void);
+void TIM6_DAC_IRQHandler(void);
 void UART7_IRQHandler(void);
 /* USER CODE BEGIN EFP */
 
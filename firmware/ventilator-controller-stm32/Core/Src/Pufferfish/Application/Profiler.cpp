@@ -0,0 +1,37 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * Profiler.cpp
+ *
+ *  Execution time statistics of the profiled regions of the firmware, for output to the
+ *  backend in the profile state segment.
+ */
+
+#include "Pufferfish/Application/Profiler.h"
+
+#include <algorithm>
+
+namespace Pufferfish::Application {
+
+// Profiler
+
+Util::ProfileStats &Profiler::region(ProfileRegion region) {
+  return regions_[static_cast<size_t>(region)];
+}
+
+void Profiler::output(uint32_t current_time, Profile &output) {
+  const Util::ProfileStats &stats = regions_[next_region_];
+  output.time = current_time;
+  output.region = static_cast<ProfileRegion>(next_region_);
+  output.count = stats.count();
+  output.min_cycles = stats.min();
+  output.max_cycles = stats.max();
+  output.mean_cycles = stats.mean();
+  const Util::ProfileStats::Histogram &histogram = stats.histogram();
+  std::copy(histogram.begin(), histogram.end(), std::begin(output.histogram));
+  output.histogram_count = histogram.size();
+
+  next_region_ = (next_region_ + 1) % num_regions;
+}
+
+}  // namespace Pufferfish::Application
@@ -18,6 +18,9 @@ PB_BIND(AlarmLimitsRequest, AlarmLimitsRequest, AUTO)
 PB_BIND(SensorMeasurements, SensorMeasurements, AUTO)
 
 
+PB_BIND(SensorWaveforms, SensorWaveforms, AUTO)
+
+
 PB_BIND(CycleMeasurements, CycleMeasurements, AUTO)
 
 
@@ -57,6 +60,18 @@ PB_BIND(AlarmMute, AlarmMute, AUTO)
 PB_BIND(AlarmMuteRequest, AlarmMuteRequest, AUTO)
 
 
+PB_BIND(Capabilities, Capabilities, AUTO)
+
+
+PB_BIND(CapabilitiesRequest, CapabilitiesRequest, AUTO)
+
+
+PB_BIND(Diagnostics, Diagnostics, AUTO)
+
+
+PB_BIND(Profile, Profile, AUTO)
+
+
 
 
 
@@ -13,6 +13,15 @@ namespace Pufferfish::Driver::BreathingCircuit {
 
 // ControlLoop
 
+void ControlLoop::update(uint32_t current_time) {
+  if (!update_needed(current_time)) {
+    return;
+  }
+
+  step(current_time);
+  advance_step_time(current_time);
+}
+
 void ControlLoop::advance_step_time(uint32_t current_time) {
   previous_step_time_ = current_time;
 }
@@ -39,11 +48,7 @@ const ActuatorVars &HFNCControlLoop::actuator_vars() const {
   return actuator_vars_;
 }
 
-void HFNCControlLoop::update(uint32_t current_time) {
-  if (!update_needed(current_time)) {
-    return;
-  }
-
+void HFNCControlLoop::step(uint32_t current_time) {
   if (parameters_.mode != VentilationMode_hfnc) {
     return;
   }
@@ -62,12 +67,11 @@ void HFNCControlLoop::update(uint32_t current_time) {
       sensor_measurements_,
       actuator_setpoints_,
       actuator_vars_);
+  waveforms_.input(current_time, sensor_measurements_);
 
   // Update actuators
   valve_air_.set_duty_cycle(actuator_vars_.valve_air_opening);
   valve_o2_.set_duty_cycle(actuator_vars_.valve_o2_opening);
-
-  advance_step_time(current_time);
 }
 
 }  // namespace Pufferfish::Driver::BreathingCircuit
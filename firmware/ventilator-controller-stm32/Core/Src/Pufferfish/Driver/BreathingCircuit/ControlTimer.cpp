@@ -0,0 +1,70 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * ControlTimer.cpp
+ *
+ *  Runs the steps of a control loop at the ticks of a hardware timer, so that the control
+ *  period does not depend on how long the other work in the main loop takes.
+ */
+
+#include "Pufferfish/Driver/BreathingCircuit/ControlTimer.h"
+
+namespace Pufferfish::Driver::BreathingCircuit {
+
+// ControlTimer
+
+void ControlTimer::start(uint32_t current_time) {
+  start_time_ = current_time;
+  serviced_ticks_ = ticks_.load(std::memory_order_acquire);
+}
+
+void ControlTimer::tick() {
+  // The timestamp is stored before the count, so that service() can check that it read the
+  // timestamp of the tick it counted
+  tick_micros_.store(time_.micros(), std::memory_order_relaxed);
+  ticks_.store(ticks_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+bool ControlTimer::service() {
+  uint32_t ticks = 0;
+  uint32_t tick_micros = 0;
+  do {
+    ticks = ticks_.load(std::memory_order_acquire);
+    tick_micros = tick_micros_.load(std::memory_order_relaxed);
+  } while (ticks != ticks_.load(std::memory_order_acquire));
+
+  uint32_t elapsed_ticks = ticks - serviced_ticks_;
+  if (elapsed_ticks == 0) {
+    return false;
+  }
+
+  stats_.missed_ticks += elapsed_ticks - 1;
+  serviced_ticks_ = ticks;
+  measure(tick_micros, time_.micros(), elapsed_ticks);
+  control_loop_.step(start_time_ + ticks * ControlLoop::update_interval);
+  return true;
+}
+
+void ControlTimer::measure(uint32_t tick_micros, uint32_t step_micros, uint32_t elapsed_ticks) {
+  if (step_micros >= tick_micros) {
+    stats_.latency = step_micros - tick_micros;
+    if (stats_.latency > stats_.max_latency) {
+      stats_.max_latency = stats_.latency;
+    }
+  }
+
+  if (stats_.steps > 0 && step_micros >= previous_step_micros_) {
+    uint32_t interval = step_micros - previous_step_micros_;
+    uint32_t expected_interval = elapsed_ticks * period;
+    stats_.jitter = interval > expected_interval ? interval - expected_interval
+                                                 : expected_interval - interval;
+    if (stats_.jitter > stats_.max_jitter) {
+      stats_.max_jitter = stats_.jitter;
+    }
+  }
+
+  previous_step_micros_ = step_micros;
+  ++stats_.steps;
+}
+
+}  // namespace Pufferfish::Driver::BreathingCircuit
@@ -0,0 +1,43 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * Waveforms.cpp
+ *
+ *  Collection of sensor measurements from every step of the control loop into batches of
+ *  waveform samples, so that the complete waveforms can be sent in a few large messages.
+ */
+
+#include "Pufferfish/Driver/BreathingCircuit/Waveforms.h"
+
+namespace Pufferfish::Driver::BreathingCircuit {
+
+// SensorWaveformsCollector
+
+void SensorWaveformsCollector::input(
+    uint32_t current_time, const SensorMeasurements &sensor_measurements) {
+  if (batch_.offset_count == 0) {
+    batch_.time = current_time;
+    batch_.first_sample = samples_;
+  }
+
+  pb_size_t index = batch_.offset_count;
+  batch_.offset[index] = current_time - batch_.time;
+  batch_.paw[index] = sensor_measurements.paw;
+  batch_.flow[index] = sensor_measurements.flow;
+  batch_.volume[index] = sensor_measurements.volume;
+  ++index;
+  batch_.offset_count = index;
+  batch_.paw_count = index;
+  batch_.flow_count = index;
+  batch_.volume_count = index;
+  ++samples_;
+
+  if (index < batch_size) {
+    return;
+  }
+
+  sensor_waveforms_ = batch_;
+  batch_ = SensorWaveforms{};
+}
+
+}  // namespace Pufferfish::Driver::BreathingCircuit
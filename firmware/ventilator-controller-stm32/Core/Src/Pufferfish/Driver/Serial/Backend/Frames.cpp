@@ -13,41 +13,66 @@ namespace Pufferfish::Driver::Serial::Backend {
 
 FrameProps::InputStatus FrameReceiver::input(uint8_t new_byte) {
   bool input_overwritten = false;
-  auto status = chunk_splitter_.input(new_byte, input_overwritten);
+  if (input_status_ == FrameProps::InputStatus::output_ready) {
+    reset();
+    input_overwritten = true;
+  }
+
+  if (new_byte == delimiter) {
+    input_status_ = FrameProps::InputStatus::output_ready;
+  } else if (length_exceeded_ || cobs_decoder_.input(new_byte, buffer_) != IndexStatus::ok) {
+    length_exceeded_ = true;
+    input_status_ = FrameProps::InputStatus::invalid_length;
+  }
+
   if (input_overwritten) {
     return FrameProps::InputStatus::input_overwritten;
   }
 
-  switch (status) {
-    case Protocols::ChunkInputStatus::output_ready:
-      return FrameProps::InputStatus::output_ready;
-    case Protocols::ChunkInputStatus::invalid_length:
-      return FrameProps::InputStatus::invalid_length;
-    case Protocols::ChunkInputStatus::ok:
-      break;
+  return input_status_;
+}
+
+FrameProps::OutputStatus FrameReceiver::output(Util::ByteView &output_view) {
+  if (input_status_ == FrameProps::InputStatus::ok) {
+    return FrameProps::OutputStatus::waiting;
+  }
+
+  FrameProps::OutputStatus status = FrameProps::OutputStatus::ok;
+  if (length_exceeded_) {
+    status = FrameProps::OutputStatus::invalid_length;
+  } else if (cobs_decoder_.complete()) {
+    output_view = buffer_;
+  } else {
+    // The last block of the frame was truncated, so it decodes to nothing
+    output_view = Util::ByteView();
   }
 
-  return FrameProps::InputStatus::ok;
+  // Only the size of buffer_ is cleared, so the view remains valid until the next input
+  reset();
+  return status;
 }
 
 FrameProps::OutputStatus FrameReceiver::output(FrameProps::PayloadBuffer &output_buffer) {
-  FrameProps::EncodedBuffer temp_buffer;
-
-  // Chunk
-  FrameProps::OutputStatus status = chunk_splitter_.output(temp_buffer);
+  Util::ByteView output_view;
+  FrameProps::OutputStatus status = output(output_view);
   if (status != FrameProps::OutputStatus::ok) {
     return status;
   }
 
-  // COBS
-  status = cobs_decoder.transform(temp_buffer, output_buffer);
-  if (status != FrameProps::OutputStatus::ok) {
-    return status;
+  if (output_buffer.copy_from(output_view.buffer(), output_view.size()) != IndexStatus::ok) {
+    return FrameProps::OutputStatus::invalid_length;
   }
 
   return FrameProps::OutputStatus::ok;
 }
 
+void FrameReceiver::reset() {
+  buffer_.clear();
+  cobs_decoder_.reset();
+  input_status_ = FrameProps::InputStatus::ok;
+  length_exceeded_ = false;
+}
+
 // FrameSender
 
 FrameProps::OutputStatus FrameSender::transform(
@@ -19,4 +19,42 @@ uint32_t HALCRC32::compute(const uint8_t *data, size_t size) {
       size);
 }
 
+uint32_t HALCRC32::init() {
+  return init_value();
+}
+
+uint32_t HALCRC32::update(uint32_t running, const uint8_t *data, size_t size) {
+  // Resume from the running value by loading it as the initial value of the peripheral,
+  // then restore the configured initial value so that compute is unaffected
+  WRITE_REG(hcrc_.Instance->INIT, running);
+  __HAL_CRC_DR_RESET(&hcrc_);
+  uint32_t result = HAL_CRC_Accumulate(
+      &hcrc_,
+      // See compute for the reasons for these casts.
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast, cppcoreguidelines-pro-type-reinterpret-cast)
+      const_cast<uint32_t *>(reinterpret_cast<const uint32_t *>(data)),
+      size);
+  WRITE_REG(hcrc_.Instance->INIT, init_value());
+  // Reading the data register applies the output inversion, which must be undone
+  return invert_output(result);
+}
+
+uint32_t HALCRC32::finalize(uint32_t running) {
+  return ~invert_output(running);
+}
+
+uint32_t HALCRC32::init_value() const {
+  if (hcrc_.Init.DefaultInitValueUse == DEFAULT_INIT_VALUE_ENABLE) {
+    return DEFAULT_CRC_INITVALUE;
+  }
+  return hcrc_.Init.InitValue;
+}
+
+uint32_t HALCRC32::invert_output(uint32_t value) const {
+  if (hcrc_.Init.OutputDataInversionMode == CRC_OUTPUTDATA_INVERSION_ENABLE) {
+    return __RBIT(value);
+  }
+  return value;
+}
+
 }  // namespace Pufferfish::HAL
@@ -74,6 +74,11 @@ uint32_t HALTime::micros() {
          cycles_per_us;
 }
 
+uint32_t HALTime::cycles() {
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-cstyle-cast)
+  return DWT->CYCCNT;  // @suppress("C-Style cast instead of C++ cast") // @suppress("Field cannot be resolved")
+}
+
 void HALTime::delay_micros(uint32_t microseconds) {
   // The following lines suppress Eclipse CDT's warning about C-style casts and
   // unresolvable fields; these come from the STM32 HAL so we can't do anything
@@ -93,4 +93,12 @@ size_t get_encoded_cobs_buffer_size(size_t unencoded_buffer_size) {
   return unencoded_buffer_size + unencoded_buffer_size / max_block_size + 1;
 }
 
+// COBSStreamDecoder
+
+void COBSStreamDecoder::reset() {
+  block_started_ = false;
+  block_code_ = 0;
+  block_remaining_ = 0;
+}
+
 }  // namespace Pufferfish::Util
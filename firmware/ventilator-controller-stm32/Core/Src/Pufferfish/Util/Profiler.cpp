@@ -0,0 +1,52 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * Profiler.cpp
+ *
+ *  A lightweight scoped profiler, which records the execution times of regions of code in CPU
+ *  cycles. Profiling is only compiled in when PF_PROFILER is defined.
+ */
+
+#include "Pufferfish/Util/Profiler.h"
+
+namespace Pufferfish::Util {
+
+// ProfileStats
+
+size_t ProfileStats::histogram_bucket(uint32_t cycles) {
+  if (cycles == 0) {
+    return 0;
+  }
+
+  // The index of the most significant set bit is floor(log2(cycles))
+  static const size_t max_bit_index = 31;
+  auto bucket = max_bit_index - static_cast<size_t>(__builtin_clz(cycles));
+  return bucket < histogram_size ? bucket : histogram_size - 1;
+}
+
+void ProfileStats::record(uint32_t cycles) {
+  if (count_ == UINT32_MAX) {
+    // The mean restarts when the count wraps around
+    count_ = 0;
+    total_ = 0;
+  }
+  ++count_;
+  total_ += cycles;
+  if (cycles < min_) {
+    min_ = cycles;
+  }
+  if (cycles > max_) {
+    max_ = cycles;
+  }
+  ++histogram_[histogram_bucket(cycles)];
+}
+
+uint32_t ProfileStats::mean() const {
+  if (count_ == 0) {
+    return 0;
+  }
+
+  return static_cast<uint32_t>(total_ / count_);
+}
+
+}  // namespace Pufferfish::Util
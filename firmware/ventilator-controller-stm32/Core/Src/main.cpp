@@ -32,10 +32,10 @@
 #include <functional>
 
 #include "Pufferfish/AlarmsManager.h"
-#include "Pufferfish/Application/States.h"
+#include "Pufferfish/Application/Firmware.h"
+#include "Pufferfish/Application/Profiler.h"
 #include "Pufferfish/Driver/BreathingCircuit/ControlLoop.h"
-#include "Pufferfish/Driver/BreathingCircuit/ParametersService.h"
-#include "Pufferfish/Driver/BreathingCircuit/Simulator.h"
+#include "Pufferfish/Driver/BreathingCircuit/ControlTimer.h"
 #include "Pufferfish/Driver/Button/Button.h"
 #include "Pufferfish/Driver/I2C/ExtendedI2CDevice.h"
 #include "Pufferfish/Driver/I2C/HoneywellABP.h"
@@ -53,6 +53,7 @@
 #include "Pufferfish/HAL/HAL.h"
 #include "Pufferfish/HAL/STM32/HAL.h"
 #include "Pufferfish/Statuses.h"
+#include "Pufferfish/Util/Scheduler.h"
 #include "Pufferfish/Util/Timeouts.h"
 /* USER CODE END Includes */
 
@@ -85,6 +86,7 @@ TIM_HandleTypeDef htim2;
 TIM_HandleTypeDef htim3;
 TIM_HandleTypeDef htim4;
 TIM_HandleTypeDef htim5;
+TIM_HandleTypeDef htim6;
 TIM_HandleTypeDef htim8;
 TIM_HandleTypeDef htim12;
 
@@ -98,29 +100,22 @@ UART_HandleTypeDef huart3;
 
 namespace PF = Pufferfish;
 
-// Application State
-PF::Application::States all_states;
-
-// Parameters
-PF::Driver::BreathingCircuit::ParametersServices parameters_service;
-
-// Breathing Circuit Simulation
-PF::Driver::BreathingCircuit::Simulators simulator;
-
 // HAL Utilities
 PF::HAL::HALCRC32 crc32c(hcrc);
 
 // HAL Time
 PF::HAL::HALTime time;
 
+#ifdef PF_PROFILER
+// Execution Profiling, also of the interrupt handlers in stm32h7xx_it.cpp
+PF::Application::Profiler profiler;
+#endif
+
 // Buffered UARTs
 volatile Pufferfish::HAL::LargeBufferedUART backend_uart(huart3, time);
 volatile Pufferfish::HAL::LargeBufferedUART fdo2_uart(huart7, time);
 volatile Pufferfish::HAL::ReadOnlyBufferedUART nonin_oem_uart(huart4, time);
 
-// UART Serial Communication
-PF::Driver::Serial::Backend::UARTBackend backend(backend_uart, crc32c, all_states);
-
 // Create an object for ADC3 of AnalogInput Class
 static const uint32_t adc_poll_timeout = 10;
 PF::HAL::HALAnalogInput adc3_input(hadc3, adc_poll_timeout);
@@ -335,14 +330,118 @@ auto i2c_test_list = PF::Util::make_array<PF::Driver::Testable *>(
 int interface_test_state = 0;
 int interface_test_millis = 0;
 
-// Breathing Circuit Control
-PF::Driver::BreathingCircuit::HFNCControlLoop hfnc(
-    all_states.parameters(),
-    all_states.sensor_measurements(),
-    sfm3019_air,
-    sfm3019_o2,
-    drive1_ch1,
-    drive1_ch2);
+// Application: states, breathing circuit control and simulation, and the backend serial link
+using Firmware = PF::Application::Firmware<PF::HAL::LargeBufferedUART>;
+Firmware firmware(backend_uart, crc32c, time, sfm3019_air, sfm3019_o2, drive1_ch1, drive1_ch2);
+// When timer-driven, the control loop steps at the ticks of TIM6 instead of whenever the main
+// loop notices that its update interval has elapsed, so its period is deterministic
+static const bool control_loop_timer_driven = true;
+PF::Driver::BreathingCircuit::ControlTimer hfnc_timer(firmware.hfnc(), time);
+
+// Scheduler
+// Periods are in ms and budgets are in us; the application's own tasks are scheduled as given
+// in Firmware. When timer-driven, the control loop checks for a tick of its timer on every
+// iteration
+static const uint32_t control_loop_period =
+    control_loop_timer_driven ? 0 : PF::Driver::BreathingCircuit::ControlLoop::update_interval;
+static const uint32_t sensors_period = 1;
+static const uint32_t sensors_budget = 200;
+static const uint8_t sensors_priority = 2;
+static const uint32_t indicators_period = 1;
+static const uint32_t indicators_budget = 20;
+static const uint8_t indicators_priority = 0;
+auto tasks = PF::Util::make_array<PF::Util::Task>(
+    // Breathing Circuit Control Loop
+    PF::Util::Task{
+        [](uint32_t current_time) {
+          PF_PROFILE(PF::HAL::HALTime, profiler.region(ProfileRegion_control_loop));
+          if (control_loop_timer_driven) {
+            hfnc_timer.service();
+          } else {
+            firmware.hfnc().update(current_time);
+          }
+        },
+        control_loop_period,
+        Firmware::control_loop_priority,
+        Firmware::control_loop_budget},
+    // Breathing Circuit Sensor Simulator
+    PF::Util::Task{
+        [](uint32_t current_time) { firmware.update_simulator(current_time); },
+        Firmware::simulator_period,
+        Firmware::simulator_priority,
+        Firmware::simulator_budget},
+    // Independent Sensors
+    PF::Util::Task{
+        [](uint32_t /*current_time*/) {
+          PF_PROFILE(PF::HAL::HALTime, profiler.region(ProfileRegion_sensors));
+          fdo2.output(firmware.hfnc().sensor_vars().po2);
+          nonin_oem.output(firmware.states().sensor_measurements().spo2);
+        },
+        sensors_period,
+        sensors_priority,
+        sensors_budget},
+    // Backend Communication Protocol
+    PF::Util::Task{
+        [](uint32_t current_time) {
+          {
+            PF_PROFILE(PF::HAL::HALTime, profiler.region(ProfileRegion_backend_receive));
+            firmware.receive_backend();
+          }
+          firmware.backend().update_clock(current_time);
+          {
+            PF_PROFILE(PF::HAL::HALTime, profiler.region(ProfileRegion_backend_send));
+            firmware.backend().send();
+          }
+        },
+        Firmware::backend_period,
+        Firmware::backend_priority,
+        Firmware::backend_budget},
+    // Parameters update
+    PF::Util::Task{
+        [](uint32_t /*current_time*/) { firmware.update_parameters(); },
+        Firmware::parameters_period,
+        Firmware::parameters_priority,
+        Firmware::parameters_budget},
+    // Software PWM signals and indicators for debugging
+    PF::Util::Task{
+        [](uint32_t current_time) {
+          flasher.input(current_time);
+          blinker.input(current_time);
+          dimmer.input(current_time);
+
+          static constexpr float valve_opening_indicator_threshold = 0.00001;
+          if (firmware.hfnc().actuator_vars().valve_air_opening >
+              valve_opening_indicator_threshold) {
+            board_led1.write(dimmer.output());
+          } else {
+            board_led1.write(false);
+          }
+          /*if (hfnc.sensor_vars().flow_o2 > 1 || hfnc.sensor_vars().flow_air > 1) {
+            board_led1.write(true);
+          } else if (hfnc.sensor_vars().flow_o2 < -1 || hfnc.sensor_vars().flow_air < -1) {
+            board_led1.write(dimmer.output());
+          } else {
+            board_led1.write(false);
+          }*/
+        },
+        indicators_period,
+        indicators_priority,
+        indicators_budget});
+#ifdef PF_PROFILER
+static const uint32_t profiler_period = 100;  // the profile state segment's output interval
+static const uint32_t profiler_budget = 20;
+static const uint8_t profiler_priority = 0;
+auto profiler_tasks = PF::Util::make_array<PF::Util::Task>(
+    // Output of the profile of one region to the backend
+    PF::Util::Task{
+        [](uint32_t current_time) { profiler.output(current_time, firmware.states().profile()); },
+        profiler_period,
+        profiler_priority,
+        profiler_budget});
+#else
+std::array<PF::Util::Task, 0> profiler_tasks{};
+#endif
+PF::Util::Scheduler<tasks.size() + profiler_tasks.size()> scheduler(time);
 
 /* USER CODE END PV */
 
@@ -366,6 +465,7 @@ static void MX_TIM4_Init(void);
 static void MX_TIM5_Init(void);
 static void MX_TIM8_Init(void);
 static void MX_TIM12_Init(void);
+static void MX_TIM6_Init(void);
 /* USER CODE BEGIN PFP */
 
 /* USER CODE END PFP */
@@ -460,6 +560,7 @@ int main(void)
   MX_TIM5_Init();
   MX_TIM8_Init();
   MX_TIM12_Init();
+  MX_TIM6_Init();
   /* USER CODE BEGIN 2 */
   // Time
   PF::HAL::HALTime::micros_delay_init();
@@ -532,51 +633,24 @@ int main(void)
   board_led1.write(false);
 
   // Normal loop
-  while (true) {
-    uint32_t current_time = time.millis();
-
-    // Software PWM signals
-    flasher.input(time.millis());
-    blinker.input(time.millis());
-    dimmer.input(time.millis());
-
-    // Parameters update
-    parameters_service.transform(all_states.parameters_request(), all_states.parameters());
-
-    // Breathing Circuit Sensor Simulator
-    simulator.transform(
-        current_time,
-        all_states.parameters(),
-        hfnc.sensor_vars(),
-        all_states.sensor_measurements(),
-        all_states.cycle_measurements());
-
-    // Independent Sensors
-    fdo2.output(hfnc.sensor_vars().po2);
-    nonin_oem.output(all_states.sensor_measurements().spo2);
-
-    // Breathing Circuit Control Loop
-    hfnc.update(current_time);
-
-    // Indicators for debugging
-    static constexpr float valve_opening_indicator_threshold = 0.00001;
-    if (hfnc.actuator_vars().valve_air_opening > valve_opening_indicator_threshold) {
-      board_led1.write(dimmer.output());
-    } else {
-      board_led1.write(false);
+  if (control_loop_timer_driven) {
+    hfnc_timer.start(time.millis());
+    if (HAL_TIM_Base_Start_IT(&htim6) != HAL_OK) {
+      Error_Handler();
     }
-    /*if (hfnc.sensor_vars().flow_o2 > 1 || hfnc.sensor_vars().flow_air > 1) {
-      board_led1.write(true);
-    } else if (hfnc.sensor_vars().flow_o2 < -1 || hfnc.sensor_vars().flow_air < -1) {
-      board_led1.write(dimmer.output());
-    } else {
-      board_led1.write(false);
-    }*/
-
-    // Backend Communication Protocol
-    backend.receive();
-    backend.update_clock(current_time);
-    backend.send();
+  }
+  for (const auto &task : tasks) {
+    if (scheduler.add(task) != PF::IndexStatus::ok) {
+      Error_Handler();
+    }
+  }
+  for (const auto &task : profiler_tasks) {
+    if (scheduler.add(task) != PF::IndexStatus::ok) {
+      Error_Handler();
+    }
+  }
+  while (true) {
+    scheduler.run(time.millis());
 
     /*
     PF::AlarmManagerStatus stat = h_alarms.update(time.millis());
@@ -1211,6 +1285,44 @@ static void MX_TIM5_Init(void)
 
 }
 
+/**
+  * @brief TIM6 Initialization Function
+  * @param None
+  * @retval None
+  */
+static void MX_TIM6_Init(void)
+{
+
+  /* USER CODE BEGIN TIM6_Init 0 */
+
+  /* USER CODE END TIM6_Init 0 */
+
+  TIM_MasterConfigTypeDef sMasterConfig = {0};
+
+  /* USER CODE BEGIN TIM6_Init 1 */
+  // The control loop's timer ticks every ControlTimer::period: 64 MHz / 64 / 2000 = 500 Hz
+  /* USER CODE END TIM6_Init 1 */
+  htim6.Instance = TIM6;
+  htim6.Init.Prescaler = 63;
+  htim6.Init.CounterMode = TIM_COUNTERMODE_UP;
+  htim6.Init.Period = 1999;
+  htim6.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+  if (HAL_TIM_Base_Init(&htim6) != HAL_OK)
+  {
+    Error_Handler();
+  }
+  sMasterConfig.MasterOutputTrigger = TIM_TRGO_RESET;
+  sMasterConfig.MasterSlaveMode = TIM_MASTERSLAVEMODE_DISABLE;
+  if (HAL_TIMEx_MasterConfigSynchronization(&htim6, &sMasterConfig) != HAL_OK)
+  {
+    Error_Handler();
+  }
+  /* USER CODE BEGIN TIM6_Init 2 */
+
+  /* USER CODE END TIM6_Init 2 */
+
+}
+
 /**
   * @brief TIM8 Initialization Function
   * @param None
@@ -1720,7 +1832,11 @@ static void MX_GPIO_Init(void)
 }
 
 /* USER CODE BEGIN 4 */
-
+void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim) {
+  if (htim->Instance == TIM6) {
+    hfnc_timer.tick();
+  }
+}
 /* USER CODE END 4 */
 
 /**
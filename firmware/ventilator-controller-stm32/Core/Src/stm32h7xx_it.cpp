@@ -23,8 +23,10 @@
 #include "stm32h7xx_it.h"
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include "Pufferfish/Application/Profiler.h"
 #include "Pufferfish/Driver/Serial/Nonin/Device.h"
 #include "Pufferfish/HAL/STM32/HALBufferedUART.h"
+#include "Pufferfish/HAL/STM32/HALTime.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -48,6 +50,10 @@
 extern volatile Pufferfish::HAL::LargeBufferedUART backend_uart;
 extern volatile Pufferfish::HAL::LargeBufferedUART fdo2_uart;
 extern volatile Pufferfish::HAL::ReadOnlyBufferedUART nonin_oem_uart;
+#ifdef PF_PROFILER
+/// Execution Profiling
+extern Pufferfish::Application::Profiler profiler;
+#endif
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
@@ -61,6 +67,7 @@ extern volatile Pufferfish::HAL::ReadOnlyBufferedUART nonin_oem_uart;
 /* USER CODE END 0 */
 
 /* External variables --------------------------------------------------------*/
+extern TIM_HandleTypeDef htim6;
 extern UART_HandleTypeDef huart4;
 extern UART_HandleTypeDef huart7;
 extern UART_HandleTypeDef huart3;
@@ -210,7 +217,10 @@ void SysTick_Handler(void)
 void USART3_IRQHandler(void)
 {
   /* USER CODE BEGIN USART3_IRQn 0 */
-  backend_uart.handle_irq();
+  {
+    PF_PROFILE(Pufferfish::HAL::HALTime, profiler.region(ProfileRegion_backend_uart_isr));
+    backend_uart.handle_irq();
+  }
   /* USER CODE END USART3_IRQn 0 */
   HAL_UART_IRQHandler(&huart3);
   /* USER CODE BEGIN USART3_IRQn 1 */
@@ -224,7 +234,10 @@ void USART3_IRQHandler(void)
 void UART4_IRQHandler(void)
 {
   /* USER CODE BEGIN UART4_IRQn 0 */
-  nonin_oem_uart.handle_irq();
+  {
+    PF_PROFILE(Pufferfish::HAL::HALTime, profiler.region(ProfileRegion_nonin_oem_uart_isr));
+    nonin_oem_uart.handle_irq();
+  }
   /* USER CODE END UART4_IRQn 0 */
   HAL_UART_IRQHandler(&huart4);
   /* USER CODE BEGIN UART4_IRQn 1 */
@@ -232,13 +245,30 @@ void UART4_IRQHandler(void)
   /* USER CODE END UART4_IRQn 1 */
 }
 
+/**
+  * @brief This function handles TIM6 global interrupt, DAC1_CH1 and DAC1_CH2 underrun error interrupts.
+  */
+void TIM6_DAC_IRQHandler(void)
+{
+  /* USER CODE BEGIN TIM6_DAC_IRQn 0 */
+
+  /* USER CODE END TIM6_DAC_IRQn 0 */
+  HAL_TIM_IRQHandler(&htim6);
+  /* USER CODE BEGIN TIM6_DAC_IRQn 1 */
+
+  /* USER CODE END TIM6_DAC_IRQn 1 */
+}
+
 /**
   * @brief This function handles UART7 global interrupt.
   */
 void UART7_IRQHandler(void)
 {
   /* USER CODE BEGIN UART7_IRQn 0 */
-  fdo2_uart.handle_irq();
+  {
+    PF_PROFILE(Pufferfish::HAL::HALTime, profiler.region(ProfileRegion_fdo2_uart_isr));
+    fdo2_uart.handle_irq();
+  }
   /* USER CODE END UART7_IRQn 0 */
   HAL_UART_IRQHandler(&huart7);
   /* USER CODE BEGIN UART7_IRQn 1 */
@@ -0,0 +1,122 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * stm32h7xx_hal.h
+ *
+ *  A minimal stand-in for the STM32Cube HAL, so that the STM32 HAL classes which are templates
+ *  can be instantiated and tested on the native computer. Only the UART, DMA, and interrupt
+ *  masking functions and macros used by those classes are emulated: the DMA controller is
+ *  driven by the tests through the extra members of the handles, and the interrupt mask is a
+ *  plain variable.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+typedef enum {
+  HAL_OK = 0x00U,
+  HAL_ERROR = 0x01U,
+  HAL_BUSY = 0x02U,
+  HAL_TIMEOUT = 0x03U
+} HAL_StatusTypeDef;
+typedef enum { RESET = 0U, SET = !RESET } FlagStatus, ITStatus;
+
+// Registers
+
+#define SET_BIT(REG, BIT) ((REG) |= (BIT))
+#define CLEAR_BIT(REG, BIT) ((REG) &= ~(BIT))
+
+#define USART_CR1_UE (1U << 0U)
+#define USART_CR1_IDLEIE (1U << 4U)
+#define USART_CR3_OVRDIS (1U << 12U)
+#define USART_ISR_IDLE (1U << 4U)
+
+typedef struct {
+  uint32_t CR1;
+  uint32_t CR3;
+  uint32_t ISR;
+} USART_TypeDef;
+
+// DMA
+
+typedef struct {
+  // Emulated NDTR register: the number of transfers remaining before the end of the buffer
+  uint32_t counter;
+} DMA_HandleTypeDef;
+
+#define __HAL_DMA_GET_COUNTER(__HANDLE__) ((__HANDLE__)->counter)
+
+// UART
+
+typedef struct {
+  USART_TypeDef *Instance;
+  DMA_HandleTypeDef *hdmatx;
+  DMA_HandleTypeDef *hdmarx;
+
+  // Emulation of the transfers started by the HAL functions below
+  uint8_t *rx_buffer;
+  uint16_t rx_size;
+  const uint8_t *tx_buffer;
+  uint16_t tx_size;
+  uint32_t tx_transfers;
+  // The statuses which HAL_UART_Receive_DMA and HAL_UART_Transmit_DMA return
+  HAL_StatusTypeDef rx_status;
+  HAL_StatusTypeDef tx_status;
+} UART_HandleTypeDef;
+
+#define UART_IT_IDLE USART_CR1_IDLEIE
+#define UART_FLAG_IDLE USART_ISR_IDLE
+
+#define __HAL_UART_ENABLE(__HANDLE__) SET_BIT((__HANDLE__)->Instance->CR1, USART_CR1_UE)
+#define __HAL_UART_DISABLE(__HANDLE__) CLEAR_BIT((__HANDLE__)->Instance->CR1, USART_CR1_UE)
+#define __HAL_UART_ENABLE_IT(__HANDLE__, __INTERRUPT__) \
+  SET_BIT((__HANDLE__)->Instance->CR1, (__INTERRUPT__))
+#define __HAL_UART_GET_IT_SOURCE(__HANDLE__, __INTERRUPT__) \
+  ((((__HANDLE__)->Instance->CR1 & (__INTERRUPT__)) != 0U) ? SET : RESET)
+#define __HAL_UART_GET_FLAG(__HANDLE__, __FLAG__) \
+  ((((__HANDLE__)->Instance->ISR & (__FLAG__)) == (__FLAG__)) ? SET : RESET)
+#define __HAL_UART_CLEAR_IDLEFLAG(__HANDLE__) CLEAR_BIT((__HANDLE__)->Instance->ISR, USART_ISR_IDLE)
+
+inline HAL_StatusTypeDef HAL_UART_Receive_DMA(
+    UART_HandleTypeDef *huart, uint8_t *p_data, uint16_t size) {
+  if (huart->rx_status != HAL_OK) {
+    return huart->rx_status;
+  }
+
+  huart->rx_buffer = p_data;
+  huart->rx_size = size;
+  huart->hdmarx->counter = size;
+  return HAL_OK;
+}
+
+inline HAL_StatusTypeDef HAL_UART_Transmit_DMA(
+    UART_HandleTypeDef *huart, const uint8_t *p_data, uint16_t size) {
+  if (huart->tx_status != HAL_OK) {
+    return huart->tx_status;
+  }
+
+  huart->tx_buffer = p_data;
+  huart->tx_size = size;
+  ++huart->tx_transfers;
+  return HAL_OK;
+}
+
+// Interrupt masking
+
+inline uint32_t &emulated_primask() {
+  static uint32_t primask = 0;
+  return primask;
+}
+
+inline uint32_t __get_PRIMASK() {
+  return emulated_primask();
+}
+
+inline void __set_PRIMASK(uint32_t pri_mask) {
+  emulated_primask() = pri_mask;
+}
+
+inline void __disable_irq() {
+  emulated_primask() = 1;
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * Firmware.cpp
+ *
+ * Unit tests to confirm behavior of the firmware application shared by main.cpp and the
+ * software-in-the-loop build
+ *
+ */
+
+#include "Pufferfish/Application/Firmware.h"
+
+#include "Pufferfish/HAL/CRCChecker.h"
+#include "Pufferfish/HAL/Mock/MockBufferedUART.h"
+#include "Pufferfish/HAL/Mock/MockI2CDevice.h"
+#include "Pufferfish/HAL/Mock/MockPWM.h"
+#include "Pufferfish/HAL/Mock/MockTime.h"
+#include "catch2/catch.hpp"
+
+namespace PF = Pufferfish;
+namespace BE = PF::Driver::Serial::Backend;
+namespace SFM3019 = PF::Driver::I2C::SFM3019;
+
+SCENARIO(
+    "Application::Firmware: requests from the backend reach the control loop's parameters, "
+    "and the simulated measurements reach the backend",
+    "[Firmware]") {
+  using TestFirmware = PF::Application::Firmware<PF::HAL::MockLargeBufferedUART>;
+
+  PF::HAL::SoftCRC32 crc32c{PF::HAL::crc32c_params};
+  PF::HAL::MockLargeBufferedUART uart;
+  PF::HAL::MockTime time;
+  PF::HAL::MockI2CDevice i2c_air;
+  PF::HAL::MockI2CDevice i2c_o2;
+  PF::HAL::MockI2CDevice i2c_global;
+  SFM3019::Device sfm3019_dev_air(i2c_air, i2c_global, SFM3019::GasType::air);
+  SFM3019::Device sfm3019_dev_o2(i2c_o2, i2c_global, SFM3019::GasType::o2);
+  SFM3019::Sensor sfm3019_air(sfm3019_dev_air, false, time);
+  SFM3019::Sensor sfm3019_o2(sfm3019_dev_o2, false, time);
+  PF::HAL::MockPWM valve_air;
+  PF::HAL::MockPWM valve_o2;
+  TestFirmware firmware(uart, crc32c, time, sfm3019_air, sfm3019_o2, valve_air, valve_o2);
+
+  GIVEN("A ParametersRequest for HFNC sent by the backend") {
+    const float flow = 30;
+    const float fio2 = 60;
+    ParametersRequest request{};
+    request.mode = VentilationMode_hfnc;
+    request.ventilating = true;
+    request.flow = flow;
+    request.fio2 = fio2;
+    BE::BackendMessage message;
+    message.payload.set(request);
+    BE::BackendSender host_sender{crc32c};
+    BE::FrameProps::ChunkBuffer frame;
+    REQUIRE(host_sender.transform(message, frame) == BE::BackendSender::Status::ok);
+    for (size_t i = 0; i < frame.size(); ++i) {
+      uart.set_read(frame[i]);
+    }
+
+    WHEN("the backend and parameters tasks run") {
+      firmware.receive_backend();
+      firmware.update_parameters();
+
+      THEN("the parameters follow the request") {
+        const Parameters &parameters = firmware.states().parameters();
+        REQUIRE(parameters.mode == VentilationMode_hfnc);
+        REQUIRE(parameters.ventilating);
+        REQUIRE(parameters.flow == flow);
+        REQUIRE(parameters.fio2 == fio2);
+      }
+    }
+
+    WHEN("the parameters and simulator tasks run for a while") {
+      firmware.receive_backend();
+      const uint32_t duration = 1000;
+      for (uint32_t current_time = 0; current_time < duration; ++current_time) {
+        if (current_time % TestFirmware::parameters_period == 0) {
+          firmware.update_parameters();
+        }
+        if (current_time % TestFirmware::simulator_period == 0) {
+          firmware.update_simulator(current_time);
+        }
+      }
+
+      THEN("the simulated measurements are in the state which the backend sends") {
+        const SensorMeasurements &measurements = firmware.states().sensor_measurements();
+        REQUIRE(measurements.time > 0);
+        REQUIRE(measurements.fio2 > 0);
+      }
+    }
+  }
+}
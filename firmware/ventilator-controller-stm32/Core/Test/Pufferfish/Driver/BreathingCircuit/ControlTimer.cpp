@@ -0,0 +1,112 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * ControlTimer.cpp
+ *
+ * Unit tests to confirm behavior of timer-driven control loop execution
+ *
+ */
+
+#include "Pufferfish/Driver/BreathingCircuit/ControlTimer.h"
+
+#include <vector>
+
+#include "Pufferfish/HAL/Mock/MockTime.h"
+#include "catch2/catch.hpp"
+
+namespace PF = Pufferfish;
+using PF::Driver::BreathingCircuit::ControlTimer;
+
+namespace {
+
+// Records the times of its steps
+class MockControlLoop : public PF::Driver::BreathingCircuit::ControlLoop {
+ public:
+  void step(uint32_t current_time) override { step_times.push_back(current_time); }
+
+  std::vector<uint32_t> step_times;
+};
+
+}  // namespace
+
+SCENARIO(
+    "BreathingCircuit::ControlTimer: steps run once per tick at nominal times",
+    "[ControlTimer]") {
+  GIVEN("A control timer started at 1000 ms") {
+    PF::HAL::MockTime time;
+    MockControlLoop control_loop;
+    ControlTimer timer(control_loop, time);
+    time.set_micros(0);
+    timer.start(1000);
+
+    WHEN("the main loop services the timer before it ticks") {
+      bool stepped = timer.service();
+
+      THEN("no step runs") {
+        REQUIRE(!stepped);
+        REQUIRE(control_loop.step_times.empty());
+      }
+    }
+
+    WHEN("the main loop services each tick at a varying delay") {
+      const std::vector<uint32_t> delays{100, 700, 50, 300};
+      for (size_t i = 0; i < delays.size(); ++i) {
+        uint32_t tick_micros = (i + 1) * ControlTimer::period;
+        time.set_micros(tick_micros);
+        timer.tick();
+        time.set_micros(tick_micros + delays[i]);
+        REQUIRE(timer.service());
+        REQUIRE(!timer.service());
+      }
+
+      THEN("each step is given the nominal time of its tick, regardless of its delay") {
+        REQUIRE(control_loop.step_times == std::vector<uint32_t>{1002, 1004, 1006, 1008});
+      }
+
+      THEN("the latency and jitter of the steps are measured") {
+        const auto &stats = timer.stats();
+        REQUIRE(stats.steps == 4);
+        REQUIRE(stats.missed_ticks == 0);
+        REQUIRE(stats.latency == 300);
+        REQUIRE(stats.max_latency == 700);
+        REQUIRE(stats.jitter == 250);
+        REQUIRE(stats.max_jitter == 650);
+      }
+    }
+
+    WHEN("the main loop falls several ticks behind") {
+      time.set_micros(ControlTimer::period);
+      timer.tick();
+      REQUIRE(timer.service());
+      for (uint32_t i = 2; i <= 4; ++i) {
+        time.set_micros(i * ControlTimer::period);
+        timer.tick();
+      }
+      time.set_micros(4 * ControlTimer::period + 10);
+      REQUIRE(timer.service());
+      REQUIRE(!timer.service());
+
+      THEN("the missed ticks are counted and skipped instead of run in a burst") {
+        REQUIRE(control_loop.step_times == std::vector<uint32_t>{1002, 1008});
+        REQUIRE(timer.stats().steps == 2);
+        REQUIRE(timer.stats().missed_ticks == 2);
+      }
+
+      THEN("jitter is measured against the interval between the ticks of the steps") {
+        REQUIRE(timer.stats().jitter == 10);
+      }
+    }
+
+    WHEN("the microsecond clock rolls over between a tick and its step") {
+      time.set_micros(UINT32_MAX - 10);
+      timer.tick();
+      time.set_micros(20);
+      REQUIRE(timer.service());
+
+      THEN("the step runs, but its latency is not measured") {
+        REQUIRE(control_loop.step_times == std::vector<uint32_t>{1002});
+        REQUIRE(timer.stats().max_latency == 0);
+      }
+    }
+  }
+}
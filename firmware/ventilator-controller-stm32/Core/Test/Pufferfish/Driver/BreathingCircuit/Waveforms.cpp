@@ -0,0 +1,71 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * Waveforms.cpp
+ *
+ * Unit tests to confirm behavior of waveform sample collection
+ *
+ */
+
+#include "Pufferfish/Driver/BreathingCircuit/Waveforms.h"
+
+#include "catch2/catch.hpp"
+
+namespace PF = Pufferfish;
+using PF::Driver::BreathingCircuit::SensorWaveformsCollector;
+
+SCENARIO(
+    "BreathingCircuit::SensorWaveformsCollector: samples are output in complete batches",
+    "[Waveforms]") {
+  GIVEN("A waveforms collector") {
+    SensorWaveforms sensor_waveforms{};
+    SensorWaveformsCollector collector(sensor_waveforms);
+    SensorMeasurements sensor_measurements{};
+    const uint32_t start_time = 1000;
+    const uint32_t interval = 2;
+
+    WHEN("one less sample than a batch is input") {
+      for (uint32_t i = 0; i < SensorWaveformsCollector::batch_size - 1; ++i) {
+        collector.input(start_time + i * interval, sensor_measurements);
+      }
+
+      THEN("no batch is output") { REQUIRE(sensor_waveforms.offset_count == 0); }
+    }
+
+    WHEN("two batches of samples are input") {
+      SensorWaveforms first_batch{};
+      for (uint32_t i = 0; i < 2 * SensorWaveformsCollector::batch_size; ++i) {
+        sensor_measurements.paw = static_cast<float>(i);
+        sensor_measurements.flow = static_cast<float>(i) + 1;
+        sensor_measurements.volume = static_cast<float>(i) + 2;
+        collector.input(start_time + i * interval, sensor_measurements);
+        if (i == SensorWaveformsCollector::batch_size - 1) {
+          first_batch = sensor_waveforms;
+        }
+      }
+
+      THEN("the first batch has every sample, timestamped from the start of the batch") {
+        REQUIRE(first_batch.time == start_time);
+        REQUIRE(first_batch.first_sample == 0);
+        REQUIRE(first_batch.offset_count == SensorWaveformsCollector::batch_size);
+        REQUIRE(first_batch.paw_count == SensorWaveformsCollector::batch_size);
+        REQUIRE(first_batch.flow_count == SensorWaveformsCollector::batch_size);
+        REQUIRE(first_batch.volume_count == SensorWaveformsCollector::batch_size);
+        for (uint32_t i = 0; i < SensorWaveformsCollector::batch_size; ++i) {
+          REQUIRE(first_batch.offset[i] == i * interval);
+          REQUIRE(first_batch.paw[i] == static_cast<float>(i));
+          REQUIRE(first_batch.flow[i] == static_cast<float>(i) + 1);
+          REQUIRE(first_batch.volume[i] == static_cast<float>(i) + 2);
+        }
+      }
+
+      THEN("the second batch continues from where the first batch ended") {
+        const uint32_t batch_size = SensorWaveformsCollector::batch_size;
+        REQUIRE(sensor_waveforms.time == start_time + batch_size * interval);
+        REQUIRE(sensor_waveforms.first_sample == batch_size);
+        REQUIRE(sensor_waveforms.offset_count == batch_size);
+        REQUIRE(sensor_waveforms.paw[0] == static_cast<float>(batch_size));
+      }
+    }
+  }
+}
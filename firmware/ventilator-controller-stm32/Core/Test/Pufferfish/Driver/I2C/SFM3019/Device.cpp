@@ -0,0 +1,42 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * Device.cpp
+ *
+ * Unit tests to confirm behavior of the SFM3019 low-level driver
+ *
+ */
+
+#include "Pufferfish/Driver/I2C/SFM3019/Device.h"
+
+#include <array>
+
+#include "Pufferfish/HAL/Mock/MockI2CDevice.h"
+#include "catch2/catch.hpp"
+
+namespace PF = Pufferfish;
+using PF::Driver::I2C::SFM3019::GasType;
+
+SCENARIO("SFM3019::Device: conversion factors are parsed from their words", "[SFM3019]") {
+  GIVEN("An SFM3019 which responds with the conversion factors from its datasheet") {
+    PF::HAL::MockI2CDevice dev;
+    PF::HAL::MockI2CDevice global_dev;
+    PF::Driver::I2C::SFM3019::Device device(dev, global_dev, GasType::air);
+    // Each 16-bit word in network order is followed by its CRC-8
+    const std::array<uint8_t, 9> response{
+        {0x00, 0xaa, 0xa6, 0xa0, 0x00, 0x7e, 0x01, 0x48, 0xf1}};
+    dev.set_read(response.data(), response.size());
+
+    WHEN("the conversion factors are read") {
+      PF::Driver::I2C::SFM3019::ConversionFactors conversion{};
+      auto status = device.read_conversion_factors(conversion);
+
+      THEN("each factor is parsed from its own word") {
+        REQUIRE(status == PF::I2CDeviceStatus::ok);
+        REQUIRE(conversion.scale_factor == 170);
+        REQUIRE(conversion.offset == -24576);
+        REQUIRE(conversion.flow_unit == 0x0148);
+      }
+    }
+  }
+}
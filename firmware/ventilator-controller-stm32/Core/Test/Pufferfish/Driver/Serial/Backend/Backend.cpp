@@ -0,0 +1,746 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * Backend.cpp
+ *
+ * Unit tests to confirm behavior of the backend serial communication protocol
+ *
+ */
+
+#include "Pufferfish/Driver/Serial/Backend/Backend.h"
+
+#include "Pufferfish/Driver/BreathingCircuit/Waveforms.h"
+#include "Pufferfish/HAL/CRCChecker.h"
+#include "Pufferfish/Test/Util.h"
+#include "catch2/catch.hpp"
+
+namespace PF = Pufferfish;
+namespace BE = PF::Driver::Serial::Backend;
+
+SCENARIO(
+    "Serial::BackendSender: The transform method generates the same frame as chaining the "
+    "protocol layers through separate buffers",
+    "[Backend]") {
+  using TestMessageSender = PF::Protocols::MessageSender<BE::BackendMessage>;
+  using TestCRCSender = PF::Protocols::CRCElementSender<BE::FrameProps::payload_max_size>;
+  using TestDatagramSender =
+      PF::Protocols::DatagramSender<TestCRCSender::Props::payload_max_size>;
+
+  PF::HAL::SoftCRC32 crc32c{PF::HAL::crc32c_params};
+  BE::BackendSender sender{crc32c};
+
+  GIVEN("A SensorMeasurements message") {
+    BE::BackendMessage message;
+    SensorMeasurements sensor_measurements{};
+    sensor_measurements.time = 1024;
+    sensor_measurements.cycle = 3;
+    sensor_measurements.paw = 20;
+    sensor_measurements.flow = -12.5;  // NOLINT(readability-magic-numbers)
+    sensor_measurements.fio2 = 80;     // NOLINT(readability-magic-numbers)
+    message.payload.set(sensor_measurements);
+
+    TestMessageSender message_sender;
+    TestDatagramSender datagram_sender;
+    TestCRCSender crc_sender{crc32c};
+    BE::FrameSender frame_sender;
+
+    WHEN("Two consecutive frames are generated by the backend sender and the chained layers") {
+      BE::FrameProps::ChunkBuffer expected;
+      BE::FrameProps::ChunkBuffer output;
+      for (size_t i = 0; i < 2; ++i) {
+        TestDatagramSender::Props::PayloadBuffer message_body;
+        TestCRCSender::Props::PayloadBuffer datagram_body;
+        BE::FrameProps::PayloadBuffer crcelement_body;
+        REQUIRE(
+            message_sender.transform(message, message_body) == PF::Protocols::MessageStatus::ok);
+        REQUIRE(
+            datagram_sender.transform(message_body, datagram_body) ==
+            TestDatagramSender::Status::ok);
+        REQUIRE(crc_sender.transform(datagram_body, crcelement_body) == TestCRCSender::Status::ok);
+        REQUIRE(
+            frame_sender.transform(crcelement_body, expected) == BE::FrameProps::OutputStatus::ok);
+
+        REQUIRE(sender.transform(message, output) == BE::BackendSender::Status::ok);
+      }
+
+      THEN("the frames are identical, including the datagram sequence number") {
+        REQUIRE(output == expected);
+      }
+    }
+
+    WHEN("A frame generated by the backend sender is given to a backend receiver") {
+      BE::FrameProps::ChunkBuffer output;
+      REQUIRE(sender.transform(message, output) == BE::BackendSender::Status::ok);
+
+      BE::BackendReceiver receiver{crc32c};
+      BE::BackendReceiver::InputStatus input_status = BE::BackendReceiver::InputStatus::ok;
+      for (size_t i = 0; i < output.size(); ++i) {
+        input_status = receiver.input(output[i]);
+      }
+      BE::BackendMessage received;
+      auto output_status = receiver.output(received);
+
+      THEN("the receiver reconstructs the original message") {
+        REQUIRE(input_status == BE::BackendReceiver::InputStatus::output_ready);
+        REQUIRE(output_status == BE::BackendReceiver::OutputStatus::available);
+        REQUIRE(received.payload.tag == PF::Application::MessageTypes::sensor_measurements);
+        REQUIRE(received.payload.value.sensor_measurements.time == sensor_measurements.time);
+        REQUIRE(received.payload.value.sensor_measurements.cycle == sensor_measurements.cycle);
+        REQUIRE(received.payload.value.sensor_measurements.flow == sensor_measurements.flow);
+        REQUIRE(received.payload.value.sensor_measurements.fio2 == sensor_measurements.fio2);
+      }
+    }
+  }
+}
+
+SCENARIO(
+    "Serial::Backend: A full batch of waveform samples fits in a single frame", "[Backend]") {
+  PF::HAL::SoftCRC32 crc32c{PF::HAL::crc32c_params};
+  BE::BackendSender sender{crc32c};
+  BE::BackendReceiver receiver{crc32c};
+
+  GIVEN("A SensorWaveforms message with the maximum number of samples") {
+    const pb_size_t max_samples = pb_arraysize(SensorWaveforms, paw);
+    const float step = 0.25F;  // NOLINT(readability-magic-numbers)
+    SensorWaveforms sensor_waveforms{};
+    sensor_waveforms.time = UINT32_MAX;
+    sensor_waveforms.first_sample = UINT32_MAX;
+    sensor_waveforms.offset_count = max_samples;
+    sensor_waveforms.paw_count = max_samples;
+    sensor_waveforms.flow_count = max_samples;
+    sensor_waveforms.volume_count = max_samples;
+    for (pb_size_t i = 0; i < max_samples; ++i) {
+      sensor_waveforms.offset[i] = UINT32_MAX - i;
+      auto value = static_cast<float>(i) + step;
+      sensor_waveforms.paw[i] = value;
+      sensor_waveforms.flow[i] = -value;
+      sensor_waveforms.volume[i] = value * value;
+    }
+    BE::BackendMessage message;
+    message.payload.set(sensor_waveforms);
+
+    WHEN("it is sent by the backend sender and given to a backend receiver") {
+      BE::FrameProps::ChunkBuffer output;
+      auto send_status = sender.transform(message, output);
+      for (size_t i = 0; i < output.size(); ++i) {
+        receiver.input(output[i]);
+      }
+      BE::BackendMessage received;
+      auto output_status = receiver.output(received);
+
+      THEN("the receiver reconstructs every sample of the original message") {
+        REQUIRE(send_status == BE::BackendSender::Status::ok);
+        REQUIRE(output_status == BE::BackendReceiver::OutputStatus::available);
+        REQUIRE(received.payload.tag == PF::Application::MessageTypes::sensor_waveforms);
+        const SensorWaveforms &received_waveforms = received.payload.value.sensor_waveforms;
+        REQUIRE(received_waveforms.time == sensor_waveforms.time);
+        REQUIRE(received_waveforms.first_sample == sensor_waveforms.first_sample);
+        REQUIRE(received_waveforms.offset_count == max_samples);
+        REQUIRE(received_waveforms.paw_count == max_samples);
+        REQUIRE(received_waveforms.flow_count == max_samples);
+        REQUIRE(received_waveforms.volume_count == max_samples);
+        for (pb_size_t i = 0; i < max_samples; ++i) {
+          REQUIRE(received_waveforms.offset[i] == sensor_waveforms.offset[i]);
+          REQUIRE(received_waveforms.paw[i] == sensor_waveforms.paw[i]);
+          REQUIRE(received_waveforms.flow[i] == sensor_waveforms.flow[i]);
+          REQUIRE(received_waveforms.volume[i] == sensor_waveforms.volume[i]);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO(
+    "Serial::Backend: SensorMeasurements are sent with a fixed layout once the receiver requests "
+    "it",
+    "[Backend]") {
+  PF::HAL::SoftCRC32 crc32c{PF::HAL::crc32c_params};
+  PF::Application::States states;
+  BE::Backend backend{crc32c, states};
+  BE::BackendSender sender{crc32c};
+  BE::BackendReceiver receiver{crc32c};
+
+  SensorMeasurements sensor_measurements{};
+  sensor_measurements.time = 1024;
+  sensor_measurements.cycle = 3;
+  sensor_measurements.paw = 20;
+  sensor_measurements.flow = -12.5;  // NOLINT(readability-magic-numbers)
+  sensor_measurements.spo2 = 97;     // NOLINT(readability-magic-numbers)
+  states.sensor_measurements() = sensor_measurements;
+
+  // Outputs state segments from the backend until SensorMeasurements are output
+  auto receive_sensor_measurements = [&](BE::BackendMessage &received) {
+    backend.update_clock(0);
+    BE::FrameProps::ChunkBuffer output;
+    do {
+      output.clear();
+      REQUIRE(backend.output(output) == BE::Backend::Status::ok);
+      for (size_t i = 0; i < output.size(); ++i) {
+        receiver.input(output[i]);
+      }
+      REQUIRE(receiver.output(received) == BE::BackendReceiver::OutputStatus::available);
+    } while (received.payload.tag != PF::Application::MessageTypes::sensor_measurements &&
+             received.payload.tag != PF::Application::MessageTypes::sensor_measurements_binary);
+    return output.size();
+  };
+
+  GIVEN("A backend whose capabilities have not been negotiated") {
+    WHEN("it outputs the sensor measurements") {
+      BE::BackendMessage received;
+      size_t frame_size = receive_sensor_measurements(received);
+
+      THEN("they are encoded as protobuf") {
+        REQUIRE(received.payload.tag == PF::Application::MessageTypes::sensor_measurements);
+        REQUIRE(received.payload.value.sensor_measurements.time == sensor_measurements.time);
+        REQUIRE(frame_size > 0);
+      }
+    }
+  }
+
+  GIVEN("A backend which receives a request for binary sensor measurements") {
+    CapabilitiesRequest capabilities_request{};
+    capabilities_request.features =
+        Capability_binary_sensor_measurements | (1U << 31U);  // NOLINT(readability-magic-numbers)
+    BE::BackendMessage request;
+    request.payload.set(capabilities_request);
+    BE::FrameProps::ChunkBuffer request_frame;
+    REQUIRE(sender.transform(request, request_frame) == BE::BackendSender::Status::ok);
+    auto input_status = BE::Backend::Status::waiting;
+    for (size_t i = 0; i < request_frame.size(); ++i) {
+      input_status = backend.input(request_frame[i]);
+    }
+
+    THEN("only the supported capabilities are enabled") {
+      REQUIRE(input_status == BE::Backend::Status::ok);
+      REQUIRE(states.capabilities().features == Capability_binary_sensor_measurements);
+    }
+
+    WHEN("it outputs the sensor measurements") {
+      BE::BackendMessage received;
+      size_t frame_size = receive_sensor_measurements(received);
+
+      THEN("they are sent with the fixed layout and parsed back with a single copy") {
+        REQUIRE(
+            received.payload.tag == PF::Application::MessageTypes::sensor_measurements_binary);
+        const SensorMeasurements &received_measurements =
+            received.payload.value.sensor_measurements_binary;
+        REQUIRE(received_measurements.time == sensor_measurements.time);
+        REQUIRE(received_measurements.cycle == sensor_measurements.cycle);
+        REQUIRE(received_measurements.paw == sensor_measurements.paw);
+        REQUIRE(received_measurements.flow == sensor_measurements.flow);
+        REQUIRE(received_measurements.spo2 == sensor_measurements.spo2);
+        // Message type, payload, datagram header, CRC, and COBS overhead and delimiter
+        REQUIRE(frame_size <= 1 + 28 + 2 + 4 + 2 + 1);  // NOLINT(readability-magic-numbers)
+      }
+
+      THEN("the received message updates the sensor measurements state") {
+        PF::Application::States received_states;
+        REQUIRE(
+            received_states.input(received.payload) ==
+            PF::Application::States::InputStatus::ok);
+        REQUIRE(received_states.sensor_measurements().flow == sensor_measurements.flow);
+      }
+    }
+  }
+}
+
+SCENARIO(
+    "Protocols::Message: fixed-layout payloads must have exactly the size of the layout",
+    "[Backend]") {
+  GIVEN("The body of a binary SensorMeasurements message") {
+    PF::Application::BinarySensorMeasurements measurements{};
+    measurements.time = 7;
+    BE::BackendMessage message;
+    message.payload.set(measurements);
+    BE::FrameProps::PayloadBuffer body;
+    REQUIRE(message.write(body) == PF::Protocols::MessageStatus::ok);
+    REQUIRE(body.size() == 1 + PF::Util::FixedLayout<decltype(measurements)>::size);
+    REQUIRE(body[1] == 7);
+
+    WHEN("it is truncated") {
+      body.resize(body.size() - 1);
+      BE::BackendMessage parsed;
+
+      THEN("it is rejected") {
+        REQUIRE(parsed.parse(body) == PF::Protocols::MessageStatus::invalid_length);
+      }
+    }
+
+    WHEN("it has trailing bytes") {
+      body.push_back(0);
+      BE::BackendMessage parsed;
+
+      THEN("it is rejected") {
+        REQUIRE(parsed.parse(body) == PF::Protocols::MessageStatus::invalid_length);
+      }
+    }
+  }
+}
+
+SCENARIO(
+    "Serial::Backend: measurements are sent as deltas once the receiver requests it",
+    "[Backend]") {
+  using SensorMeasurementsReceiver = PF::Protocols::DeltaReceiver<SensorMeasurements>;
+
+  PF::HAL::SoftCRC32 crc32c{PF::HAL::crc32c_params};
+  PF::Application::States states;
+  BE::Backend backend{crc32c, states};
+  BE::BackendSender sender{crc32c};
+  BE::BackendReceiver receiver{crc32c};
+  SensorMeasurementsReceiver deltas;
+
+  CapabilitiesRequest capabilities_request{};
+  capabilities_request.features =
+      Capability_delta_measurements | Capability_binary_sensor_measurements;
+  BE::BackendMessage request;
+  request.payload.set(capabilities_request);
+  BE::FrameProps::ChunkBuffer request_frame;
+  REQUIRE(sender.transform(request, request_frame) == BE::BackendSender::Status::ok);
+  for (size_t i = 0; i < request_frame.size(); ++i) {
+    backend.input(request_frame[i]);
+  }
+  REQUIRE(states.capabilities().features == capabilities_request.features);
+
+  // Reconstructs the sensor measurements from each frame which has them, or their delta
+  struct Received {
+    size_t frame_size = 0;
+    bool reconstructed = false;
+    SensorMeasurements measurements{};
+  };
+
+  // Advances the clock by the interval of the sensor measurements at the default baud rate with
+  // new sensor measurements, and receives every frame output by the backend, optionally
+  // dropping the frame with the sensor measurements
+  const uint32_t interval = 50;
+  uint32_t time = 0;
+  auto exchange = [&](bool drop_measurements) {
+    time += interval;
+    states.sensor_measurements().time = time;
+    // NOLINTNEXTLINE(readability-magic-numbers)
+    states.sensor_measurements().paw = static_cast<float>(time) / 100;
+    backend.update_clock(time);
+
+    Received result;
+    BE::FrameProps::ChunkBuffer frame;
+    while (backend.output(frame) == BE::Backend::Status::ok) {
+      // The frame is parsed once to find its type, as if it were lost in transmission
+      BE::BackendReceiver probe{crc32c};
+      BE::BackendMessage probed;
+      for (size_t i = 0; i < frame.size(); ++i) {
+        probe.input(frame[i]);
+      }
+      probe.output(probed);
+      bool is_measurements =
+          probed.payload.tag == PF::Application::MessageTypes::sensor_measurements_binary ||
+          probed.payload.tag == PF::Application::MessageTypes::sensor_measurements_delta;
+      if (is_measurements && drop_measurements) {
+        frame.clear();
+        continue;
+      }
+
+      for (size_t i = 0; i < frame.size(); ++i) {
+        receiver.input(frame[i]);
+      }
+      BE::BackendMessage received;
+      if (receiver.output(received) ==
+          BE::BackendReceiver::OutputStatus::invalid_datagram_sequence) {
+        deltas.reset();
+      }
+      if (received.payload.tag == PF::Application::MessageTypes::sensor_measurements_binary) {
+        result.measurements = received.payload.value.sensor_measurements_binary;
+        deltas.input(result.measurements);
+        result.reconstructed = true;
+      } else if (
+          received.payload.tag == PF::Application::MessageTypes::sensor_measurements_delta) {
+        result.reconstructed =
+            deltas.transform(
+                received.payload.value.sensor_measurements_delta, result.measurements) ==
+            SensorMeasurementsReceiver::Status::ok;
+      }
+      if (is_measurements) {
+        result.frame_size = frame.size();
+      }
+      frame.clear();
+    }
+    return result;
+  };
+
+  GIVEN("A stream of sensor measurements") {
+    WHEN("every frame is received") {
+      size_t keyframe_size = 0;
+      size_t delta_size = 0;
+      for (size_t i = 0; i < BE::sensor_measurements_keyframe_interval + 1; ++i) {
+        Received received = exchange(false);
+        REQUIRE(received.reconstructed);
+        REQUIRE(received.measurements.time == states.sensor_measurements().time);
+        REQUIRE(received.measurements.paw == states.sensor_measurements().paw);
+        if (i == 0 || i == BE::sensor_measurements_keyframe_interval) {
+          keyframe_size = received.frame_size;
+        } else {
+          delta_size = received.frame_size;
+        }
+      }
+
+      THEN("deltas are sent between keyframes, in less than half the bytes per frame") {
+        REQUIRE(keyframe_size > 0);
+        REQUIRE(delta_size > 0);
+        REQUIRE(2 * delta_size < keyframe_size);
+      }
+    }
+
+    WHEN("a frame with a delta is lost") {
+      REQUIRE(exchange(false).reconstructed);
+      REQUIRE(exchange(false).reconstructed);
+      exchange(true);
+
+      THEN("deltas are rejected until the next keyframe") {
+        for (size_t i = 3; i < BE::sensor_measurements_keyframe_interval; ++i) {
+          REQUIRE(!exchange(false).reconstructed);
+        }
+        Received received = exchange(false);
+        REQUIRE(received.reconstructed);
+        REQUIRE(received.measurements.time == states.sensor_measurements().time);
+      }
+    }
+  }
+}
+
+SCENARIO(
+    "Serial::Backend: protocol errors and throughput are counted in the diagnostics state "
+    "segment",
+    "[Backend]") {
+  PF::HAL::SoftCRC32 crc32c{PF::HAL::crc32c_params};
+  PF::Application::States states;
+  BE::Backend backend{crc32c, states};
+  BE::BackendSender sender{crc32c};
+  const Diagnostics &diagnostics = states.diagnostics();
+
+  auto make_frame = [&](const auto &payload) {
+    BE::BackendMessage message;
+    message.payload.set(payload);
+    BE::FrameProps::ChunkBuffer frame;
+    REQUIRE(sender.transform(message, frame) == BE::BackendSender::Status::ok);
+    return frame;
+  };
+  auto input_frame = [&](const BE::FrameProps::ChunkBuffer &frame) {
+    auto status = BE::Backend::Status::waiting;
+    for (size_t i = 0; i < frame.size(); ++i) {
+      status = backend.input(frame[i]);
+    }
+    return status;
+  };
+
+  ParametersRequest parameters_request{};
+  parameters_request.fio2 = 40;  // NOLINT(readability-magic-numbers)
+
+  GIVEN("A valid frame") {
+    auto frame = make_frame(parameters_request);
+    REQUIRE(input_frame(frame) == BE::Backend::Status::ok);
+
+    THEN("its bytes and message are counted, with no errors") {
+      REQUIRE(diagnostics.rx_bytes == frame.size());
+      REQUIRE(diagnostics.rx_messages == 1);
+      REQUIRE(diagnostics.rx_crc_errors == 0);
+      REQUIRE(diagnostics.rx_sequence_gaps == 0);
+      REQUIRE(diagnostics.rx_rejected_messages == 0);
+    }
+  }
+
+  GIVEN("A frame whose CRC does not match its payload") {
+    auto frame = make_frame(parameters_request);
+    frame[frame.size() - 2] ^= 0x01U;
+    REQUIRE(input_frame(frame) == BE::Backend::Status::invalid);
+
+    THEN("it is counted as a CRC error") {
+      REQUIRE(diagnostics.rx_crc_errors == 1);
+      REQUIRE(diagnostics.rx_messages == 0);
+    }
+  }
+
+  GIVEN("A frame which is too long") {
+    const size_t frame_size = 2 * BE::FrameProps::payload_max_size;
+    for (size_t i = 0; i < frame_size - 1; ++i) {
+      backend.input(1);
+    }
+    REQUIRE(backend.input(0) == BE::Backend::Status::invalid);
+
+    THEN("it is counted once as a frame length error") {
+      REQUIRE(diagnostics.rx_bytes == frame_size);
+      REQUIRE(diagnostics.rx_frame_length_errors == 1);
+    }
+  }
+
+  GIVEN("A valid message of a type which the backend does not accept") {
+    REQUIRE(input_frame(make_frame(SensorMeasurements{})) == BE::Backend::Status::invalid);
+
+    THEN("it is counted as a rejected message") {
+      REQUIRE(diagnostics.rx_messages == 1);
+      REQUIRE(diagnostics.rx_rejected_messages == 1);
+    }
+  }
+
+  GIVEN("A frame which is lost before the next one") {
+    REQUIRE(input_frame(make_frame(parameters_request)) == BE::Backend::Status::ok);
+    make_frame(parameters_request);
+    REQUIRE(input_frame(make_frame(parameters_request)) == BE::Backend::Status::ok);
+
+    THEN("the next message is accepted and counted as a sequence gap") {
+      REQUIRE(diagnostics.rx_messages == 2);
+      REQUIRE(diagnostics.rx_sequence_gaps == 1);
+    }
+  }
+
+  GIVEN("A backend which sends its state segments for a second") {
+    const uint32_t window = BE::diagnostics_rate_window;
+    const uint32_t interval = 10;
+    size_t frames = 0;
+    size_t bytes = 0;
+    size_t diagnostics_frames = 0;
+    BE::BackendReceiver receiver{crc32c};
+    for (uint32_t time = 0; time <= window; time += interval) {
+      backend.update_clock(time);
+      BE::FrameProps::ChunkBuffer frame;
+      while (backend.output(frame) == BE::Backend::Status::ok) {
+        ++frames;
+        bytes += frame.size();
+        for (size_t i = 0; i < frame.size(); ++i) {
+          receiver.input(frame[i]);
+        }
+        BE::BackendMessage received;
+        REQUIRE(receiver.output(received) == BE::BackendReceiver::OutputStatus::available);
+        if (received.payload.tag == PF::Application::MessageTypes::diagnostics) {
+          ++diagnostics_frames;
+        }
+        frame.clear();
+      }
+    }
+
+    THEN("the sent frames and their throughput are counted") {
+      REQUIRE(diagnostics.tx_messages == frames);
+      REQUIRE(diagnostics.tx_bytes == bytes);
+      REQUIRE(diagnostics.time == window);
+      REQUIRE(diagnostics.tx_message_rate > 0);
+      REQUIRE(diagnostics.tx_byte_rate > diagnostics.tx_message_rate);
+      REQUIRE(diagnostics.tx_message_errors == 0);
+      REQUIRE(diagnostics.tx_frame_errors == 0);
+    }
+
+    THEN("the diagnostics are sent once per window") {
+      REQUIRE(diagnostics_frames == 2);
+    }
+  }
+}
+
+SCENARIO(
+    "Serial::BaudRateNegotiator: the fastest supported baud rate is chosen, with a fallback",
+    "[Backend]") {
+  BE::BaudRateNegotiator negotiator;
+  const uint32_t fast_baud_rate = 2000000;
+  const uint32_t host_max_baud_rate = 2500000;
+
+  GIVEN("A negotiator which has not announced any baud rate") {
+    THEN("the link runs at the default baud rate") {
+      REQUIRE(negotiator.baud_rate() == BE::default_baud_rate);
+    }
+
+    THEN("the fastest supported baud rate up to the receiver's maximum is chosen") {
+      REQUIRE(negotiator.negotiate(host_max_baud_rate) == fast_baud_rate);
+      REQUIRE(negotiator.negotiate(UINT32_MAX) == BE::supported_baud_rates[0]);
+      REQUIRE(negotiator.negotiate(BE::default_baud_rate) == BE::default_baud_rate);
+    }
+
+    THEN("a receiver which does not support switching stays at the default baud rate") {
+      REQUIRE(negotiator.negotiate(0) == BE::default_baud_rate);
+    }
+  }
+
+  GIVEN("A negotiator which has announced a faster baud rate") {
+    const uint32_t announce_time = 100;
+    negotiator.announce(negotiator.negotiate(host_max_baud_rate), announce_time);
+    REQUIRE(negotiator.baud_rate() == fast_baud_rate);
+
+    WHEN("valid messages keep arriving") {
+      uint32_t time = announce_time;
+      bool fell_back = false;
+      const uint32_t interval = 50;
+      for (size_t i = 0; i < 3 * BE::baud_rate_fallback_timeout / interval; ++i) {
+        time += interval;
+        negotiator.input_valid(time);
+        fell_back = fell_back || negotiator.update_clock(time);
+      }
+
+      THEN("the link stays at the faster baud rate") {
+        REQUIRE(!fell_back);
+        REQUIRE(negotiator.baud_rate() == fast_baud_rate);
+      }
+    }
+
+    WHEN("no valid message arrives before the fallback timeout") {
+      REQUIRE(!negotiator.update_clock(announce_time + BE::baud_rate_fallback_timeout - 1));
+      REQUIRE(negotiator.update_clock(announce_time + BE::baud_rate_fallback_timeout));
+
+      THEN("the link falls back to the default baud rate, and only slower rates are chosen") {
+        REQUIRE(negotiator.baud_rate() == BE::default_baud_rate);
+        REQUIRE(negotiator.negotiate(host_max_baud_rate) < fast_baud_rate);
+        REQUIRE(negotiator.negotiate(host_max_baud_rate) > BE::default_baud_rate);
+      }
+    }
+  }
+}
+
+SCENARIO(
+    "Serial::Backend: edited parameters are sent soon after each change, and otherwise only at "
+    "the keepalive interval",
+    "[Backend]") {
+  PF::HAL::SoftCRC32 crc32c{PF::HAL::crc32c_params};
+  PF::Application::States states;
+  BE::Backend backend{crc32c, states};
+  BE::BackendReceiver receiver{crc32c};
+
+  // Advances the clock to the time, outputs every state segment which is due, and returns
+  // whether the parameters were among them
+  auto parameters_sent_at = [&](uint32_t time) {
+    backend.update_clock(time);
+    bool sent = false;
+    BE::FrameProps::ChunkBuffer frame;
+    while (backend.output(frame) == BE::Backend::Status::ok) {
+      for (size_t i = 0; i < frame.size(); ++i) {
+        receiver.input(frame[i]);
+      }
+      BE::BackendMessage received;
+      REQUIRE(receiver.output(received) == BE::BackendReceiver::OutputStatus::available);
+      sent = sent || received.payload.tag == PF::Application::MessageTypes::parameters;
+      frame.clear();
+    }
+    return sent;
+  };
+
+  GIVEN("A backend which has sent its initial parameters and re-sent them at the keepalive") {
+    const uint32_t change_interval = 20;
+    uint32_t time = 0;
+    REQUIRE(parameters_sent_at(time));
+    for (time = 1; time <= BE::state_sync_keepalive_interval + change_interval; ++time) {
+      parameters_sent_at(time);
+    }
+
+    WHEN("the parameters do not change") {
+      THEN("they are not sent again before the keepalive interval") {
+        for (; time < 2 * BE::state_sync_keepalive_interval; ++time) {
+          REQUIRE(!parameters_sent_at(time));
+        }
+      }
+    }
+
+    WHEN("the parameters are changed twice in quick succession") {
+      states.parameters().fio2 = 60;  // NOLINT(readability-magic-numbers)
+
+      THEN("the first change is sent immediately") { REQUIRE(parameters_sent_at(time)); }
+
+      parameters_sent_at(time);
+      uint32_t first_change_time = time;
+      states.parameters().fio2 = 70;  // NOLINT(readability-magic-numbers)
+
+      THEN("the second change is sent once the interval for changes has elapsed") {
+        for (++time; time < first_change_time + change_interval; ++time) {
+          REQUIRE(!parameters_sent_at(time));
+        }
+        REQUIRE(parameters_sent_at(time));
+      }
+    }
+  }
+}
+
+SCENARIO(
+    "Serial::Backend: sensor measurements are sent less often at the default baud rate, and "
+    "unsent waveform samples are counted",
+    "[Backend]") {
+  PF::HAL::SoftCRC32 crc32c{PF::HAL::crc32c_params};
+  PF::Application::States states;
+  BE::Backend backend{crc32c, states};
+  BE::BackendSender sender{crc32c};
+  BE::BackendReceiver receiver{crc32c};
+
+  // Advances the clock to the time, outputs every state segment which is due, and returns the
+  // number of sensor measurements which were output
+  auto measurements_sent_at = [&](uint32_t time) {
+    states.sensor_measurements().time = time;
+    backend.update_clock(time);
+    size_t sent = 0;
+    BE::FrameProps::ChunkBuffer frame;
+    while (backend.output(frame) == BE::Backend::Status::ok) {
+      for (size_t i = 0; i < frame.size(); ++i) {
+        receiver.input(frame[i]);
+      }
+      BE::BackendMessage received;
+      REQUIRE(receiver.output(received) == BE::BackendReceiver::OutputStatus::available);
+      if (received.payload.tag == PF::Application::MessageTypes::sensor_measurements) {
+        ++sent;
+      }
+      frame.clear();
+    }
+    return sent;
+  };
+  const uint32_t interval = 10;
+  const uint32_t duration = 500;
+
+  GIVEN("A backend at the default baud rate") {
+    REQUIRE(backend.baud_rate() == BE::default_baud_rate);
+
+    WHEN("the sensor measurements change every 10 ms") {
+      size_t sent = 0;
+      for (uint32_t time = interval; time <= duration; time += interval) {
+        sent += measurements_sent_at(time);
+      }
+
+      THEN("they are sent every 50 ms") { REQUIRE(sent == duration / 50); }
+    }
+  }
+
+  GIVEN("A backend which has negotiated a faster baud rate") {
+    CapabilitiesRequest capabilities_request{};
+    capabilities_request.max_baud_rate = BE::supported_baud_rates[0];
+    BE::BackendMessage request;
+    request.payload.set(capabilities_request);
+    BE::FrameProps::ChunkBuffer request_frame;
+    REQUIRE(sender.transform(request, request_frame) == BE::BackendSender::Status::ok);
+    for (size_t i = 0; i < request_frame.size(); ++i) {
+      backend.input(request_frame[i]);
+    }
+    measurements_sent_at(0);
+    REQUIRE(backend.baud_rate() == BE::supported_baud_rates[0]);
+
+    WHEN("the sensor measurements change every 10 ms") {
+      size_t sent = 0;
+      for (uint32_t time = interval; time <= duration; time += interval) {
+        sent += measurements_sent_at(time);
+      }
+
+      THEN("they are sent every 10 ms") { REQUIRE(sent == duration / interval); }
+    }
+  }
+
+  GIVEN("A backend which has sent a batch of waveform samples") {
+    const uint32_t batch_size = PF::Driver::BreathingCircuit::SensorWaveformsCollector::batch_size;
+    SensorWaveforms &sensor_waveforms = states.sensor_waveforms();
+    sensor_waveforms.offset_count = batch_size;
+    measurements_sent_at(0);
+
+    WHEN("the next batch is replaced by a newer batch before it is sent") {
+      sensor_waveforms.first_sample = batch_size;
+      sensor_waveforms.first_sample = 2 * batch_size;
+      measurements_sent_at(2 * interval);
+
+      THEN("the samples of the replaced batch are counted") {
+        REQUIRE(states.diagnostics().tx_dropped_waveform_samples == batch_size);
+      }
+    }
+
+    WHEN("the same batch is re-sent at the keepalive interval") {
+      measurements_sent_at(BE::state_sync_keepalive_interval);
+
+      THEN("no samples are counted") {
+        REQUIRE(states.diagnostics().tx_dropped_waveform_samples == 0);
+      }
+    }
+  }
+}
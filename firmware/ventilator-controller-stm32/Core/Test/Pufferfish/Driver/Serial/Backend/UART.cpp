@@ -0,0 +1,278 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * UART.cpp
+ *
+ * Unit tests to confirm behavior of the backend serial communication over a UART
+ *
+ */
+
+#include "Pufferfish/Driver/Serial/Backend/UART.h"
+
+#include "Pufferfish/HAL/CRCChecker.h"
+#include "Pufferfish/HAL/Mock/MockBufferedUART.h"
+#include "catch2/catch.hpp"
+
+namespace PF = Pufferfish;
+namespace BE = PF::Driver::Serial::Backend;
+
+namespace {
+
+using TestUARTBackend = BE::UARTBackend<PF::HAL::MockLargeBufferedUART>;
+
+// Time which advances by one microsecond whenever it is read
+class TickingTime : public PF::HAL::Time {
+ public:
+  uint32_t millis() override { return micros_ / 1000; }  // NOLINT(readability-magic-numbers)
+  void delay(uint32_t /*ms*/) override {}
+  uint32_t micros() override { return micros_++; }
+  void delay_micros(uint32_t /*microseconds*/) override {}
+
+ private:
+  uint32_t micros_ = 0;
+};
+
+}  // namespace
+
+SCENARIO(
+    "Serial::UARTBackend: budgeted receive consumes every complete frame within its budget",
+    "[UARTBackend]") {
+  PF::HAL::SoftCRC32 crc32c{PF::HAL::crc32c_params};
+  PF::HAL::MockLargeBufferedUART uart;
+  PF::Application::States states;
+  TickingTime time;
+  TestUARTBackend backend(uart, crc32c, states, time);
+
+  GIVEN("A burst of five ParametersRequest frames in the UART read buffer") {
+    const size_t num_frames = 5;
+    BE::BackendSender sender{crc32c};
+    size_t frame_size = 0;
+    for (size_t i = 1; i <= num_frames; ++i) {
+      ParametersRequest parameters_request{};
+      parameters_request.fio2 = static_cast<float>(i);
+      BE::BackendMessage message;
+      message.payload.set(parameters_request);
+      BE::FrameProps::ChunkBuffer frame;
+      REQUIRE(sender.transform(message, frame) == BE::BackendSender::Status::ok);
+      for (size_t j = 0; j < frame.size(); ++j) {
+        uart.set_read(frame[j]);
+      }
+      frame_size = frame.size();
+    }
+
+    WHEN("the frames are received without a budget") {
+      TestUARTBackend::ReceiveCounts counts;
+      auto status = backend.receive(TestUARTBackend::ReceiveBudget{}, counts);
+
+      THEN("every frame is consumed in one call") {
+        REQUIRE(status == TestUARTBackend::ReceiveStatus::empty);
+        REQUIRE(counts.messages == num_frames);
+        REQUIRE(counts.bytes == num_frames * frame_size);
+        REQUIRE(states.parameters_request().fio2 == static_cast<float>(num_frames));
+      }
+    }
+
+    WHEN("the frames are received one message at a time") {
+      backend.receive();
+
+      THEN("only the first frame is consumed") {
+        REQUIRE(states.parameters_request().fio2 == 1);
+      }
+    }
+
+    WHEN("the frames are received with a budget of a little more than two frames") {
+      TestUARTBackend::ReceiveBudget budget;
+      budget.max_bytes = 2 * frame_size + 1;
+      TestUARTBackend::ReceiveCounts counts;
+      auto status = backend.receive(budget, counts);
+
+      THEN("only the bytes within the budget are consumed") {
+        REQUIRE(status == TestUARTBackend::ReceiveStatus::budget_exhausted);
+        REQUIRE(counts.messages == 2);
+        REQUIRE(counts.bytes == budget.max_bytes);
+        REQUIRE(states.parameters_request().fio2 == 2);
+      }
+
+      AND_WHEN("the rest of the frames are received in another call") {
+        status = backend.receive(TestUARTBackend::ReceiveBudget{}, counts);
+
+        THEN("the remaining frames are consumed") {
+          REQUIRE(status == TestUARTBackend::ReceiveStatus::empty);
+          REQUIRE(counts.messages == num_frames - 2);
+          REQUIRE(counts.bytes == num_frames * frame_size - budget.max_bytes);
+          REQUIRE(states.parameters_request().fio2 == static_cast<float>(num_frames));
+        }
+      }
+    }
+
+    WHEN("the frames are received with a time budget shorter than the burst") {
+      TestUARTBackend::ReceiveBudget budget;
+      budget.max_micros = 2;
+      TestUARTBackend::ReceiveCounts counts;
+      auto status = backend.receive(budget, counts);
+
+      THEN("receiving stops at the first time check after the budget is used up") {
+        REQUIRE(status == TestUARTBackend::ReceiveStatus::budget_exhausted);
+        REQUIRE(counts.bytes == 64);
+        REQUIRE(counts.bytes < num_frames * frame_size);
+      }
+    }
+  }
+}
+
+SCENARIO(
+    "Serial::UARTBackend: dropped bytes and stalled sends are counted in the diagnostics",
+    "[UARTBackend]") {
+  PF::HAL::SoftCRC32 crc32c{PF::HAL::crc32c_params};
+  PF::HAL::MockLargeBufferedUART uart;
+  PF::Application::States states;
+  TickingTime time;
+  TestUARTBackend backend(uart, crc32c, states, time);
+
+  GIVEN("More bytes than the UART read buffer can hold") {
+    const size_t extra_bytes = 10;
+    for (size_t i = 0; i < PF::HAL::mock_large_uart_buffer_size + extra_bytes; ++i) {
+      uart.set_read(0);
+    }
+
+    WHEN("the clock is updated") {
+      backend.update_clock(0);
+
+      THEN("the bytes dropped by the UART are counted") {
+        REQUIRE(states.diagnostics().rx_dropped_bytes >= extra_bytes);
+      }
+    }
+  }
+
+  GIVEN("A UART write buffer which is never emptied") {
+    const uint32_t interval = 10;
+    const uint32_t duration = 60000;
+    for (uint32_t current_time = 0; current_time < duration; current_time += interval) {
+      states.sensor_measurements().time = current_time;
+      backend.update_clock(current_time);
+      backend.send();
+    }
+
+    THEN("the frame which doesn't fit in the buffer is counted as one stall") {
+      REQUIRE(states.diagnostics().tx_stalls == 1);
+      REQUIRE(states.diagnostics().tx_bytes > PF::HAL::mock_large_uart_buffer_size);
+    }
+
+    WHEN("the buffer is emptied and then filled up again") {
+      uint8_t byte = 0;
+      for (size_t i = 0; i < PF::HAL::mock_large_uart_buffer_size; ++i) {
+        uart.get_write(byte);
+      }
+      for (uint32_t current_time = duration; current_time < 2 * duration;
+           current_time += interval) {
+        states.sensor_measurements().time = current_time;
+        backend.update_clock(current_time);
+        backend.send();
+      }
+
+      THEN("the next frame which doesn't fit in the buffer is counted as another stall") {
+        REQUIRE(states.diagnostics().tx_stalls == 2);
+      }
+    }
+  }
+}
+
+SCENARIO(
+    "Serial::UARTBackend: the UART switches baud rates once the new baud rate is announced",
+    "[UARTBackend]") {
+  PF::HAL::SoftCRC32 crc32c{PF::HAL::crc32c_params};
+  PF::HAL::MockLargeBufferedUART uart;
+  PF::Application::States states;
+  TickingTime time;
+  TestUARTBackend backend(uart, crc32c, states, time);
+  BE::BackendSender host_sender{crc32c};
+  BE::BackendReceiver host_receiver{crc32c};
+  const uint32_t host_max_baud_rate = 3000000;
+
+  auto host_send = [&](const auto &payload) {
+    BE::BackendMessage message;
+    message.payload.set(payload);
+    BE::FrameProps::ChunkBuffer frame;
+    REQUIRE(host_sender.transform(message, frame) == BE::BackendSender::Status::ok);
+    for (size_t i = 0; i < frame.size(); ++i) {
+      uart.set_read(frame[i]);
+    }
+  };
+  // Sends at most one frame from the backend and returns the baud rate it announces, if any.
+  // Frames are COBS-encoded, so they only contain a zero byte as their delimiter, and an empty
+  // UART write buffer leaves the read byte at zero.
+  auto host_receive = [&]() {
+    backend.send();
+    uint32_t announced_baud_rate = 0;
+    uint8_t byte = 0;
+    do {
+      byte = 0;
+      uart.get_write(byte);
+      if (host_receiver.input(byte) != BE::BackendReceiver::InputStatus::output_ready) {
+        continue;
+      }
+      BE::BackendMessage received;
+      if (host_receiver.output(received) == BE::BackendReceiver::OutputStatus::available &&
+          received.payload.tag == PF::Application::MessageTypes::capabilities) {
+        announced_baud_rate = received.payload.value.capabilities.baud_rate;
+      }
+    } while (byte != 0);
+    return announced_baud_rate;
+  };
+
+  GIVEN("A host which requests a faster baud rate") {
+    CapabilitiesRequest request{};
+    request.max_baud_rate = host_max_baud_rate;
+    host_send(request);
+    backend.receive();
+
+    uint32_t current_time = 0;
+    uint32_t announced_baud_rate = 0;
+    const uint32_t interval = 10;
+    while (announced_baud_rate == 0 && current_time < BE::baud_rate_fallback_timeout) {
+      backend.update_clock(current_time);
+      announced_baud_rate = host_receive();
+      current_time += interval;
+    }
+
+    THEN("the backend announces the fastest baud rate which both sides support") {
+      REQUIRE(announced_baud_rate == host_max_baud_rate);
+      REQUIRE(uart.baud_rate() == 0);
+    }
+
+    WHEN("the backend sends its next output") {
+      host_receive();
+
+      THEN("the UART switches to the announced baud rate") {
+        REQUIRE(uart.baud_rate() == host_max_baud_rate);
+      }
+    }
+
+    WHEN("the host keeps sending valid messages") {
+      for (uint32_t i = 0; i < 2 * BE::baud_rate_fallback_timeout / interval; ++i) {
+        host_send(ParametersRequest{});
+        backend.receive();
+        backend.update_clock(current_time);
+        host_receive();
+        current_time += interval;
+      }
+
+      THEN("the UART stays at the faster baud rate") {
+        REQUIRE(uart.baud_rate() == host_max_baud_rate);
+      }
+    }
+
+    WHEN("the host stops sending valid messages") {
+      for (uint32_t i = 0; i < 2 * BE::baud_rate_fallback_timeout / interval; ++i) {
+        backend.update_clock(current_time);
+        host_receive();
+        current_time += interval;
+      }
+
+      THEN("the UART falls back to the default baud rate") {
+        REQUIRE(uart.baud_rate() == BE::default_baud_rate);
+        REQUIRE(states.capabilities().baud_rate == BE::default_baud_rate);
+      }
+    }
+  }
+}
@@ -231,3 +231,56 @@ SCENARIO("CRC32C should obtain correct checksums on test inputs", "[crc]") {
     }
   }
 }
+
+SCENARIO("CRC32C incremental computation should match whole-buffer computation", "[crc]") {
+  GIVEN("The software CRC32C implementation") {
+    PF::HAL::SoftCRC32 checker(PF::HAL::crc32c_params);
+    auto input = PF::Util::make_array<uint8_t>(
+        static_cast<uint8_t>('1'),
+        static_cast<uint8_t>('2'),
+        static_cast<uint8_t>('3'),
+        static_cast<uint8_t>('4'),
+        static_cast<uint8_t>('5'),
+        static_cast<uint8_t>('6'),
+        static_cast<uint8_t>('7'),
+        static_cast<uint8_t>('8'),
+        static_cast<uint8_t>('9'));
+
+    WHEN("no data is folded in") {
+      THEN("the checksum is the checksum of an empty sequence") {
+        REQUIRE(checker.finalize(checker.init()) == 0x00);
+      }
+    }
+
+    WHEN("the standard test sequence is folded in one byte at a time") {
+      uint32_t running = checker.init();
+      for (const auto &byte : input) {
+        running = checker.update(running, &byte, 1);
+      }
+
+      THEN("the checksum is correct") { REQUIRE(checker.finalize(running) == 0xe3069283); }
+    }
+
+    WHEN("the standard test sequence is folded in as two uneven pieces") {
+      const size_t split = 4;
+      uint32_t running = checker.init();
+      running = checker.update(running, input.data(), split);
+      running = checker.update(running, input.data() + split, input.size() - split);
+
+      THEN("the checksum matches the result of compute") {
+        REQUIRE(checker.finalize(running) == checker.compute(input.data(), input.size()));
+      }
+    }
+
+    WHEN("a whole-buffer computation happens in the middle of an incremental computation") {
+      uint32_t running = checker.init();
+      running = checker.update(running, input.data(), 3);
+      checker.compute(input.data(), 1);
+      running = checker.update(running, input.data() + 3, input.size() - 3);
+
+      THEN("the incremental computation is unaffected") {
+        REQUIRE(checker.finalize(running) == 0xe3069283);
+      }
+    }
+  }
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * CRCEngine.cpp
+ *
+ * Unit tests to compare compile-time CRC engines against SoftCRC
+ *
+ */
+
+#include "Pufferfish/HAL/CRCEngine.h"
+
+#include <array>
+#include <random>
+
+#include "Pufferfish/HAL/CRCChecker.h"
+#include "catch2/catch.hpp"
+
+namespace PF = Pufferfish;
+
+namespace {
+
+constexpr PF::HAL::CRC8Parameters sensirion_crc8_params = {0x31, 0xff, false, false, 0x00};
+constexpr PF::HAL::CRC8Parameters sfm3000_crc8_params = {0x31, 0x00, false, false, 0x00};
+
+using CRC32CBytewise = PF::HAL::CRCEngine<uint32_t, PF::HAL::crc32c_params, 1>;
+using CRC32CSliced4 = PF::HAL::CRCEngine<uint32_t, PF::HAL::crc32c_params, 4>;
+using CRC32CSliced8 = PF::HAL::CRCEngine<uint32_t, PF::HAL::crc32c_params, 8>;
+using SensirionCRC8 = PF::HAL::CRCEngine<uint8_t, sensirion_crc8_params>;
+using SFM3000CRC8 = PF::HAL::CRCEngine<uint8_t, sfm3000_crc8_params>;
+
+constexpr std::array<uint8_t, 9> check_input = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+// Example from the Sensirion datasheets
+constexpr std::array<uint8_t, 2> sensirion_input = {0xbe, 0xef};
+
+// The CRC is computed entirely at compile time
+static_assert(CRC32CBytewise::compute(check_input.data(), check_input.size()) == 0xe3069283);
+static_assert(CRC32CSliced8::compute(check_input.data(), check_input.size()) == 0xe3069283);
+static_assert(SensirionCRC8::compute(sensirion_input.data(), sensirion_input.size()) == 0x92);
+
+template <size_t size>
+std::array<uint8_t, size> make_random_bytes() {
+  std::array<uint8_t, size> result{};
+  std::mt19937 generator(size);
+  std::uniform_int_distribution<unsigned int> distribution(0, UINT8_MAX);
+  for (auto &byte : result) {
+    byte = static_cast<uint8_t>(distribution(generator));
+  }
+  return result;
+}
+
+}  // namespace
+
+SCENARIO("CRCEngine should obtain the same checksums as SoftCRC", "[crc]") {
+  auto input = make_random_bytes<251>();
+
+  GIVEN("CRC32C engines with 1, 4, and 8 slices, and the software CRC32C implementation") {
+    PF::HAL::SoftCRC32 soft_crc(PF::HAL::crc32c_params);
+
+    WHEN("inputs of every length up to 251 bytes are computed") {
+      THEN("all engines agree with SoftCRC") {
+        for (size_t size = 0; size <= input.size(); ++size) {
+          uint32_t expected = soft_crc.compute(input.data(), size);
+          REQUIRE(CRC32CBytewise::compute(input.data(), size) == expected);
+          REQUIRE(CRC32CSliced4::compute(input.data(), size) == expected);
+          REQUIRE(CRC32CSliced8::compute(input.data(), size) == expected);
+        }
+      }
+    }
+
+    WHEN("an input is folded in incrementally, through the CRCChecker interface") {
+      PF::HAL::EngineCRC32C engine_crc;
+      PF::HAL::CRC32 &checker = engine_crc;
+      uint32_t running = checker.init();
+      running = checker.update(running, input.data(), 7);
+      running = checker.update(running, input.data() + 7, input.size() - 7);
+
+      THEN("the checksum agrees with SoftCRC") {
+        REQUIRE(checker.finalize(running) == soft_crc.compute(input.data(), input.size()));
+      }
+    }
+  }
+
+  GIVEN("Sensirion CRC8 engines, and the software CRC8 implementation with the same parameters") {
+    PF::HAL::SoftCRC8 soft_sensirion(sensirion_crc8_params);
+    PF::HAL::SoftCRC8 soft_sfm3000(sfm3000_crc8_params);
+
+    WHEN("every two-byte word of the input is computed, as in SensirionDevice::read") {
+      THEN("the engines agree with SoftCRC") {
+        for (size_t start = 0; start + 2 <= input.size(); ++start) {
+          REQUIRE(
+              SensirionCRC8::compute(input.data() + start, 2) ==
+              soft_sensirion.compute(input.data() + start, 2));
+          REQUIRE(
+              SFM3000CRC8::compute(input.data() + start, 2) ==
+              soft_sfm3000.compute(input.data() + start, 2));
+        }
+      }
+    }
+  }
+}
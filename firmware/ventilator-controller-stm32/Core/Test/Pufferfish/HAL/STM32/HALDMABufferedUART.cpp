@@ -0,0 +1,288 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * HALDMABufferedUART.cpp
+ *
+ * Unit tests to confirm behavior of the DMA-backed UART, against an emulated DMA controller
+ *
+ */
+
+#include "Pufferfish/HAL/STM32/HALDMABufferedUART.h"
+
+#include <vector>
+
+#include "Pufferfish/HAL/Mock/MockTime.h"
+#include "catch2/catch.hpp"
+
+namespace PF = Pufferfish;
+
+// Every instantiation which the firmware can use must compile
+template class PF::HAL::HALDMABufferedUART<
+    PF::HAL::large_dma_uart_buffer_size,
+    PF::HAL::large_dma_uart_buffer_size>;
+template class PF::HAL::HALDMABufferedUART<PF::HAL::read_only_dma_uart_buffer_size, 2>;
+
+namespace {
+
+const PF::HAL::AtomicSize test_buffer_size = 16;
+using TestDMABufferedUART = PF::HAL::HALDMABufferedUART<test_buffer_size, test_buffer_size>;
+
+// Emulates the circular RX DMA transfer and the interrupts which it and the UART raise
+class EmulatedRX {
+ public:
+  EmulatedRX(UART_HandleTypeDef &huart, TestDMABufferedUART &uart) : huart_(huart), uart_(uart) {}
+
+  void receive(uint8_t byte) {
+    huart_.rx_buffer[position_] = byte;
+    position_ = (position_ + 1) % huart_.rx_size;
+    huart_.hdmarx->counter = huart_.rx_size - position_;
+    if (position_ == huart_.rx_size / 2 || position_ == 0) {
+      uart_.handle_rx_dma_event();
+    }
+  }
+
+  void idle() {
+    huart_.Instance->ISR |= UART_FLAG_IDLE;
+    uart_.handle_irq();
+  }
+
+ private:
+  UART_HandleTypeDef &huart_;
+  TestDMABufferedUART &uart_;
+  size_t position_ = 0;
+};
+
+std::vector<uint8_t> read_all(TestDMABufferedUART &uart) {
+  std::vector<uint8_t> result;
+  uint8_t byte = 0;
+  while (uart.read(byte) == PF::BufferStatus::ok) {
+    result.push_back(byte);
+  }
+  return result;
+}
+
+std::vector<uint8_t> transmitted(const UART_HandleTypeDef &huart) {
+  return std::vector<uint8_t>(huart.tx_buffer, huart.tx_buffer + huart.tx_size);
+}
+
+}  // namespace
+
+SCENARIO(
+    "HAL::HALDMABufferedUART: the UART only starts if its DMA transfers can be started",
+    "[HALDMABufferedUART]") {
+  USART_TypeDef usart{};
+  DMA_HandleTypeDef hdmatx{};
+  DMA_HandleTypeDef hdmarx{};
+  UART_HandleTypeDef huart{};
+  huart.Instance = &usart;
+  huart.hdmatx = &hdmatx;
+  huart.hdmarx = &hdmarx;
+  PF::HAL::MockTime time;
+  TestDMABufferedUART uart(huart, time);
+  const std::vector<uint8_t> bytes{1, 2, 3};
+  PF::HAL::AtomicSize written = 0;
+
+  GIVEN("A UART handle without an RX DMA stream") {
+    huart.hdmarx = nullptr;
+
+    WHEN("the UART is set up and its line goes idle") {
+      auto status = uart.setup_irq();
+      usart.ISR |= UART_FLAG_IDLE;
+      uart.handle_irq();
+      uart.handle_rx_dma_event();
+
+      THEN("setup fails without starting the UART, and nothing is received") {
+        REQUIRE(status == PF::UARTStatus::error);
+        REQUIRE((usart.CR1 & UART_IT_IDLE) == 0);
+        REQUIRE(huart.rx_buffer == nullptr);
+        REQUIRE(read_all(uart).empty());
+      }
+    }
+  }
+
+  GIVEN("A UART handle without a TX DMA stream") {
+    huart.hdmatx = nullptr;
+
+    WHEN("the UART is set up and bytes are written") {
+      auto status = uart.setup_irq();
+      uart.write(bytes.data(), bytes.size(), written);
+
+      THEN("setup fails without starting the UART, and nothing is transmitted") {
+        REQUIRE(status == PF::UARTStatus::error);
+        REQUIRE((usart.CR1 & UART_IT_IDLE) == 0);
+        REQUIRE(huart.tx_transfers == 0);
+      }
+    }
+  }
+
+  GIVEN("A UART whose RX DMA transfer can't be started") {
+    huart.rx_status = HAL_ERROR;
+
+    WHEN("the UART is set up") {
+      auto status = uart.setup_irq();
+
+      THEN("setup fails without enabling the idle-line interrupt") {
+        REQUIRE(status == PF::UARTStatus::error);
+        REQUIRE((usart.CR1 & UART_IT_IDLE) == 0);
+      }
+    }
+  }
+
+  GIVEN("A UART handle with both DMA streams") {
+    WHEN("bytes are written before the UART is set up") {
+      REQUIRE(uart.write(bytes.data(), bytes.size(), written) == PF::BufferStatus::ok);
+      REQUIRE(huart.tx_transfers == 0);
+      auto status = uart.setup_irq();
+
+      THEN("setup succeeds and transmits them") {
+        REQUIRE(status == PF::UARTStatus::ok);
+        REQUIRE((usart.CR1 & UART_IT_IDLE) != 0);
+        REQUIRE(huart.tx_transfers == 1);
+        REQUIRE(transmitted(huart) == bytes);
+      }
+    }
+  }
+}
+
+SCENARIO("HAL::HALDMABufferedUART: received bytes are read in order", "[HALDMABufferedUART]") {
+  USART_TypeDef usart{};
+  DMA_HandleTypeDef hdmatx{};
+  DMA_HandleTypeDef hdmarx{};
+  UART_HandleTypeDef huart{};
+  huart.Instance = &usart;
+  huart.hdmatx = &hdmatx;
+  huart.hdmarx = &hdmarx;
+  PF::HAL::MockTime time;
+  TestDMABufferedUART uart(huart, time);
+  REQUIRE(uart.setup_irq() == PF::UARTStatus::ok);
+  EmulatedRX rx(huart, uart);
+
+  GIVEN("A UART whose RX DMA transfer has been started") {
+    THEN("overruns are disabled and the circular transfer covers the whole buffer") {
+      REQUIRE((usart.CR3 & USART_CR3_OVRDIS) != 0);
+      REQUIRE(huart.rx_size == test_buffer_size);
+    }
+
+    WHEN("a burst of bytes is received and the line goes idle") {
+      std::vector<uint8_t> burst{1, 2, 3, 4, 5};
+      for (uint8_t byte : burst) {
+        rx.receive(byte);
+      }
+      REQUIRE(read_all(uart).empty());
+      rx.idle();
+
+      THEN("the bytes are read in order") {
+        REQUIRE(read_all(uart) == burst);
+        REQUIRE(uart.rx_dropped() == 0);
+      }
+    }
+
+    WHEN("more bytes are received than the buffer holds before they are read") {
+      const uint8_t extra_bytes = 4;
+      std::vector<uint8_t> expected;
+      for (uint8_t i = 0; i < test_buffer_size + extra_bytes; ++i) {
+        rx.receive(i);
+        if (i >= extra_bytes) {
+          expected.push_back(i);
+        }
+      }
+      rx.idle();
+
+      THEN("the overwritten bytes are counted, and the rest are read in order") {
+        REQUIRE(read_all(uart) == expected);
+        REQUIRE(uart.rx_dropped() == extra_bytes);
+      }
+    }
+
+    WHEN("exactly as many bytes are received as the buffer holds before they are read") {
+      std::vector<uint8_t> expected;
+      for (uint8_t i = 0; i < test_buffer_size; ++i) {
+        rx.receive(i);
+        expected.push_back(i);
+      }
+      rx.idle();
+
+      THEN("no bytes are dropped") {
+        REQUIRE(read_all(uart) == expected);
+        REQUIRE(uart.rx_dropped() == 0);
+      }
+
+      AND_WHEN("one more byte is received before the next DMA event or idle line") {
+        const uint8_t newest = test_buffer_size;
+        rx.receive(newest);
+        expected.erase(expected.begin());
+        expected.push_back(newest);
+
+        THEN("the overwritten oldest byte is counted, and the rest are read in order") {
+          REQUIRE(read_all(uart) == expected);
+          REQUIRE(uart.rx_dropped() == 1);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO(
+    "HAL::HALDMABufferedUART: written bytes are transmitted from ping-pong buffers",
+    "[HALDMABufferedUART]") {
+  USART_TypeDef usart{};
+  DMA_HandleTypeDef hdmatx{};
+  DMA_HandleTypeDef hdmarx{};
+  UART_HandleTypeDef huart{};
+  huart.Instance = &usart;
+  huart.hdmatx = &hdmatx;
+  huart.hdmarx = &hdmarx;
+  PF::HAL::MockTime time;
+  TestDMABufferedUART uart(huart, time);
+  REQUIRE(uart.setup_irq() == PF::UARTStatus::ok);
+  const std::vector<uint8_t> first{1, 2, 3};
+  const std::vector<uint8_t> second{4, 5, 6, 7, 8, 9, 10, 11, 12, 13};
+  PF::HAL::AtomicSize written = 0;
+
+  GIVEN("A UART which is not transmitting") {
+    WHEN("bytes are written") {
+      REQUIRE(uart.write(first.data(), first.size(), written) == PF::BufferStatus::ok);
+
+      THEN("they are transmitted immediately") {
+        REQUIRE(huart.tx_transfers == 1);
+        REQUIRE(transmitted(huart) == first);
+      }
+    }
+
+    WHEN("more bytes are written while the first bytes are transmitted") {
+      uart.write(first.data(), first.size(), written);
+      auto status = uart.write(second.data(), second.size(), written);
+
+      THEN("only the bytes which fit in the other buffer are accepted") {
+        REQUIRE(status == PF::BufferStatus::partial);
+        REQUIRE(written == TestDMABufferedUART::tx_half_size);
+        REQUIRE(huart.tx_transfers == 1);
+      }
+
+      uart.handle_tx_dma_complete();
+
+      THEN("the accepted bytes are transmitted once the first transfer completes") {
+        REQUIRE(huart.tx_transfers == 2);
+        REQUIRE(
+            transmitted(huart) ==
+            std::vector<uint8_t>(second.begin(), second.begin() + written));
+      }
+    }
+  }
+
+  GIVEN("A UART whose DMA transfers can't be started") {
+    huart.tx_status = HAL_BUSY;
+
+    WHEN("bytes are written, and then more bytes are written once transfers can start") {
+      REQUIRE(uart.write(first.data(), first.size(), written) == PF::BufferStatus::ok);
+      REQUIRE(huart.tx_transfers == 0);
+      huart.tx_status = HAL_OK;
+      REQUIRE(uart.write(second.data(), 2, written) == PF::BufferStatus::ok);
+
+      THEN("none of the bytes are lost") {
+        REQUIRE(huart.tx_transfers == 1);
+        REQUIRE(transmitted(huart) == std::vector<uint8_t>{1, 2, 3, 4, 5});
+      }
+    }
+  }
+}
@@ -0,0 +1,153 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * StepResponse.cpp
+ *
+ * Unit tests to confirm behavior of the step response metrics of the control harness
+ *
+ */
+
+#include "Pufferfish/Host/StepResponse.h"
+
+#include <cmath>
+
+#include "catch2/catch.hpp"
+
+namespace PF = Pufferfish;
+
+SCENARIO("Host::StepResponse: metrics of a first-order response", "[StepResponse]") {
+  GIVEN("A step from 0 to 10 at 1000 ms, with a settling band of 0.5") {
+    const float setpoint = 10;
+    const float settling_band = 0.5;
+    const uint32_t start_time = 1000;
+    const uint32_t steady_state_start = 1500;
+    PF::Host::StepResponse response(0, setpoint, settling_band, start_time, steady_state_start);
+
+    WHEN("the response approaches the setpoint with a time constant of 100 ms") {
+      const float time_constant = 100;
+      for (uint32_t time = start_time; time <= start_time + 1000; ++time) {
+        float elapsed = static_cast<float>(time - start_time);
+        response.input(time, setpoint * (1 - std::exp(-elapsed / time_constant)));
+      }
+      PF::Host::StepMetrics metrics = response.metrics();
+
+      THEN("it settles after three time constants, measured from the step") {
+        REQUIRE(metrics.settled);
+        REQUIRE(metrics.settling_time == 300);
+      }
+
+      THEN("it has no overshoot") { REQUIRE(metrics.overshoot == 0); }
+
+      THEN("its steady-state error is small and positive") {
+        REQUIRE(metrics.steady_state_error > 0);
+        REQUIRE(metrics.steady_state_error < setpoint * std::exp(-5.0F));
+      }
+    }
+
+    WHEN("the response settles at 9.75 instead of the setpoint") {
+      const float final_value = 9.75;
+      for (uint32_t time = start_time; time <= start_time + 1000; ++time) {
+        response.input(time, time < start_time + 200 ? 0 : final_value);
+      }
+      PF::Host::StepMetrics metrics = response.metrics();
+
+      THEN("it settles when it reaches the final value") {
+        REQUIRE(metrics.settled);
+        REQUIRE(metrics.settling_time == 200);
+      }
+
+      THEN("the steady-state error is the offset from the setpoint") {
+        REQUIRE(metrics.steady_state_error == Approx(setpoint - final_value));
+      }
+    }
+  }
+}
+
+SCENARIO("Host::StepResponse: overshoot of an underdamped response", "[StepResponse]") {
+  const float settling_band = 0.5;
+
+  GIVEN("A step from 0 to 10, with a response which rises to 12 and then falls back to 10") {
+    PF::Host::StepResponse response(0, 10, settling_band, 0, 400);
+    for (uint32_t time = 0; time < 100; ++time) {
+      response.input(time, static_cast<float>(time) * 12 / 100);  // rises through the band
+    }
+    for (uint32_t time = 100; time < 200; ++time) {
+      response.input(time, 12 - static_cast<float>(time - 100) * 2 / 100);
+    }
+    for (uint32_t time = 200; time <= 500; ++time) {
+      response.input(time, 10);
+    }
+    PF::Host::StepMetrics metrics = response.metrics();
+
+    THEN("the overshoot is 20% of the step") { REQUIRE(metrics.overshoot == Approx(20)); }
+
+    THEN("the settling time is when the response last entered the band, at 10.5") {
+      REQUIRE(metrics.settled);
+      REQUIRE(metrics.settling_time == 175);
+    }
+
+    THEN("there is no steady-state error") { REQUIRE(metrics.steady_state_error == 0); }
+  }
+
+  GIVEN("A step from 10 down to 0, with a response which falls to -1 before settling") {
+    PF::Host::StepResponse response(10, 0, settling_band, 0, 400);
+    response.input(0, 10);
+    response.input(100, -1);
+    response.input(200, 0);
+    PF::Host::StepMetrics metrics = response.metrics();
+
+    THEN("the overshoot is measured in the direction of the step") {
+      REQUIRE(metrics.overshoot == Approx(10));
+    }
+  }
+
+  GIVEN("A step with a size of zero") {
+    PF::Host::StepResponse response(10, 10, settling_band, 0, 400);
+    response.input(0, 10);
+    response.input(100, 12);
+    response.input(200, 10);
+
+    THEN("no overshoot is reported") { REQUIRE(response.metrics().overshoot == 0); }
+  }
+}
+
+SCENARIO("Host::StepResponse: responses which never settle", "[StepResponse]") {
+  const float setpoint = 10;
+  const float settling_band = 0.5;
+  const uint32_t half_period = 50;
+
+  GIVEN("A response which oscillates between 8 and 12 around the setpoint") {
+    PF::Host::StepResponse response(0, setpoint, settling_band, 0, 500);
+    for (uint32_t time = 0; time < 1000; ++time) {
+      response.input(time, (time / half_period) % 2 == 0 ? 8 : 12);
+    }
+    PF::Host::StepMetrics metrics = response.metrics();
+
+    THEN("it is not settled, and has no settling time") {
+      REQUIRE_FALSE(metrics.settled);
+      REQUIRE(metrics.settling_time == 0);
+    }
+
+    THEN("the overshoot is the amplitude of the oscillation") {
+      REQUIRE(metrics.overshoot == Approx(20));
+    }
+
+    THEN("the steady-state errors average out") {
+      REQUIRE(metrics.steady_state_error == Approx(0).margin(1e-6));
+    }
+  }
+
+  GIVEN("A response which enters the band but leaves it again by the end of the step") {
+    PF::Host::StepResponse response(0, setpoint, settling_band, 0, 500);
+    response.input(0, 0);
+    response.input(100, setpoint);
+    response.input(200, setpoint);
+    response.input(300, setpoint + 2 * settling_band);
+    PF::Host::StepMetrics metrics = response.metrics();
+
+    THEN("it is not settled, and has no settling time") {
+      REQUIRE_FALSE(metrics.settled);
+      REQUIRE(metrics.settling_time == 0);
+    }
+  }
+}
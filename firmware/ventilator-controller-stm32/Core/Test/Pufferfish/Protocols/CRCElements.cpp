@@ -1076,3 +1076,126 @@ SCENARIO(
     }
   }
 }
+
+SCENARIO(
+    "Protocols::CRCElementReceiver: correctly parses CRCElement bodies into a borrowed payload "
+    "view",
+    "[CRCElementReceiver]") {
+  GIVEN(
+      "A CRC element receiver of capacity 254 bytes and an output_crcelement constructed with an "
+      "empty payload view") {
+    constexpr size_t buffer_size = 254UL;
+    using TestCRCElementReceiver = PF::Protocols::CRCElementReceiver<buffer_size>;
+
+    PF::HAL::SoftCRC32 crc32c{PF::HAL::crc32c_params};
+    TestCRCElementReceiver crc_element_receiver{crc32c};
+
+    PF::Util::ByteView payload_view;
+    PF::Protocols::BorrowedCRCElement crc_element{payload_view};
+
+    WHEN("A valid body with payload '123456789' is given to the crc element receiver") {
+      auto body = std::string("\xe3\x06\x92\x83\x31\x32\x33\x34\x35\x36\x37\x38\x39", 13);
+      PF::Util::ByteVector<buffer_size> input_buffer;
+      for (auto& ch : body) {
+        input_buffer.push_back(ch);
+      }
+
+      auto transform_status = crc_element_receiver.transform(input_buffer, crc_element);
+
+      THEN("the transform status is ok") {
+        REQUIRE(transform_status == TestCRCElementReceiver::Status::ok);
+      }
+      THEN("the output_crcelement's crc accessor method returns the CRC from the header") {
+        REQUIRE(crc_element.crc() == 0xE3069283);
+      }
+      THEN("the payload view refers to the payload bytes inside input_buffer without a copy") {
+        REQUIRE(payload_view.buffer() == input_buffer.buffer() + 4);
+        REQUIRE(payload_view.size() == 9);
+        REQUIRE(payload_view[0] == '1');
+        REQUIRE(payload_view[8] == '9');
+      }
+    }
+
+    WHEN("A body with an incorrect CRC is given to the crc element receiver") {
+      auto body = std::string("\x00\x00\x00\x00\x31\x32\x33", 7);
+      PF::Util::ByteVector<buffer_size> input_buffer;
+      for (auto& ch : body) {
+        input_buffer.push_back(ch);
+      }
+
+      auto transform_status = crc_element_receiver.transform(input_buffer, crc_element);
+
+      THEN("the transform status is equal to invalid crc") {
+        REQUIRE(transform_status == TestCRCElementReceiver::Status::invalid_crc);
+      }
+    }
+
+    WHEN("A body with less than 4 bytes is given to the crc element receiver") {
+      PF::Util::ByteVector<buffer_size> input_buffer;
+      input_buffer.push_back(0x00);
+
+      auto transform_status = crc_element_receiver.transform(input_buffer, crc_element);
+
+      THEN("the transform status is equal to invalid parse") {
+        REQUIRE(transform_status == TestCRCElementReceiver::Status::invalid_parse);
+      }
+      THEN("the payload view remains empty") { REQUIRE(payload_view.empty() == true); }
+    }
+  }
+}
+
+SCENARIO(
+    "Protocols::CRCElementAccumulator: computes the payload CRC of a body as its bytes arrive",
+    "[CRCElementAccumulator]") {
+  GIVEN("A CRC element accumulator") {
+    constexpr size_t buffer_size = 254UL;
+    PF::HAL::SoftCRC32 crc32c{PF::HAL::crc32c_params};
+    PF::Protocols::CRCElementAccumulator accumulator{crc32c};
+
+    auto body = std::string("\xe3\x06\x92\x83\x31\x32\x33\x34\x35\x36\x37\x38\x39", 13);
+
+    WHEN("the body is appended one byte at a time, with an update after each byte") {
+      PF::Util::ByteVector<buffer_size> input_buffer;
+      for (auto& ch : body) {
+        input_buffer.push_back(ch);
+        accumulator.update(input_buffer);
+      }
+
+      THEN("the CRC matches the CRC in the header and the result of compute_body_crc") {
+        REQUIRE(accumulator.crc() == 0xE3069283);
+        REQUIRE(
+            accumulator.crc() ==
+            PF::Protocols::BorrowedCRCElement::compute_body_crc(input_buffer, crc32c));
+      }
+
+      THEN("the crc element receiver accepts the body with the accumulated CRC") {
+        using TestCRCElementReceiver = PF::Protocols::CRCElementReceiver<buffer_size>;
+        TestCRCElementReceiver crc_element_receiver{crc32c};
+        PF::Util::ByteView payload_view;
+        PF::Protocols::BorrowedCRCElement crc_element{payload_view};
+
+        auto status = crc_element_receiver.transform(input_buffer, accumulator.crc(), crc_element);
+        REQUIRE(status == TestCRCElementReceiver::Status::ok);
+        REQUIRE(payload_view.size() == 9);
+      }
+    }
+
+    WHEN("the accumulator is reset after a partial body, and a new body is appended") {
+      PF::Util::ByteVector<buffer_size> input_buffer;
+      for (auto& ch : std::string("\x01\x02\x03\x04\x05\x06", 6)) {
+        input_buffer.push_back(ch);
+        accumulator.update(input_buffer);
+      }
+      accumulator.reset();
+      input_buffer.clear();
+      for (auto& ch : body) {
+        input_buffer.push_back(ch);
+        accumulator.update(input_buffer);
+      }
+
+      THEN("the CRC only covers the payload of the new body") {
+        REQUIRE(accumulator.crc() == 0xE3069283);
+      }
+    }
+  }
+}
@@ -0,0 +1,241 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * Deltas.cpp
+ *
+ * Unit tests to confirm behavior of delta-coded message streams
+ *
+ */
+
+#include "Pufferfish/Protocols/Deltas.h"
+
+#include <array>
+#include <cmath>
+
+#include "Pufferfish/Application/States.h"
+#include "Pufferfish/Util/Array.h"
+#include "Pufferfish/Util/Protobuf.h"
+#include "catch2/catch.hpp"
+
+namespace PF = Pufferfish;
+
+namespace {
+
+using Buffer = std::array<uint8_t, 64>;
+using SensorMeasurementsDelta = PF::Util::Delta<SensorMeasurements>;
+
+const size_t test_keyframe_interval = 4;
+using TestSender = PF::Protocols::DeltaSender<SensorMeasurements, test_keyframe_interval>;
+using TestReceiver = PF::Protocols::DeltaReceiver<SensorMeasurements>;
+
+// Sensor measurements at 100 Hz from a breath cycle of 3 s, with steady FiO2 and SpO2
+SensorMeasurements make_measurements(uint32_t sample) {
+  static const float pi = 3.14159265F;
+  static const uint32_t interval = 10;  // ms
+  static const uint32_t period = 300;   // samples
+  float phase = 2 * pi * static_cast<float>(sample % period) / period;
+  SensorMeasurements measurements{};
+  measurements.time = sample * interval;
+  measurements.cycle = sample / period;
+  measurements.paw = 12 + 8 * std::sin(phase);        // NOLINT(readability-magic-numbers)
+  measurements.flow = 30 * std::cos(phase);           // NOLINT(readability-magic-numbers)
+  measurements.volume = 250 - 200 * std::cos(phase);  // NOLINT(readability-magic-numbers)
+  measurements.fio2 = 40;                             // NOLINT(readability-magic-numbers)
+  measurements.spo2 = 97;                             // NOLINT(readability-magic-numbers)
+  return measurements;
+}
+
+void require_equal(const SensorMeasurements &actual, const SensorMeasurements &expected) {
+  REQUIRE(actual.time == expected.time);
+  REQUIRE(actual.cycle == expected.cycle);
+  REQUIRE(actual.paw == expected.paw);
+  REQUIRE(actual.flow == expected.flow);
+  REQUIRE(actual.volume == expected.volume);
+  REQUIRE(actual.fio2 == expected.fio2);
+  REQUIRE(actual.spo2 == expected.spo2);
+}
+
+}  // namespace
+
+SCENARIO("Util::Delta: deltas are coded from the changed fields", "[Deltas]") {
+  GIVEN("Two SensorMeasurements which differ in their time, paw, and a negative flow") {
+    SensorMeasurements reference{};
+    reference.time = UINT32_MAX - 4;
+    reference.cycle = 7;
+    reference.paw = 20.0F;
+    reference.flow = 1.0F;
+    reference.fio2 = 21;
+    SensorMeasurements value = reference;
+    value.time = 5;  // wraps around
+    value.paw = 20.25F;
+    value.flow = -1.0F;
+
+    auto delta = PF::Util::make_delta(reference, value);
+
+    THEN("only the changed fields are marked, with small differences") {
+      REQUIRE(delta.changed == 0b1101);
+      REQUIRE(delta.differences[0] == 10);
+      REQUIRE(delta.differences[1] == 0);
+      // 20.0 and 20.25 share their sign, exponent, and high mantissa bits
+      REQUIRE(delta.differences[2] < (1U << 18U));
+      // Only the sign bit differs
+      REQUIRE(delta.differences[3] == 0x80000000);
+    }
+
+    THEN("the delta is encoded as a field mask followed by varints") {
+      Buffer buffer{};
+      size_t encoded_size = 0;
+      REQUIRE(PF::Util::encode_delta(delta, buffer.data(), buffer.size(), encoded_size));
+      REQUIRE(buffer[0] == 0b1101);
+      REQUIRE(buffer[1] == 10);
+      REQUIRE(encoded_size <= PF::Util::delta_max_size<SensorMeasurements>);
+
+      AND_THEN("decoding and applying it to the reference reconstructs the value") {
+        SensorMeasurementsDelta decoded{};
+        REQUIRE(PF::Util::decode_delta(buffer.data(), encoded_size, decoded));
+        SensorMeasurements reconstructed{};
+        PF::Util::apply_delta(reference, decoded, reconstructed);
+        require_equal(reconstructed, value);
+      }
+    }
+
+    THEN("a buffer which is too small is rejected") {
+      Buffer buffer{};
+      size_t encoded_size = 0;
+      REQUIRE(!PF::Util::encode_delta(delta, buffer.data(), 3, encoded_size));
+    }
+  }
+
+  GIVEN("Identical SensorMeasurements") {
+    auto value = make_measurements(3);
+    auto delta = PF::Util::make_delta(value, value);
+
+    THEN("the delta is encoded as a single byte") {
+      Buffer buffer{};
+      size_t encoded_size = 0;
+      REQUIRE(delta.changed == 0);
+      REQUIRE(PF::Util::encode_delta(delta, buffer.data(), buffer.size(), encoded_size));
+      REQUIRE(encoded_size == 1);
+    }
+  }
+
+  GIVEN("Invalid encodings of deltas") {
+    SensorMeasurementsDelta decoded{};
+
+    THEN("an empty delta is rejected") {
+      REQUIRE(!PF::Util::decode_delta(nullptr, 0, decoded));
+    }
+
+    THEN("a delta which marks a field past the last field is rejected") {
+      const auto input = PF::Util::make_array<uint8_t>(0x80, 0x01);
+      REQUIRE(!PF::Util::decode_delta(input.data(), input.size(), decoded));
+    }
+
+    THEN("a delta with a missing or truncated varint is rejected") {
+      const auto missing = PF::Util::make_array<uint8_t>(0x03, 0x01);
+      REQUIRE(!PF::Util::decode_delta(missing.data(), missing.size(), decoded));
+      const auto truncated = PF::Util::make_array<uint8_t>(0x01, 0x80);
+      REQUIRE(!PF::Util::decode_delta(truncated.data(), truncated.size(), decoded));
+    }
+
+    THEN("a delta with a difference which overflows 32 bits is rejected") {
+      const auto input = PF::Util::make_array<uint8_t>(0x01, 0x80, 0x80, 0x80, 0x80, 0x10);
+      REQUIRE(!PF::Util::decode_delta(input.data(), input.size(), decoded));
+    }
+
+    THEN("a delta with trailing bytes is rejected") {
+      const auto input = PF::Util::make_array<uint8_t>(0x01, 0x01, 0x00);
+      REQUIRE(!PF::Util::decode_delta(input.data(), input.size(), decoded));
+    }
+  }
+}
+
+SCENARIO(
+    "Protocols::DeltaSender: measurement streams are reconstructed from keyframes and deltas",
+    "[Deltas]") {
+  GIVEN("A delta sender and a delta receiver") {
+    TestSender sender;
+    TestReceiver receiver;
+
+    WHEN("a stream of measurements is sent through them") {
+      size_t keyframes = 0;
+      for (uint32_t i = 0; i < 3 * test_keyframe_interval; ++i) {
+        auto measurements = make_measurements(i);
+        SensorMeasurementsDelta delta{};
+        SensorMeasurements received{};
+        if (sender.transform(measurements, delta) == TestSender::Status::keyframe) {
+          ++keyframes;
+          receiver.input(measurements);
+          received = measurements;
+        } else {
+          REQUIRE(receiver.transform(delta, received) == TestReceiver::Status::ok);
+        }
+        require_equal(received, measurements);
+      }
+
+      THEN("every message is reconstructed, with a keyframe once every interval") {
+        REQUIRE(keyframes == 3);
+      }
+    }
+
+    WHEN("the receiver has not received a keyframe") {
+      SensorMeasurementsDelta delta{};
+      SensorMeasurements received{};
+
+      THEN("it rejects deltas") {
+        REQUIRE(receiver.transform(delta, received) == TestReceiver::Status::invalid_reference);
+      }
+    }
+
+    WHEN("the receiver loses a delta and is reset") {
+      SensorMeasurementsDelta delta{};
+      SensorMeasurements received{};
+      REQUIRE(sender.transform(make_measurements(0), delta) == TestSender::Status::keyframe);
+      receiver.input(make_measurements(0));
+      REQUIRE(sender.transform(make_measurements(1), delta) == TestSender::Status::ok);
+      receiver.reset();
+
+      THEN("it rejects deltas until the next keyframe") {
+        REQUIRE(sender.transform(make_measurements(2), delta) == TestSender::Status::ok);
+        REQUIRE(receiver.transform(delta, received) == TestReceiver::Status::invalid_reference);
+        REQUIRE(sender.transform(make_measurements(3), delta) == TestSender::Status::ok);
+        REQUIRE(receiver.transform(delta, received) == TestReceiver::Status::invalid_reference);
+        REQUIRE(sender.transform(make_measurements(4), delta) == TestSender::Status::keyframe);
+        receiver.input(make_measurements(4));
+        REQUIRE(sender.transform(make_measurements(5), delta) == TestSender::Status::ok);
+        REQUIRE(receiver.transform(delta, received) == TestReceiver::Status::ok);
+        require_equal(received, make_measurements(5));
+      }
+    }
+
+    WHEN("the sender is reset") {
+      SensorMeasurementsDelta delta{};
+      REQUIRE(sender.transform(make_measurements(0), delta) == TestSender::Status::keyframe);
+      REQUIRE(sender.transform(make_measurements(1), delta) == TestSender::Status::ok);
+      sender.reset();
+
+      THEN("the next message is a keyframe") {
+        REQUIRE(sender.transform(make_measurements(2), delta) == TestSender::Status::keyframe);
+      }
+    }
+  }
+
+  GIVEN("A breath cycle of sensor measurements at 100 Hz") {
+    const uint32_t samples = 300;
+
+    THEN("deltas are less than half the size of the protobuf encoding, on average") {
+      size_t protobuf_size = 0;
+      size_t delta_size = 0;
+      for (uint32_t i = 1; i < samples; ++i) {
+        auto delta = PF::Util::make_delta(make_measurements(i - 1), make_measurements(i));
+        Buffer buffer{};
+        size_t encoded_size = 0;
+        REQUIRE(PF::Util::encode_delta(delta, buffer.data(), buffer.size(), encoded_size));
+        delta_size += encoded_size;
+        protobuf_size += PF::Util::ProtobufCodec<SensorMeasurements>::encoded_size(
+            make_measurements(i));
+      }
+      REQUIRE(2 * delta_size < protobuf_size);
+    }
+  }
+}
@@ -0,0 +1,153 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * States.cpp
+ *
+ * Unit tests to confirm behavior of state synchronization
+ *
+ */
+
+#include "Pufferfish/Protocols/States.h"
+
+#include "Pufferfish/Application/States.h"
+#include "Pufferfish/Util/Array.h"
+#include "catch2/catch.hpp"
+
+namespace PF = Pufferfish;
+
+namespace {
+
+using TestOutputRate = PF::Protocols::StateOutputRate<PF::Application::MessageTypes>;
+
+const auto test_rates = PF::Util::make_array<const TestOutputRate>(
+    TestOutputRate{PF::Application::MessageTypes::sensor_measurements, 10, 20},
+    TestOutputRate{PF::Application::MessageTypes::parameters, 50, 100},
+    TestOutputRate{PF::Application::MessageTypes::alarm_limits, 50, 100});
+
+const uint32_t test_keepalive_interval = 200;
+
+using TestSynchronizer = PF::Protocols::StateSynchronizer<
+    PF::Application::States,
+    PF::Application::StateSegment,
+    PF::Application::MessageTypes,
+    test_rates.size()>;
+
+}  // namespace
+
+SCENARIO(
+    "Protocols::StateSynchronizer: state segments are output at their rates when they change",
+    "[StateSynchronizer]") {
+  GIVEN("A state synchronizer whose states have all been output once") {
+    PF::Application::States states;
+    TestSynchronizer synchronizer(states, test_rates, test_keepalive_interval);
+    PF::Application::StateSegment segment;
+    uint32_t time = 0;
+
+    synchronizer.input(time);
+    for (size_t i = 0; i < test_rates.size(); ++i) {
+      REQUIRE(synchronizer.output(segment) == TestSynchronizer::OutputStatus::ok);
+    }
+    REQUIRE(synchronizer.output(segment) == TestSynchronizer::OutputStatus::waiting);
+
+    WHEN("no state segments change") {
+      time += 100;
+      synchronizer.input(time);
+
+      THEN("no segments are output before the keepalive interval") {
+        REQUIRE(synchronizer.output(segment) == TestSynchronizer::OutputStatus::waiting);
+      }
+    }
+
+    WHEN("the keepalive interval elapses") {
+      time += test_keepalive_interval;
+      synchronizer.input(time);
+
+      THEN("every state segment is output again, once") {
+        for (size_t i = 0; i < test_rates.size(); ++i) {
+          REQUIRE(synchronizer.output(segment) == TestSynchronizer::OutputStatus::ok);
+        }
+        REQUIRE(synchronizer.output(segment) == TestSynchronizer::OutputStatus::waiting);
+      }
+    }
+
+    WHEN("the sensor measurements change continuously through a reference") {
+      THEN("they are output at most once per interval") {
+        size_t outputs = 0;
+        for (uint32_t i = 1; i <= 100; ++i) {
+          states.sensor_measurements().time = i;
+          synchronizer.input(i);
+          if (synchronizer.output(segment) == TestSynchronizer::OutputStatus::ok) {
+            REQUIRE(segment.tag == PF::Application::MessageTypes::sensor_measurements);
+            REQUIRE(segment.value.sensor_measurements.time == i);
+            ++outputs;
+          }
+        }
+        REQUIRE(outputs == 10);
+      }
+    }
+
+    WHEN("the parameters change by input") {
+      Parameters parameters{};
+      parameters.fio2 = 40;
+      PF::Application::StateSegment input;
+      input.set(parameters);
+      REQUIRE(states.input(input) == PF::Application::States::InputStatus::ok);
+
+      THEN("they are not output before their interval has elapsed") {
+        time += 49;
+        synchronizer.input(time);
+        REQUIRE(synchronizer.output(segment) == TestSynchronizer::OutputStatus::waiting);
+      }
+
+      THEN("they are output once their interval has elapsed") {
+        time += 50;
+        synchronizer.input(time);
+        REQUIRE(synchronizer.output(segment) == TestSynchronizer::OutputStatus::ok);
+        REQUIRE(segment.tag == PF::Application::MessageTypes::parameters);
+        REQUIRE(segment.value.parameters.fio2 == 40);
+        REQUIRE(synchronizer.output(segment) == TestSynchronizer::OutputStatus::waiting);
+      }
+    }
+
+    WHEN("several changed state segments are waiting to be output") {
+      Parameters parameters{};
+      parameters.fio2 = 40;
+      PF::Application::StateSegment input;
+      input.set(parameters);
+      REQUIRE(states.input(input) == PF::Application::States::InputStatus::ok);
+      states.sensor_measurements().time = 1;
+      time += 90;
+      synchronizer.input(time);
+
+      THEN("the segment which is furthest past its deadline is output first") {
+        REQUIRE(synchronizer.output(segment) == TestSynchronizer::OutputStatus::ok);
+        REQUIRE(segment.tag == PF::Application::MessageTypes::sensor_measurements);
+        REQUIRE(synchronizer.output(segment) == TestSynchronizer::OutputStatus::ok);
+        REQUIRE(segment.tag == PF::Application::MessageTypes::parameters);
+        REQUIRE(synchronizer.output(segment) == TestSynchronizer::OutputStatus::waiting);
+      }
+    }
+
+    WHEN("a segment changes just as unchanged segments are due for a keepalive") {
+      time = test_keepalive_interval - 10;
+      states.sensor_measurements().time = time;
+      synchronizer.input(time);
+      REQUIRE(synchronizer.output(segment) == TestSynchronizer::OutputStatus::ok);
+      REQUIRE(segment.tag == PF::Application::MessageTypes::sensor_measurements);
+      time += 20;
+      states.sensor_measurements().time = time;
+      synchronizer.input(time);
+
+      THEN("the changed segment is output before the keepalives, even though it is less late") {
+        REQUIRE(synchronizer.output(segment) == TestSynchronizer::OutputStatus::ok);
+        REQUIRE(segment.tag == PF::Application::MessageTypes::sensor_measurements);
+        REQUIRE(segment.value.sensor_measurements.time == time);
+        REQUIRE(synchronizer.output(segment) == TestSynchronizer::OutputStatus::ok);
+        REQUIRE(segment.tag == PF::Application::MessageTypes::parameters);
+        REQUIRE(synchronizer.output(segment) == TestSynchronizer::OutputStatus::ok);
+        REQUIRE(segment.tag == PF::Application::MessageTypes::alarm_limits);
+        REQUIRE(synchronizer.output(segment) == TestSynchronizer::OutputStatus::waiting);
+      }
+    }
+  }
+}
@@ -0,0 +1,119 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * COBS.cpp
+ *
+ * Unit tests to confirm behavior of incremental COBS decoding
+ *
+ */
+
+#include "Pufferfish/Util/COBS.h"
+
+#include <string>
+
+#include "Pufferfish/Test/Util.h"
+#include "catch2/catch.hpp"
+
+namespace PF = Pufferfish;
+
+namespace {
+
+constexpr size_t buffer_size = 256UL;
+
+PF::Util::ByteVector<buffer_size> stream_decode(const std::string &encoded) {
+  PF::Util::ByteVector<buffer_size> decoded;
+  PF::Util::COBSStreamDecoder decoder;
+  for (const auto &ch : encoded) {
+    REQUIRE(decoder.input(static_cast<uint8_t>(ch), decoded) == PF::IndexStatus::ok);
+  }
+  if (!decoder.complete()) {
+    decoded.clear();
+  }
+  return decoded;
+}
+
+PF::Util::ByteVector<buffer_size> batch_decode(const std::string &encoded) {
+  PF::Util::ByteVector<buffer_size> decoded;
+  decoded.resize(PF::Util::decode_cobs(
+      reinterpret_cast<const uint8_t *>(encoded.data()), encoded.size(), decoded.buffer()));
+  return decoded;
+}
+
+std::string encode(const std::string &unencoded) {
+  std::string encoded(PF::Util::get_encoded_cobs_buffer_size(unencoded.size()), '\0');
+  encoded.resize(PF::Util::encode_cobs(
+      reinterpret_cast<const uint8_t *>(unencoded.data()),
+      unencoded.size(),
+      reinterpret_cast<uint8_t *>(&encoded[0])));
+  return encoded;
+}
+
+}  // namespace
+
+SCENARIO(
+    "Util::COBSStreamDecoder: byte-wise decoding matches decode_cobs on the whole buffer",
+    "[COBS]") {
+  GIVEN("Payloads encoded with encode_cobs") {
+    WHEN("payloads with and without zeros are decoded one byte at a time") {
+      auto payload = GENERATE(
+          std::string(""),
+          std::string("\x00", 1),
+          std::string("\x00\x00", 2),
+          std::string("\x11\x22\x00\x33", 4),
+          std::string("\x11\x22\x33\x44", 4),
+          std::string("\x11\x00\x00\x00", 4),
+          std::string(253, '\x01'),
+          std::string(254, '\x01'),
+          std::string(254, '\x01') + std::string("\x00\x02", 2));
+      auto encoded = encode(payload);
+      auto streamed = stream_decode(encoded);
+
+      THEN("the decoded bytes match the payload and the output of decode_cobs") {
+        REQUIRE(streamed == batch_decode(encoded));
+        REQUIRE(streamed == payload);
+      }
+    }
+  }
+
+  GIVEN("An encoded buffer whose last block is truncated") {
+    auto encoded = std::string("\x05\x11\x22", 3);
+
+    WHEN("it is decoded one byte at a time") {
+      PF::Util::ByteVector<buffer_size> decoded;
+      PF::Util::COBSStreamDecoder decoder;
+      for (const auto &ch : encoded) {
+        decoder.input(static_cast<uint8_t>(ch), decoded);
+      }
+
+      THEN("the decoder reports the buffer as incomplete, as decode_cobs rejects it") {
+        REQUIRE(decoder.complete() == false);
+        REQUIRE(batch_decode(encoded).empty() == true);
+      }
+      THEN("after a reset, the decoder decodes the next buffer independently") {
+        decoder.reset();
+        decoded.clear();
+        for (const auto &ch : std::string("\x02\x33\x01", 3)) {
+          decoder.input(static_cast<uint8_t>(ch), decoded);
+        }
+        REQUIRE(decoder.complete() == true);
+        REQUIRE(decoded == std::string("\x33\x00", 2));
+      }
+    }
+  }
+
+  GIVEN("An output buffer which is too small for the decoded bytes") {
+    PF::Util::ByteVector<2> decoded;
+    PF::Util::COBSStreamDecoder decoder;
+
+    WHEN("more bytes are decoded than fit in the output buffer") {
+      REQUIRE(decoder.input(0x04, decoded) == PF::IndexStatus::ok);
+      REQUIRE(decoder.input(0x11, decoded) == PF::IndexStatus::ok);
+      REQUIRE(decoder.input(0x22, decoded) == PF::IndexStatus::ok);
+      auto status = decoder.input(0x33, decoded);
+
+      THEN("the input method reports out_of_bounds") {
+        REQUIRE(status == PF::IndexStatus::out_of_bounds);
+      }
+    }
+  }
+}
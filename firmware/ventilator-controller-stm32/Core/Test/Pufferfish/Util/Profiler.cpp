@@ -0,0 +1,163 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * Profiler.cpp
+ *
+ * Unit tests to confirm behavior of the scoped execution time profiler
+ *
+ */
+
+#include "Pufferfish/Util/Profiler.h"
+
+#include "Pufferfish/Application/Profiler.h"
+#include "catch2/catch.hpp"
+
+namespace PF = Pufferfish;
+
+namespace {
+
+// A cycle counter which the tests advance manually
+struct MockCycleCounter {
+  static uint32_t value;
+  static uint32_t cycles() { return value; }
+};
+
+uint32_t MockCycleCounter::value = 0;
+
+}  // namespace
+
+SCENARIO("Util::ProfileStats: histogram buckets are powers of two", "[Profiler]") {
+  GIVEN("Execution times of various numbers of cycles") {
+    THEN("each is counted in the bucket of its most significant bit") {
+      REQUIRE(PF::Util::ProfileStats::histogram_bucket(0) == 0);
+      REQUIRE(PF::Util::ProfileStats::histogram_bucket(1) == 0);
+      REQUIRE(PF::Util::ProfileStats::histogram_bucket(2) == 1);
+      REQUIRE(PF::Util::ProfileStats::histogram_bucket(3) == 1);
+      REQUIRE(PF::Util::ProfileStats::histogram_bucket(4) == 2);
+      REQUIRE(PF::Util::ProfileStats::histogram_bucket(1000) == 9);
+      REQUIRE(PF::Util::ProfileStats::histogram_bucket(1024) == 10);
+      REQUIRE(PF::Util::ProfileStats::histogram_bucket((1U << 23U) - 1) == 22);
+    }
+
+    THEN("executions beyond the last bucket are counted in the last bucket") {
+      REQUIRE(PF::Util::ProfileStats::histogram_bucket(1U << 23U) == 23);
+      REQUIRE(PF::Util::ProfileStats::histogram_bucket(1U << 24U) == 23);
+      REQUIRE(PF::Util::ProfileStats::histogram_bucket(UINT32_MAX) == 23);
+    }
+  }
+}
+
+SCENARIO("Util::ProfileStats: execution times are summarized", "[Profiler]") {
+  GIVEN("Empty profile stats") {
+    PF::Util::ProfileStats stats;
+
+    THEN("every statistic is 0") {
+      REQUIRE(stats.count() == 0);
+      REQUIRE(stats.min() == 0);
+      REQUIRE(stats.max() == 0);
+      REQUIRE(stats.mean() == 0);
+      for (auto bucket : stats.histogram()) {
+        REQUIRE(bucket == 0);
+      }
+    }
+
+    WHEN("several execution times are recorded") {
+      stats.record(100);
+      stats.record(300);
+      stats.record(110);
+      stats.record(2);
+
+      THEN("the count, min, max, mean, and histogram cover every execution") {
+        REQUIRE(stats.count() == 4);
+        REQUIRE(stats.min() == 2);
+        REQUIRE(stats.max() == 300);
+        REQUIRE(stats.mean() == 128);
+        REQUIRE(stats.histogram()[1] == 1);
+        REQUIRE(stats.histogram()[6] == 2);
+        REQUIRE(stats.histogram()[8] == 1);
+      }
+    }
+  }
+}
+
+SCENARIO("Util::ScopedProfile: the duration of a scope is recorded", "[Profiler]") {
+  GIVEN("Empty profile stats") {
+    PF::Util::ProfileStats stats;
+
+    WHEN("a scope is profiled") {
+      MockCycleCounter::value = 1000;
+      {
+        PF::Util::ScopedProfile<MockCycleCounter> profile(stats);
+        MockCycleCounter::value = 1500;
+      }
+
+      THEN("its execution time is recorded when the scope ends") {
+        REQUIRE(stats.count() == 1);
+        REQUIRE(stats.max() == 500);
+      }
+    }
+
+    WHEN("the cycle counter wraps around during a profiled scope") {
+      MockCycleCounter::value = UINT32_MAX - 9;
+      {
+        PF::Util::ScopedProfile<MockCycleCounter> profile(stats);
+        MockCycleCounter::value = 20;
+      }
+
+      THEN("the execution time is still correct") {
+        REQUIRE(stats.count() == 1);
+        REQUIRE(stats.max() == 30);
+      }
+    }
+  }
+}
+
+SCENARIO("Application::Profiler: regions are output in turn", "[Profiler]") {
+  GIVEN("A profiler with executions recorded in two regions") {
+    PF::Application::Profiler profiler;
+    profiler.region(ProfileRegion_control_loop).record(4000);
+    profiler.region(ProfileRegion_backend_send).record(10);
+    profiler.region(ProfileRegion_backend_send).record(30);
+
+    WHEN("every region is output") {
+      Profile control_loop{};
+      profiler.output(10, control_loop);
+      Profile backend_receive{};
+      profiler.output(20, backend_receive);
+      Profile backend_send{};
+      profiler.output(30, backend_send);
+      for (size_t i = 3; i < PF::Application::Profiler::num_regions; ++i) {
+        Profile other{};
+        profiler.output(0, other);
+      }
+      Profile next{};
+      profiler.output(40, next);
+
+      THEN("each output holds the statistics of its region") {
+        REQUIRE(control_loop.time == 10);
+        REQUIRE(control_loop.region == ProfileRegion_control_loop);
+        REQUIRE(control_loop.count == 1);
+        REQUIRE(control_loop.min_cycles == 4000);
+        REQUIRE(control_loop.histogram_count == PF::Util::ProfileStats::histogram_size);
+        REQUIRE(control_loop.histogram[11] == 1);
+
+        REQUIRE(backend_receive.region == ProfileRegion_backend_receive);
+        REQUIRE(backend_receive.count == 0);
+
+        REQUIRE(backend_send.region == ProfileRegion_backend_send);
+        REQUIRE(backend_send.count == 2);
+        REQUIRE(backend_send.min_cycles == 10);
+        REQUIRE(backend_send.max_cycles == 30);
+        REQUIRE(backend_send.mean_cycles == 20);
+        REQUIRE(backend_send.histogram[3] == 1);
+        REQUIRE(backend_send.histogram[4] == 1);
+      }
+
+      THEN("the output starts over from the first region") {
+        REQUIRE(next.time == 40);
+        REQUIRE(next.region == ProfileRegion_control_loop);
+        REQUIRE(next.count == 1);
+      }
+    }
+  }
+}
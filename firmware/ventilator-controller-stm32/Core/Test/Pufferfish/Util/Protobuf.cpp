@@ -0,0 +1,255 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * Protobuf.cpp
+ *
+ * Unit tests to confirm that the generated protobuf codecs are wire-compatible with nanopb
+ *
+ */
+
+#include "Pufferfish/Util/Protobuf.h"
+
+#include <array>
+#include <cmath>
+#include <cstring>
+
+#include "Pufferfish/Application/mcu_pb_codecs.h"
+#include "Pufferfish/Util/Array.h"
+#include "catch2/catch.hpp"
+#include "nanopb/pb_decode.h"
+#include "nanopb/pb_encode.h"
+
+namespace PF = Pufferfish;
+
+namespace {
+
+using Buffer = std::array<uint8_t, 256>;
+
+template <typename MessageType>
+size_t nanopb_encode(const MessageType &message, Buffer &buffer) {
+  pb_ostream_t stream = pb_ostream_from_buffer(buffer.data(), buffer.size());
+  REQUIRE(pb_encode(&stream, nanopb::MessageDescriptor<MessageType>::fields(), &message));
+  return stream.bytes_written;
+}
+
+template <typename MessageType>
+size_t generated_encode(const MessageType &message, Buffer &buffer) {
+  size_t encoded_size = 0;
+  REQUIRE(PF::Util::encode_protobuf(message, buffer.data(), buffer.size(), encoded_size));
+  REQUIRE(encoded_size == PF::Util::ProtobufCodec<MessageType>::encoded_size(message));
+  return encoded_size;
+}
+
+// Encodes with both encoders, checks that the outputs match, and decodes the output with the
+// generated decoder
+template <typename MessageType>
+MessageType check_round_trip(const MessageType &message) {
+  Buffer nanopb_output{};
+  Buffer generated_output{};
+  size_t nanopb_size = nanopb_encode(message, nanopb_output);
+  size_t generated_size = generated_encode(message, generated_output);
+  REQUIRE(generated_size == nanopb_size);
+  REQUIRE(std::memcmp(generated_output.data(), nanopb_output.data(), nanopb_size) == 0);
+  REQUIRE(generated_size <= PF::Util::ProtobufCodec<MessageType>::max_size);
+
+  MessageType decoded{};
+  REQUIRE(PF::Util::decode_protobuf(generated_output.data(), generated_size, decoded));
+  return decoded;
+}
+
+}  // namespace
+
+SCENARIO(
+    "Util::ProtobufCodec: generated codecs are selected only for fixed-shape messages",
+    "[Protobuf]") {
+  GIVEN("Messages with and without generated codecs") {
+    THEN("fixed-shape messages have generated codecs") {
+      REQUIRE(PF::Util::ProtobufCodec<SensorMeasurements>::generated);
+      REQUIRE(PF::Util::ProtobufCodec<AlarmLimits>::generated);
+    }
+
+    THEN("messages with variable-size fields fall back to nanopb") {
+      REQUIRE(!PF::Util::ProtobufCodec<Announcement>::generated);
+      REQUIRE(!PF::Util::ProtobufCodec<NextLogEvents>::generated);
+    }
+
+    THEN("the maximum encoded sizes match nanopb's") {
+      REQUIRE(PF::Util::ProtobufCodec<Range>::max_size == Range_size);
+      REQUIRE(PF::Util::ProtobufCodec<AlarmLimits>::max_size == AlarmLimits_size);
+      REQUIRE(PF::Util::ProtobufCodec<SensorMeasurements>::max_size == SensorMeasurements_size);
+      REQUIRE(PF::Util::ProtobufCodec<SensorWaveforms>::max_size == SensorWaveforms_size);
+      REQUIRE(PF::Util::ProtobufCodec<CycleMeasurements>::max_size == CycleMeasurements_size);
+      REQUIRE(PF::Util::ProtobufCodec<Parameters>::max_size == Parameters_size);
+      REQUIRE(PF::Util::ProtobufCodec<LogEvent>::max_size == LogEvent_size);
+    }
+  }
+}
+
+SCENARIO(
+    "Util::ProtobufCodec: generated encoders produce the same bytes as nanopb", "[Protobuf]") {
+  GIVEN("A SensorMeasurements message with zero, negative, and extreme field values") {
+    SensorMeasurements message{};
+    message.time = UINT32_MAX;
+    message.cycle = 0;
+    message.paw = -0.0F;
+    message.flow = -12.25F;
+    message.volume = 0.0F;
+    message.fio2 = 1e30F;
+    message.spo2 = 97.5F;
+
+    THEN("it round-trips through the generated codec") {
+      auto decoded = check_round_trip(message);
+      REQUIRE(decoded.time == message.time);
+      REQUIRE(decoded.cycle == 0);
+      REQUIRE(std::signbit(decoded.paw));
+      REQUIRE(decoded.flow == message.flow);
+      REQUIRE(decoded.fio2 == message.fio2);
+      REQUIRE(decoded.spo2 == message.spo2);
+    }
+  }
+
+  GIVEN("An AlarmLimits message with some present and some absent ranges") {
+    AlarmLimits message{};
+    message.time = 300;
+    message.has_fio2 = true;
+    message.fio2 = Range{21, 100};
+    message.has_spo2 = true;
+    message.spo2 = Range{0, 0};
+    message.has_apnea = true;
+    message.apnea = Range{100000, 200000};
+
+    THEN("it round-trips through the generated codec") {
+      auto decoded = check_round_trip(message);
+      REQUIRE(decoded.time == message.time);
+      REQUIRE(decoded.has_fio2);
+      REQUIRE(decoded.fio2.lower == 21);
+      REQUIRE(decoded.fio2.upper == 100);
+      REQUIRE(decoded.has_spo2);
+      REQUIRE(!decoded.has_rr);
+      REQUIRE(decoded.has_apnea);
+      REQUIRE(decoded.apnea.upper == 200000);
+    }
+  }
+
+  GIVEN("A Parameters message with an enum and a bool") {
+    Parameters message{};
+    message.time = 1;
+    message.mode = VentilationMode_hfnc;
+    message.fio2 = 40;
+    message.flow = 30;
+    message.ventilating = true;
+
+    THEN("it round-trips through the generated codec") {
+      auto decoded = check_round_trip(message);
+      REQUIRE(decoded.mode == VentilationMode_hfnc);
+      REQUIRE(decoded.fio2 == 40);
+      REQUIRE(decoded.ventilating);
+    }
+  }
+
+  GIVEN("A full SensorWaveforms batch") {
+    SensorWaveforms message{};
+    message.time = 1000;
+    message.first_sample = 4800;
+    for (uint32_t i = 0; i < pb_arraysize(SensorWaveforms, paw); ++i) {
+      message.offset[i] = i * 2;
+      message.paw[i] = static_cast<float>(i) - 3;
+      message.flow[i] = static_cast<float>(i) * 2;
+      message.volume[i] = static_cast<float>(i) / 4;
+    }
+    message.offset_count = pb_arraysize(SensorWaveforms, offset);
+    message.paw_count = pb_arraysize(SensorWaveforms, paw);
+    message.flow_count = pb_arraysize(SensorWaveforms, flow);
+    message.volume_count = pb_arraysize(SensorWaveforms, volume);
+
+    THEN("it round-trips through the generated codec") {
+      auto decoded = check_round_trip(message);
+      REQUIRE(decoded.offset_count == message.offset_count);
+      REQUIRE(decoded.volume_count == message.volume_count);
+      REQUIRE(decoded.offset[11] == 22);
+      REQUIRE(decoded.paw[0] == -3);
+      REQUIRE(decoded.volume[11] == 2.75F);
+    }
+
+    WHEN("the sample counts exceed the capacity of the arrays") {
+      message.paw_count = pb_arraysize(SensorWaveforms, paw) + 1;
+      Buffer output{};
+      size_t encoded_size = 0;
+
+      THEN("the generated encoder rejects the message") {
+        REQUIRE(!PF::Util::encode_protobuf(message, output.data(), output.size(), encoded_size));
+      }
+    }
+  }
+
+  GIVEN("A message which doesn't fit in the output buffer") {
+    CycleMeasurements message{};
+    message.time = 1;
+    message.vt = 2;
+    message.rr = 3;
+    std::array<uint8_t, 8> output{};
+    size_t encoded_size = 0;
+
+    THEN("the generated encoder fails instead of overflowing the buffer") {
+      REQUIRE(!PF::Util::encode_protobuf(message, output.data(), output.size(), encoded_size));
+    }
+  }
+}
+
+SCENARIO("Util::ProtobufCodec: generated decoders accept any valid encoding", "[Protobuf]") {
+  GIVEN("A SensorWaveforms message with unpacked repeated fields, out of order") {
+    // offset: 3 (unpacked), time: 5, offset: 4 (unpacked), paw: 1.0 (unpacked fixed32)
+    const auto input = PF::Util::make_array<uint8_t>(
+        0x18, 0x03, 0x08, 0x05, 0x18, 0x04, 0x25, 0x00, 0x00, 0x80, 0x3f);
+    SensorWaveforms decoded{};
+
+    THEN("all values are decoded") {
+      REQUIRE(PF::Util::decode_protobuf(input.data(), input.size(), decoded));
+      REQUIRE(decoded.time == 5);
+      REQUIRE(decoded.offset_count == 2);
+      REQUIRE(decoded.offset[0] == 3);
+      REQUIRE(decoded.offset[1] == 4);
+      REQUIRE(decoded.paw_count == 1);
+      REQUIRE(decoded.paw[0] == 1.0F);
+    }
+  }
+
+  GIVEN("A SensorMeasurements message with unknown fields") {
+    // time: 7, field 15 (varint), field 16 (length-delimited, 2 bytes), cycle: 9
+    const auto input = PF::Util::make_array<uint8_t>(
+        0x08, 0x07, 0x78, 0x96, 0x01, 0x82, 0x01, 0x02, 0xaa, 0xbb, 0x10, 0x09);
+    SensorMeasurements decoded{};
+
+    THEN("the unknown fields are skipped") {
+      REQUIRE(PF::Util::decode_protobuf(input.data(), input.size(), decoded));
+      REQUIRE(decoded.time == 7);
+      REQUIRE(decoded.cycle == 9);
+    }
+  }
+
+  GIVEN("Invalid encodings") {
+    SensorMeasurements decoded{};
+
+    THEN("a truncated varint is rejected") {
+      const auto input = PF::Util::make_array<uint8_t>(0x08, 0x80);
+      REQUIRE(!PF::Util::decode_protobuf(input.data(), input.size(), decoded));
+    }
+
+    THEN("a field with the wrong wire type is rejected") {
+      const auto input = PF::Util::make_array<uint8_t>(0x1d, 0x00, 0x00, 0x80, 0x3f, 0x08, 0x01);
+      REQUIRE(PF::Util::decode_protobuf(input.data(), input.size(), decoded));
+      const auto wrong = PF::Util::make_array<uint8_t>(0x18, 0x01);
+      REQUIRE(!PF::Util::decode_protobuf(wrong.data(), wrong.size(), decoded));
+    }
+
+    THEN("a uint32 which overflows is rejected") {
+      const auto input = PF::Util::make_array<uint8_t>(0x08, 0x80, 0x80, 0x80, 0x80, 0x10);
+      REQUIRE(!PF::Util::decode_protobuf(input.data(), input.size(), decoded));
+    }
+
+    THEN("a field number of zero is rejected") {
+      const auto input = PF::Util::make_array<uint8_t>(0x00, 0x01);
+      REQUIRE(!PF::Util::decode_protobuf(input.data(), input.size(), decoded));
+    }
+  }
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * RingBuffer.cpp
+ *
+ * Unit tests to confirm behavior of the ring buffer
+ *
+ */
+
+#include "Pufferfish/Util/RingBuffer.h"
+
+#include <array>
+
+#include "Pufferfish/Util/Array.h"
+#include "catch2/catch.hpp"
+
+namespace PF = Pufferfish;
+
+SCENARIO(
+    "Util::RingBuffer: bulk reads and writes wrap around the end of the array", "[RingBuffer]") {
+  GIVEN("A ring buffer of 8 bytes whose head and tail are near the end of the array") {
+    volatile PF::Util::RingBuffer<8> buffer;
+    uint8_t byte = 0;
+    for (size_t i = 0; i < 6; ++i) {
+      REQUIRE(buffer.write(0) == PF::BufferStatus::ok);
+      REQUIRE(buffer.read(byte) == PF::BufferStatus::ok);
+    }
+    REQUIRE(buffer.size() == 0);
+
+    WHEN("more bytes are written than the buffer can hold") {
+      const auto input = PF::Util::make_array<uint8_t>(1, 2, 3, 4, 5, 6, 7, 8, 9);
+      PF::HAL::AtomicSize written_size = 0;
+      auto status = buffer.write(PF::Util::ByteView(input.data(), input.size()), written_size);
+
+      THEN("only the bytes which fit are written") {
+        REQUIRE(status == PF::BufferStatus::partial);
+        REQUIRE(written_size == 7);
+        REQUIRE(buffer.size() == 7);
+        REQUIRE(buffer.write(0) == PF::BufferStatus::full);
+      }
+
+      THEN("a bulk read returns the written bytes in order") {
+        std::array<uint8_t, 16> output{};
+        PF::HAL::AtomicSize read_size = 0;
+        REQUIRE(
+            buffer.read(PF::Util::Span<uint8_t>(output.data(), output.size()), read_size) ==
+            PF::BufferStatus::ok);
+        REQUIRE(read_size == 7);
+        for (size_t i = 0; i < read_size; ++i) {
+          REQUIRE(output[i] == input[i]);
+        }
+        REQUIRE(buffer.size() == 0);
+        REQUIRE(
+            buffer.read(PF::Util::Span<uint8_t>(output.data(), output.size()), read_size) ==
+            PF::BufferStatus::empty);
+        REQUIRE(read_size == 0);
+      }
+
+      THEN("a bulk read into a small buffer only reads as many bytes as fit") {
+        std::array<uint8_t, 3> output{};
+        PF::HAL::AtomicSize read_size = 0;
+        REQUIRE(
+            buffer.read(PF::Util::Span<uint8_t>(output.data(), output.size()), read_size) ==
+            PF::BufferStatus::ok);
+        REQUIRE(read_size == 3);
+        REQUIRE(output[2] == 3);
+        REQUIRE(buffer.read(byte) == PF::BufferStatus::ok);
+        REQUIRE(byte == 4);
+      }
+
+      THEN("the bytes can be peeked in two contiguous regions and committed") {
+        PF::Util::ByteView region;
+        REQUIRE(buffer.peek(region) == PF::BufferStatus::ok);
+        REQUIRE(region.size() == 2);
+        REQUIRE(region[0] == 1);
+        REQUIRE(region[1] == 2);
+        REQUIRE(buffer.commit(region.size()) == PF::IndexStatus::ok);
+
+        REQUIRE(buffer.peek(region) == PF::BufferStatus::ok);
+        REQUIRE(region.size() == 5);
+        REQUIRE(region[0] == 3);
+        REQUIRE(region[4] == 7);
+        REQUIRE(buffer.commit(region.size() + 1) == PF::IndexStatus::out_of_bounds);
+        REQUIRE(buffer.commit(region.size()) == PF::IndexStatus::ok);
+
+        REQUIRE(buffer.peek(region) == PF::BufferStatus::empty);
+        REQUIRE(buffer.size() == 0);
+      }
+    }
+  }
+}
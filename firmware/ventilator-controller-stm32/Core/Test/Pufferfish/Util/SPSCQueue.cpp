@@ -0,0 +1,174 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * SPSCQueue.cpp
+ *
+ * Unit tests to confirm behavior of the single-producer, single-consumer queue,
+ * including stress tests with the producer and consumer on separate threads
+ *
+ */
+
+#include "Pufferfish/Util/SPSCQueue.h"
+
+#include <array>
+#include <memory>
+#include <thread>
+
+#include "catch2/catch.hpp"
+
+namespace PF = Pufferfish;
+
+namespace {
+
+struct Sample {
+  Sample() = default;
+  Sample(uint32_t time, float value) : time(time), value(value), check(~time) {}
+
+  uint32_t time = 0;
+  float value = 0;
+  uint32_t check = 0;
+};
+
+const size_t stress_count = 1000000;
+
+}  // namespace
+
+SCENARIO("Util::SPSCQueue: elements are popped in the order they were pushed", "[SPSCQueue]") {
+  GIVEN("An empty queue of 4 samples") {
+    PF::Util::SPSCQueue<Sample, 4> queue;
+    Sample sample;
+    REQUIRE(queue.empty());
+    REQUIRE(queue.pop(sample) == PF::BufferStatus::empty);
+
+    WHEN("the queue is filled by in-place construction") {
+      for (uint32_t i = 0; i < queue.capacity(); ++i) {
+        REQUIRE(queue.emplace(i, static_cast<float>(i) / 2) == PF::BufferStatus::ok);
+      }
+
+      THEN("all of its capacity is usable, and no more") {
+        REQUIRE(queue.size() == 4);
+        REQUIRE(queue.push(Sample{4, 2}) == PF::BufferStatus::full);
+      }
+
+      THEN("elements are popped in order") {
+        for (uint32_t i = 0; i < queue.capacity(); ++i) {
+          REQUIRE(queue.pop(sample) == PF::BufferStatus::ok);
+          REQUIRE(sample.time == i);
+          REQUIRE(sample.value == static_cast<float>(i) / 2);
+        }
+        REQUIRE(queue.pop(sample) == PF::BufferStatus::empty);
+      }
+
+      THEN("a batch pop moves out as many elements as fit") {
+        std::array<Sample, 3> batch{};
+        size_t popped = 0;
+        REQUIRE(
+            queue.pop(PF::Util::Span<Sample>(batch.data(), batch.size()), popped) ==
+            PF::BufferStatus::ok);
+        REQUIRE(popped == 3);
+        REQUIRE(batch[2].time == 2);
+        REQUIRE(queue.size() == 1);
+        REQUIRE(queue.push(Sample{4, 2}) == PF::BufferStatus::ok);
+        REQUIRE(
+            queue.pop(PF::Util::Span<Sample>(batch.data(), batch.size()), popped) ==
+            PF::BufferStatus::ok);
+        REQUIRE(popped == 2);
+        REQUIRE(batch[0].time == 3);
+        REQUIRE(batch[1].time == 4);
+      }
+    }
+  }
+
+  GIVEN("A queue of elements which own resources") {
+    auto resource = std::make_shared<int>(0);
+    {
+      PF::Util::SPSCQueue<std::shared_ptr<int>, 2> queue;
+      REQUIRE(queue.push(resource) == PF::BufferStatus::ok);
+      REQUIRE(queue.push(resource) == PF::BufferStatus::ok);
+      REQUIRE(resource.use_count() == 3);
+
+      std::shared_ptr<int> popped;
+      REQUIRE(queue.pop(popped) == PF::BufferStatus::ok);
+      popped.reset();
+      REQUIRE(resource.use_count() == 2);
+    }
+
+    THEN("elements left in the queue are destroyed with the queue") {
+      REQUIRE(resource.use_count() == 1);
+    }
+  }
+}
+
+SCENARIO(
+    "Util::SPSCQueue: a producer thread and a consumer thread never lose or corrupt elements",
+    "[SPSCQueue]") {
+  GIVEN("A small queue shared by a producer thread and a consumer thread") {
+    PF::Util::SPSCQueue<Sample, 16> queue;
+
+    WHEN("the consumer pops elements one at a time") {
+      std::thread producer([&queue]() {
+        for (uint32_t i = 0; i < stress_count; ++i) {
+          while (queue.emplace(i, static_cast<float>(i)) != PF::BufferStatus::ok) {
+            std::this_thread::yield();
+          }
+        }
+      });
+
+      size_t received = 0;
+      size_t out_of_order = 0;
+      size_t corrupted = 0;
+      Sample sample;
+      while (received < stress_count) {
+        if (queue.pop(sample) != PF::BufferStatus::ok) {
+          std::this_thread::yield();
+          continue;
+        }
+        out_of_order += sample.time == received ? 0 : 1;
+        corrupted += sample.check == ~sample.time ? 0 : 1;
+        ++received;
+      }
+      producer.join();
+
+      THEN("every element arrives intact and in order") {
+        REQUIRE(out_of_order == 0);
+        REQUIRE(corrupted == 0);
+        REQUIRE(queue.empty());
+      }
+    }
+
+    WHEN("the consumer pops elements in batches") {
+      std::thread producer([&queue]() {
+        for (uint32_t i = 0; i < stress_count; ++i) {
+          while (queue.push(Sample{i, static_cast<float>(i)}) != PF::BufferStatus::ok) {
+            std::this_thread::yield();
+          }
+        }
+      });
+
+      size_t received = 0;
+      size_t out_of_order = 0;
+      size_t corrupted = 0;
+      std::array<Sample, 5> batch{};
+      while (received < stress_count) {
+        size_t popped = 0;
+        if (queue.pop(PF::Util::Span<Sample>(batch.data(), batch.size()), popped) !=
+            PF::BufferStatus::ok) {
+          std::this_thread::yield();
+          continue;
+        }
+        for (size_t i = 0; i < popped; ++i) {
+          out_of_order += batch[i].time == received ? 0 : 1;
+          corrupted += batch[i].check == ~batch[i].time ? 0 : 1;
+          ++received;
+        }
+      }
+      producer.join();
+
+      THEN("every element arrives intact and in order") {
+        REQUIRE(out_of_order == 0);
+        REQUIRE(corrupted == 0);
+        REQUIRE(queue.empty());
+      }
+    }
+  }
+}
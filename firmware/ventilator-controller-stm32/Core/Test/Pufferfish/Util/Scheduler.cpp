@@ -0,0 +1,167 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * Scheduler.cpp
+ *
+ * Unit tests to confirm behavior of the cooperative task scheduler
+ *
+ */
+
+#include "Pufferfish/Util/Scheduler.h"
+
+#include <vector>
+
+#include "Pufferfish/HAL/Mock/MockTime.h"
+#include "catch2/catch.hpp"
+
+namespace PF = Pufferfish;
+
+namespace {
+
+// Tasks are capture-less, so they record their runs here
+PF::HAL::MockTime mock_time;
+std::vector<char> task_runs;
+uint32_t task_micros = 0;
+
+template <char name>
+void record_run(uint32_t /*current_time*/) {
+  task_runs.push_back(name);
+}
+
+// Takes task_micros of time on the mock microsecond clock
+void record_slow_run(uint32_t /*current_time*/) {
+  task_runs.push_back('s');
+  mock_time.set_micros(mock_time.micros() + task_micros);
+}
+
+PF::Util::TaskStats get_stats(const PF::Util::Scheduler<4> &scheduler, size_t index) {
+  PF::Util::TaskStats stats{};
+  REQUIRE(scheduler.stats(index, stats) == PF::IndexStatus::ok);
+  return stats;
+}
+
+}  // namespace
+
+SCENARIO("Util::Scheduler: tasks run when they are due, in order of priority", "[Scheduler]") {
+  task_runs.clear();
+  mock_time.set_micros(0);
+
+  GIVEN("A scheduler with tasks of different periods and priorities") {
+    PF::Util::Scheduler<4> scheduler(mock_time);
+    REQUIRE(scheduler.add(PF::Util::Task{record_run<'a'>, 10, 1, 100}) == PF::IndexStatus::ok);
+    REQUIRE(scheduler.add(PF::Util::Task{record_run<'b'>, 2, 3, 100}) == PF::IndexStatus::ok);
+    REQUIRE(scheduler.add(PF::Util::Task{record_run<'c'>, 0, 0, 100}) == PF::IndexStatus::ok);
+    REQUIRE(scheduler.add(PF::Util::Task{record_run<'d'>, 10, 3, 100}) == PF::IndexStatus::ok);
+
+    THEN("no more tasks can be added") {
+      REQUIRE(scheduler.size() == 4);
+      REQUIRE(
+          scheduler.add(PF::Util::Task{record_run<'e'>, 1, 0, 100}) ==
+          PF::IndexStatus::out_of_bounds);
+      PF::Util::TaskStats stats{};
+      REQUIRE(scheduler.stats(4, stats) == PF::IndexStatus::out_of_bounds);
+    }
+
+    WHEN("the scheduler runs for the first time") {
+      size_t runs = scheduler.run(1000);
+
+      THEN("every task runs, by descending priority and then in order of addition") {
+        REQUIRE(runs == 4);
+        REQUIRE(task_runs == std::vector<char>{'b', 'd', 'a', 'c'});
+      }
+    }
+
+    WHEN("the scheduler runs every ms for 20 ms") {
+      for (uint32_t time = 1000; time < 1020; ++time) {
+        scheduler.run(time);
+      }
+
+      THEN("each task runs once per period") {
+        REQUIRE(get_stats(scheduler, 0).runs == 2);
+        REQUIRE(get_stats(scheduler, 1).runs == 10);
+        REQUIRE(get_stats(scheduler, 2).runs == 20);
+        REQUIRE(get_stats(scheduler, 3).runs == 2);
+        REQUIRE(get_stats(scheduler, 1).missed_periods == 0);
+      }
+    }
+
+    WHEN("the scheduler runs at irregular times") {
+      scheduler.run(1000);
+      task_runs.clear();
+      scheduler.run(1001);
+      REQUIRE(task_runs == std::vector<char>{'c'});
+      task_runs.clear();
+      scheduler.run(1003);
+      REQUIRE(task_runs == std::vector<char>{'b', 'c'});
+      task_runs.clear();
+      scheduler.run(1004);
+
+      THEN("periodic tasks stay on the grid of their periods instead of drifting") {
+        REQUIRE(task_runs == std::vector<char>{'b', 'c'});
+      }
+    }
+
+    WHEN("the scheduler falls behind by several periods") {
+      scheduler.run(1000);
+      task_runs.clear();
+      scheduler.run(1007);
+      REQUIRE(task_runs == std::vector<char>{'b', 'c'});
+      task_runs.clear();
+      scheduler.run(1008);
+
+      THEN("the missed periods are skipped and counted, rather than run in a burst") {
+        REQUIRE(task_runs == std::vector<char>{'b', 'c'});
+        REQUIRE(get_stats(scheduler, 1).runs == 3);
+        REQUIRE(get_stats(scheduler, 1).missed_periods == 2);
+      }
+    }
+
+    WHEN("the current time rolls over") {
+      scheduler.run(UINT32_MAX - 1);
+      task_runs.clear();
+      scheduler.run(UINT32_MAX);
+      REQUIRE(task_runs == std::vector<char>{'c'});
+      task_runs.clear();
+      scheduler.run(0);
+
+      THEN("tasks stay on schedule") {
+        REQUIRE(task_runs == std::vector<char>{'b', 'c'});
+      }
+    }
+  }
+
+  GIVEN("A scheduler with a task which sometimes exceeds its budget") {
+    PF::Util::Scheduler<4> scheduler(mock_time);
+    REQUIRE(scheduler.add(PF::Util::Task{record_slow_run, 1, 0, 100}) == PF::IndexStatus::ok);
+
+    WHEN("the task runs within and beyond its budget") {
+      task_micros = 100;
+      scheduler.run(0);
+      task_micros = 250;
+      scheduler.run(1);
+      task_micros = 50;
+      scheduler.run(2);
+
+      THEN("its overruns and its longest duration are recorded") {
+        auto stats = get_stats(scheduler, 0);
+        REQUIRE(stats.runs == 3);
+        REQUIRE(stats.overruns == 1);
+        REQUIRE(stats.max_duration == 250);
+        REQUIRE(scheduler.max_iteration_duration() == 250);
+      }
+    }
+
+    WHEN("the microsecond clock rolls over during a run") {
+      mock_time.set_micros(UINT32_MAX - 10);
+      task_micros = 20;
+      scheduler.run(0);
+
+      THEN("the run is counted but its duration is not measured") {
+        auto stats = get_stats(scheduler, 0);
+        REQUIRE(stats.runs == 1);
+        REQUIRE(stats.overruns == 0);
+        REQUIRE(stats.max_duration == 0);
+      }
+    }
+  }
+}
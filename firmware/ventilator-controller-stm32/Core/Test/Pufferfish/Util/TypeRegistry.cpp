@@ -0,0 +1,147 @@
+/*
+ * Copyright 2020, the Pez Globo team and the Pufferfish project contributors
+ *
+ * TypeRegistry.cpp
+ *
+ * Unit tests to confirm behavior of compile-time type registries
+ *
+ */
+
+#include "Pufferfish/Util/TypeRegistry.h"
+
+#include "Pufferfish/Application/States.h"
+#include "Pufferfish/Protocols/States.h"
+#include "Pufferfish/Util/Array.h"
+#include "Pufferfish/Util/TaggedUnion.h"
+#include "catch2/catch.hpp"
+
+namespace PF = Pufferfish;
+
+namespace {
+
+enum class TestTag : uint8_t { unknown = 0, integer = 2, real = 5 };
+
+union TestUnion {
+  int integer;
+  double real;
+};
+
+struct TestStruct {
+  int integer;
+  double real;
+};
+
+using TestRegistry = PF::Util::TypeRegistry<
+    TestTag,
+    PF::Util::TypeEntry<TestTag::real, double, &TestUnion::real, &TestStruct::real>,
+    PF::Util::TypeEntry<TestTag::integer, int, &TestUnion::integer, &TestStruct::integer>>;
+
+using TestTaggedUnion = PF::Util::TaggedUnion<TestUnion, TestTag, TestRegistry>;
+
+// Returns the registered tag of the visited entry, or unknown
+TestTag visit_tag(TestTag tag) {
+  return TestRegistry::visit(
+      tag, [](auto entry) { return decltype(entry)::tag; }, TestTag::unknown);
+}
+
+using TestOutputRate = PF::Protocols::StateOutputRate<PF::Application::MessageTypes>;
+
+constexpr auto valid_rates = PF::Util::make_array<const TestOutputRate>(
+    TestOutputRate{PF::Application::MessageTypes::sensor_measurements, 10, 20},
+    TestOutputRate{PF::Application::MessageTypes::parameters, 50, 100});
+static_assert(PF::Protocols::valid_output_rates<PF::Application::MessageRegistry>(valid_rates));
+
+constexpr auto unregistered_rates = PF::Util::make_array<const TestOutputRate>(
+    TestOutputRate{PF::Application::MessageTypes::unknown, 10, 20});
+static_assert(
+    !PF::Protocols::valid_output_rates<PF::Application::MessageRegistry>(unregistered_rates));
+
+constexpr auto duplicate_rates = PF::Util::make_array<const TestOutputRate>(
+    TestOutputRate{PF::Application::MessageTypes::parameters, 10, 20},
+    TestOutputRate{PF::Application::MessageTypes::parameters, 50, 100});
+static_assert(
+    !PF::Protocols::valid_output_rates<PF::Application::MessageRegistry>(duplicate_rates));
+
+}  // namespace
+
+SCENARIO("Util::TypeRegistry: types are mapped to and from their tags", "[TypeRegistry]") {
+  GIVEN("A registry of two types with sparse tags") {
+    THEN("it reports the tags and types which are registered") {
+      STATIC_REQUIRE(TestRegistry::size == 2);
+      STATIC_REQUIRE(TestRegistry::includes(TestTag::integer));
+      STATIC_REQUIRE(TestRegistry::includes(static_cast<uint8_t>(5)));
+      STATIC_REQUIRE(!TestRegistry::includes(TestTag::unknown));
+      STATIC_REQUIRE(!TestRegistry::includes(static_cast<uint8_t>(3)));
+      STATIC_REQUIRE(TestRegistry::contains<double>());
+      STATIC_REQUIRE(!TestRegistry::contains<float>());
+      STATIC_REQUIRE(TestRegistry::tag_of<int>() == TestTag::integer);
+      STATIC_REQUIRE(TestRegistry::tag_of<double>() == TestTag::real);
+    }
+
+    THEN("visiting a registered tag calls the visitor with its entry") {
+      REQUIRE(visit_tag(TestTag::integer) == TestTag::integer);
+      REQUIRE(visit_tag(TestTag::real) == TestTag::real);
+    }
+
+    THEN("visiting a tag which is unregistered, or past the largest tag, is rejected") {
+      for (uint8_t i = 0; i < UINT8_MAX; ++i) {
+        auto tag = static_cast<TestTag>(i);
+        if (tag != TestTag::integer && tag != TestTag::real) {
+          REQUIRE(visit_tag(tag) == TestTag::unknown);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO(
+    "Util::TypeRegistry: tagged unions and structs are accessed through the registry",
+    "[TypeRegistry]") {
+  GIVEN("A tagged union with setters generated from the registry") {
+    TestTaggedUnion tagged_union{};
+
+    WHEN("a value of each registered type is set") {
+      tagged_union.set(3.5);
+
+      THEN("the tag and union member match the type of the value") {
+        REQUIRE(tagged_union.tag == TestTag::real);
+        REQUIRE(tagged_union.value.real == 3.5);
+      }
+
+      AND_WHEN("it is copied into a struct through its registry entry") {
+        TestStruct values{};
+        TestRegistry::visit(
+            tagged_union.tag,
+            [&](auto entry) {
+              using Entry = decltype(entry);
+              values.*Entry::struct_member = tagged_union.value.*Entry::union_member;
+              return true;
+            },
+            false);
+
+        THEN("only the matching struct member is updated") {
+          REQUIRE(values.real == 3.5);
+          REQUIRE(values.integer == 0);
+        }
+      }
+
+      tagged_union.set(7);
+
+      THEN("the tag follows the most recently set value") {
+        REQUIRE(tagged_union.tag == TestTag::integer);
+        REQUIRE(tagged_union.value.integer == 7);
+      }
+    }
+  }
+
+  GIVEN("The application's message registry") {
+    PF::Application::StateSegment segment{};
+
+    THEN("state segment setters tag each message type with its registered type code") {
+      segment.set(SensorWaveforms{});
+      REQUIRE(segment.tag == PF::Application::MessageTypes::sensor_waveforms);
+      segment.set(AlarmLimitsRequest{});
+      REQUIRE(segment.tag == PF::Application::MessageTypes::alarm_limits_request);
+    }
+  }
+}
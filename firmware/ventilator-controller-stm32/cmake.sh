@@ -2,7 +2,8 @@
 
 BUILD_TARGET="$1"
 
-if [ "$BUILD_TARGET" == "TestCatch2" ]; then
+if [ "$BUILD_TARGET" == "TestCatch2" ] || [ "$BUILD_TARGET" == "Benchmark" ] || \
+   [ "$BUILD_TARGET" == "Host" ]; then
   TOOLCHAIN_ARGS=""
 else
   TOOLCHAIN_ARGS="\
@@ -14,6 +14,11 @@ nanopb_generator \
 find ../firmware/ventilator-controller-stm32/Core/Inc/Pufferfish -name *_pb.h \
   | xargs sed -i 's/inline const pb_msgdesc_t/PB_INLINE_CONSTEXPR const pb_msgdesc_t/g'
 
+# Generate straight-line encoders and decoders for fixed-shape messages, from nanopb's field lists
+python3 generate_mcu_codecs.py \
+  ../firmware/ventilator-controller-stm32/Core/Inc/Pufferfish/Application/mcu_pb.h \
+  ../firmware/ventilator-controller-stm32/Core/Inc/Pufferfish/Application/mcu_pb_codecs.h
+
 # Move source files, since STM32Cube IDE puts them in different directories
 SOURCE_FILES=`find ../firmware/ventilator-controller-stm32/Core/Inc/Pufferfish -name *_pb.c`
 for SOURCE in $SOURCE_FILES; do
@@ -0,0 +1,290 @@
+#!/usr/bin/env python3
+"""Generate straight-line protobuf encoders and decoders for the nanopb messages.
+
+The nanopb field lists in the generated header are the source of truth, so that the
+generated code always matches the nanopb structs. Messages with fields which can't be
+encoded in straight-line code (bytes, strings, callbacks, repeated submessages) are
+skipped; they fall back to nanopb's descriptor-driven encoder and decoder.
+
+Usage: generate_mcu_codecs.py NANOPB_HEADER OUTPUT_HEADER
+"""
+
+import os
+import re
+import sys
+from typing import Dict, List, NamedTuple, Optional, Tuple
+
+
+FIELD_PATTERN = re.compile(
+    r'X\(a,\s*(\w+),\s*(\w+),\s*(\w+),\s*(\w+),\s*(\d+)\)'
+)
+FIELDLIST_PATTERN = re.compile(
+    r'#define (\w+)_FIELDLIST\(X, a\) \\\n((?:X\(.*\)(?: \\)?\n)+)'
+)
+MSGTYPE_PATTERN = re.compile(r'#define (\w+)_MSGTYPE (\w+)')
+STRUCT_PATTERN = re.compile(r'typedef struct _(\w+) \{\n(.*?)\n\} \1;', re.DOTALL)
+STRUCT_FIELD_PATTERN = re.compile(r'^\s*(\w+) (\w+)(?:\[(\d+)\])?;$', re.MULTILINE)
+ENUM_PATTERN = re.compile(r'typedef enum _(\w+) \{\n(.*?)\n\} \1;', re.DOTALL)
+ENUM_VALUE_PATTERN = re.compile(r'(\w+) = (-?\d+)')
+
+SCALAR_MAX_SIZES = {'UINT32': 5, 'BOOL': 1, 'FLOAT': 4}
+REPEATED_ELEMENT_SIZES = {'UINT32': 5, 'FLOAT': 4}
+
+
+class Field(NamedTuple):
+    """A field of a nanopb message."""
+
+    name: str
+    number: int
+    allocation: str
+    label: str
+    type: str
+    c_type: str
+    max_count: int
+    submessage: Optional[str]
+
+
+class Message(NamedTuple):
+    """A nanopb message."""
+
+    name: str
+    fields: List[Field]
+
+
+def varint_size(value: int) -> int:
+    """Return the number of bytes in the varint encoding of a value."""
+    size = 1
+    while value >= 0x80:
+        value >>= 7
+        size += 1
+    return size
+
+
+def tag_size(number: int) -> int:
+    """Return the number of bytes in the tag of a field."""
+    return varint_size(number << 3)
+
+
+def parse_header(header: str) -> List[Message]:
+    """Parse the messages in a nanopb header."""
+    structs: Dict[str, Dict[str, Tuple[str, int]]] = {}
+    for struct_match in STRUCT_PATTERN.finditer(header):
+        structs[struct_match.group(1)] = {
+            field_match.group(2): (field_match.group(1), int(field_match.group(3) or 0))
+            for field_match in STRUCT_FIELD_PATTERN.finditer(struct_match.group(2))
+        }
+    # Keyed by message name and field name, joined by an underscore
+    submessages = {
+        match.group(1): match.group(2) for match in MSGTYPE_PATTERN.finditer(header)
+    }
+    messages = []
+    for fieldlist_match in FIELDLIST_PATTERN.finditer(header):
+        name = fieldlist_match.group(1)
+        fields = []
+        for field_match in FIELD_PATTERN.finditer(fieldlist_match.group(2)):
+            (allocation, label, field_type, field_name, number) = field_match.groups()
+            (c_type, max_count) = structs.get(name, {}).get(field_name, ('', 0))
+            fields.append(Field(
+                field_name, int(number), allocation, label, field_type, c_type,
+                max_count, submessages.get('{}_{}'.format(name, field_name))
+            ))
+        messages.append(Message(name, fields))
+    return messages
+
+
+def parse_enum_maxima(header: str) -> Dict[str, int]:
+    """Parse the largest value of each enum in a nanopb header."""
+    return {
+        match.group(1): max(
+            int(value.group(2)) for value in ENUM_VALUE_PATTERN.finditer(match.group(2))
+        )
+        for match in ENUM_PATTERN.finditer(header)
+    }
+
+
+def supported(message: Message, supported_messages: Dict[str, Message]) -> bool:
+    """Check whether straight-line code can be generated for a message."""
+    for field in message.fields:
+        if field.allocation != 'STATIC':
+            return False
+        if field.label == 'SINGULAR':
+            if field.type not in SCALAR_MAX_SIZES and field.type != 'UENUM':
+                return False
+        elif field.label == 'REPEATED':
+            if field.type not in REPEATED_ELEMENT_SIZES or field.max_count == 0:
+                return False
+        elif field.label == 'OPTIONAL':
+            if field.type != 'MESSAGE' or field.submessage not in supported_messages:
+                return False
+        else:
+            return False
+    return True
+
+
+def max_size(
+        message: Message, max_sizes: Dict[str, int], enum_maxima: Dict[str, int]
+) -> int:
+    """Compute the largest possible encoded size of a message."""
+    size = 0
+    for field in message.fields:
+        if field.label == 'REPEATED':
+            body_size = field.max_count * REPEATED_ELEMENT_SIZES[field.type]
+            size += tag_size(field.number) + varint_size(body_size) + body_size
+        elif field.type == 'MESSAGE':
+            body_size = max_sizes[field.submessage]
+            size += tag_size(field.number) + varint_size(body_size) + body_size
+        elif field.type == 'UENUM':
+            size += tag_size(field.number) + varint_size(enum_maxima[field.c_type])
+        else:
+            size += tag_size(field.number) + SCALAR_MAX_SIZES[field.type]
+    return size
+
+
+def size_term(field: Field) -> str:
+    """Generate the expression for the encoded size of a field."""
+    value = 'message.{}'.format(field.name)
+    if field.label == 'REPEATED':
+        if field.type == 'UINT32':
+            return 'protobuf_packed_uint32_size({}, {}, {}_count)'.format(
+                field.number, value, value
+            )
+        return 'protobuf_packed_float_size({}, {}_count)'.format(field.number, value)
+    if field.type == 'MESSAGE':
+        return 'protobuf_message_size({}, message.has_{}, {})'.format(
+            field.number, field.name, value
+        )
+    if field.type == 'UENUM':
+        return 'protobuf_uint32_size({}, static_cast<uint32_t>({}))'.format(
+            field.number, value
+        )
+    return 'protobuf_{}_size({}, {})'.format(field.type.lower(), field.number, value)
+
+
+def encode_term(message: Message, field: Field) -> str:
+    """Generate the expression which encodes a field."""
+    value = 'message.{}'.format(field.name)
+    if field.label == 'REPEATED':
+        return (
+            'writer.write_packed_{}(\n'
+            '               {}, {}, {}_count, pb_arraysize({}, {}))'
+        ).format(field.type.lower(), field.number, value, value, message.name, field.name)
+    if field.type == 'MESSAGE':
+        return 'writer.write_message({}, message.has_{}, {})'.format(
+            field.number, field.name, value
+        )
+    if field.type == 'UENUM':
+        return 'writer.write_uint32({}, static_cast<uint32_t>({}))'.format(
+            field.number, value
+        )
+    return 'writer.write_{}({}, {})'.format(field.type.lower(), field.number, value)
+
+
+def decode_statement(message: Message, field: Field) -> str:
+    """Generate the statement which decodes a field."""
+    value = 'message.{}'.format(field.name)
+    if field.label == 'REPEATED':
+        return (
+            'ok = reader.read_repeated_{}(\n'
+            '              wire_type,\n'
+            '              {},\n'
+            '              {}_count,\n'
+            '              pb_arraysize({}, {}));'
+        ).format(field.type.lower(), value, value, message.name, field.name)
+    if field.type == 'MESSAGE':
+        return 'ok = reader.read_message(wire_type, message.has_{}, {});'.format(
+            field.name, value
+        )
+    if field.type == 'UENUM':
+        return 'ok = reader.read_enum(wire_type, {});'.format(value)
+    return 'ok = reader.read_{}(wire_type, {});'.format(field.type.lower(), value)
+
+
+def join_terms(terms: List[str], operator: str, indent: str) -> str:
+    """Join expressions with a binary operator, one per line."""
+    return (' {}\n{}'.format(operator, indent)).join(terms)
+
+
+def generate_codec(message: Message, size: int) -> str:
+    """Generate the codec specialization of a message."""
+    sizes = join_terms([size_term(field) for field in message.fields], '+', '           ')
+    encodes = join_terms([encode_term(message, field) for field in message.fields], '&&', '           ')
+    cases = ''.join(
+        '        case {}:\n          {}\n          break;\n'.format(
+            field.number, decode_statement(message, field)
+        )
+        for field in message.fields
+    )
+    return '''template <>
+struct ProtobufCodec<{name}> {{
+  static constexpr bool generated = true;
+  static constexpr size_t max_size = {size};
+
+  static size_t encoded_size(const {name} &message) {{
+    return {sizes};
+  }}
+
+  static bool encode(const {name} &message, ProtobufWriter &writer) {{
+    return {encodes};
+  }}
+
+  static bool decode(ProtobufReader &reader, {name} &message) {{
+    uint32_t field = 0;
+    ProtobufWireType wire_type = ProtobufWireType::varint;
+    while (!reader.empty()) {{
+      if (!reader.read_tag(field, wire_type)) {{
+        return false;
+      }}
+      bool ok = false;
+      switch (field) {{
+{cases}        default:
+          ok = reader.skip(wire_type);
+      }}
+      if (!ok) {{
+        return false;
+      }}
+    }}
+    return true;
+  }}
+}};
+'''.format(name=message.name, size=size, sizes=sizes, encodes=encodes, cases=cases)
+
+
+def generate(header: str, header_name: str) -> str:
+    """Generate the codecs for all supported messages in a nanopb header."""
+    enum_maxima = parse_enum_maxima(header)
+    supported_messages: Dict[str, Message] = {}
+    max_sizes: Dict[str, int] = {}
+    codecs = []
+    # nanopb orders messages so that submessages are defined before they are used
+    for message in parse_header(header):
+        if not supported(message, supported_messages):
+            continue
+        supported_messages[message.name] = message
+        max_sizes[message.name] = max_size(message, max_sizes, enum_maxima)
+        codecs.append(generate_codec(message, max_sizes[message.name]))
+    return '''/* Automatically generated by generate_mcu_codecs.py from {header_name} */
+/* Straight-line protobuf encoders and decoders, wire-compatible with nanopb */
+
+#pragma once
+
+#include "Pufferfish/Application/{header_name}"
+#include "Pufferfish/Util/ProtobufWire.h"
+
+namespace Pufferfish::Util {{
+
+{codecs}
+}}  // namespace Pufferfish::Util
+'''.format(header_name=header_name, codecs='\n'.join(codecs))
+
+
+def main() -> None:
+    """Generate the codecs header from the nanopb header."""
+    (header_path, output_path) = sys.argv[1:3]
+    with open(header_path) as header_file:
+        header = header_file.read()
+    with open(output_path, 'w') as output_file:
+        output_file.write(generate(header, os.path.basename(header_path)))
+
+
+if __name__ == '__main__':
+    main()